@@ -68,6 +68,9 @@ class CRoutine {
   void Stop();
   void Wake();
   void HangUp();
+  // Hangs up until notified, or until the timeout has passed once the
+  // processor looks at the routine again.
+  void HangUp(const Duration &timeout);
   void Sleep(const Duration &sleep_duration);
 
   // getter and setter
@@ -111,6 +114,7 @@ class CRoutine {
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
 
   bool force_stop_ = false;
+  bool timed_wait_ = false;
 
   int processor_id_ = -1;
   uint32_t priority_ = 0;
@@ -152,7 +156,19 @@ inline std::chrono::steady_clock::time_point CRoutine::wake_time() const {
 
 inline void CRoutine::Wake() { state_ = RoutineState::READY; }
 
-inline void CRoutine::HangUp() { CRoutine::Yield(RoutineState::DATA_WAIT); }
+inline void CRoutine::HangUp() {
+  timed_wait_ = false;
+  CRoutine::Yield(RoutineState::DATA_WAIT);
+}
+
+inline void CRoutine::HangUp(const Duration &timeout) {
+  wake_time_ = std::chrono::steady_clock::now() + timeout;
+  timed_wait_ = true;
+  CRoutine::Yield(RoutineState::DATA_WAIT);
+  // The deadline is only for this wait, the routine may go on to wait for
+  // data without one, like the component and reader routines do.
+  timed_wait_ = false;
+}
 
 inline void CRoutine::Sleep(const Duration &sleep_duration) {
   wake_time_ = std::chrono::steady_clock::now() + sleep_duration;
@@ -187,6 +203,10 @@ inline RoutineState CRoutine::UpdateState() {
       state_ = RoutineState::READY;
     }
   }
+  if (state_ == RoutineState::DATA_WAIT && timed_wait_ &&
+      std::chrono::steady_clock::now() > wake_time_) {
+    state_ = RoutineState::READY;
+  }
   return state_;
 }
 
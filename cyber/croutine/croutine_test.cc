@@ -15,6 +15,9 @@
  *****************************************************************************/
 #include "cyber/croutine/croutine.h"
 
+#include <chrono>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "cyber/common/global_data.h"
@@ -27,6 +30,12 @@ namespace croutine {
 
 void function() { CRoutine::Yield(RoutineState::IO_WAIT); }
 
+void timed_wait_function() {
+  CRoutine::GetCurrentRoutine()->HangUp(std::chrono::milliseconds(10));
+  // Then waits for data without a deadline, like a reader routine.
+  CRoutine::Yield(RoutineState::DATA_WAIT);
+}
+
 TEST(Croutine, croutinetest) {
   apollo::cyber::Init("croutine_test");
   std::shared_ptr<CRoutine> cr = std::make_shared<CRoutine>(function);
@@ -49,6 +58,21 @@ TEST(Croutine, croutinetest) {
   EXPECT_EQ(cr->Resume(), RoutineState::FINISHED);
 }
 
+TEST(Croutine, timed_wait) {
+  std::shared_ptr<CRoutine> cr =
+      std::make_shared<CRoutine>(timed_wait_function);
+  EXPECT_EQ(cr->Resume(), RoutineState::DATA_WAIT);
+  EXPECT_EQ(cr->UpdateState(), RoutineState::DATA_WAIT);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(cr->UpdateState(), RoutineState::READY);
+  EXPECT_EQ(cr->Resume(), RoutineState::DATA_WAIT);
+  // The passed deadline does not wake up the next wait.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(cr->UpdateState(), RoutineState::DATA_WAIT);
+  cr->Stop();
+  EXPECT_EQ(cr->Resume(), RoutineState::FINISHED);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
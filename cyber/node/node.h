@@ -130,12 +130,15 @@ class Node {
    * @tparam Response Message Type of the Response
    * @param service_name specific service name to a serve
    * @param service_callback invoked when a service is called
+   * @param concurrency number of requests handled at the same time, 0 to
+   * handle them on the task pool
    * @return std::shared_ptr<Service<Request, Response>> result `Service`
    */
   template <typename Request, typename Response>
   auto CreateService(const std::string& service_name,
                      const typename Service<Request, Response>::ServiceCallback&
-                         service_callback)
+                         service_callback,
+                     uint32_t concurrency = 1)
       -> std::shared_ptr<Service<Request, Response>>;
 
   /**
@@ -258,9 +261,10 @@ template <typename Request, typename Response>
 auto Node::CreateService(
     const std::string& service_name,
     const typename Service<Request, Response>::ServiceCallback&
-        service_callback) -> std::shared_ptr<Service<Request, Response>> {
+        service_callback,
+    uint32_t concurrency) -> std::shared_ptr<Service<Request, Response>> {
   return node_service_impl_->template CreateService<Request, Response>(
-      service_name, service_callback);
+      service_name, service_callback, concurrency);
 }
 
 template <typename Request, typename Response>
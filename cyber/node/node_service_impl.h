@@ -69,7 +69,8 @@ class NodeServiceImpl {
   template <typename Request, typename Response>
   auto CreateService(const std::string& service_name,
                      const typename Service<Request, Response>::ServiceCallback&
-                         service_callback) ->
+                         service_callback,
+                     uint32_t concurrency) ->
       typename std::shared_ptr<Service<Request, Response>>;
 
   template <typename Request, typename Response>
@@ -86,10 +87,11 @@ template <typename Request, typename Response>
 auto NodeServiceImpl::CreateService(
     const std::string& service_name,
     const typename Service<Request, Response>::ServiceCallback&
-        service_callback) ->
+        service_callback,
+    uint32_t concurrency) ->
     typename std::shared_ptr<Service<Request, Response>> {
   auto service_ptr = std::make_shared<Service<Request, Response>>(
-      node_name_, service_name, service_callback);
+      node_name_, service_name, service_callback, concurrency);
   RETURN_VAL_IF(!service_ptr->Init(), nullptr);
 
   service_list_.emplace_back(service_ptr);
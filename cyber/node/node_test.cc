@@ -16,11 +16,19 @@
 
 #include "cyber/node/node.h"
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/proto/unit_test.pb.h"
 
 #include "cyber/cyber.h"
+#include "cyber/croutine/croutine.h"
 #include "cyber/init.h"
 #include "cyber/node/reader.h"
 #include "cyber/node/writer.h"
@@ -64,6 +72,191 @@ TEST(NodeTest, cases) {
   node->ClearData();
 }
 
+TEST(NodeTest, concurrent_service) {
+  auto node = CreateNode("node_test_concurrent");
+  std::atomic<int> running = {0};
+  std::atomic<int> max_running = {0};
+  auto server = node->CreateService<Chatter, Chatter>(
+      "node_test_concurrent_server",
+      [&](const std::shared_ptr<Chatter>& request,
+          std::shared_ptr<Chatter>& response) {
+        int now = ++running;
+        int max = max_running.load();
+        while (now > max && !max_running.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        --running;
+        response->set_seq(request->seq());
+      },
+      2);
+  ASSERT_NE(server, nullptr);
+  auto client =
+      node->CreateClient<Chatter, Chatter>("node_test_concurrent_server");
+  ASSERT_NE(client, nullptr);
+
+  auto request = std::make_shared<Chatter>();
+  request->set_seq(1);
+  auto first = client->AsyncSendRequest(request);
+  request = std::make_shared<Chatter>();
+  request->set_seq(2);
+  auto second = client->AsyncSendRequest(request);
+  ASSERT_EQ(std::future_status::ready,
+            first.wait_for(std::chrono::seconds(5)));
+  ASSERT_EQ(std::future_status::ready,
+            second.wait_for(std::chrono::seconds(5)));
+  EXPECT_EQ(1, first.get()->seq());
+  EXPECT_EQ(2, second.get()->seq());
+  // Both requests are handled at the same time by the two workers.
+  EXPECT_EQ(2, max_running.load());
+
+  // From a task pool routine the request hangs up the routine.
+  auto response = Async([&client]() {
+                    auto request = std::make_shared<Chatter>();
+                    request->set_seq(3);
+                    return client->SendRequest(request);
+                  }).get();
+  ASSERT_NE(response, nullptr);
+  EXPECT_EQ(3, response->seq());
+
+  EXPECT_EQ(3, server->handle_latency().count());
+  EXPECT_GE(server->handle_latency().max(), std::chrono::milliseconds(200));
+  EXPECT_EQ(3, client->request_latency().count());
+  EXPECT_EQ(0, client->timeout_count());
+}
+
+TEST(NodeTest, task_pool_service) {
+  auto node = CreateNode("node_test_task_pool");
+  std::atomic<int> calls = {0};
+  std::atomic<bool> from_pool = {true};
+  std::atomic<bool> slow_started = {false};
+  std::atomic<bool> slow_released = {false};
+  auto server = node->CreateService<Chatter, Chatter>(
+      "node_test_task_pool_server",
+      [&](const std::shared_ptr<Chatter>& request,
+          std::shared_ptr<Chatter>& response) {
+        ++calls;
+        if (croutine::CRoutine::GetCurrentRoutine() == nullptr) {
+          from_pool = false;
+        }
+        if (request->seq() == 2) {
+          slow_started = true;
+          while (!slow_released.load()) {
+            SleepFor(std::chrono::milliseconds(5));
+          }
+        }
+        response->set_seq(request->seq());
+      },
+      0);
+  ASSERT_NE(server, nullptr);
+  auto client =
+      node->CreateClient<Chatter, Chatter>("node_test_task_pool_server");
+  ASSERT_NE(client, nullptr);
+
+  auto request = std::make_shared<Chatter>();
+  request->set_seq(1);
+  auto response = client->SendRequest(request);
+  ASSERT_NE(response, nullptr);
+  EXPECT_EQ(1, response->seq());
+  EXPECT_EQ(1, calls.load());
+  EXPECT_TRUE(from_pool.load());
+
+  // Keep all but one routine of the task pool busy, so that the slow request
+  // takes the last one and the requests after it stay queued.
+  const uint32_t pool_size = TaskManager::Instance()->ThreadNum();
+  ASSERT_GT(pool_size, 0u);
+  std::atomic<uint32_t> blocked = {0};
+  std::atomic<bool> pool_released = {false};
+  std::vector<std::future<void>> blockers;
+  for (uint32_t i = 1; i < pool_size; ++i) {
+    blockers.emplace_back(Async([&blocked, &pool_released]() {
+      ++blocked;
+      while (!pool_released.load()) {
+        SleepFor(std::chrono::milliseconds(5));
+      }
+    }));
+  }
+  while (blocked.load() + 1 < pool_size) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  request = std::make_shared<Chatter>();
+  request->set_seq(2);
+  auto slow = client->AsyncSendRequest(request);
+  while (!slow_started.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::vector<Client<Chatter, Chatter>::SharedFuture> queued;
+  for (uint64_t seq = 3; seq < 6; ++seq) {
+    request = std::make_shared<Chatter>();
+    request->set_seq(seq);
+    queued.emplace_back(client->AsyncSendRequest(request));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // destroy() waits for the running request only.
+  std::atomic<bool> destroyed = {false};
+  std::thread destroyer([&server, &destroyed]() {
+    server->destroy();
+    destroyed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_FALSE(destroyed.load());
+  slow_released = true;
+  destroyer.join();
+  EXPECT_TRUE(destroyed.load());
+  EXPECT_EQ(2, calls.load());
+
+  // The queued requests are dropped once the task pool gets to them.
+  pool_released = true;
+  for (auto& blocker : blockers) {
+    blocker.wait();
+  }
+  for (uint32_t i = 0; i < pool_size; ++i) {
+    Async([]() {}).wait();
+  }
+  EXPECT_EQ(2, calls.load());
+}
+
+TEST(NodeTest, service_from_reader) {
+  auto node = CreateNode("node_test_reader_client");
+  auto server = node->CreateService<Chatter, Chatter>(
+      "node_test_reader_server", [](const std::shared_ptr<Chatter>& request,
+                                    std::shared_ptr<Chatter>& response) {
+        response->set_seq(request->seq());
+      });
+  ASSERT_NE(server, nullptr);
+  auto client = node->CreateClient<Chatter, Chatter>("node_test_reader_server");
+  ASSERT_NE(client, nullptr);
+
+  std::atomic<int> responses = {0};
+  auto reader = node->CreateReader<Chatter>(
+      "/node_test_reader_channel",
+      [&client, &responses](const std::shared_ptr<Chatter>& msg) {
+        auto response = client->SendRequest(*msg, std::chrono::seconds(1));
+        if (response != nullptr && response->seq() == msg->seq()) {
+          ++responses;
+        }
+      });
+  ASSERT_NE(reader, nullptr);
+  auto writer = node->CreateWriter<Chatter>("/node_test_reader_channel");
+  ASSERT_NE(writer, nullptr);
+
+  Chatter msg;
+  msg.set_seq(4);
+  for (int i = 0; i < 50 && responses.load() == 0; ++i) {
+    writer->Write(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_GT(responses.load(), 0);
+
+  // Once the request deadline has passed, the reader routine waits for data
+  // again instead of being made ready over and over by that deadline.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  std::clock_t start = std::clock();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  EXPECT_LT(std::clock() - start, CLOCKS_PER_SEC / 2);
+}
+
 }  // namespace cyber
 }  // namespace apollo
 
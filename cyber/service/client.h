@@ -17,6 +17,8 @@
 #ifndef CYBER_SERVICE_CLIENT_H_
 #define CYBER_SERVICE_CLIENT_H_
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <map>
 #include <memory>
@@ -28,8 +30,11 @@
 
 #include "cyber/common/log.h"
 #include "cyber/common/types.h"
+#include "cyber/croutine/croutine.h"
 #include "cyber/node/node_channel_impl.h"
+#include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/service/client_base.h"
+#include "cyber/service/latency_statistics.h"
 
 namespace apollo {
 namespace cyber {
@@ -41,6 +46,9 @@ namespace cyber {
  * @tparam Request the `Service` request type
  * @tparam Response the `Service` response type
  *
+ * Called from a croutine, SendRequest hangs up the routine instead of
+ * blocking the thread of its processor until the response arrives.
+ *
  * @warning One Client can only request one Service
  */
 template <typename Request, typename Response>
@@ -148,10 +156,26 @@ class Client : public ClientBase {
         std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
   }
 
+  /**
+   * @brief Time from sending a request to receiving its response
+   */
+  const LatencyStatistics& request_latency() const { return request_latency_; }
+
+  /**
+   * @brief Number of SendRequest calls that timed out
+   */
+  uint64_t timeout_count() const { return timeout_count_.load(); }
+
  private:
+  using Clock = std::chrono::steady_clock;
+
   void HandleResponse(const std::shared_ptr<Response>& response,
                       const transport::MessageInfo& request_info);
 
+  SharedResponse AwaitResponse(croutine::CRoutine* routine,
+                               SharedRequest request,
+                               const std::chrono::seconds& timeout_s);
+
   bool IsInit(void) const { return response_receiver_ != nullptr; }
 
   std::string node_name_;
@@ -160,8 +184,8 @@ class Client : public ClientBase {
                      const transport::MessageInfo&)>
       response_callback_;
 
-  std::unordered_map<uint64_t,
-                     std::tuple<SharedPromise, CallbackType, SharedFuture>>
+  std::unordered_map<uint64_t, std::tuple<SharedPromise, CallbackType,
+                                          SharedFuture, Clock::time_point>>
       pending_requests_;
   std::mutex pending_requests_mutex_;
 
@@ -172,6 +196,9 @@ class Client : public ClientBase {
 
   transport::Identity writer_id_;
   uint64_t sequence_number_;
+
+  LatencyStatistics request_latency_;
+  std::atomic<uint64_t> timeout_count_ = {0};
 };
 
 template <typename Request, typename Response>
@@ -227,6 +254,10 @@ Client<Request, Response>::SendRequest(SharedRequest request,
   if (!IsInit()) {
     return nullptr;
   }
+  auto routine = croutine::CRoutine::GetCurrentRoutine();
+  if (routine != nullptr) {
+    return AwaitResponse(routine, request, timeout_s);
+  }
   auto future = AsyncSendRequest(request);
   if (!future.valid()) {
     return nullptr;
@@ -235,10 +266,39 @@ Client<Request, Response>::SendRequest(SharedRequest request,
   if (status == std::future_status::ready) {
     return future.get();
   } else {
+    timeout_count_.fetch_add(1);
     return nullptr;
   }
 }
 
+template <typename Request, typename Response>
+typename Client<Request, Response>::SharedResponse
+Client<Request, Response>::AwaitResponse(
+    croutine::CRoutine* routine, SharedRequest request,
+    const std::chrono::seconds& timeout_s) {
+  // The response wakes the routine up, the routine checks the future itself
+  // since it can be woken for its other events too.
+  uint64_t routine_id = routine->id();
+  auto future = AsyncSendRequest(request, [routine_id](SharedFuture) {
+    scheduler::Instance()->NotifyTask(routine_id);
+  });
+  if (!future.valid()) {
+    return nullptr;
+  }
+  auto deadline = Clock::now() + timeout_s;
+  while (future.wait_for(std::chrono::seconds(0)) !=
+         std::future_status::ready) {
+    auto now = Clock::now();
+    if (now >= deadline) {
+      timeout_count_.fetch_add(1);
+      return nullptr;
+    }
+    routine->HangUp(
+        std::chrono::duration_cast<croutine::Duration>(deadline - now));
+  }
+  return future.get();
+}
+
 template <typename Request, typename Response>
 typename Client<Request, Response>::SharedResponse
 Client<Request, Response>::SendRequest(const Request& request,
@@ -274,8 +334,8 @@ Client<Request, Response>::AsyncSendRequest(SharedRequest request,
     request_transmitter_->Transmit(request, info);
     SharedPromise call_promise = std::make_shared<Promise>();
     SharedFuture f(call_promise->get_future());
-    pending_requests_[info.seq_num()] =
-        std::make_tuple(call_promise, std::forward<CallbackType>(cb), f);
+    pending_requests_[info.seq_num()] = std::make_tuple(
+        call_promise, std::forward<CallbackType>(cb), f, Clock::now());
     return f;
   } else {
     return std::shared_future<std::shared_ptr<Response>>();
@@ -304,6 +364,7 @@ void Client<Request, Response>::HandleResponse(
   auto call_promise = std::get<0>(tuple);
   auto callback = std::get<1>(tuple);
   auto future = std::get<2>(tuple);
+  request_latency_.Add(Clock::now() - std::get<3>(tuple));
   this->pending_requests_.erase(sequence_number);
   call_promise->set_value(response);
   callback(future);
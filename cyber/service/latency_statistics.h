@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SERVICE_LATENCY_STATISTICS_H_
+#define CYBER_SERVICE_LATENCY_STATISTICS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @class LatencyStatistics
+ * @brief Lock free count, average, maximum and percentiles of latencies.
+ *
+ * Percentiles are read from power of two buckets, so they are upper bounds
+ * within a factor of two.
+ */
+class LatencyStatistics {
+ public:
+  using Duration = std::chrono::nanoseconds;
+
+  void Add(const Duration& latency) {
+    const uint64_t ns =
+        latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max_ns && !max_ns_.compare_exchange_weak(
+                              max_ns, ns, std::memory_order_relaxed)) {
+    }
+    buckets_[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  Duration average() const {
+    const uint64_t count = this->count();
+    return Duration(count == 0 ? 0 : sum_ns_.load() / count);
+  }
+
+  Duration max() const { return Duration(max_ns_.load()); }
+
+  /**
+   * @brief Upper bound of the given percentile, in [0, 100].
+   */
+  Duration Percentile(double percentile) const {
+    const uint64_t count = this->count();
+    if (count == 0) {
+      return Duration(0);
+    }
+    const uint64_t rank =
+        static_cast<uint64_t>(static_cast<double>(count) * percentile / 100.0);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketNum; ++i) {
+      seen += buckets_[i].load(std::memory_order_relaxed);
+      if (seen > rank && i < kBucketNum - 1) {
+        return std::min(Duration((int64_t{1} << i) - 1), max());
+      }
+    }
+    return max();
+  }
+
+ private:
+  static constexpr int kBucketNum = 64;
+
+  // Bucket i holds latencies in [2^(i-1), 2^i) ns, bucket 0 holds 0.
+  static int BucketOf(uint64_t ns) {
+    int bucket = 0;
+    while (ns != 0 && bucket < kBucketNum - 1) {
+      ns >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  std::atomic<uint64_t> count_ = {0};
+  std::atomic<uint64_t> sum_ns_ = {0};
+  std::atomic<uint64_t> max_ns_ = {0};
+  std::atomic<uint64_t> buckets_[kBucketNum] = {};
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SERVICE_LATENCY_STATISTICS_H_
@@ -17,15 +17,21 @@
 #ifndef CYBER_SERVICE_SERVICE_H_
 #define CYBER_SERVICE_SERVICE_H_
 
+#include <chrono>
+#include <condition_variable>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/types.h"
 #include "cyber/node/node_channel_impl.h"
 #include "cyber/scheduler/scheduler.h"
+#include "cyber/service/latency_statistics.h"
 #include "cyber/service/service_base.h"
+#include "cyber/task/task_manager.h"
 
 namespace apollo {
 namespace cyber {
@@ -35,6 +41,10 @@ namespace cyber {
  * @brief Service handles `Request` from the Client, and send a `Response` to
  * it.
  *
+ * Requests are handled by `concurrency` worker threads, one by default, or
+ * on the routines of the cyber task pool if `concurrency` is 0. With more
+ * than one worker the callback must be thread safe.
+ *
  * @tparam Request the request type
  * @tparam Response the response type
  */
@@ -49,14 +59,16 @@ class Service : public ServiceBase {
    * @param node_name used to fill RoleAttribute when join the topology
    * @param service_name the service name we provide
    * @param service_callback reference of `ServiceCallback` object
+   * @param concurrency number of worker threads, 0 to use the task pool
    */
   Service(const std::string& node_name, const std::string& service_name,
-          const ServiceCallback& service_callback)
+          const ServiceCallback& service_callback, uint32_t concurrency = 1)
       : ServiceBase(service_name),
         node_name_(node_name),
         service_callback_(service_callback),
         request_channel_(service_name + SRV_CHANNEL_REQ_SUFFIX),
-        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX) {}
+        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX),
+        concurrency_(concurrency) {}
 
   /**
    * @brief Construct a new Service object
@@ -64,14 +76,16 @@ class Service : public ServiceBase {
    * @param node_name used to fill RoleAttribute when join the topology
    * @param service_name the service name we provide
    * @param service_callback rvalue reference of `ServiceCallback` object
+   * @param concurrency number of worker threads, 0 to use the task pool
    */
   Service(const std::string& node_name, const std::string& service_name,
-          ServiceCallback&& service_callback)
+          ServiceCallback&& service_callback, uint32_t concurrency = 1)
       : ServiceBase(service_name),
         node_name_(node_name),
         service_callback_(service_callback),
         request_channel_(service_name + SRV_CHANNEL_REQ_SUFFIX),
-        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX) {}
+        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX),
+        concurrency_(concurrency) {}
 
   /**
    * @brief Forbid default constructing
@@ -90,10 +104,26 @@ class Service : public ServiceBase {
    */
   void destroy();
 
+  /**
+   * @brief Time from the receipt of a request to the start of its handling
+   */
+  const LatencyStatistics& queue_latency() const { return queue_latency_; }
+
+  /**
+   * @brief Time spent in the callback and sending the response
+   */
+  const LatencyStatistics& handle_latency() const { return handle_latency_; }
+
  private:
+  using Clock = std::chrono::steady_clock;
+
   void HandleRequest(const std::shared_ptr<Request>& request,
                      const transport::MessageInfo& message_info);
 
+  void HandleReceivedRequest(const std::shared_ptr<Request>& request,
+                             const transport::MessageInfo& message_info,
+                             const Clock::time_point& receive_time);
+
   void SendResponse(const transport::MessageInfo& message_info,
                     const std::shared_ptr<Response>& response);
 
@@ -109,15 +139,29 @@ class Service : public ServiceBase {
   std::shared_ptr<transport::Receiver<Request>> request_receiver_;
   std::string request_channel_;
   std::string response_channel_;
-  std::mutex service_handle_request_mutex_;
 
   volatile bool inited_ = false;
   void Enqueue(std::function<void()>&& task);
   void Process();
-  std::thread thread_;
+  uint32_t concurrency_ = 1;
+  std::vector<std::thread> threads_;
   std::mutex queue_mutex_;
   std::condition_variable condition_;
   std::list<std::function<void()>> tasks_;
+
+  // Requests handed to the task pool. It outlives the service, so the ones
+  // still queued after destroy() are dropped without touching the service.
+  struct PostedRequests {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopped = false;
+    uint32_t running = 0;
+  };
+  std::shared_ptr<PostedRequests> posted_requests_ =
+      std::make_shared<PostedRequests>();
+
+  LatencyStatistics queue_latency_;
+  LatencyStatistics handle_latency_;
 };
 
 template <typename Request, typename Response>
@@ -128,13 +172,42 @@ void Service<Request, Response>::destroy() {
     this->tasks_.clear();
   }
   condition_.notify_all();
-  if (thread_.joinable()) {
-    thread_.join();
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
   }
+  threads_.clear();
+  // Only wait for the requests being handled, the task pool may already be
+  // stopped and never run the queued ones.
+  std::unique_lock<std::mutex> ul(posted_requests_->mutex);
+  posted_requests_->stopped = true;
+  posted_requests_->condition.wait(
+      ul, [this]() { return posted_requests_->running == 0; });
 }
 
 template <typename Request, typename Response>
 inline void Service<Request, Response>::Enqueue(std::function<void()>&& task) {
+  if (concurrency_ == 0) {
+    auto posted = posted_requests_;
+    auto wrapper = [posted, task]() {
+      {
+        std::lock_guard<std::mutex> lg(posted->mutex);
+        if (posted->stopped) {
+          return;
+        }
+        ++posted->running;
+      }
+      task();
+      std::lock_guard<std::mutex> lg(posted->mutex);
+      --posted->running;
+      posted->condition.notify_all();
+    };
+    if (!TaskManager::Instance()->Post(std::move(wrapper))) {
+      AWARN << "task pool is full, drop request of " << service_name_;
+    }
+    return;
+  }
   std::lock_guard<std::mutex> lg(queue_mutex_);
   tasks_.emplace_back(std::move(task));
   condition_.notify_one();
@@ -190,14 +263,17 @@ bool Service<Request, Response>::Init() {
           const transport::MessageInfo& message_info,
           const proto::RoleAttributes& reader_attr) {
         (void)reader_attr;
-        auto task = [this, request, message_info]() {
-          this->HandleRequest(request, message_info);
+        auto receive_time = Clock::now();
+        auto task = [this, request, message_info, receive_time]() {
+          this->HandleReceivedRequest(request, message_info, receive_time);
         };
         Enqueue(std::move(task));
       },
       proto::OptionalMode::RTPS);
   inited_ = true;
-  thread_ = std::thread(&Service<Request, Response>::Process, this);
+  for (uint32_t i = 0; i < concurrency_; ++i) {
+    threads_.emplace_back(&Service<Request, Response>::Process, this);
+  }
   if (request_receiver_ == nullptr) {
     AERROR << " Create request sub failed." << request_channel_;
     response_transmitter_.reset();
@@ -210,17 +286,27 @@ template <typename Request, typename Response>
 void Service<Request, Response>::HandleRequest(
     const std::shared_ptr<Request>& request,
     const transport::MessageInfo& message_info) {
+  HandleReceivedRequest(request, message_info, Clock::now());
+}
+
+template <typename Request, typename Response>
+void Service<Request, Response>::HandleReceivedRequest(
+    const std::shared_ptr<Request>& request,
+    const transport::MessageInfo& message_info,
+    const Clock::time_point& receive_time) {
   if (!IsInit()) {
     // LOG_DEBUG << "not inited error.";
     return;
   }
   ADEBUG << "handling request:" << request_channel_;
-  std::lock_guard<std::mutex> lk(service_handle_request_mutex_);
+  auto start_time = Clock::now();
+  queue_latency_.Add(start_time - receive_time);
   auto response = std::make_shared<Response>();
   service_callback_(request, response);
   transport::MessageInfo msg_info(message_info);
   msg_info.set_sender_id(response_transmitter_->id());
   SendResponse(msg_info, response);
+  handle_latency_.Add(Clock::now() - start_time);
 }
 
 template <typename Request, typename Response>
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/task/task_group.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/task/task_manager.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::common::GlobalData;
+
+namespace {
+
+// Chunks per worker when no grain is given, a few of them balance the load
+// between workers of different speed.
+constexpr size_t kChunksPerWorker = 4;
+
+struct ParallelForState {
+  std::atomic<size_t> next = {0};
+  std::atomic<size_t> done = {0};
+  size_t begin = 0;
+  size_t count = 0;
+  size_t grain = 1;
+  // Only called while chunks are left, when the caller still waits.
+  const std::function<void(size_t, size_t)>* body = nullptr;
+};
+
+void RunChunks(ParallelForState* state) {
+  size_t offset = 0;
+  while ((offset = state->next.fetch_add(state->grain)) < state->count) {
+    const size_t size = std::min(state->grain, state->count - offset);
+    (*state->body)(state->begin + offset, state->begin + offset + size);
+    state->done.fetch_add(size, std::memory_order_release);
+  }
+}
+
+void WaitYield() {
+  if (croutine::CRoutine::GetCurrentRoutine()) {
+    croutine::CRoutine::Yield();
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+uint32_t WorkerNum() {
+  return GlobalData::Instance()->IsRealityMode()
+             ? TaskManager::Instance()->ThreadNum()
+             : 0;
+}
+
+}  // namespace
+
+TaskGroup::TaskGroup()
+    : state_(std::make_shared<State>()), parallel_(WorkerNum() > 0) {}
+
+TaskGroup::~TaskGroup() { Wait(); }
+
+void TaskGroup::Run(std::function<void()>&& func) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tasks.push_back(std::move(func));
+  }
+  state_->pending.fetch_add(1);
+  if (parallel_) {
+    auto state = state_;
+    // Left to Wait() if the task pool is full.
+    TaskManager::Instance()->Post([state]() { RunOne(state.get()); });
+  }
+}
+
+void TaskGroup::Wait() {
+  while (RunOne(state_.get())) {
+  }
+  while (state_->pending.load(std::memory_order_acquire) > 0) {
+    WaitYield();
+  }
+}
+
+bool TaskGroup::RunOne(State* state) {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->tasks.empty()) {
+      return false;
+    }
+    task = std::move(state->tasks.front());
+    state->tasks.pop_front();
+  }
+  task();
+  state->pending.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+void ParallelForRange(size_t begin, size_t end, size_t grain,
+                      const std::function<void(size_t, size_t)>& body) {
+  if (end <= begin) {
+    return;
+  }
+  const size_t count = end - begin;
+  const uint32_t workers = WorkerNum();
+  if (grain == 0) {
+    grain = std::max<size_t>(count / (kChunksPerWorker * (workers + 1)), 1);
+  }
+  const size_t chunks = (count + grain - 1) / grain;
+  if (workers == 0 || chunks == 1) {
+    body(begin, end);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  state->begin = begin;
+  state->count = count;
+  state->grain = grain;
+  state->body = &body;
+  // The caller takes chunks too, so one helper less than chunks is enough.
+  const size_t helpers = std::min<size_t>(workers, chunks - 1);
+  for (size_t i = 0; i < helpers; ++i) {
+    if (!TaskManager::Instance()->Post([state]() { RunChunks(state.get()); })) {
+      break;
+    }
+  }
+  RunChunks(state.get());
+  while (state->done.load(std::memory_order_acquire) < count) {
+    WaitYield();
+  }
+}
+
+}  // namespace cyber
+}  // namespace apollo
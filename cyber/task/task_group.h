@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TASK_TASK_GROUP_H_
+#define CYBER_TASK_TASK_GROUP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @class TaskGroup
+ * @brief Runs a set of tasks on the task pool and waits for all of them.
+ *
+ * Each Run() wakes at most one idle task pool routine. Wait() runs the tasks
+ * no routine has taken yet on the calling thread or routine, so a group
+ * waited for from a task pool routine cannot dead lock the pool. Outside of
+ * reality mode the tasks all run in Wait().
+ */
+class TaskGroup {
+ public:
+  TaskGroup();
+  ~TaskGroup();
+
+  template <typename F>
+  void Run(F&& func) {
+    Run(std::function<void()>(std::forward<F>(func)));
+  }
+  void Run(std::function<void()>&& func);
+
+  // Returns once every task of the group has run.
+  void Wait();
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    // Tasks added and not finished yet.
+    std::atomic<size_t> pending = {0};
+  };
+
+  static bool RunOne(State* state);
+
+  std::shared_ptr<State> state_;
+  bool parallel_ = false;
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+};
+
+/**
+ * @brief Calls body(begin, end) on chunks of [begin, end) in parallel and
+ * returns once all of them are done.
+ *
+ * Chunks are taken by the caller and by at most one task per task pool
+ * routine from a shared counter, so faster workers take more of them.
+ * @param grain Chunk size, 0 for about four chunks per worker.
+ */
+void ParallelForRange(size_t begin, size_t end, size_t grain,
+                      const std::function<void(size_t, size_t)>& body);
+
+/**
+ * @brief Calls func(i) for every i of [begin, end) in parallel.
+ */
+template <typename F>
+void ParallelFor(size_t begin, size_t end, F&& func, size_t grain = 0) {
+  ParallelForRange(begin, end, grain,
+                   [&func](size_t chunk_begin, size_t chunk_end) {
+                     for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                       func(i);
+                     }
+                   });
+}
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TASK_TASK_GROUP_H_
@@ -34,24 +34,47 @@ TaskManager::TaskManager()
     AERROR << "Task queue init failed";
     throw std::runtime_error("Task queue init failed");
   }
+  num_threads_ = scheduler::Instance()->TaskPoolSize();
+  tasks_.reserve(num_threads_);
+  idle_.reset(new std::atomic<bool>[num_threads_]);
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    tasks_.push_back(
+        common::GlobalData::RegisterTaskName(task_prefix + std::to_string(i)));
+    idle_[i].store(false);
+  }
+
   auto func = [this]() {
+    auto routine = croutine::CRoutine::GetCurrentRoutine();
+    uint32_t index = 0;
+    while (index < num_threads_ && tasks_[index] != routine->id()) {
+      ++index;
+    }
     while (!stop_) {
       std::function<void()> task;
-      if (!task_queue_->Dequeue(&task)) {
-        auto routine = croutine::CRoutine::GetCurrentRoutine();
-        routine->HangUp();
+      if (task_queue_->Dequeue(&task)) {
+        task();
+        continue;
+      }
+      if (index == num_threads_) {
+        // Not a task pool routine, it is never notified.
+        croutine::CRoutine::Yield();
+        continue;
+      }
+      // Post either sees the routine idle or its task is dequeued here.
+      idle_[index].store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (task_queue_->Dequeue(&task)) {
+        idle_[index].store(false);
+        task();
         continue;
       }
-      task();
+      routine->HangUp();
     }
   };
 
-  num_threads_ = scheduler::Instance()->TaskPoolSize();
   auto factory = croutine::CreateRoutineFactory(std::move(func));
-  tasks_.reserve(num_threads_);
   for (uint32_t i = 0; i < num_threads_; i++) {
     auto task_name = task_prefix + std::to_string(i);
-    tasks_.push_back(common::GlobalData::RegisterTaskName(task_name));
     if (!scheduler::Instance()->CreateTask(factory, task_name)) {
       AERROR << "CreateTask failed:" << task_name;
     }
@@ -69,5 +92,29 @@ void TaskManager::Shutdown() {
   }
 }
 
+bool TaskManager::Post(std::function<void()>&& task) {
+  if (stop_.load() || !task_queue_->Enqueue(std::move(task))) {
+    return false;
+  }
+  NotifyIdleTask();
+  return true;
+}
+
+void TaskManager::NotifyIdleTask() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // Start from a different routine every time to spread the tasks.
+  const uint32_t start = next_notified_.fetch_add(1, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    const uint32_t index = (start + i) % num_threads_;
+    bool idle = true;
+    if (idle_[index].load(std::memory_order_relaxed) &&
+        idle_[index].compare_exchange_strong(idle, false)) {
+      scheduler::Instance()->NotifyTask(tasks_[index]);
+      return;
+    }
+  }
+  // All routines are busy, they take the task once done with theirs.
+}
+
 }  // namespace cyber
 }  // namespace apollo
@@ -18,6 +18,7 @@
 #define CYBER_TASK_TASK_MANAGER_H_
 
 #include <atomic>
+#include <functional>
 #include <future>
 #include <memory>
 #include <string>
@@ -44,20 +45,28 @@ class TaskManager {
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         std::bind(std::forward<F>(func), std::forward<Args>(args)...));
     if (!stop_.load()) {
-      task_queue_->Enqueue([task]() { (*task)(); });
-      for (auto& task : tasks_) {
-        scheduler::Instance()->NotifyTask(task);
-      }
+      Post([task]() { (*task)(); });
     }
     std::future<return_type> res(task->get_future());
     return res;
   }
 
+  // Runs the task on the task pool without a future, waking at most one
+  // idle routine for it. Returns false if the task was not queued.
+  bool Post(std::function<void()>&& task);
+
+  uint32_t ThreadNum() const { return num_threads_; }
+
  private:
+  void NotifyIdleTask();
+
   uint32_t num_threads_ = 0;
   uint32_t task_queue_size_ = 1000;
   std::atomic<bool> stop_ = {false};
   std::vector<uint64_t> tasks_;
+  // Whether the routine of tasks_ at the same index waits for a task.
+  std::unique_ptr<std::atomic<bool>[]> idle_;
+  std::atomic<uint32_t> next_notified_ = {0};
   std::shared_ptr<base::BoundedQueue<std::function<void()>>> task_queue_;
   DECLARE_SINGLETON(TaskManager);
 };
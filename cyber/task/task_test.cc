@@ -16,6 +16,7 @@
 
 #include "cyber/task/task.h"
 
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -98,6 +99,67 @@ TEST(AsyncTest, run_member_function) {
   foo.RunOnce();
 }
 
+TEST(ParallelForTest, visit_once) {
+  for (size_t grain : {0, 1, 7, 1000}) {
+    std::vector<std::atomic<int>> visits(1000);
+    ParallelFor(
+        0, visits.size(), [&visits](size_t i) { visits[i].fetch_add(1); },
+        grain);
+    for (auto& visit : visits) {
+      EXPECT_EQ(1, visit.load());
+    }
+  }
+
+  int count = 0;
+  ParallelFor(5, 5, [&count](size_t) { ++count; });
+  EXPECT_EQ(0, count);
+}
+
+TEST(ParallelForTest, range) {
+  std::vector<uint64_t> sums(8, 0);
+  std::atomic<size_t> chunks = {0};
+  ParallelForRange(10, 1010, 125, [&](size_t begin, size_t end) {
+    EXPECT_EQ(0, (begin - 10) % 125);
+    for (size_t i = begin; i < end; ++i) {
+      sums[(begin - 10) / 125] += i;
+    }
+    chunks.fetch_add(1);
+  });
+  EXPECT_EQ(8, chunks.load());
+  uint64_t sum = 0;
+  for (auto value : sums) {
+    sum += value;
+  }
+  EXPECT_EQ((10 + 1009) * 1000 / 2, sum);
+}
+
+TEST(ParallelForTest, nested) {
+  std::atomic<int> count = {0};
+  ParallelFor(0, 16, [&count](size_t) {
+    ParallelFor(0, 16, [&count](size_t) { count.fetch_add(1); });
+  });
+  EXPECT_EQ(256, count.load());
+}
+
+TEST(TaskGroupTest, wait) {
+  std::atomic<int> count = {0};
+  {
+    TaskGroup group;
+    for (int i = 0; i < 100; i++) {
+      group.Run([&count]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        count.fetch_add(1);
+      });
+    }
+    group.Wait();
+    EXPECT_EQ(100, count.load());
+
+    group.Run([&count]() { count.fetch_add(1); });
+  }
+  // The destructor waits as well.
+  EXPECT_EQ(101, count.load());
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -54,6 +54,7 @@ void ShmDispatcher::AddSegment(const RoleAttributes& self_attr) {
   auto segment = SegmentFactory::CreateSegment(channel_id);
   segments_[channel_id] = segment;
   previous_indexes_[channel_id] = UINT32_MAX;
+  notifier_->Subscribe(channel_id);
 }
 
 void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
@@ -75,6 +76,7 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
 
   if (msg_info.DeserializeFrom(msg_info_addr, rb->block->msg_info_size())) {
     OnMessage(channel_id, rb, msg_info);
+    parsed_messages_.clear();
   } else {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
@@ -146,6 +148,11 @@ void ShmDispatcher::ThreadFunc() {
 
 bool ShmDispatcher::Init() {
   host_id_ = common::Hash(GlobalData::Instance()->HostIp());
+  auto& g_conf = GlobalData::Instance()->Config();
+  if (g_conf.has_transport_conf() && g_conf.transport_conf().has_shm_conf()) {
+    arena_allocation_ =
+        g_conf.transport_conf().shm_conf().arena_allocation();
+  }
   notifier_ = NotifierFactory::CreateNotifier();
   thread_ = std::thread(&ShmDispatcher::ThreadFunc, this);
   scheduler::Instance()->SetInnerThreadAttr("shm_disp", &thread_);
@@ -17,11 +17,18 @@
 #ifndef CYBER_TRANSPORT_DISPATCHER_SHM_DISPATCHER_H_
 #define CYBER_TRANSPORT_DISPATCHER_SHM_DISPATCHER_H_
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <thread>
+#include <type_traits>
+#include <typeindex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/arena.h"
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/global_data.h"
@@ -68,12 +75,37 @@ class ShmDispatcher : public Dispatcher {
   void ThreadFunc();
   bool Init();
 
+  // Parses the block being dispatched once per message type, every reader of
+  // that type in the process gets the same message. Returns nullptr if the
+  // block cannot be parsed.
+  template <typename MessageT>
+  std::shared_ptr<MessageT> ParsedMessage(
+      const std::shared_ptr<ReadableBlock>& rb);
+
+  template <typename MessageT>
+  static typename std::enable_if<
+      google::protobuf::Arena::is_arena_constructable<MessageT>::value,
+      std::shared_ptr<MessageT>>::type
+  NewArenaMessage(size_t msg_size);
+
+  template <typename MessageT>
+  static typename std::enable_if<
+      !google::protobuf::Arena::is_arena_constructable<MessageT>::value,
+      std::shared_ptr<MessageT>>::type
+  NewArenaMessage(size_t msg_size);
+
   uint64_t host_id_;
   SegmentContainer segments_;
   std::unordered_map<uint64_t, uint32_t> previous_indexes_;
   AtomicRWLock segments_lock_;
   std::thread thread_;
   NotifierPtr notifier_;
+  bool arena_allocation_ = false;
+
+  // Messages parsed from the block being dispatched, cleared once all its
+  // readers have run. Only touched by the dispatcher thread.
+  std::vector<std::pair<std::type_index, std::shared_ptr<void>>>
+      parsed_messages_;
 
   DECLARE_SINGLETON(ShmDispatcher)
 };
@@ -81,12 +113,11 @@ class ShmDispatcher : public Dispatcher {
 template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const MessageListener<MessageT>& listener) {
-  // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+  auto listener_adapter = [this, listener](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto msg = ParsedMessage<MessageT>(rb);
+    RETURN_IF(msg == nullptr);
     listener(msg, msg_info);
   };
 
@@ -98,12 +129,11 @@ template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const RoleAttributes& opposite_attr,
                                 const MessageListener<MessageT>& listener) {
-  // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+  auto listener_adapter = [this, listener](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto msg = ParsedMessage<MessageT>(rb);
+    RETURN_IF(msg == nullptr);
     listener(msg, msg_info);
   };
 
@@ -112,6 +142,52 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   AddSegment(self_attr);
 }
 
+template <typename MessageT>
+std::shared_ptr<MessageT> ShmDispatcher::ParsedMessage(
+    const std::shared_ptr<ReadableBlock>& rb) {
+  const std::type_index type(typeid(MessageT));
+  for (const auto& parsed : parsed_messages_) {
+    if (parsed.first == type) {
+      return std::static_pointer_cast<MessageT>(parsed.second);
+    }
+  }
+
+  const size_t msg_size = rb->block->msg_size();
+  auto msg = arena_allocation_ ? NewArenaMessage<MessageT>(msg_size)
+                               : std::make_shared<MessageT>();
+  if (!message::ParseFromArray(rb->buf, static_cast<int>(msg_size),
+                               msg.get())) {
+    msg.reset();
+  }
+  parsed_messages_.emplace_back(type, msg);
+  return msg;
+}
+
+template <typename MessageT>
+typename std::enable_if<
+    google::protobuf::Arena::is_arena_constructable<MessageT>::value,
+    std::shared_ptr<MessageT>>::type
+ShmDispatcher::NewArenaMessage(size_t msg_size) {
+  // The decoded message takes a few times its wire size.
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = std::max<size_t>(2 * msg_size, 1024);
+  options.max_block_size =
+      std::max(options.max_block_size, options.start_block_size);
+  auto arena = std::make_shared<google::protobuf::Arena>(options);
+  // The message shares the ownership of its arena.
+  return std::shared_ptr<MessageT>(
+      arena, google::protobuf::Arena::CreateMessage<MessageT>(arena.get()));
+}
+
+template <typename MessageT>
+typename std::enable_if<
+    !google::protobuf::Arena::is_arena_constructable<MessageT>::value,
+    std::shared_ptr<MessageT>>::type
+ShmDispatcher::NewArenaMessage(size_t msg_size) {
+  (void)msg_size;
+  return std::make_shared<MessageT>();
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
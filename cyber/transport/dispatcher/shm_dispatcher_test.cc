@@ -95,6 +95,59 @@ TEST(ShmDispatcherTest, on_message) {
   EXPECT_EQ(recv_msg->message, send_msg->message);
 }
 
+TEST(ShmDispatcherTest, parse_once) {
+  auto dispatcher = ShmDispatcher::Instance();
+
+  RoleAttributes oppo_attr;
+  oppo_attr.set_host_name(common::GlobalData::Instance()->HostName());
+  oppo_attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  oppo_attr.set_channel_name("parse_once");
+  oppo_attr.set_channel_id(common::Hash("parse_once"));
+  Identity oppo_id;
+  oppo_attr.set_id(oppo_id.HashValue());
+
+  auto transmitter = Transport::Instance()->CreateTransmitter<proto::Chatter>(
+      oppo_attr, proto::OptionalMode::SHM);
+  EXPECT_NE(transmitter, nullptr);
+
+  RoleAttributes self_attr;
+  self_attr.set_channel_name("parse_once");
+  self_attr.set_channel_id(common::Hash("parse_once"));
+
+  std::shared_ptr<proto::Chatter> first;
+  std::shared_ptr<proto::Chatter> second;
+  std::shared_ptr<message::RawMessage> raw;
+  Identity first_id;
+  self_attr.set_id(first_id.HashValue());
+  dispatcher->AddListener<proto::Chatter>(
+      self_attr, [&first](const std::shared_ptr<proto::Chatter>& msg,
+                          const MessageInfo&) { first = msg; });
+  Identity second_id;
+  self_attr.set_id(second_id.HashValue());
+  dispatcher->AddListener<proto::Chatter>(
+      self_attr, [&second](const std::shared_ptr<proto::Chatter>& msg,
+                           const MessageInfo&) { second = msg; });
+  Identity raw_id;
+  self_attr.set_id(raw_id.HashValue());
+  dispatcher->AddListener<message::RawMessage>(
+      self_attr, [&raw](const std::shared_ptr<message::RawMessage>& msg,
+                        const MessageInfo&) { raw = msg; });
+
+  auto send_msg = std::make_shared<proto::Chatter>();
+  send_msg->set_seq(7);
+  send_msg->set_content("parse_once");
+  transmitter->Transmit(send_msg);
+
+  sleep(1);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(raw, nullptr);
+  // Readers of the same type share one message.
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(7, first->seq());
+  EXPECT_EQ("parse_once", first->content());
+  EXPECT_EQ(send_msg->SerializeAsString(), raw->message);
+}
+
 TEST(ShmDispatcherTest, shutdown) {
   auto dispatcher = ShmDispatcher::Instance();
   dispatcher->Shutdown();
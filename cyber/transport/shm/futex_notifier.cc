@@ -0,0 +1,399 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using common::Hash;
+
+namespace {
+
+constexpr uint64_t kWritingSeq = UINT64_MAX;
+
+uint32_t BucketOf(uint64_t channel_id) {
+  return static_cast<uint32_t>(channel_id % kFutexChannelBucketNum);
+}
+
+// The words live in shared memory, so the futexes must not be private.
+void FutexWait(std::atomic<uint32_t>* word, uint32_t value, int timeout_us) {
+  struct timespec timeout;
+  timeout.tv_sec = timeout_us / 1000000;
+  timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, value,
+          &timeout, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+bool IsAlive(int32_t pid) {
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace
+
+FutexNotifier::FutexNotifier() {
+  key_ = static_cast<key_t>(
+      Hash("/apollo/cyber/transport/shm/futex_notifier"));
+  ADEBUG << "futex notifier key: " << key_;
+  shm_size_ = sizeof(Indicator);
+
+  if (!Init()) {
+    AERROR << "fail to init futex notifier.";
+    is_shutdown_.store(true);
+    return;
+  }
+}
+
+FutexNotifier::~FutexNotifier() { Shutdown(); }
+
+void FutexNotifier::Shutdown() {
+  if (is_shutdown_.exchange(true)) {
+    return;
+  }
+
+  ReleaseSubscriber();
+  subscribed_word_.fetch_add(1);
+  FutexWake(&subscribed_word_);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  Reset();
+}
+
+bool FutexNotifier::Notify(const ReadableInfo& info) {
+  if (is_shutdown_.load()) {
+    ADEBUG << "notifier is shutdown.";
+    return false;
+  }
+
+  const uint32_t bucket = BucketOf(info.channel_id());
+  const uint64_t mask = uint64_t{1} << (bucket % 64);
+  for (auto& subscriber : indicator_->subscribers) {
+    if (subscriber.pid.load(std::memory_order_acquire) == 0 ||
+        (subscriber.buckets[bucket / 64].load(std::memory_order_acquire) &
+         mask) == 0) {
+      continue;
+    }
+
+    uint64_t seq = subscriber.next_seq.fetch_add(1);
+    Slot& slot = subscriber.slots[seq % kFutexBufLength];
+    slot.seq.store(kWritingSeq, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.host_id.store(info.host_id(), std::memory_order_relaxed);
+    slot.channel_id.store(info.channel_id(), std::memory_order_relaxed);
+    slot.block_index.store(info.block_index(), std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_release);
+
+    // Pairs with the sleeping flag set by Listen before its last check, so
+    // either the listener sees the slot or we see it sleeping.
+    subscriber.wake_word.fetch_add(1);
+    if (subscriber.sleeping.load() != 0) {
+      FutexWake(&subscriber.wake_word);
+    }
+  }
+  return true;
+}
+
+bool FutexNotifier::Listen(int timeout_ms, ReadableInfo* info) {
+  if (info == nullptr) {
+    AERROR << "info nullptr.";
+    return false;
+  }
+
+  if (is_shutdown_.load()) {
+    ADEBUG << "notifier is shutdown.";
+    return false;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (!is_shutdown_.load()) {
+    Subscriber* subscriber = subscriber_.load(std::memory_order_acquire);
+    if (subscriber != nullptr && TryRead(subscriber, info)) {
+      return true;
+    }
+
+    auto timeout_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          deadline - std::chrono::steady_clock::now())
+                          .count();
+    if (timeout_us <= 0) {
+      return false;
+    }
+
+    if (subscriber == nullptr) {
+      // Nothing to listen to yet, wait for the first subscription.
+      uint32_t word = subscribed_word_.load();
+      if (subscriber_.load() == nullptr && !is_shutdown_.load()) {
+        FutexWait(&subscribed_word_, word, static_cast<int>(timeout_us));
+      }
+      continue;
+    }
+
+    uint32_t word = subscriber->wake_word.load();
+    subscriber->sleeping.store(1);
+    if (!Readable(subscriber) && !is_shutdown_.load()) {
+      FutexWait(&subscriber->wake_word, word, static_cast<int>(timeout_us));
+    }
+    subscriber->sleeping.store(0);
+  }
+  return false;
+}
+
+void FutexNotifier::Subscribe(uint64_t channel_id) {
+  if (is_shutdown_.load()) {
+    return;
+  }
+
+  Subscriber* subscriber = AcquireSubscriber();
+  if (subscriber == nullptr) {
+    return;
+  }
+  const uint32_t bucket = BucketOf(channel_id);
+  subscriber->buckets[bucket / 64].fetch_or(uint64_t{1} << (bucket % 64));
+}
+
+bool FutexNotifier::TryRead(Subscriber* subscriber, ReadableInfo* info) {
+  while (true) {
+    uint64_t head = subscriber->next_seq.load(std::memory_order_acquire);
+    if (head == next_seq_) {
+      return false;
+    }
+    if (head - next_seq_ > kFutexBufLength) {
+      AWARN << "futex notifier lost " << head - next_seq_ - kFutexBufLength
+            << " readable infos.";
+      next_seq_ = head - kFutexBufLength;
+    }
+
+    Slot& slot = subscriber->slots[next_seq_ % kFutexBufLength];
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq == kWritingSeq || seq < next_seq_ + 1) {
+      ADEBUG << "seq[" << next_seq_ << "] is writing, can not read now.";
+      return false;
+    }
+    if (seq > next_seq_ + 1) {
+      // Overwritten by a writer that lapped us.
+      ++next_seq_;
+      continue;
+    }
+
+    uint64_t host_id = slot.host_id.load(std::memory_order_relaxed);
+    uint64_t channel_id = slot.channel_id.load(std::memory_order_relaxed);
+    uint32_t block_index = slot.block_index.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    ++next_seq_;
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+    info->set_host_id(host_id);
+    info->set_channel_id(channel_id);
+    info->set_block_index(block_index);
+    return true;
+  }
+}
+
+bool FutexNotifier::Readable(Subscriber* subscriber) {
+  uint64_t head = subscriber->next_seq.load();
+  if (head == next_seq_) {
+    return false;
+  }
+  if (head - next_seq_ > kFutexBufLength) {
+    return true;
+  }
+  uint64_t seq = subscriber->slots[next_seq_ % kFutexBufLength].seq.load();
+  return seq != kWritingSeq && seq >= next_seq_ + 1;
+}
+
+FutexNotifier::Subscriber* FutexNotifier::AcquireSubscriber() {
+  Subscriber* subscriber = subscriber_.load(std::memory_order_acquire);
+  if (subscriber != nullptr) {
+    return subscriber;
+  }
+
+  std::lock_guard<std::mutex> lock(subscribe_mutex_);
+  subscriber = subscriber_.load();
+  if (subscriber != nullptr) {
+    return subscriber;
+  }
+
+  const int32_t pid = static_cast<int32_t>(getpid());
+  for (auto& candidate : indicator_->subscribers) {
+    int32_t owner = candidate.pid.load();
+    // Slots of processes that died without shutting down are taken over.
+    while (owner == 0 || !IsAlive(owner)) {
+      if (candidate.pid.compare_exchange_weak(owner, pid)) {
+        subscriber = &candidate;
+        break;
+      }
+    }
+    if (subscriber != nullptr) {
+      break;
+    }
+  }
+  if (subscriber == nullptr) {
+    AERROR << "futex notifier has no free subscriber, at most "
+           << kFutexSubscriberNum << " processes can listen.";
+    return nullptr;
+  }
+
+  for (auto& bucket : subscriber->buckets) {
+    bucket.store(0);
+  }
+  next_seq_ = subscriber->next_seq.load();
+  subscriber_.store(subscriber, std::memory_order_release);
+  subscribed_word_.fetch_add(1);
+  FutexWake(&subscribed_word_);
+  return subscriber;
+}
+
+void FutexNotifier::ReleaseSubscriber() {
+  std::lock_guard<std::mutex> lock(subscribe_mutex_);
+  Subscriber* subscriber = subscriber_.load();
+  if (subscriber == nullptr) {
+    return;
+  }
+  for (auto& bucket : subscriber->buckets) {
+    bucket.store(0);
+  }
+  subscriber->wake_word.fetch_add(1);
+  FutexWake(&subscriber->wake_word);
+  subscriber->pid.store(0);
+}
+
+bool FutexNotifier::Init() { return OpenOrCreate(); }
+
+bool FutexNotifier::OpenOrCreate() {
+  // create managed_shm_
+  int retry = 0;
+  int shmid = 0;
+  while (retry < 2) {
+    shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    if (shmid != -1) {
+      break;
+    }
+
+    if (EINVAL == errno) {
+      AINFO << "need larger space, recreate.";
+      Reset();
+      Remove();
+      ++retry;
+    } else if (EEXIST == errno) {
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    } else {
+      break;
+    }
+  }
+
+  if (shmid == -1) {
+    AERROR << "create shm failed, error code: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed.";
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // create indicator_, shmget has zeroed the memory already, which is the
+  // state the constructor leaves it in, so processes opening it meanwhile
+  // see a valid indicator.
+  indicator_ = new (managed_shm_) Indicator();
+  if (indicator_ == nullptr) {
+    AERROR << "create indicator failed.";
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  ADEBUG << "open or create true.";
+  return true;
+}
+
+bool FutexNotifier::OpenOnly() {
+  // get managed_shm_
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  // get indicator_
+  indicator_ = reinterpret_cast<Indicator*>(managed_shm_);
+  if (indicator_ == nullptr) {
+    AERROR << "get indicator failed.";
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  ADEBUG << "open true.";
+  return true;
+}
+
+bool FutexNotifier::Remove() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1 || shmctl(shmid, IPC_RMID, 0) == -1) {
+    AERROR << "remove shm failed, error code: " << strerror(errno);
+    return false;
+  }
+  ADEBUG << "remove success.";
+
+  return true;
+}
+
+void FutexNotifier::Reset() {
+  subscriber_.store(nullptr);
+  indicator_ = nullptr;
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+#define CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "cyber/common/macros.h"
+#include "cyber/transport/shm/notifier_base.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+const uint32_t kFutexSubscriberNum = 64;
+const uint32_t kFutexBufLength = 1024;
+const uint32_t kFutexChannelBucketNum = 1024;
+
+/**
+ * @class FutexNotifier
+ * @brief Notifier that lets every listening process block on a futex of its
+ * own in the shared indicator.
+ *
+ * A process takes a subscriber slot when its first channel is subscribed.
+ * The slot holds the channel buckets it listens to, a ring of readable infos
+ * and the futex word it sleeps on. Notify only writes to, and wakes, the
+ * subscribers listening to the bucket of the channel, so an idle process
+ * does not wake up and a busy one is woken without polling.
+ */
+class FutexNotifier : public NotifierBase {
+  struct Slot {
+    // Position in the ring plus one once written, kWritingSeq while written.
+    std::atomic<uint64_t> seq = {0};
+    std::atomic<uint64_t> host_id = {0};
+    std::atomic<uint64_t> channel_id = {0};
+    std::atomic<uint32_t> block_index = {0};
+  };
+
+  struct alignas(64) Subscriber {
+    std::atomic<int32_t> pid = {0};
+    std::atomic<uint32_t> wake_word = {0};
+    std::atomic<uint32_t> sleeping = {0};
+    std::atomic<uint64_t> buckets[kFutexChannelBucketNum / 64] = {};
+    alignas(64) std::atomic<uint64_t> next_seq = {0};
+    Slot slots[kFutexBufLength];
+  };
+
+  struct Indicator {
+    Subscriber subscribers[kFutexSubscriberNum];
+  };
+
+ public:
+  virtual ~FutexNotifier();
+
+  void Shutdown() override;
+  bool Notify(const ReadableInfo& info) override;
+  bool Listen(int timeout_ms, ReadableInfo* info) override;
+  void Subscribe(uint64_t channel_id) override;
+
+  static const char* Type() { return "futex"; }
+
+ private:
+  bool Init();
+  bool OpenOrCreate();
+  bool OpenOnly();
+  bool Remove();
+  void Reset();
+
+  Subscriber* AcquireSubscriber();
+  void ReleaseSubscriber();
+  bool TryRead(Subscriber* subscriber, ReadableInfo* info);
+  bool Readable(Subscriber* subscriber);
+
+  key_t key_ = 0;
+  void* managed_shm_ = nullptr;
+  size_t shm_size_ = 0;
+  Indicator* indicator_ = nullptr;
+
+  // Set once the first channel is subscribed, only released on shutdown.
+  std::mutex subscribe_mutex_;
+  std::atomic<Subscriber*> subscriber_ = {nullptr};
+  // Wakes a Listen that started before the first subscription.
+  std::atomic<uint32_t> subscribed_word_ = {0};
+  uint64_t next_seq_ = 0;
+  std::atomic<bool> is_shutdown_ = {false};
+
+  DECLARE_SINGLETON(FutexNotifier)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
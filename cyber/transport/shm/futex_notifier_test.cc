@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+const uint64_t kChannelId = 1001;
+const uint64_t kOtherChannelId = 1002;
+
+TEST(FutexNotifierTest, constructor) {
+  auto notifier = FutexNotifier::Instance();
+  EXPECT_NE(notifier, nullptr);
+}
+
+TEST(FutexNotifierTest, notify_listen) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(kChannelId);
+  ReadableInfo readable_info(1, 2, kChannelId);
+  ReadableInfo received;
+  while (notifier->Listen(100, &received)) {
+  }
+  EXPECT_FALSE(notifier->Listen(100, &received));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Listen(100, &received));
+  EXPECT_EQ(1, received.host_id());
+  EXPECT_EQ(2, received.block_index());
+  EXPECT_EQ(kChannelId, received.channel_id());
+  EXPECT_FALSE(notifier->Listen(100, &received));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Listen(100, &received));
+  EXPECT_TRUE(notifier->Listen(100, &received));
+  EXPECT_FALSE(notifier->Listen(100, &received));
+}
+
+TEST(FutexNotifierTest, other_channel) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(kChannelId);
+  ReadableInfo received;
+  while (notifier->Listen(10, &received)) {
+  }
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(1, 2, kOtherChannelId)));
+  EXPECT_FALSE(notifier->Listen(100, &received));
+}
+
+TEST(FutexNotifierTest, overflow) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(kChannelId);
+  ReadableInfo received;
+  while (notifier->Listen(10, &received)) {
+  }
+  for (uint32_t i = 0; i < kFutexBufLength + 10; ++i) {
+    EXPECT_TRUE(notifier->Notify(ReadableInfo(1, i, kChannelId)));
+  }
+  // The oldest infos are overwritten.
+  EXPECT_TRUE(notifier->Listen(100, &received));
+  EXPECT_EQ(10, received.block_index());
+  uint32_t count = 1;
+  while (notifier->Listen(10, &received)) {
+    ++count;
+  }
+  EXPECT_EQ(kFutexBufLength, count);
+  EXPECT_EQ(kFutexBufLength + 9, received.block_index());
+}
+
+TEST(FutexNotifierTest, wakeup) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Subscribe(kChannelId);
+  ReadableInfo received;
+  while (notifier->Listen(10, &received)) {
+  }
+  const uint32_t kCount = 1000;
+  std::thread listener([&]() {
+    ReadableInfo info;
+    for (uint32_t i = 0; i < kCount; ++i) {
+      ASSERT_TRUE(notifier->Listen(1000, &info));
+      EXPECT_EQ(i, info.block_index());
+    }
+  });
+  for (uint32_t i = 0; i < kCount; ++i) {
+    EXPECT_TRUE(notifier->Notify(ReadableInfo(1, i, kChannelId)));
+    if (i % 10 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  listener.join();
+}
+
+TEST(FutexNotifierTest, shutdown) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Shutdown();
+  ReadableInfo readable_info;
+  EXPECT_FALSE(notifier->Notify(readable_info));
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Measures the wakeup latency and the idle cpu time of the shm notifiers.
+// Every notifier is run in a process of its own, a listener thread receives
+// the notifications that the main thread sends at a fixed interval.
+//
+//   notifier_benchmark --notifier_types=condition,multicast,futex
+
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/transport/shm/condition_notifier.h"
+#include "cyber/transport/shm/futex_notifier.h"
+#include "cyber/transport/shm/multicast_notifier.h"
+
+DEFINE_string(notifier_types, "condition,multicast,futex",
+              "Comma separated notifiers to benchmark.");
+DEFINE_int32(messages, 10000, "Notifications sent to each notifier.");
+DEFINE_int32(interval_us, 200, "Interval between two notifications.");
+DEFINE_int32(idle_seconds, 5, "Time spent listening without notifications.");
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+namespace {
+
+const uint64_t kChannelId = 0x6e6f746966696572;
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double ThreadCpuSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) + ts.tv_nsec * 1e-9;
+}
+
+NotifierPtr CreateNotifier(const std::string& type) {
+  if (type == ConditionNotifier::Type()) {
+    return ConditionNotifier::Instance();
+  } else if (type == MulticastNotifier::Type()) {
+    return MulticastNotifier::Instance();
+  } else if (type == FutexNotifier::Type()) {
+    return FutexNotifier::Instance();
+  }
+  return nullptr;
+}
+
+int Run(const std::string& type) {
+  NotifierPtr notifier = CreateNotifier(type);
+  if (notifier == nullptr) {
+    fprintf(stderr, "unknown notifier: %s\n", type.c_str());
+    return 1;
+  }
+  notifier->Subscribe(kChannelId);
+
+  // The send time travels in the host id, steady clock is shared by threads.
+  std::vector<uint64_t> latencies;
+  latencies.reserve(FLAGS_messages);
+  double idle_cpu = 0.0;
+  std::thread listener([&]() {
+    ReadableInfo info;
+    double begin = ThreadCpuSeconds();
+    auto idle_end = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(FLAGS_idle_seconds);
+    while (std::chrono::steady_clock::now() < idle_end) {
+      notifier->Listen(100, &info);
+    }
+    idle_cpu = ThreadCpuSeconds() - begin;
+
+    while (static_cast<int>(latencies.size()) < FLAGS_messages) {
+      if (!notifier->Listen(1000, &info)) {
+        break;
+      }
+      if (info.channel_id() == kChannelId) {
+        latencies.push_back(NowNs() - info.host_id());
+      }
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::seconds(FLAGS_idle_seconds) +
+                              std::chrono::milliseconds(200));
+  for (int i = 0; i < FLAGS_messages; ++i) {
+    notifier->Notify(ReadableInfo(NowNs(), i, kChannelId));
+    std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_interval_us));
+  }
+  listener.join();
+  notifier->Shutdown();
+
+  if (latencies.empty()) {
+    fprintf(stderr, "%s: nothing received\n", type.c_str());
+    return 1;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1e3;
+  };
+  printf(
+      "%-10s received %zu/%d  latency us p50 %.1f p90 %.1f p99 %.1f max %.1f"
+      "  idle cpu %.2f%%\n",
+      type.c_str(), latencies.size(), FLAGS_messages, percentile(0.5),
+      percentile(0.9), percentile(0.99), percentile(1.0),
+      100.0 * idle_cpu / FLAGS_idle_seconds);
+  return 0;
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  int result = 0;
+  std::string types = FLAGS_notifier_types + ",";
+  for (size_t begin = 0, end = 0; (end = types.find(',', begin)) !=
+                                  std::string::npos;
+       begin = end + 1) {
+    std::string type = types.substr(begin, end - begin);
+    if (type.empty()) {
+      continue;
+    }
+    // Notifiers are singletons, so each one gets a fresh process.
+    pid_t pid = fork();
+    if (pid == 0) {
+      int code = apollo::cyber::transport::Run(type);
+      fflush(stdout);
+      _exit(code);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      result = 1;
+    }
+  }
+  return result;
+}
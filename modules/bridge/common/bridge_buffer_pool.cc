@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/bridge/common/bridge_buffer_pool.h"
+
+#include <algorithm>
+
+namespace apollo {
+namespace bridge {
+
+BridgeBufferPool::~BridgeBufferPool() {
+  for (auto &buf : free_list_) {
+    delete[] buf.first;
+  }
+  free_list_.clear();
+}
+
+BridgeBufferPool *BridgeBufferPool::Instance() {
+  static BridgeBufferPool pool;
+  return &pool;
+}
+
+char *BridgeBufferPool::Acquire(size_t size, size_t *capacity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Take the smallest free buffer that is large enough.
+    auto best = free_list_.end();
+    for (auto itor = free_list_.begin(); itor != free_list_.end(); ++itor) {
+      if (itor->second >= size &&
+          (best == free_list_.end() || itor->second < best->second)) {
+        best = itor;
+      }
+    }
+    if (best != free_list_.end()) {
+      char *buf = best->first;
+      *capacity = best->second;
+      *best = free_list_.back();
+      free_list_.pop_back();
+      return buf;
+    }
+  }
+  *capacity = std::max<size_t>(size, 1);
+  return new char[*capacity];
+}
+
+void BridgeBufferPool::Release(char *buf, size_t capacity) {
+  if (!buf) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_list_.size() < max_pooled_) {
+      free_list_.emplace_back(buf, capacity);
+      return;
+    }
+  }
+  delete[] buf;
+}
+
+size_t BridgeBufferPool::pooled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return free_list_.size();
+}
+
+}  // namespace bridge
+}  // namespace apollo
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace bridge {
+
+/**
+ * @class BridgeBufferPool
+ * @brief Recycles the buffers messages are reassembled in, so that a
+ * steady stream of messages does not allocate one buffer per message.
+ */
+class BridgeBufferPool {
+ public:
+  explicit BridgeBufferPool(size_t max_pooled = 32)
+      : max_pooled_(max_pooled) {}
+  ~BridgeBufferPool();
+
+  static BridgeBufferPool *Instance();
+
+  /**
+   * @brief Gets a buffer of at least size bytes.
+   * @param capacity The actual size of the buffer, to pass to Release.
+   */
+  char *Acquire(size_t size, size_t *capacity);
+
+  /**
+   * @brief Returns a buffer obtained from Acquire.
+   */
+  void Release(char *buf, size_t capacity);
+
+  size_t pooled() const;
+
+ private:
+  const size_t max_pooled_;
+  mutable std::mutex mutex_;
+  // Free buffers with their capacity.
+  std::vector<std::pair<char *, size_t>> free_list_;
+
+  BridgeBufferPool(const BridgeBufferPool &) = delete;
+  BridgeBufferPool &operator=(const BridgeBufferPool &) = delete;
+};
+
+}  // namespace bridge
+}  // namespace apollo
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/bridge/common/bridge_buffer_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace bridge {
+
+TEST(BridgeBufferPoolTest, recycle) {
+  BridgeBufferPool pool(2);
+  size_t capacity1 = 0;
+  char *buf1 = pool.Acquire(100, &capacity1);
+  EXPECT_EQ(100, capacity1);
+  size_t capacity2 = 0;
+  char *buf2 = pool.Acquire(200, &capacity2);
+  EXPECT_EQ(200, capacity2);
+  pool.Release(buf1, capacity1);
+  pool.Release(buf2, capacity2);
+  EXPECT_EQ(2, pool.pooled());
+
+  // The smallest buffer that is large enough is reused.
+  size_t capacity = 0;
+  EXPECT_EQ(buf2, pool.Acquire(150, &capacity));
+  EXPECT_EQ(200, capacity);
+  EXPECT_EQ(buf1, pool.Acquire(50, &capacity));
+  EXPECT_EQ(100, capacity);
+  EXPECT_EQ(0, pool.pooled());
+
+  char *buf3 = pool.Acquire(300, &capacity);
+  EXPECT_EQ(300, capacity);
+  pool.Release(buf1, 100);
+  pool.Release(buf2, 200);
+  // The pool is full, buf3 is freed.
+  pool.Release(buf3, 300);
+  EXPECT_EQ(2, pool.pooled());
+}
+
+}  // namespace bridge
+}  // namespace apollo
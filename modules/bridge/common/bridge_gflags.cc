@@ -18,3 +18,7 @@
 
 DEFINE_string(bridge_module_name, "Bridge", "Bridge module name");
 DEFINE_double(timeout, 1.0, "receive/send proto msg time out");
+DEFINE_int32(bridge_receive_workers, 2,
+             "number of threads receiving on a bridge port");
+DEFINE_double(bridge_statistics_interval, 10.0,
+              "seconds between throughput/loss logs, 0 to disable");
@@ -20,3 +20,5 @@
 
 DECLARE_string(bridge_module_name);
 DECLARE_double(timeout);
+DECLARE_int32(bridge_receive_workers);
+DECLARE_double(bridge_statistics_interval);
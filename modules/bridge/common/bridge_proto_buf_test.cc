@@ -21,6 +21,7 @@
 #include "cyber/init.h"
 #include "modules/bridge/common/bridge_proto_diserialized_buf.h"
 #include "modules/bridge/common/bridge_proto_serialized_buf.h"
+#include "modules/bridge/common/util.h"
 
 namespace apollo {
 namespace bridge {
@@ -93,5 +94,49 @@ TEST(BridgeProtoBufTest, Simple) {
   }
 }
 
+TEST(BridgeProtoBufTest, FrameSizeFromMTU) {
+  auto adc_trajectory = std::make_shared<planning::ADCTrajectory>();
+  for (size_t i = 0; i < 500; ++i) {
+    auto *point = adc_trajectory->add_trajectory_point();
+    point->mutable_path_point()->set_x(0.1 * static_cast<double>(i));
+  }
+  adc_trajectory->mutable_header()->set_sequence_num(7);
+
+  const std::string name = "planning::ADCTrajectory";
+  const size_t datagram_size = 1472;
+  bsize frame_size =
+      BridgeProtoSerializedBuf<planning::ADCTrajectory>::GetFrameSizeFor(
+          datagram_size, name);
+  BridgeProtoSerializedBuf<planning::ADCTrajectory> proto_buf;
+  EXPECT_TRUE(proto_buf.Serialize(adc_trajectory, name, frame_size));
+  EXPECT_LT(1, proto_buf.GetSerializedBufCount());
+
+  BridgeProtoDiserializedBuf<planning::ADCTrajectory> proto_recv_buf;
+  for (size_t i = 0; i < proto_buf.GetSerializedBufCount(); i++) {
+    EXPECT_LE(proto_buf.GetSerializedBufSize(i), datagram_size);
+    BridgeHeader header;
+    const char *payload = nullptr;
+    ASSERT_TRUE(ParseFrame(proto_buf.GetSerializedBuf(i),
+                           proto_buf.GetSerializedBufSize(i), &header,
+                           &payload));
+    // A truncated frame is rejected.
+    BridgeHeader truncated;
+    EXPECT_FALSE(ParseFrame(proto_buf.GetSerializedBuf(i),
+                            proto_buf.GetSerializedBufSize(i) - 1, &truncated,
+                            &payload));
+
+    proto_recv_buf.Initialize(header);
+    memcpy(proto_recv_buf.GetBuf(header.GetFramePos()), payload,
+           header.GetFrameSize());
+    proto_recv_buf.UpdateStatus(header.GetIndex());
+  }
+  EXPECT_EQ(datagram_size, proto_buf.GetSerializedBufSize(0));
+  ASSERT_TRUE(proto_recv_buf.IsReadyDiserialize());
+  auto pb_msg = std::make_shared<planning::ADCTrajectory>();
+  proto_recv_buf.Diserialized(pb_msg);
+  EXPECT_EQ(500, pb_msg->trajectory_point_size());
+  EXPECT_EQ(7, pb_msg->header().sequence_num());
+}
+
 }  // namespace bridge
 }  // namespace apollo
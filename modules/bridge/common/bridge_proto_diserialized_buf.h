@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "cyber/cyber.h"
+#include "modules/bridge/common/bridge_buffer_pool.h"
 #include "modules/bridge/common/bridge_header.h"
 #include "modules/bridge/common/macro.h"
 
@@ -73,7 +74,9 @@ class BridgeProtoDiserializedBuf : public ProtoDiserializedBufBase {
   size_t total_size_ = 0;
   std::string proto_name_ = "";
   std::vector<uint32_t> status_list_;
+  // Taken from BridgeBufferPool::Instance() and returned to it.
   char *proto_buf_ = nullptr;
+  size_t proto_buf_capacity_ = 0;
   bool is_ready_diser = false;
   uint32_t sequence_num_ = 0;
   std::shared_ptr<cyber::Writer<T>> writer_;
@@ -82,7 +85,8 @@ class BridgeProtoDiserializedBuf : public ProtoDiserializedBufBase {
 
 template <typename T>
 BridgeProtoDiserializedBuf<T>::~BridgeProtoDiserializedBuf() {
-  FREE_ARRY(proto_buf_);
+  BridgeBufferPool::Instance()->Release(proto_buf_, proto_buf_capacity_);
+  proto_buf_ = nullptr;
 }
 
 template <typename T>
@@ -109,7 +113,7 @@ void BridgeProtoDiserializedBuf<T>::UpdateStatus(uint32_t frame_index) {
     if (i == status_size - 1) {
       if (static_cast<int>(status_list_[i]) ==
           (1 << total_frames_ % INT_BITS) - 1) {
-        AINFO << "diserialized is ready";
+        ADEBUG << "diserialized is ready";
         is_ready_diser = true;
       } else {
         is_ready_diser = false;
@@ -153,7 +157,8 @@ bool BridgeProtoDiserializedBuf<T>::Initialize(const BridgeHeader &header) {
 
   if (!proto_buf_) {
     try {
-      proto_buf_ = new char[total_size_];
+      proto_buf_ = BridgeBufferPool::Instance()->Acquire(
+          total_size_, &proto_buf_capacity_);
     } catch (const std::bad_alloc& e) {
       AERROR << "Memory allocation failed: " << e.what();
       return false;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,7 +34,19 @@ class BridgeProtoSerializedBuf {
   ~BridgeProtoSerializedBuf();
 
   char *GetFrame(size_t index);
-  bool Serialize(const std::shared_ptr<T> &proto, const std::string &msg_name);
+  /**
+   * @brief Splits the serialized proto into frames of at most frame_size
+   * payload bytes each, plus the header.
+   */
+  bool Serialize(const std::shared_ptr<T> &proto, const std::string &msg_name,
+                 bsize frame_size = FRAME_SIZE);
+
+  /**
+   * @brief Gets the largest frame payload such that header and payload fit
+   * in datagram_size bytes.
+   */
+  static bsize GetFrameSizeFor(size_t datagram_size,
+                               const std::string &msg_name);
 
   const char *GetSerializedBuf(size_t index) const {
     return frames_[index].buf_;
@@ -60,9 +73,36 @@ BridgeProtoSerializedBuf<T>::~BridgeProtoSerializedBuf() {
   }
 }
 
+template <typename T>
+bsize BridgeProtoSerializedBuf<T>::GetFrameSizeFor(
+    size_t datagram_size, const std::string &msg_name) {
+  // The header size only depends on the name, the other items are fixed
+  // size.
+  BridgeHeader header;
+  header.SetHeaderVer(0);
+  header.SetMsgName(msg_name);
+  header.SetMsgID(0);
+  header.SetTimeStamp(0.0);
+  header.SetMsgSize(0);
+  header.SetTotalFrames(0);
+  header.SetFrameSize(0);
+  header.SetIndex(0);
+  header.SetFramePos(0);
+  const size_t header_size = header.GetHeaderSize();
+  datagram_size = std::min<size_t>(datagram_size, MAX_DATAGRAM_SIZE);
+  if (datagram_size <= header_size) {
+    return FRAME_SIZE;
+  }
+  return static_cast<bsize>(datagram_size - header_size);
+}
+
 template <typename T>
 bool BridgeProtoSerializedBuf<T>::Serialize(const std::shared_ptr<T> &proto,
-                                            const std::string &msg_name) {
+                                            const std::string &msg_name,
+                                            bsize frame_size) {
+  if (frame_size == 0) {
+    return false;
+  }
   bsize msg_len = static_cast<bsize>(proto->ByteSizeLong());
   char *tmp = new char[msg_len]();
   if (!proto->SerializeToArray(tmp, static_cast<int>(msg_len))) {
@@ -71,12 +111,12 @@ bool BridgeProtoSerializedBuf<T>::Serialize(const std::shared_ptr<T> &proto,
   }
   bsize offset = 0;
   bsize frame_index = 0;
-  uint32_t total_frames = static_cast<uint32_t>(msg_len / FRAME_SIZE +
-                                                (msg_len % FRAME_SIZE ? 1 : 0));
+  uint32_t total_frames = static_cast<uint32_t>(msg_len / frame_size +
+                                                (msg_len % frame_size ? 1 : 0));
 
   while (offset < msg_len) {
-    bsize left = msg_len - frame_index * FRAME_SIZE;
-    bsize cpy_size = (left > FRAME_SIZE) ? FRAME_SIZE : left;
+    bsize left = msg_len - frame_index * frame_size;
+    bsize cpy_size = (left > frame_size) ? frame_size : left;
 
     BridgeHeader header;
     header.SetHeaderVer(0);
@@ -87,13 +127,13 @@ bool BridgeProtoSerializedBuf<T>::Serialize(const std::shared_ptr<T> &proto,
     header.SetTotalFrames(total_frames);
     header.SetFrameSize(cpy_size);
     header.SetIndex(frame_index);
-    header.SetFramePos(frame_index * FRAME_SIZE);
+    header.SetFramePos(frame_index * frame_size);
     hsize header_size = header.GetHeaderSize();
     Buf buf;
     buf.buf_ = new char[cpy_size + header_size];
     buf.buf_len_ = cpy_size + header_size;
     header.Serialize(buf.buf_, buf.buf_len_);
-    memcpy(buf.buf_ + header_size, tmp + frame_index * FRAME_SIZE, cpy_size);
+    memcpy(buf.buf_ + header_size, tmp + frame_index * frame_size, cpy_size);
     frames_.push_back(buf);
     frame_index++;
     offset += cpy_size;
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/bridge/common/bridge_statistics.h"
+
+#include <sstream>
+
+namespace apollo {
+namespace bridge {
+
+void BridgeStatistics::AddSentMessage(uint64_t frames, uint64_t bytes,
+                                      bool complete) {
+  ++sent_messages_;
+  sent_frames_ += frames;
+  sent_bytes_ += bytes;
+  if (!complete) {
+    ++send_failures_;
+  }
+}
+
+void BridgeStatistics::AddReceivedFrame(uint64_t bytes) {
+  ++received_frames_;
+  received_bytes_ += bytes;
+}
+
+BridgeStatistics::Counters BridgeStatistics::GetCounters() const {
+  Counters counters;
+  counters.sent_messages = sent_messages_;
+  counters.sent_frames = sent_frames_;
+  counters.sent_bytes = sent_bytes_;
+  counters.send_failures = send_failures_;
+  counters.received_messages = received_messages_;
+  counters.received_frames = received_frames_;
+  counters.received_bytes = received_bytes_;
+  counters.dropped_messages = dropped_messages_;
+  counters.malformed_frames = malformed_frames_;
+  return counters;
+}
+
+bool BridgeStatistics::Report(double now_sec, double interval,
+                              std::string *report) {
+  std::lock_guard<std::mutex> lock(report_mutex_);
+  if (last_report_time_ == 0.0) {
+    last_report_time_ = now_sec;
+    last_report_ = GetCounters();
+    return false;
+  }
+  const double elapsed = now_sec - last_report_time_;
+  if (elapsed < interval || elapsed <= 0.0) {
+    return false;
+  }
+  const Counters counters = GetCounters();
+  std::ostringstream oss;
+  oss << "sent " << counters.sent_messages - last_report_.sent_messages
+      << " msgs, "
+      << static_cast<double>(counters.sent_bytes - last_report_.sent_bytes) /
+             elapsed
+      << " B/s, " << counters.send_failures - last_report_.send_failures
+      << " failed; received "
+      << counters.received_messages - last_report_.received_messages
+      << " msgs, "
+      << static_cast<double>(counters.received_bytes -
+                             last_report_.received_bytes) /
+             elapsed
+      << " B/s, "
+      << counters.dropped_messages - last_report_.dropped_messages
+      << " dropped, "
+      << counters.malformed_frames - last_report_.malformed_frames
+      << " malformed frames";
+  *report = oss.str();
+  last_report_time_ = now_sec;
+  last_report_ = counters;
+  return true;
+}
+
+}  // namespace bridge
+}  // namespace apollo
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace apollo {
+namespace bridge {
+
+/**
+ * @class BridgeStatistics
+ * @brief Throughput and loss counters of a bridge endpoint. Counting is
+ * lock free and may be done from any thread.
+ */
+class BridgeStatistics {
+ public:
+  struct Counters {
+    uint64_t sent_messages = 0;
+    uint64_t sent_frames = 0;
+    uint64_t sent_bytes = 0;
+    // Messages of which some frames could not be sent.
+    uint64_t send_failures = 0;
+    uint64_t received_messages = 0;
+    uint64_t received_frames = 0;
+    uint64_t received_bytes = 0;
+    // Partially received messages given up on.
+    uint64_t dropped_messages = 0;
+    uint64_t malformed_frames = 0;
+  };
+
+  void AddSentMessage(uint64_t frames, uint64_t bytes, bool complete);
+  void AddReceivedFrame(uint64_t bytes);
+  void AddReceivedMessage() { ++received_messages_; }
+  void AddDroppedMessages(uint64_t count) { dropped_messages_ += count; }
+  void AddMalformedFrame() { ++malformed_frames_; }
+
+  Counters GetCounters() const;
+
+  /**
+   * @brief Describes the rates since the last report, at most once per
+   * interval seconds.
+   * @return False if the interval has not elapsed yet.
+   */
+  bool Report(double now_sec, double interval, std::string *report);
+
+ private:
+  std::atomic<uint64_t> sent_messages_{0};
+  std::atomic<uint64_t> sent_frames_{0};
+  std::atomic<uint64_t> sent_bytes_{0};
+  std::atomic<uint64_t> send_failures_{0};
+  std::atomic<uint64_t> received_messages_{0};
+  std::atomic<uint64_t> received_frames_{0};
+  std::atomic<uint64_t> received_bytes_{0};
+  std::atomic<uint64_t> dropped_messages_{0};
+  std::atomic<uint64_t> malformed_frames_{0};
+
+  std::mutex report_mutex_;
+  double last_report_time_ = 0.0;
+  Counters last_report_;
+};
+
+}  // namespace bridge
+}  // namespace apollo
@@ -34,5 +34,7 @@ namespace bridge {
   p = nullptr
 
 constexpr uint32_t FRAME_SIZE = 1024;
+// Largest UDP payload over IPv4, the bound of any frame including its header.
+constexpr uint32_t MAX_DATAGRAM_SIZE = 65507;
 }  // namespace bridge
 }  // namespace apollo
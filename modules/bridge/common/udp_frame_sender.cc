@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/bridge/common/udp_frame_sender.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "modules/bridge/common/macro.h"
+
+namespace apollo {
+namespace bridge {
+
+namespace {
+
+// Frames handed to a single sendmmsg call.
+constexpr size_t kMaxBatchSize = 64;
+// IPv4 and UDP headers.
+constexpr size_t kUDPOverhead = 28;
+
+}  // namespace
+
+bool UDPFrameSender::Connect(const std::string &remote_ip,
+                             uint16_t remote_port) {
+  Close();
+  struct sockaddr_in server_addr;
+  memset(&server_addr, 0, sizeof(server_addr));
+  server_addr.sin_addr.s_addr = inet_addr(remote_ip.c_str());
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(remote_port);
+  sock_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (sock_fd_ == -1) {
+    return false;
+  }
+  if (connect(sock_fd_, (struct sockaddr *)&server_addr,
+              sizeof(server_addr)) < 0) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void UDPFrameSender::Close() {
+  if (sock_fd_ != -1) {
+    close(sock_fd_);
+    sock_fd_ = -1;
+  }
+}
+
+size_t UDPFrameSender::GetMaxDatagramSize() const {
+  int mtu = 0;
+  socklen_t len = static_cast<socklen_t>(sizeof(mtu));
+  if (sock_fd_ == -1 ||
+      getsockopt(sock_fd_, IPPROTO_IP, IP_MTU, &mtu, &len) < 0 ||
+      mtu <= static_cast<int>(kUDPOverhead)) {
+    return 0;
+  }
+  return std::min<size_t>(static_cast<size_t>(mtu) - kUDPOverhead,
+                          MAX_DATAGRAM_SIZE);
+}
+
+size_t UDPFrameSender::SendFrames() {
+  if (sock_fd_ == -1) {
+    return 0;
+  }
+  const size_t count = frames_.size();
+  msgs_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    memset(&msgs_[i], 0, sizeof(msgs_[i]));
+    msgs_[i].msg_hdr.msg_iov = &frames_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+  size_t sent = 0;
+  while (sent < count) {
+    const unsigned int batch =
+        static_cast<unsigned int>(std::min(count - sent, kMaxBatchSize));
+    const int res = sendmmsg(sock_fd_, &msgs_[sent], batch, 0);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // A full socket buffer or an unreachable peer, drop the rest.
+      break;
+    }
+    sent += static_cast<size_t>(res);
+  }
+  return sent;
+}
+
+}  // namespace bridge
+}  // namespace apollo
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/bridge/common/bridge_proto_serialized_buf.h"
+
+namespace apollo {
+namespace bridge {
+
+/**
+ * @class UDPFrameSender
+ * @brief A long-lived UDP socket connected to the remote end of a bridge,
+ * sending the frames of a message in batches with sendmmsg.
+ *
+ * The socket is non-blocking: frames that do not fit in the socket buffer
+ * are dropped rather than stalling the sender.
+ */
+class UDPFrameSender {
+ public:
+  UDPFrameSender() = default;
+  ~UDPFrameSender() { Close(); }
+
+  bool Connect(const std::string &remote_ip, uint16_t remote_port);
+  bool IsConnected() const { return sock_fd_ != -1; }
+  void Close();
+
+  /**
+   * @brief Gets the largest datagram that fits in the path MTU of the
+   * connection, IP and UDP headers excluded.
+   * @return 0 if the path MTU is unknown.
+   */
+  size_t GetMaxDatagramSize() const;
+
+  /**
+   * @brief Sends all the frames of a serialized message.
+   * @return The number of frames sent.
+   */
+  template <typename T>
+  size_t Send(const BridgeProtoSerializedBuf<T> &proto_buf);
+
+ private:
+  size_t SendFrames();
+
+  int sock_fd_ = -1;
+  // Reused between messages.
+  std::vector<struct iovec> frames_;
+  std::vector<struct mmsghdr> msgs_;
+
+  UDPFrameSender(const UDPFrameSender &) = delete;
+  UDPFrameSender &operator=(const UDPFrameSender &) = delete;
+};
+
+template <typename T>
+size_t UDPFrameSender::Send(const BridgeProtoSerializedBuf<T> &proto_buf) {
+  frames_.clear();
+  for (size_t j = 0; j < proto_buf.GetSerializedBufCount(); j++) {
+    struct iovec frame;
+    frame.iov_base = const_cast<char *>(proto_buf.GetSerializedBuf(j));
+    frame.iov_len = proto_buf.GetSerializedBufSize(j);
+    frames_.push_back(frame);
+  }
+  return SendFrames();
+}
+
+}  // namespace bridge
+}  // namespace apollo
@@ -27,15 +27,37 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "modules/bridge/common/bridge_gflags.h"
+#include "modules/bridge/common/macro.h"
+
 namespace apollo {
 namespace bridge {
 
 constexpr int MAXEPOLLSIZE = 100;
-
+// Datagrams received by a single recvmmsg call.
+constexpr unsigned int RECV_BATCH_SIZE = 8;
+// How often the workers check whether they were stopped.
+constexpr int EPOLL_TIMEOUT_MS = 100;
+// Absorbs bursts of frames, capped by net.core.rmem_max.
+constexpr int RECV_BUFFER_SIZE = 8 * 1024 * 1024;
+
+/**
+ * @class UDPListener
+ * @brief Receives datagrams on a port with a fixed pool of
+ * FLAGS_bridge_receive_workers threads, and hands each of them to the
+ * receiver. The handler may be called from several threads at once.
+ */
 template <typename T>
 class UDPListener {
  public:
-  typedef bool (T::*func)(int fd);
+  typedef bool (T::*func)(const char *buf, size_t size);
   UDPListener() {}
   UDPListener(T *receiver, uint16_t port, func msg_handle) {
     receiver_ = receiver;
@@ -46,30 +68,33 @@ class UDPListener {
     if (listener_sock_ != -1) {
       close(listener_sock_);
     }
+    if (kdpfd_ != -1) {
+      close(kdpfd_);
+    }
   }
 
   void SetMsgHandle(func msg_handle) { msg_handle_ = msg_handle; }
   bool Initialize(T *receiver, func msg_handle, uint16_t port);
-  bool Listen();
 
-  static void *pthread_handle_message(void *param);
-
- public:
-  struct Param {
-    int fd_ = 0;
-    UDPListener<T> *listener_ = nullptr;
-  };
+  /**
+   * @brief Receives until Stop() is called. The calling thread is one of the
+   * workers.
+   */
+  bool Listen();
+  void Stop() { running_ = false; }
 
  private:
   bool setnonblocking(int sockfd);
-  void MessageHandle(int fd);
+  bool ReceiveLoop();
+  void Drain(std::vector<char> *bufs, struct mmsghdr *msgs);
 
  private:
   T *receiver_ = nullptr;
   uint16_t listened_port_ = 0;
   int listener_sock_ = -1;
   func msg_handle_ = nullptr;
-  int kdpfd_ = 0;
+  int kdpfd_ = -1;
+  std::atomic<bool> running_{true};
 };
 
 template <typename T>
@@ -96,6 +121,9 @@ bool UDPListener<T>::Initialize(T *receiver, func msg_handle, uint16_t port) {
   }
   int opt = SO_REUSEADDR;
   setsockopt(listener_sock_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  int recv_buffer_size = RECV_BUFFER_SIZE;
+  setsockopt(listener_sock_, SOL_SOCKET, SO_RCVBUF, &recv_buffer_size,
+             sizeof(recv_buffer_size));
   setnonblocking(listener_sock_);
 
   struct sockaddr_in serv_addr;
@@ -105,6 +133,7 @@ bool UDPListener<T>::Initialize(T *receiver, func msg_handle, uint16_t port) {
   if (bind(listener_sock_, (struct sockaddr *)&serv_addr,
            sizeof(struct sockaddr)) == -1) {
     close(listener_sock_);
+    listener_sock_ = -1;
     return false;
   }
   kdpfd_ = epoll_create(MAXEPOLLSIZE);
@@ -113,6 +142,7 @@ bool UDPListener<T>::Initialize(T *receiver, func msg_handle, uint16_t port) {
   ev.data.fd = listener_sock_;
   if (epoll_ctl(kdpfd_, EPOLL_CTL_ADD, listener_sock_, &ev) < 0) {
     close(listener_sock_);
+    listener_sock_ = -1;
     return false;
   }
   return true;
@@ -120,69 +150,77 @@ bool UDPListener<T>::Initialize(T *receiver, func msg_handle, uint16_t port) {
 
 template <typename T>
 bool UDPListener<T>::Listen() {
-  int nfds = -1;
-  bool res = true;
+  running_ = true;
+  const int num_workers = std::max(FLAGS_bridge_receive_workers, 1);
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_workers; ++i) {
+    workers.emplace_back([this]() { ReceiveLoop(); });
+  }
+  bool res = ReceiveLoop();
+  running_ = false;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return res;
+}
+
+template <typename T>
+bool UDPListener<T>::ReceiveLoop() {
+  std::vector<char> bufs(RECV_BATCH_SIZE * MAX_DATAGRAM_SIZE);
+  struct iovec iovecs[RECV_BATCH_SIZE];
+  struct mmsghdr msgs[RECV_BATCH_SIZE];
+  memset(msgs, 0, sizeof(msgs));
+  for (unsigned int i = 0; i < RECV_BATCH_SIZE; ++i) {
+    iovecs[i].iov_base = bufs.data() + i * MAX_DATAGRAM_SIZE;
+    iovecs[i].iov_len = MAX_DATAGRAM_SIZE;
+    msgs[i].msg_hdr.msg_iov = &iovecs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
   struct epoll_event events[MAXEPOLLSIZE];
-  while (true) {
-    nfds = epoll_wait(kdpfd_, events, 10000, -1);
+  while (running_) {
+    int nfds = epoll_wait(kdpfd_, events, MAXEPOLLSIZE, EPOLL_TIMEOUT_MS);
     if (nfds == -1) {
-      res = false;
-      break;
+      if (errno == EINTR) {
+        continue;
+      }
+      running_ = false;
+      return false;
     }
-
     for (int i = 0; i < nfds; ++i) {
       if (events[i].data.fd == listener_sock_) {
-        pthread_t thread;
-        pthread_attr_t attr;
-        pthread_attr_init(&attr);
-        pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-        Param *par = new Param;
-        par->fd_ = events[i].data.fd;
-        par->listener_ = this;
-        if (pthread_create(&thread, &attr,
-                           &UDPListener<T>::pthread_handle_message,
-                           reinterpret_cast<void *>(par))) {
-          res = false;
-          return res;
-        }
+        Drain(&bufs, msgs);
       }
     }
   }
-  close(listener_sock_);
-  return res;
-}
-
-template <typename T>
-bool UDPListener<T>::setnonblocking(int sockfd) {
-  if (fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFD, 0) | O_NONBLOCK) == -1) {
-    return false;
-  }
   return true;
 }
 
 template <typename T>
-void *UDPListener<T>::pthread_handle_message(void *param) {
-  Param *par = static_cast<Param *>(param);
-  int fd = par->fd_;
-  UDPListener<T> *listener = par->listener_;
-  if (par) {
-    delete par;
-  }
-  par = nullptr;
-  if (!listener) {
-    pthread_exit(nullptr);
+void UDPListener<T>::Drain(std::vector<char> *bufs, struct mmsghdr *msgs) {
+  // The socket is edge triggered, read until it is empty.
+  while (true) {
+    int count = recvmmsg(listener_sock_, msgs, RECV_BATCH_SIZE, MSG_DONTWAIT,
+                         nullptr);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;
+    }
+    for (int i = 0; i < count; ++i) {
+      (receiver_->*msg_handle_)(bufs->data() + i * MAX_DATAGRAM_SIZE,
+                                msgs[i].msg_len);
+    }
   }
-  listener->MessageHandle(fd);
-  pthread_exit(nullptr);
 }
 
 template <typename T>
-void UDPListener<T>::MessageHandle(int fd) {
-  if (!receiver_ || !msg_handle_) {
-    return;
+bool UDPListener<T>::setnonblocking(int sockfd) {
+  if (fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFD, 0) | O_NONBLOCK) == -1) {
+    return false;
   }
-  (receiver_->*msg_handle_)(fd);
+  return true;
 }
 
 }  // namespace bridge
@@ -28,5 +28,30 @@ int GetProtoSize(const char *buf, size_t size) {
   return proto_size;
 }
 
+bool ParseFrame(const char *buf, size_t size, BridgeHeader *header,
+                const char **payload) {
+  size_t offset = HEADER_FLAG_SIZE + 1;
+  if (!buf || size < offset + sizeof(hsize) + 1 ||
+      strncmp(buf, BRIDGE_HEADER_FLAG, HEADER_FLAG_SIZE) != 0) {
+    return false;
+  }
+  hsize header_size = 0;
+  memcpy(&header_size, buf + offset, sizeof(hsize));
+  offset += sizeof(hsize) + 1;
+  if (header_size < offset || header_size > size) {
+    return false;
+  }
+  if (!header->Diserialize(buf + offset, header_size - offset)) {
+    return false;
+  }
+  if (header->GetFramePos() > header->GetMsgSize() ||
+      header->GetFrameSize() > size - header_size ||
+      header->GetFrameSize() > header->GetMsgSize() - header->GetFramePos()) {
+    return false;
+  }
+  *payload = buf + header_size;
+  return true;
+}
+
 }  // namespace bridge
 }  // namespace apollo
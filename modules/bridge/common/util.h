@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "modules/bridge/common/bridge_buffer.h"
+#include "modules/bridge/common/bridge_header.h"
 #include "modules/bridge/common/macro.h"
 
 namespace apollo {
@@ -79,5 +80,16 @@ bool RemoveItem(std::vector<std::shared_ptr<T>> *list, std::shared_ptr<T> t) {
 
 int GetProtoSize(const char *buf, size_t size);
 
+/**
+ * @brief Parses the header of a received frame and checks that its payload
+ * lies within both the datagram and the message it belongs to.
+ * @param buf The received datagram.
+ * @param size Size of the datagram.
+ * @param header The parsed header.
+ * @param payload Start of the frame payload in buf.
+ */
+bool ParseFrame(const char *buf, size_t size, BridgeHeader *header,
+                const char **payload);
+
 }  // namespace bridge
 }  // namespace apollo
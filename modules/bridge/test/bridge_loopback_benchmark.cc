@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Replays localization and trajectory messages through the UDP bridge
+ * on the loopback interface, and reports throughput and loss.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "modules/common_msgs/localization_msgs/localization.pb.h"
+#include "modules/common_msgs/planning_msgs/planning.pb.h"
+
+#include "cyber/common/log.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/time/clock.h"
+#include "modules/bridge/common/bridge_proto_diserialized_buf.h"
+#include "modules/bridge/common/bridge_proto_serialized_buf.h"
+#include "modules/bridge/common/bridge_statistics.h"
+#include "modules/bridge/common/udp_frame_sender.h"
+#include "modules/bridge/common/udp_listener.h"
+#include "modules/bridge/common/util.h"
+#include "modules/common/adapters/adapter_gflags.h"
+
+DEFINE_string(record, "",
+              "record to replay messages from, synthetic messages if empty");
+DEFINE_int32(port, 8950, "loopback port of the benchmark");
+DEFINE_int32(messages, 10000, "number of messages to send");
+DEFINE_double(rate, 0.0, "messages sent per second, 0 for no limit");
+DEFINE_bool(frame_size_from_mtu, true, "size the frames to the path MTU");
+
+using apollo::bridge::BridgeHeader;
+using apollo::bridge::BridgeProtoDiserializedBuf;
+using apollo::bridge::BridgeProtoSerializedBuf;
+using apollo::bridge::BridgeStatistics;
+using apollo::bridge::UDPFrameSender;
+using apollo::bridge::UDPListener;
+using apollo::cyber::Clock;
+using apollo::localization::LocalizationEstimate;
+using apollo::planning::ADCTrajectory;
+
+namespace {
+
+const char kLocalizationName[] = "LocalizationEstimate";
+const char kTrajectoryName[] = "ADCTrajectory";
+
+template <typename T>
+class Reassembler {
+ public:
+  explicit Reassembler(BridgeStatistics *statistics)
+      : statistics_(statistics) {}
+
+  void OnFrame(const BridgeHeader &header, const char *payload) {
+    auto &proto_buf = proto_bufs_[header.GetMsgID()];
+    if (!proto_buf) {
+      proto_buf = std::make_unique<BridgeProtoDiserializedBuf<T>>();
+      proto_buf->Initialize(header);
+    }
+    memcpy(proto_buf->GetBuf(header.GetFramePos()), payload,
+           header.GetFrameSize());
+    proto_buf->UpdateStatus(header.GetIndex());
+    if (!proto_buf->IsReadyDiserialize()) {
+      return;
+    }
+    auto pb_msg = std::make_shared<T>();
+    if (proto_buf->Diserialized(pb_msg)) {
+      statistics_->AddReceivedMessage();
+    }
+    // Frames of older messages are not coming anymore.
+    auto end = proto_bufs_.upper_bound(header.GetMsgID());
+    statistics_->AddDroppedMessages(std::distance(proto_bufs_.begin(), end) -
+                                    1);
+    proto_bufs_.erase(proto_bufs_.begin(), end);
+  }
+
+  size_t pending() const { return proto_bufs_.size(); }
+
+ private:
+  BridgeStatistics *statistics_;
+  std::map<uint32_t, std::unique_ptr<BridgeProtoDiserializedBuf<T>>>
+      proto_bufs_;
+};
+
+class Receiver {
+ public:
+  bool MsgHandle(const char *buf, size_t size) {
+    BridgeHeader header;
+    const char *payload = nullptr;
+    if (!apollo::bridge::ParseFrame(buf, size, &header, &payload)) {
+      statistics_.AddMalformedFrame();
+      return false;
+    }
+    statistics_.AddReceivedFrame(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header.GetMsgName() == kLocalizationName) {
+      localization_.OnFrame(header, payload);
+    } else {
+      trajectory_.OnFrame(header, payload);
+    }
+    return true;
+  }
+
+  BridgeStatistics::Counters GetCounters() const {
+    return statistics_.GetCounters();
+  }
+
+  size_t pending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return localization_.pending() + trajectory_.pending();
+  }
+
+ private:
+  BridgeStatistics statistics_;
+  std::mutex mutex_;
+  Reassembler<LocalizationEstimate> localization_{&statistics_};
+  Reassembler<ADCTrajectory> trajectory_{&statistics_};
+};
+
+struct Messages {
+  std::vector<std::shared_ptr<LocalizationEstimate>> localizations;
+  std::vector<std::shared_ptr<ADCTrajectory>> trajectories;
+  // Replay order, true for a localization.
+  std::vector<std::pair<bool, size_t>> order;
+};
+
+bool LoadRecord(const std::string &record, Messages *messages) {
+  apollo::cyber::record::RecordReader reader(record);
+  if (!reader.IsValid()) {
+    AERROR << "Failed to open " << record;
+    return false;
+  }
+  apollo::cyber::record::RecordMessage message;
+  while (reader.ReadMessage(&message)) {
+    if (message.channel_name == FLAGS_localization_topic) {
+      auto localization = std::make_shared<LocalizationEstimate>();
+      if (localization->ParseFromString(message.content)) {
+        messages->order.emplace_back(true, messages->localizations.size());
+        messages->localizations.push_back(localization);
+      }
+    } else if (message.channel_name == FLAGS_planning_trajectory_topic) {
+      auto trajectory = std::make_shared<ADCTrajectory>();
+      if (trajectory->ParseFromString(message.content)) {
+        messages->order.emplace_back(false, messages->trajectories.size());
+        messages->trajectories.push_back(trajectory);
+      }
+    }
+  }
+  return !messages->order.empty();
+}
+
+// Localization at 100Hz and a trajectory of 200 points at 10Hz.
+void Synthesize(Messages *messages) {
+  auto trajectory = std::make_shared<ADCTrajectory>();
+  for (int i = 0; i < 200; ++i) {
+    auto *point = trajectory->add_trajectory_point();
+    point->mutable_path_point()->set_x(0.1 * i);
+    point->mutable_path_point()->set_y(0.2 * i);
+    point->mutable_path_point()->set_theta(0.01 * i);
+    point->set_v(10.0);
+    point->set_relative_time(0.01 * i);
+  }
+  messages->trajectories.push_back(trajectory);
+  for (int i = 0; i < 10; ++i) {
+    auto localization = std::make_shared<LocalizationEstimate>();
+    localization->mutable_pose()->mutable_position()->set_x(i);
+    localization->mutable_pose()->mutable_position()->set_y(i);
+    localization->mutable_pose()->mutable_linear_velocity()->set_x(10.0);
+    messages->order.emplace_back(true, messages->localizations.size());
+    messages->localizations.push_back(localization);
+  }
+  messages->order.emplace_back(false, 0);
+}
+
+template <typename T>
+size_t Send(const std::shared_ptr<T> &pb_msg, const std::string &name,
+            uint32_t sequence_num, UDPFrameSender *sender,
+            BridgeStatistics *statistics) {
+  pb_msg->mutable_header()->set_sequence_num(sequence_num);
+  pb_msg->mutable_header()->set_timestamp_sec(Clock::NowInSeconds());
+  apollo::bridge::bsize frame_size = apollo::bridge::FRAME_SIZE;
+  if (FLAGS_frame_size_from_mtu && sender->GetMaxDatagramSize() > 0) {
+    frame_size = BridgeProtoSerializedBuf<T>::GetFrameSizeFor(
+        sender->GetMaxDatagramSize(), name);
+  }
+  BridgeProtoSerializedBuf<T> proto_buf;
+  if (!proto_buf.Serialize(pb_msg, name, frame_size)) {
+    return 0;
+  }
+  size_t frames = sender->Send(proto_buf);
+  size_t bytes = 0;
+  for (size_t j = 0; j < frames; ++j) {
+    bytes += proto_buf.GetSerializedBufSize(j);
+  }
+  statistics->AddSentMessage(frames, bytes,
+                             frames == proto_buf.GetSerializedBufCount());
+  return bytes;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  Messages messages;
+  if (FLAGS_record.empty() || !LoadRecord(FLAGS_record, &messages)) {
+    Synthesize(&messages);
+  }
+
+  Receiver receiver;
+  UDPListener<Receiver> listener;
+  if (!listener.Initialize(&receiver, &Receiver::MsgHandle,
+                           static_cast<uint16_t>(FLAGS_port))) {
+    AERROR << "Failed to listen on port " << FLAGS_port;
+    return -1;
+  }
+  std::thread listen_thread([&listener]() { listener.Listen(); });
+
+  UDPFrameSender sender;
+  if (!sender.Connect("127.0.0.1", static_cast<uint16_t>(FLAGS_port))) {
+    AERROR << "Failed to connect to port " << FLAGS_port;
+    listener.Stop();
+    listen_thread.join();
+    return -1;
+  }
+
+  BridgeStatistics statistics;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_messages; ++i) {
+    const auto &entry = messages.order[i % messages.order.size()];
+    const uint32_t sequence_num = static_cast<uint32_t>(i + 1);
+    if (entry.first) {
+      Send(messages.localizations[entry.second], kLocalizationName,
+           sequence_num, &sender, &statistics);
+    } else {
+      Send(messages.trajectories[entry.second], kTrajectoryName, sequence_num,
+           &sender, &statistics);
+    }
+    if (FLAGS_rate > 0.0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration<double>((i + 1) / FLAGS_rate));
+    }
+  }
+  const double send_sec = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+  // Let the workers drain the socket.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  listener.Stop();
+  listen_thread.join();
+
+  const auto sent = statistics.GetCounters();
+  const auto received = receiver.GetCounters();
+  const uint64_t lost = sent.sent_messages - received.received_messages;
+  printf("sent %lu msgs, %lu frames, %.1f MB in %.3f s: %.0f msgs/s, "
+         "%.1f MB/s\n",
+         sent.sent_messages, sent.sent_frames, sent.sent_bytes / 1e6,
+         send_sec, sent.sent_messages / send_sec,
+         sent.sent_bytes / 1e6 / send_sec);
+  printf("received %lu msgs, %lu frames; lost %lu msgs (%.2f%%), "
+         "%lu incomplete, %lu malformed frames\n",
+         received.received_messages, received.received_frames, lost,
+         100.0 * static_cast<double>(lost) / sent.sent_messages,
+         received.dropped_messages + receiver.pending(),
+         received.malformed_frames);
+  return 0;
+}
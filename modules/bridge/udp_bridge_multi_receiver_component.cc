@@ -65,6 +65,7 @@ UDPBridgeMultiReceiverComponent::CreateBridgeProtoBuf(
     for (; itor != proto_list_.end();) {
       if ((*itor)->IsTheProto(header)) {
         itor = proto_list_.erase(itor);
+        statistics_.AddDroppedMessages(1);
         break;
       }
       ++itor;
@@ -110,40 +111,16 @@ bool UDPBridgeMultiReceiverComponent::IsTimeout(double time_stamp) {
   return false;
 }
 
-bool UDPBridgeMultiReceiverComponent::MsgHandle(int fd) {
-  struct sockaddr_in client_addr;
-  socklen_t sock_len = static_cast<socklen_t>(sizeof(client_addr));
-  int total_recv = 2 * FRAME_SIZE;
-  char total_buf[2 * FRAME_SIZE] = {0};
-  int bytes =
-      static_cast<int>(recvfrom(fd, total_buf, total_recv, 0,
-                                (struct sockaddr *)&client_addr, &sock_len));
-  if (bytes <= 0 || bytes > total_recv) {
-    return false;
-  }
-
-  if (strncmp(total_buf, BRIDGE_HEADER_FLAG, HEADER_FLAG_SIZE) != 0) {
-    AERROR << "Header flag didn't match!";
-    return false;
-  }
-  size_t offset = HEADER_FLAG_SIZE + 1;
-
-  const char *cursor = total_buf + offset;
-  hsize header_size = *(reinterpret_cast<const hsize *>(cursor));
-  offset += sizeof(hsize) + 1;
-
-  if (header_size < offset || header_size > FRAME_SIZE) {
-    AERROR << "header size is more than FRAME_SIZE!";
-    return false;
-  }
-
-  cursor = total_buf + offset;
-  size_t buf_size = header_size - offset;
+bool UDPBridgeMultiReceiverComponent::MsgHandle(const char *buf,
+                                                size_t size) {
   BridgeHeader header;
-  if (!header.Diserialize(cursor, buf_size)) {
-    AERROR << "header diserialize failed!";
+  const char *payload = nullptr;
+  if (!ParseFrame(buf, size, &header, &payload)) {
+    AERROR << "Frame is malformed!";
+    statistics_.AddMalformedFrame();
     return false;
   }
+  statistics_.AddReceivedFrame(size);
 
   ADEBUG << "proto name : " << header.GetMsgName().c_str();
   ADEBUG << "proto sequence num: " << header.GetMsgID();
@@ -151,30 +128,19 @@ bool UDPBridgeMultiReceiverComponent::MsgHandle(int fd) {
   ADEBUG << "proto frame index: " << header.GetIndex();
 
   std::lock_guard<std::mutex> lock(mutex_);
+  ReportStatistics();
   std::shared_ptr<ProtoDiserializedBufBase> proto_buf =
       CreateBridgeProtoBuf(header);
   if (!proto_buf) {
     return false;
   }
 
-  cursor = total_buf + header_size;
-  if (header.GetFramePos() > header.GetMsgSize()) {
-    return false;
-  }
-  char *buf = proto_buf->GetBuf(header.GetFramePos());
-  // check cursor size
-  if (header.GetFrameSize() < 0 ||
-    header.GetFrameSize() > (total_recv - header_size)) {
-    return false;
-  }
-  // check buf size
-  if (header.GetFrameSize() > (header.GetMsgSize() - header.GetFramePos())) {
-    return false;
-  }
-  memcpy(buf, cursor, header.GetFrameSize());
+  memcpy(proto_buf->GetBuf(header.GetFramePos()), payload,
+         header.GetFrameSize());
   proto_buf->UpdateStatus(header.GetIndex());
   if (proto_buf->IsReadyDiserialize()) {
     proto_buf->DiserializedAndPub();
+    statistics_.AddReceivedMessage();
     RemoveInvalidBuf(proto_buf->GetMsgID(), proto_buf->GetMsgName());
     RemoveItem(&proto_list_, proto_buf);
   }
@@ -192,6 +158,7 @@ bool UDPBridgeMultiReceiverComponent::RemoveInvalidBuf(
     if ((*itor)->GetMsgID() < msg_id &&
         strcmp((*itor)->GetMsgName().c_str(), msg_name.c_str()) == 0) {
       itor = proto_list_.erase(itor);
+      statistics_.AddDroppedMessages(1);
       continue;
     }
     ++itor;
@@ -199,5 +166,14 @@ bool UDPBridgeMultiReceiverComponent::RemoveInvalidBuf(
   return true;
 }
 
+void UDPBridgeMultiReceiverComponent::ReportStatistics() {
+  std::string report;
+  if (FLAGS_bridge_statistics_interval > 0.0 &&
+      statistics_.Report(apollo::cyber::Clock::NowInSeconds(),
+                         FLAGS_bridge_statistics_interval, &report)) {
+    AINFO << report;
+  }
+}
+
 }  // namespace bridge
 }  // namespace apollo
@@ -35,6 +35,7 @@
 #include "modules/bridge/common/bridge_gflags.h"
 #include "modules/bridge/common/bridge_header.h"
 #include "modules/bridge/common/bridge_proto_diserialized_buf.h"
+#include "modules/bridge/common/bridge_statistics.h"
 #include "modules/bridge/common/udp_listener.h"
 #include "modules/common/monitor_log/monitor_log_buffer.h"
 
@@ -53,10 +54,11 @@ class UDPBridgeMultiReceiverComponent final : public cyber::Component<> {
   bool IsTimeout(double time_stamp);
   void MsgDispatcher();
   bool InitSession(uint16_t port);
-  bool MsgHandle(int fd);
+  bool MsgHandle(const char *buf, size_t size);
 
  private:
   bool RemoveInvalidBuf(uint32_t msg_id, const std::string &msg_name);
+  void ReportStatistics();
 
  private:
   common::monitor::MonitorLogBuffer monitor_logger_buffer_;
@@ -65,6 +67,7 @@ class UDPBridgeMultiReceiverComponent final : public cyber::Component<> {
   unsigned int bind_port_ = 0;
   bool enable_timeout_ = true;
   std::mutex mutex_;
+  BridgeStatistics statistics_;
   std::vector<std::shared_ptr<ProtoDiserializedBufBase>> proto_list_;
 };
 
@@ -85,6 +85,7 @@ BridgeProtoDiserializedBuf<T>
         BridgeProtoDiserializedBuf<T> *tmp = *itor;
         FREE_POINTER(tmp);
         itor = proto_list_.erase(itor);
+        statistics_.AddDroppedMessages(1);
         break;
       }
       ++itor;
@@ -132,45 +133,15 @@ bool UDPBridgeReceiverComponent<T>::IsTimeout(double time_stamp) {
 }
 
 template <typename T>
-bool UDPBridgeReceiverComponent<T>::MsgHandle(int fd) {
-  struct sockaddr_in client_addr;
-  socklen_t sock_len = static_cast<socklen_t>(sizeof(client_addr));
-  int bytes = 0;
-  int total_recv = 2 * FRAME_SIZE;
-  char total_buf[2 * FRAME_SIZE] = {0};
-  bytes =
-      static_cast<int>(recvfrom(fd, total_buf, total_recv, 0,
-                                (struct sockaddr *)&client_addr, &sock_len));
-  ADEBUG << "total recv " << bytes;
-  if (bytes <= 0 || bytes > total_recv) {
-    return false;
-  }
-  char header_flag[sizeof(BRIDGE_HEADER_FLAG) + 1] = {0};
-  size_t offset = 0;
-  memcpy(header_flag, total_buf, HEADER_FLAG_SIZE);
-  if (strcmp(header_flag, BRIDGE_HEADER_FLAG) != 0) {
-    AINFO << "header flag not match!";
-    return false;
-  }
-  offset += sizeof(BRIDGE_HEADER_FLAG) + 1;
-
-  char header_size_buf[sizeof(hsize) + 1] = {0};
-  const char *cursor = total_buf + offset;
-  memcpy(header_size_buf, cursor, sizeof(hsize));
-  hsize header_size = *(reinterpret_cast<hsize *>(header_size_buf));
-  offset += sizeof(hsize) + 1;
-  if (header_size > FRAME_SIZE || header_size < offset) {
-    AINFO << "header size is more than FRAME_SIZE or less than offset!";
-    return false;
-  }
-
+bool UDPBridgeReceiverComponent<T>::MsgHandle(const char *buf, size_t size) {
   BridgeHeader header;
-  size_t buf_size = header_size - offset;
-  cursor = total_buf + offset;
-  if (!header.Diserialize(cursor, buf_size)) {
-    AINFO << "header diserialize failed!";
+  const char *payload = nullptr;
+  if (!ParseFrame(buf, size, &header, &payload)) {
+    AINFO << "frame is malformed!";
+    statistics_.AddMalformedFrame();
     return false;
   }
+  statistics_.AddReceivedFrame(size);
 
   ADEBUG << "proto name : " << header.GetMsgName().c_str();
   ADEBUG << "proto sequence num: " << header.GetMsgID();
@@ -178,31 +149,20 @@ bool UDPBridgeReceiverComponent<T>::MsgHandle(int fd) {
   ADEBUG << "proto frame index: " << header.GetIndex();
 
   std::lock_guard<std::mutex> lock(mutex_);
+  ReportStatistics();
   BridgeProtoDiserializedBuf<T> *proto_buf = CreateBridgeProtoBuf(header);
   if (!proto_buf) {
     return false;
   }
 
-  cursor = total_buf + header_size;
-  if (header.GetFramePos() > header.GetMsgSize()) {
-    return false;
-  }
-  char *buf = proto_buf->GetBuf(header.GetFramePos());
-  // check cursor size
-  if (header.GetFrameSize() < 0 ||
-    header.GetFrameSize() > (total_recv - header_size)) {
-    return false;
-  }
-  // check buf size
-  if (header.GetFrameSize() > (header.GetMsgSize() - header.GetFramePos())) {
-    return false;
-  }
-  memcpy(buf, cursor, header.GetFrameSize());
+  memcpy(proto_buf->GetBuf(header.GetFramePos()), payload,
+         header.GetFrameSize());
   proto_buf->UpdateStatus(header.GetIndex());
   if (proto_buf->IsReadyDiserialize()) {
     auto pb_msg = std::make_shared<T>();
     proto_buf->Diserialized(pb_msg);
     writer_->Write(pb_msg);
+    statistics_.AddReceivedMessage();
     RemoveInvalidBuf(proto_buf->GetMsgID());
     RemoveItem(&proto_list_, proto_buf);
   }
@@ -221,6 +181,7 @@ bool UDPBridgeReceiverComponent<T>::RemoveInvalidBuf(uint32_t msg_id) {
       BridgeProtoDiserializedBuf<T> *tmp = *itor;
       FREE_POINTER(tmp);
       itor = proto_list_.erase(itor);
+      statistics_.AddDroppedMessages(1);
       continue;
     }
     ++itor;
@@ -228,6 +189,16 @@ bool UDPBridgeReceiverComponent<T>::RemoveInvalidBuf(uint32_t msg_id) {
   return true;
 }
 
+template <typename T>
+void UDPBridgeReceiverComponent<T>::ReportStatistics() {
+  std::string report;
+  if (FLAGS_bridge_statistics_interval > 0.0 &&
+      statistics_.Report(apollo::cyber::Clock::NowInSeconds(),
+                         FLAGS_bridge_statistics_interval, &report)) {
+    AINFO << proto_name_ << " " << report;
+  }
+}
+
 BRIDGE_RECV_IMPL(canbus::Chassis);
 }  // namespace bridge
 }  // namespace apollo
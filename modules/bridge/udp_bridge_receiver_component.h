@@ -35,6 +35,7 @@
 #include "modules/bridge/common/bridge_gflags.h"
 #include "modules/bridge/common/bridge_header.h"
 #include "modules/bridge/common/bridge_proto_diserialized_buf.h"
+#include "modules/bridge/common/bridge_statistics.h"
 #include "modules/bridge/common/udp_listener.h"
 #include "modules/common/monitor_log/monitor_log_buffer.h"
 
@@ -53,7 +54,7 @@ class UDPBridgeReceiverComponent final : public cyber::Component<> {
   bool Init() override;
 
   std::string Name() const { return FLAGS_bridge_module_name; }
-  bool MsgHandle(int fd);
+  bool MsgHandle(const char *buf, size_t size);
 
  private:
   bool InitSession(uint16_t port);
@@ -63,6 +64,7 @@ class UDPBridgeReceiverComponent final : public cyber::Component<> {
       const BridgeHeader &header);
   bool IsTimeout(double time_stamp);
   bool RemoveInvalidBuf(uint32_t msg_id);
+  void ReportStatistics();
 
  private:
   common::monitor::MonitorLogBuffer monitor_logger_buffer_;
@@ -72,6 +74,7 @@ class UDPBridgeReceiverComponent final : public cyber::Component<> {
   bool enable_timeout_ = true;
   std::shared_ptr<cyber::Writer<T>> writer_;
   std::mutex mutex_;
+  BridgeStatistics statistics_;
 
   std::shared_ptr<UDPListener<UDPBridgeReceiverComponent<T>>> listener_ =
       std::make_shared<UDPListener<UDPBridgeReceiverComponent<T>>>();
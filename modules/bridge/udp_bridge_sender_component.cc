@@ -16,6 +16,7 @@
 
 #include "modules/bridge/udp_bridge_sender_component.h"
 
+#include "cyber/time/clock.h"
 #include "modules/bridge/common/bridge_proto_serialized_buf.h"
 #include "modules/bridge/common/macro.h"
 #include "modules/bridge/common/util.h"
@@ -40,9 +41,30 @@ bool UDPBridgeSenderComponent<T>::Init() {
   remote_ip_ = udp_bridge_remote.remote_ip();
   remote_port_ = udp_bridge_remote.remote_port();
   proto_name_ = udp_bridge_remote.proto_name();
+  frame_size_from_mtu_ = udp_bridge_remote.frame_size_from_mtu();
   ADEBUG << "UDP Bridge remote ip is: " << remote_ip_;
   ADEBUG << "UDP Bridge remote port is: " << remote_port_;
   ADEBUG << "UDP Bridge for Proto is: " << proto_name_;
+  if (remote_port_ != 0 && !remote_ip_.empty() && !Connect()) {
+    AWARN << "connect to remote failed, retry on next message.";
+  }
+  return true;
+}
+
+template <typename T>
+bool UDPBridgeSenderComponent<T>::Connect() {
+  if (!sender_.Connect(remote_ip_, static_cast<uint16_t>(remote_port_))) {
+    return false;
+  }
+  frame_size_ = FRAME_SIZE;
+  if (frame_size_from_mtu_) {
+    size_t datagram_size = sender_.GetMaxDatagramSize();
+    if (datagram_size > 0) {
+      frame_size_ = BridgeProtoSerializedBuf<T>::GetFrameSizeFor(
+          datagram_size, proto_name_);
+    }
+  }
+  ADEBUG << "UDP Bridge frame size is: " << frame_size_;
   return true;
 }
 
@@ -58,30 +80,29 @@ bool UDPBridgeSenderComponent<T>::Proc(const std::shared_ptr<T> &pb_msg) {
     return false;
   }
 
-  struct sockaddr_in server_addr;
-  server_addr.sin_addr.s_addr = inet_addr(remote_ip_.c_str());
-  server_addr.sin_family = AF_INET;
-  server_addr.sin_port = htons(static_cast<uint16_t>(remote_port_));
-  int sock_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
-
-  int res =
-      connect(sock_fd, (struct sockaddr *)&server_addr, sizeof(server_addr));
-  if (res < 0) {
-    close(sock_fd);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!sender_.IsConnected() && !Connect()) {
     return false;
   }
 
   BridgeProtoSerializedBuf<T> proto_buf;
-  proto_buf.Serialize(pb_msg, proto_name_);
-  for (size_t j = 0; j < proto_buf.GetSerializedBufCount(); j++) {
-    ssize_t nbytes = send(sock_fd, proto_buf.GetSerializedBuf(j),
-                          proto_buf.GetSerializedBufSize(j), 0);
-    if (nbytes != static_cast<ssize_t>(proto_buf.GetSerializedBufSize(j))) {
-      break;
-    }
+  if (!proto_buf.Serialize(pb_msg, proto_name_, frame_size_)) {
+    return false;
+  }
+  size_t frames = sender_.Send(proto_buf);
+  size_t bytes = 0;
+  for (size_t j = 0; j < frames; j++) {
+    bytes += proto_buf.GetSerializedBufSize(j);
   }
-  close(sock_fd);
+  statistics_.AddSentMessage(frames, bytes,
+                             frames == proto_buf.GetSerializedBufCount());
 
+  std::string report;
+  if (FLAGS_bridge_statistics_interval > 0.0 &&
+      statistics_.Report(cyber::Clock::NowInSeconds(),
+                         FLAGS_bridge_statistics_interval, &report)) {
+    AINFO << proto_name_ << " " << report;
+  }
   return true;
 }
 
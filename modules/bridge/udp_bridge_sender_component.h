@@ -35,6 +35,8 @@
 #include "cyber/io/session.h"
 #include "cyber/scheduler/scheduler_factory.h"
 #include "modules/bridge/common/bridge_gflags.h"
+#include "modules/bridge/common/bridge_statistics.h"
+#include "modules/bridge/common/udp_frame_sender.h"
 #include "modules/common/monitor_log/monitor_log_buffer.h"
 #include "modules/common/util/util.h"
 
@@ -55,11 +57,18 @@ class UDPBridgeSenderComponent final : public cyber::Component<T> {
 
   std::string Name() const { return FLAGS_bridge_module_name; }
 
+ private:
+  bool Connect();
+
  private:
   common::monitor::MonitorLogBuffer monitor_logger_buffer_;
   unsigned int remote_port_ = 0;
   std::string remote_ip_ = "";
   std::string proto_name_ = "";
+  bool frame_size_from_mtu_ = false;
+  bsize frame_size_ = FRAME_SIZE;
+  UDPFrameSender sender_;
+  BridgeStatistics statistics_;
   std::mutex mutex_;
 };
 
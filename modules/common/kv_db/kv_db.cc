@@ -21,11 +21,21 @@
 
 #include "absl/strings/str_cat.h"
 #include "cyber/common/log.h"
+#include "modules/common/kv_db/log_kv_store.h"
 #include "modules/common/util/util.h"
 
 DEFINE_string(kv_db_path, "/apollo/data/kv_db.sqlite",
               "Path to Key-value DB file.");
 
+DEFINE_string(kv_db_backend, "sqlite",
+              "Key-value DB backend, should be sqlite or log.");
+
+DEFINE_string(kv_db_log_path, "/apollo/data/kv_db.log",
+              "Path to Key-value log file of the log backend.");
+
+DEFINE_bool(kv_db_log_sync, true,
+            "Whether the log backend syncs every write to disk.");
+
 namespace apollo {
 namespace common {
 namespace {
@@ -89,22 +99,60 @@ class SqliteWraper {
   sqlite3 *db_ = nullptr;
 };
 
+// The log backend keeps its index in memory, so it lives for the process.
+LogKVStore *GetLogKVStore() {
+  if (FLAGS_kv_db_backend != "log") {
+    return nullptr;
+  }
+  static LogKVStore *store =
+      new LogKVStore(FLAGS_kv_db_log_path, FLAGS_kv_db_log_sync);
+  return store;
+}
+
 }  // namespace
 
 bool KVDB::Put(std::string_view key, std::string_view value) {
+  if (auto *store = GetLogKVStore()) {
+    return store->Put(key, value);
+  }
   SqliteWraper sqlite;
   return sqlite.SQL(
       absl::StrCat("INSERT OR REPLACE INTO key_value (key, value) VALUES ('",
                    key, "', '", value, "');"));
 }
 
+bool KVDB::PutBatch(
+    const std::vector<std::pair<std::string, std::string>> &key_values) {
+  if (auto *store = GetLogKVStore()) {
+    std::vector<LogKVStore::Update> updates(key_values.begin(),
+                                            key_values.end());
+    return store->WriteBatch(updates);
+  }
+  SqliteWraper sqlite;
+  // A single transaction syncs once for the whole batch.
+  std::string sql = "BEGIN TRANSACTION;";
+  for (const auto &key_value : key_values) {
+    absl::StrAppend(
+        &sql, "INSERT OR REPLACE INTO key_value (key, value) VALUES ('",
+        key_value.first, "', '", key_value.second, "');");
+  }
+  absl::StrAppend(&sql, "COMMIT;");
+  return sqlite.SQL(sql);
+}
+
 bool KVDB::Delete(std::string_view key) {
+  if (auto *store = GetLogKVStore()) {
+    return store->Delete(key);
+  }
   SqliteWraper sqlite;
   return sqlite.SQL(
       absl::StrCat("DELETE FROM key_value WHERE key='", key, "';"));
 }
 
 std::optional<std::string> KVDB::Get(std::string_view key) {
+  if (auto *store = GetLogKVStore()) {
+    return store->Get(key);
+  }
   SqliteWraper sqlite;
   std::string value;
   const bool ret = sqlite.SQL(
@@ -118,6 +166,9 @@ std::optional<std::string> KVDB::Get(std::string_view key) {
 
 std::vector<std::pair<std::string, std::string>> KVDB::GetWithStart(
     std::string_view start) {
+  if (auto *store = GetLogKVStore()) {
+    return store->GetWithPrefix(start);
+  }
   SqliteWraper sqlite;
   std::vector<std::pair<std::string, std::string>> results;
 
@@ -34,6 +34,10 @@ namespace common {
  *
  * @brief Lightweight key-value database to store system-wide parameters.
  *        We prefer keys like "apollo:data:commit_id".
+ *
+ *        Data is kept in SQLite, or with --kv_db_backend=log in a
+ *        LogKVStore, which avoids SQL for every call. kv_db_migrate copies
+ *        the SQLite data into the log.
  */
 class KVDB {
  public:
@@ -43,6 +47,13 @@ class KVDB {
    */
   static bool Put(std::string_view key, std::string_view value);
 
+  /**
+   * @brief Store all {key, value} pairs to DB at once.
+   * @return Success or not.
+   */
+  static bool PutBatch(
+      const std::vector<std::pair<std::string, std::string>> &key_values);
+
   /**
    * @brief Delete a key.
    * @return Success or not.
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the SQLite and log backends of KVDB, e.g.
+//   kv_db_benchmark --kv_db_path=/tmp/kv_db.sqlite \
+//       --kv_db_log_path=/tmp/kv_db.log --num_keys=1000
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gflags/gflags.h"
+
+#include "modules/common/kv_db/kv_db.h"
+
+DEFINE_int32(num_keys, 1000, "Number of keys written and read.");
+DEFINE_int32(num_scans, 100, "Number of prefix scans.");
+
+DECLARE_string(kv_db_backend);
+
+using apollo::common::KVDB;
+
+namespace {
+
+void Measure(const std::string &name, const int ops,
+             const std::function<void()> &func) {
+  const auto begin = std::chrono::steady_clock::now();
+  func();
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+  std::printf("  %-12s %8d ops %10.3f ms %12.0f ops/s\n", name.c_str(), ops,
+              seconds * 1e3, ops / seconds);
+}
+
+std::string Key(const int i) {
+  return absl::StrCat("apollo:benchmark:", i % 10, ":", i);
+}
+
+void Run(const std::string &backend) {
+  FLAGS_kv_db_backend = backend;
+  std::printf("%s\n", backend.c_str());
+  const int num_keys = FLAGS_num_keys;
+  Measure("put", num_keys, [num_keys]() {
+    for (int i = 0; i < num_keys; ++i) {
+      KVDB::Put(Key(i), absl::StrCat("value_", i));
+    }
+  });
+  Measure("put_batch", num_keys, [num_keys]() {
+    std::vector<std::pair<std::string, std::string>> key_values;
+    for (int i = 0; i < num_keys; ++i) {
+      key_values.emplace_back(Key(i), absl::StrCat("batch_value_", i));
+    }
+    KVDB::PutBatch(key_values);
+  });
+  Measure("get", num_keys, [num_keys]() {
+    for (int i = 0; i < num_keys; ++i) {
+      KVDB::Get(Key(i));
+    }
+  });
+  Measure("prefix_scan", FLAGS_num_scans, []() {
+    for (int i = 0; i < FLAGS_num_scans; ++i) {
+      KVDB::GetWithStart(absl::StrCat("apollo:benchmark:", i % 10, ":"));
+    }
+  });
+  Measure("delete", num_keys, [num_keys]() {
+    for (int i = 0; i < num_keys; ++i) {
+      KVDB::Delete(Key(i));
+    }
+  });
+}
+
+}  // namespace
+
+int main(int32_t argc, char **argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  Run("sqlite");
+  Run("log");
+  return 0;
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Copies the key-values of the SQLite backend into the log backend, e.g.
+//   kv_db_migrate --kv_db_path=/apollo/data/kv_db.sqlite \
+//       --kv_db_log_path=/apollo/data/kv_db.log
+// after which processes can run with --kv_db_backend=log.
+
+#include <sqlite3.h>
+
+#include <iostream>
+
+#include "gflags/gflags.h"
+
+#include "cyber/common/log.h"
+#include "modules/common/kv_db/log_kv_store.h"
+
+DECLARE_string(kv_db_path);
+DECLARE_string(kv_db_log_path);
+
+using apollo::common::LogKVStore;
+
+int main(int32_t argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  sqlite3 *db = nullptr;
+  if (sqlite3_open_v2(FLAGS_kv_db_path.c_str(), &db, SQLITE_OPEN_READONLY,
+                      nullptr) != SQLITE_OK) {
+    AERROR << "Can't open Key-Value database: " << sqlite3_errmsg(db);
+    sqlite3_close(db);
+    return 1;
+  }
+  sqlite3_stmt *stmt = nullptr;
+  if (sqlite3_prepare_v2(db, "SELECT key, value FROM key_value;", -1, &stmt,
+                         nullptr) != SQLITE_OK) {
+    AERROR << "Failed to read Key-Value database: " << sqlite3_errmsg(db);
+    sqlite3_close(db);
+    return 1;
+  }
+  std::vector<LogKVStore::Update> updates;
+  int ret = SQLITE_ROW;
+  while ((ret = sqlite3_step(stmt)) == SQLITE_ROW) {
+    const auto *key =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    const auto *value =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+    if (key != nullptr && value != nullptr) {
+      updates.emplace_back(key, value);
+    }
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  if (ret != SQLITE_DONE) {
+    AERROR << "Failed to read Key-Value database " << FLAGS_kv_db_path;
+    return 1;
+  }
+
+  LogKVStore store(FLAGS_kv_db_log_path, true);
+  if (!store.WriteBatch(updates) || !store.Compact()) {
+    AERROR << "Failed to write Key-Value log " << FLAGS_kv_db_log_path;
+    return 1;
+  }
+  for (const auto &update : updates) {
+    if (store.Get(update.first) != update.second &&
+        !update.second->empty()) {
+      AERROR << "Key " << update.first << " was not migrated.";
+      return 1;
+    }
+  }
+  std::cout << "Migrated " << updates.size() << " keys from "
+            << FLAGS_kv_db_path << " to " << FLAGS_kv_db_log_path
+            << std::endl;
+  return 0;
+}
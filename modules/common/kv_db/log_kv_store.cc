@@ -0,0 +1,390 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/common/kv_db/log_kv_store.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace common {
+namespace {
+
+// Record layout, integers in host byte order:
+//   uint32 checksum of the rest of the record
+//   uint8  type
+//   uint32 key size
+//   uint32 value size
+//   key, value
+constexpr uint64_t kHeaderSize = 13;
+constexpr uint8_t kPut = 1;
+constexpr uint8_t kDelete = 2;
+
+// Logs smaller than this are never compacted.
+constexpr uint64_t kMinCompactionSize = 1 << 20;
+
+uint32_t Checksum(const char *data, const size_t size) {
+  // FNV-1a.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+void AppendRecord(const uint8_t type, std::string_view key,
+                  std::string_view value, std::string *records) {
+  const size_t begin = records->size();
+  records->resize(begin + kHeaderSize);
+  char *header = &(*records)[begin];
+  const uint32_t key_size = static_cast<uint32_t>(key.size());
+  const uint32_t value_size = static_cast<uint32_t>(value.size());
+  header[4] = static_cast<char>(type);
+  std::memcpy(header + 5, &key_size, sizeof(key_size));
+  std::memcpy(header + 9, &value_size, sizeof(value_size));
+  records->append(key);
+  records->append(value);
+  const uint32_t checksum = Checksum(records->data() + begin + 4,
+                                     records->size() - begin - 4);
+  std::memcpy(&(*records)[begin], &checksum, sizeof(checksum));
+}
+
+bool PWriteAll(const int fd, const char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    const ssize_t written = pwrite(fd, data, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+    offset += written;
+  }
+  return true;
+}
+
+bool PReadAll(const int fd, char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    const ssize_t read = pread(fd, data, size, offset);
+    if (read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (read <= 0) {
+      return false;
+    }
+    data += read;
+    size -= static_cast<size_t>(read);
+    offset += read;
+  }
+  return true;
+}
+
+}  // namespace
+
+LogKVStore::LogKVStore(const std::string &path, const bool sync)
+    : path_(path), sync_(sync) {
+  lock_fd_ = open((path_ + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC,
+                  0644);
+  if (lock_fd_ < 0) {
+    AERROR << "Can't open lock file of Key-Value log " << path_ << ": "
+           << std::strerror(errno);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Open();
+}
+
+LogKVStore::~LogKVStore() {
+  Close();
+  if (lock_fd_ >= 0) {
+    close(lock_fd_);
+  }
+}
+
+bool LogKVStore::Open() {
+  Close();
+  fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  struct stat file_stat;
+  if (fd_ < 0 || fstat(fd_, &file_stat) != 0) {
+    AERROR << "Can't open Key-Value log " << path_ << ": "
+           << std::strerror(errno);
+    Close();
+    return false;
+  }
+  inode_ = file_stat.st_ino;
+  return true;
+}
+
+void LogKVStore::Close() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+  fd_ = -1;
+  inode_ = 0;
+  end_ = 0;
+  garbage_size_ = 0;
+  index_.clear();
+}
+
+bool LogKVStore::Refresh() {
+  struct stat file_stat;
+  if (stat(path_.c_str(), &file_stat) != 0 || file_stat.st_ino != inode_) {
+    if (!Open()) {
+      return false;
+    }
+  }
+  if (fstat(fd_, &file_stat) != 0) {
+    return false;
+  }
+  const uint64_t size = static_cast<uint64_t>(file_stat.st_size);
+  if (size <= end_) {
+    return true;
+  }
+  std::string data(size - end_, '\0');
+  if (!PReadAll(fd_, &data[0], data.size(), static_cast<off_t>(end_))) {
+    AERROR << "Failed to read Key-Value log " << path_;
+    return false;
+  }
+  end_ += Index(data.data(), data.size(), end_);
+  return true;
+}
+
+uint64_t LogKVStore::Index(const char *data, const uint64_t size,
+                           const uint64_t offset) {
+  uint64_t pos = 0;
+  while (size - pos >= kHeaderSize) {
+    const char *header = data + pos;
+    uint32_t checksum = 0;
+    uint32_t key_size = 0;
+    uint32_t value_size = 0;
+    std::memcpy(&checksum, header, sizeof(checksum));
+    std::memcpy(&key_size, header + 5, sizeof(key_size));
+    std::memcpy(&value_size, header + 9, sizeof(value_size));
+    const uint64_t record_size = kHeaderSize + key_size + value_size;
+    // An incomplete or corrupted tail is left to be completed or truncated.
+    if (size - pos < record_size ||
+        Checksum(header + 4, record_size - 4) != checksum) {
+      break;
+    }
+
+    const uint8_t type = static_cast<uint8_t>(header[4]);
+    std::string_view key(header + kHeaderSize, key_size);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      garbage_size_ += iter->second.record_size;
+    }
+    if (type == kPut) {
+      Location location;
+      location.record_offset = offset + pos;
+      location.record_size = static_cast<uint32_t>(record_size);
+      location.value_size = value_size;
+      if (iter == index_.end()) {
+        index_.emplace(key, location);
+      } else {
+        iter->second = location;
+      }
+    } else {
+      if (iter != index_.end()) {
+        index_.erase(iter);
+      }
+      garbage_size_ += record_size;
+    }
+    pos += record_size;
+  }
+  return pos;
+}
+
+bool LogKVStore::WithWriterLock(const std::function<bool()> &func) {
+  if (lock_fd_ < 0) {
+    return false;
+  }
+  while (flock(lock_fd_, LOCK_EX) != 0) {
+    if (errno != EINTR) {
+      AERROR << "Failed to lock Key-Value log " << path_ << ": "
+             << std::strerror(errno);
+      return false;
+    }
+  }
+  const bool ret = func();
+  flock(lock_fd_, LOCK_UN);
+  return ret;
+}
+
+bool LogKVStore::Append(const std::string &records) {
+  const bool ret = WithWriterLock([this, &records]() {
+    if (!Refresh()) {
+      return false;
+    }
+    // Drop the tail left by a writer that died mid-record.
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) == 0 &&
+        static_cast<uint64_t>(file_stat.st_size) > end_ &&
+        ftruncate(fd_, static_cast<off_t>(end_)) != 0) {
+      return false;
+    }
+    if (!PWriteAll(fd_, records.data(), records.size(),
+                   static_cast<off_t>(end_)) ||
+        (sync_ && fdatasync(fd_) != 0)) {
+      AERROR << "Failed to write Key-Value log " << path_ << ": "
+             << std::strerror(errno);
+      return false;
+    }
+    end_ += Index(records.data(), records.size(), end_);
+    if (end_ >= kMinCompactionSize && garbage_size_ * 2 > end_) {
+      CompactLocked();
+    }
+    return true;
+  });
+  return ret;
+}
+
+bool LogKVStore::Put(std::string_view key, std::string_view value) {
+  std::string records;
+  AppendRecord(kPut, key, value, &records);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Append(records);
+}
+
+bool LogKVStore::Delete(std::string_view key) {
+  std::string records;
+  AppendRecord(kDelete, key, "", &records);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Append(records);
+}
+
+bool LogKVStore::WriteBatch(const std::vector<Update> &updates) {
+  if (updates.empty()) {
+    return true;
+  }
+  std::string records;
+  for (const auto &update : updates) {
+    if (update.second.has_value()) {
+      AppendRecord(kPut, update.first, *update.second, &records);
+    } else {
+      AppendRecord(kDelete, update.first, "", &records);
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Append(records);
+}
+
+bool LogKVStore::ReadValue(const Location &location,
+                           std::string *value) const {
+  value->resize(location.value_size);
+  return location.value_size == 0 ||
+         PReadAll(fd_, &(*value)[0], location.value_size,
+                  static_cast<off_t>(location.record_offset +
+                                     location.record_size -
+                                     location.value_size));
+}
+
+std::optional<std::string> LogKVStore::Get(std::string_view key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!Refresh()) {
+    return {};
+  }
+  auto iter = index_.find(key);
+  std::string value;
+  if (iter == index_.end() || !ReadValue(iter->second, &value) ||
+      value.empty()) {
+    return {};
+  }
+  return value;
+}
+
+std::vector<std::pair<std::string, std::string>> LogKVStore::GetWithPrefix(
+    std::string_view prefix) {
+  std::vector<std::pair<std::string, std::string>> results;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!Refresh()) {
+    return results;
+  }
+  for (auto iter = index_.lower_bound(prefix);
+       iter != index_.end() &&
+       std::string_view(iter->first).substr(0, prefix.size()) == prefix;
+       ++iter) {
+    std::string value;
+    if (ReadValue(iter->second, &value)) {
+      results.emplace_back(iter->first, std::move(value));
+    }
+  }
+  return results;
+}
+
+bool LogKVStore::Compact() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return WithWriterLock([this]() { return Refresh() && CompactLocked(); });
+}
+
+bool LogKVStore::CompactLocked() {
+  std::string records;
+  records.reserve(end_ - garbage_size_);
+  for (const auto &entry : index_) {
+    std::string value;
+    if (!ReadValue(entry.second, &value)) {
+      return false;
+    }
+    AppendRecord(kPut, entry.first, value, &records);
+  }
+
+  const std::string compact_path = path_ + ".compact";
+  const int fd =
+      open(compact_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+           0644);
+  if (fd < 0) {
+    AERROR << "Can't create " << compact_path << ": " << std::strerror(errno);
+    return false;
+  }
+  const bool written = PWriteAll(fd, records.data(), records.size(), 0) &&
+                       fdatasync(fd) == 0;
+  close(fd);
+  if (!written || rename(compact_path.c_str(), path_.c_str()) != 0) {
+    AERROR << "Failed to compact Key-Value log " << path_ << ": "
+           << std::strerror(errno);
+    unlink(compact_path.c_str());
+    return false;
+  }
+  AINFO << "Compacted Key-Value log " << path_ << " from " << end_ << " to "
+        << records.size() << " bytes.";
+  if (!Open()) {
+    return false;
+  }
+  end_ = Index(records.data(), records.size(), 0);
+  return true;
+}
+
+uint64_t LogKVStore::log_size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Refresh();
+  return end_;
+}
+
+uint64_t LogKVStore::garbage_size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Refresh();
+  return garbage_size_;
+}
+
+}  // namespace common
+}  // namespace apollo
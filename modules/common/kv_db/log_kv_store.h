@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace common {
+
+/**
+ * @class LogKVStore
+ *
+ * @brief Key-value store kept in an append-only log file with an in-memory
+ *        index from keys to value offsets.
+ *
+ * Every write appends checksummed records and syncs them once per batch.
+ * Reads look a key up in the index and read only its value. The index is
+ * ordered, so prefix scans are range scans.
+ *
+ * The log may be shared with other processes: writers serialize on a lock
+ * file next to the log, and each call first indexes whatever other
+ * processes appended since. Once superseded records make up most of the
+ * log, it is rewritten with the live records only and renamed over the old
+ * one, which readers notice by its inode.
+ */
+class LogKVStore {
+ public:
+  // A put, or a delete if there is no value.
+  using Update = std::pair<std::string, std::optional<std::string>>;
+
+  /**
+   * @param path Path of the log file, created if missing.
+   * @param sync Whether each write is synced to disk before returning.
+   */
+  LogKVStore(const std::string &path, const bool sync);
+  ~LogKVStore();
+
+  LogKVStore(const LogKVStore &) = delete;
+  LogKVStore &operator=(const LogKVStore &) = delete;
+
+  bool Put(std::string_view key, std::string_view value);
+
+  bool Delete(std::string_view key);
+
+  /**
+   * @brief Applies all updates with a single append and sync.
+   */
+  bool WriteBatch(const std::vector<Update> &updates);
+
+  std::optional<std::string> Get(std::string_view key);
+
+  std::vector<std::pair<std::string, std::string>> GetWithPrefix(
+      std::string_view prefix);
+
+  /**
+   * @brief Rewrites the log with the live records only.
+   */
+  bool Compact();
+
+  /**
+   * @brief Size of the log and of its superseded records, in bytes.
+   */
+  uint64_t log_size();
+  uint64_t garbage_size();
+
+ private:
+  struct Location {
+    uint64_t record_offset = 0;
+    uint32_t record_size = 0;
+    uint32_t value_size = 0;
+  };
+
+  bool Open();
+  void Close();
+  // Indexes the records appended by other processes, reopening the log if
+  // it was compacted. Needs mutex_.
+  bool Refresh();
+  // Indexes the complete records in data, which starts at offset, and
+  // returns the size they take.
+  uint64_t Index(const char *data, const uint64_t size, const uint64_t offset);
+  bool Append(const std::string &records);
+  bool CompactLocked();
+  bool ReadValue(const Location &location, std::string *value) const;
+  // Runs func with the writer lock file locked.
+  bool WithWriterLock(const std::function<bool()> &func);
+
+  const std::string path_;
+  const bool sync_;
+
+  std::mutex mutex_;
+  int fd_ = -1;
+  int lock_fd_ = -1;
+  ino_t inode_ = 0;
+  // End of the last indexed record.
+  uint64_t end_ = 0;
+  uint64_t garbage_size_ = 0;
+  std::map<std::string, Location, std::less<>> index_;
+};
+
+}  // namespace common
+}  // namespace apollo
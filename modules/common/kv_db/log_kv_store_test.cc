@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/common/kv_db/log_kv_store.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+
+class LogKVStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/log_kv_store_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    dir_ = dir;
+    path_ = dir_ + "/kv_db.log";
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+    std::remove((path_ + ".lock").c_str());
+    rmdir(dir_.c_str());
+  }
+
+  std::string dir_;
+  std::string path_;
+};
+
+TEST_F(LogKVStoreTest, CRUD) {
+  LogKVStore store(path_, false);
+  EXPECT_TRUE(store.Delete("test_key"));
+  EXPECT_FALSE(store.Get("test_key").has_value());
+
+  EXPECT_TRUE(store.Put("test_key", "val0"));
+  EXPECT_EQ("val0", store.Get("test_key").value());
+
+  EXPECT_TRUE(store.Put("test_key", "val1"));
+  EXPECT_EQ("val1", store.Get("test_key").value());
+
+  // Empty values read as missing, as with SQLite.
+  EXPECT_TRUE(store.Put("empty_key", ""));
+  EXPECT_FALSE(store.Get("empty_key").has_value());
+
+  EXPECT_TRUE(store.Delete("test_key"));
+  EXPECT_FALSE(store.Get("test_key").has_value());
+}
+
+TEST_F(LogKVStoreTest, BatchAndPrefix) {
+  LogKVStore store(path_, false);
+  EXPECT_TRUE(store.WriteBatch({{"apollo:a:1", "1"},
+                                {"apollo:a:2", "2"},
+                                {"apollo:ab", "3"},
+                                {"apollo:b:1", "4"},
+                                {"apollo:a:3", "5"},
+                                {"apollo:a:3", std::nullopt}}));
+  const auto results = store.GetWithPrefix("apollo:a:");
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ("apollo:a:1", results[0].first);
+  EXPECT_EQ("1", results[0].second);
+  EXPECT_EQ("apollo:a:2", results[1].first);
+  EXPECT_EQ(4, store.GetWithPrefix("").size());
+  EXPECT_TRUE(store.GetWithPrefix("apollo:c").empty());
+}
+
+TEST_F(LogKVStoreTest, Reopen) {
+  {
+    LogKVStore store(path_, true);
+    EXPECT_TRUE(store.Put("key", "val0"));
+    EXPECT_TRUE(store.Put("key", "val1"));
+    EXPECT_TRUE(store.Put("other", "val2"));
+  }
+  // A record torn by a crash is dropped.
+  const int fd = open(path_.c_str(), O_WRONLY | O_APPEND);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(5, write(fd, "\x01\x02\x03\x04\x01", 5));
+  close(fd);
+
+  LogKVStore store(path_, true);
+  EXPECT_EQ("val1", store.Get("key").value());
+  EXPECT_EQ("val2", store.Get("other").value());
+  EXPECT_TRUE(store.Put("new", "val3"));
+
+  LogKVStore reopened(path_, true);
+  EXPECT_EQ("val3", reopened.Get("new").value());
+  EXPECT_EQ("val1", reopened.Get("key").value());
+}
+
+TEST_F(LogKVStoreTest, SharedLog) {
+  LogKVStore writer(path_, false);
+  LogKVStore reader(path_, false);
+  EXPECT_FALSE(reader.Get("key").has_value());
+  EXPECT_TRUE(writer.Put("key", "val0"));
+  EXPECT_EQ("val0", reader.Get("key").value());
+  EXPECT_TRUE(reader.Put("key", "val1"));
+  EXPECT_EQ("val1", writer.Get("key").value());
+
+  // The reader notices that the log was replaced.
+  EXPECT_TRUE(writer.Compact());
+  EXPECT_TRUE(writer.Put("key2", "val2"));
+  EXPECT_EQ("val1", reader.Get("key").value());
+  EXPECT_EQ("val2", reader.Get("key2").value());
+}
+
+TEST_F(LogKVStoreTest, Compaction) {
+  LogKVStore store(path_, false);
+  const std::string value(1000, 'v');
+  for (int i = 0; i < 3000; ++i) {
+    EXPECT_TRUE(store.Put(absl::StrCat("key", i % 10), value));
+  }
+  // Compacted automatically once most of the log was garbage.
+  EXPECT_LT(store.log_size(), 1 << 20);
+  EXPECT_EQ(10, store.GetWithPrefix("key").size());
+
+  EXPECT_TRUE(store.Compact());
+  EXPECT_EQ(0, store.garbage_size());
+  EXPECT_EQ(value, store.Get("key3").value());
+}
+
+}  // namespace common
+}  // namespace apollo
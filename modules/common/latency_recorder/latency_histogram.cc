@@ -0,0 +1,241 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/latency_recorder/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace apollo {
+namespace common {
+
+namespace {
+
+constexpr uint64_t kMaxValue =
+    (uint64_t{1} << LatencyDistribution::kMaxValueBits) - 1;
+
+void UpdateMin(const uint64_t value, std::atomic<uint64_t>* min_value) {
+  uint64_t current = min_value->load(std::memory_order_relaxed);
+  while (value < current &&
+         !min_value->compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+void UpdateMax(const uint64_t value, std::atomic<uint64_t>* max_value) {
+  uint64_t current = max_value->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max_value->compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+int LatencyDistribution::BucketIndex(const uint64_t duration) {
+  const uint64_t value = std::min(duration, kMaxValue);
+  if (value < static_cast<uint64_t>(kSubBucketNum)) {
+    return static_cast<int>(value);
+  }
+  const int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+  return (shift + 1) * kSubBucketNum +
+         static_cast<int>(value >> shift) - kSubBucketNum;
+}
+
+uint64_t LatencyDistribution::BucketLowerBound(const int index) {
+  if (index < kSubBucketNum) {
+    return static_cast<uint64_t>(index);
+  }
+  const int shift = index / kSubBucketNum - 1;
+  return static_cast<uint64_t>(index % kSubBucketNum + kSubBucketNum)
+         << shift;
+}
+
+uint64_t LatencyDistribution::BucketUpperBound(const int index) {
+  return index + 1 < kBucketNum ? BucketLowerBound(index + 1) - 1 : kMaxValue;
+}
+
+LatencyDistribution::LatencyDistribution() : counts_(kBucketNum, 0) {}
+
+void LatencyDistribution::Add(const uint64_t duration) {
+  ++counts_[BucketIndex(duration)];
+  ++sample_size_;
+  min_duration_ = std::min(min_duration_, duration);
+  max_duration_ = std::max(max_duration_, duration);
+  sum_duration_ += duration;
+}
+
+void LatencyDistribution::Merge(const LatencyDistribution& other) {
+  if (other.sample_size_ == 0) {
+    return;
+  }
+  for (int i = 0; i < kBucketNum; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  sample_size_ += other.sample_size_;
+  min_duration_ = std::min(min_duration_, other.min_duration_);
+  max_duration_ = std::max(max_duration_, other.max_duration_);
+  sum_duration_ += other.sum_duration_;
+}
+
+void LatencyDistribution::Merge(const LatencyHistogram& histogram) {
+  const int size =
+      std::min(histogram.bucket_index_size(), histogram.bucket_count_size());
+  uint64_t sample_size = 0;
+  for (int i = 0; i < size; ++i) {
+    const uint32_t index = histogram.bucket_index(i);
+    if (index >= static_cast<uint32_t>(kBucketNum)) {
+      continue;
+    }
+    counts_[index] += histogram.bucket_count(i);
+    sample_size += histogram.bucket_count(i);
+  }
+  if (sample_size == 0) {
+    return;
+  }
+  sample_size_ += sample_size;
+  min_duration_ = std::min(min_duration_, histogram.min_duration());
+  max_duration_ = std::max(max_duration_, histogram.max_duration());
+  sum_duration_ += histogram.sum_duration();
+}
+
+void LatencyDistribution::Clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  sample_size_ = 0;
+  min_duration_ = std::numeric_limits<uint64_t>::max();
+  max_duration_ = 0;
+  sum_duration_ = 0;
+}
+
+void LatencyDistribution::ToProto(LatencyHistogram* histogram) const {
+  histogram->clear_bucket_index();
+  histogram->clear_bucket_count();
+  for (int i = 0; i < kBucketNum; ++i) {
+    if (counts_[i] != 0) {
+      histogram->add_bucket_index(static_cast<uint32_t>(i));
+      histogram->add_bucket_count(counts_[i]);
+    }
+  }
+  if (sample_size_ == 0) {
+    histogram->clear_min_duration();
+    histogram->clear_max_duration();
+    histogram->clear_sum_duration();
+    return;
+  }
+  histogram->set_min_duration(min_duration_);
+  histogram->set_max_duration(max_duration_);
+  histogram->set_sum_duration(sum_duration_);
+}
+
+void LatencyDistribution::ToStat(LatencyStat* stat) const {
+  stat->set_sample_size(static_cast<uint32_t>(sample_size_));
+  if (sample_size_ == 0) {
+    stat->clear_min_duration();
+    stat->set_max_duration(0);
+    stat->set_aver_duration(0);
+    return;
+  }
+  stat->set_min_duration(min_duration_);
+  stat->set_max_duration(max_duration_);
+  stat->set_aver_duration(sum_duration_ / sample_size_);
+  stat->set_p50_duration(Percentile(0.5));
+  stat->set_p90_duration(Percentile(0.9));
+  stat->set_p99_duration(Percentile(0.99));
+}
+
+uint64_t LatencyDistribution::Percentile(const double quantile) const {
+  if (sample_size_ == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(
+          std::min(std::max(quantile, 0.0), 1.0) * sample_size_)),
+      1);
+  uint64_t seen = 0;
+  for (int i = 0; i < kBucketNum; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const uint64_t lower = BucketLowerBound(i);
+      const uint64_t middle = lower + (BucketUpperBound(i) - lower) / 2;
+      return std::min(std::max(middle, min_duration_), max_duration_);
+    }
+  }
+  return max_duration_;
+}
+
+int ConcurrentLatencyDistribution::ShardIndex() {
+  static std::atomic<int> next_shard{0};
+  thread_local const int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kShardNum;
+  return shard;
+}
+
+void ConcurrentLatencyDistribution::Add(const uint64_t duration) {
+  Shard& shard = shards_[ShardIndex()];
+  shard.counts[LatencyDistribution::BucketIndex(duration)].fetch_add(
+      1, std::memory_order_relaxed);
+  shard.sum_duration.fetch_add(duration, std::memory_order_relaxed);
+  UpdateMin(duration, &shard.min_duration);
+  UpdateMax(duration, &shard.max_duration);
+}
+
+void ConcurrentLatencyDistribution::Drain(LatencyDistribution* distribution) {
+  for (Shard& shard : shards_) {
+    uint64_t sample_size = 0;
+    for (int i = 0; i < LatencyDistribution::kBucketNum; ++i) {
+      if (shard.counts[i].load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      const uint64_t count =
+          shard.counts[i].exchange(0, std::memory_order_relaxed);
+      distribution->counts_[i] += count;
+      sample_size += count;
+    }
+    const uint64_t sum =
+        shard.sum_duration.exchange(0, std::memory_order_relaxed);
+    const uint64_t min_duration = shard.min_duration.exchange(
+        std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    const uint64_t max_duration =
+        shard.max_duration.exchange(0, std::memory_order_relaxed);
+    if (sample_size == 0) {
+      continue;
+    }
+    distribution->sample_size_ += sample_size;
+    distribution->sum_duration_ += sum;
+    distribution->min_duration_ =
+        std::min(distribution->min_duration_, min_duration);
+    distribution->max_duration_ =
+        std::max(distribution->max_duration_, max_duration);
+  }
+  if (distribution->sample_size_ == 0 ||
+      distribution->min_duration_ <= distribution->max_duration_) {
+    return;
+  }
+  // Only latencies still being added were drained, fall back to the bounds
+  // of their buckets.
+  const auto& counts = distribution->counts_;
+  const auto first = std::find_if(counts.begin(), counts.end(),
+                                  [](const uint64_t count) { return count; });
+  const auto last = std::find_if(counts.rbegin(), counts.rend(),
+                                 [](const uint64_t count) { return count; });
+  distribution->min_duration_ = LatencyDistribution::BucketLowerBound(
+      static_cast<int>(first - counts.begin()));
+  distribution->max_duration_ = LatencyDistribution::BucketUpperBound(
+      static_cast<int>(counts.rend() - last - 1));
+}
+
+}  // namespace common
+}  // namespace apollo
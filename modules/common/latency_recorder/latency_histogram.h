@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Latency histograms with log-linear buckets.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "modules/common/latency_recorder/proto/latency_record.pb.h"
+
+namespace apollo {
+namespace common {
+
+/**
+ * @class LatencyDistribution
+ * @brief Counts latencies in HDR-style buckets: 32 linear sub-buckets per
+ * power of two, so a percentile is off by at most 1/32 of its value.
+ * Latencies of 2^36 ns (about 68 s) and more share the last bucket.
+ *
+ * Not thread-safe.
+ */
+class LatencyDistribution {
+ public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int kSubBucketNum = 1 << kSubBucketBits;
+  static constexpr int kMaxValueBits = 36;
+  static constexpr int kBucketNum =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBucketNum;
+
+  static int BucketIndex(const uint64_t duration);
+  static uint64_t BucketLowerBound(const int index);
+  static uint64_t BucketUpperBound(const int index);
+
+  LatencyDistribution();
+
+  void Add(const uint64_t duration);
+
+  void Merge(const LatencyDistribution& other);
+  void Merge(const LatencyHistogram& histogram);
+
+  void Clear();
+
+  /**
+   * @brief Writes the non-empty buckets and summary values, the time window
+   * is left to the caller.
+   */
+  void ToProto(LatencyHistogram* histogram) const;
+
+  /**
+   * @brief Fills min, max, average, percentiles and sample size.
+   */
+  void ToStat(LatencyStat* stat) const;
+
+  /**
+   * @param quantile In [0, 1].
+   * @return Midpoint of the bucket holding the quantile, clamped to
+   * [min, max], or 0 if empty.
+   */
+  uint64_t Percentile(const double quantile) const;
+
+  uint64_t sample_size() const { return sample_size_; }
+  uint64_t min_duration() const { return min_duration_; }
+  uint64_t max_duration() const { return max_duration_; }
+  uint64_t sum_duration() const { return sum_duration_; }
+
+ private:
+  friend class ConcurrentLatencyDistribution;
+
+  std::vector<uint64_t> counts_;
+  uint64_t sample_size_ = 0;
+  uint64_t min_duration_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_duration_ = 0;
+  uint64_t sum_duration_ = 0;
+};
+
+/**
+ * @class ConcurrentLatencyDistribution
+ * @brief A LatencyDistribution that any number of threads add to without
+ * locking. Each thread counts into one of a few shards of relaxed atomic
+ * counters, and Drain() moves everything counted so far into a
+ * LatencyDistribution.
+ *
+ * A latency added while Drain() runs may have its bucket and its sum
+ * reported by different drains.
+ */
+class ConcurrentLatencyDistribution {
+ public:
+  ConcurrentLatencyDistribution() = default;
+
+  void Add(const uint64_t duration);
+
+  /**
+   * @brief Merges the latencies added since the previous drain into
+   * distribution and resets the counters.
+   */
+  void Drain(LatencyDistribution* distribution);
+
+ private:
+  static constexpr int kShardNum = 8;
+
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, LatencyDistribution::kBucketNum>
+        counts{};
+    std::atomic<uint64_t> min_duration{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> max_duration{0};
+    std::atomic<uint64_t> sum_duration{0};
+  };
+
+  static int ShardIndex();
+
+  std::array<Shard, kShardNum> shards_;
+};
+
+}  // namespace common
+}  // namespace apollo
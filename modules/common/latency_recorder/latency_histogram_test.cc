@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/latency_recorder/latency_histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+
+TEST(LatencyDistributionTest, Buckets) {
+  uint64_t last_upper_bound = 0;
+  for (int i = 0; i < LatencyDistribution::kBucketNum; ++i) {
+    const uint64_t lower = LatencyDistribution::BucketLowerBound(i);
+    const uint64_t upper = LatencyDistribution::BucketUpperBound(i);
+    EXPECT_EQ(i == 0 ? 0 : last_upper_bound + 1, lower);
+    EXPECT_LE(lower, upper);
+    EXPECT_EQ(i, LatencyDistribution::BucketIndex(lower));
+    EXPECT_EQ(i, LatencyDistribution::BucketIndex(upper));
+    // Relative width stays within 1 / 32.
+    EXPECT_LE((upper - lower) * LatencyDistribution::kSubBucketNum, lower);
+    last_upper_bound = upper;
+  }
+  EXPECT_EQ(LatencyDistribution::kBucketNum - 1,
+            LatencyDistribution::BucketIndex(UINT64_MAX));
+}
+
+TEST(LatencyDistributionTest, Percentile) {
+  LatencyDistribution distribution;
+  EXPECT_EQ(0, distribution.Percentile(0.5));
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    distribution.Add(i * 1000);
+  }
+  EXPECT_EQ(1000, distribution.sample_size());
+  EXPECT_EQ(1000, distribution.min_duration());
+  EXPECT_EQ(1000000, distribution.max_duration());
+  EXPECT_NEAR(500000.0, distribution.Percentile(0.5), 500000.0 / 32);
+  EXPECT_NEAR(990000.0, distribution.Percentile(0.99), 990000.0 / 32);
+  EXPECT_EQ(1000, distribution.Percentile(0.0));
+  EXPECT_EQ(1000000, distribution.Percentile(1.0));
+
+  LatencyStat stat;
+  distribution.ToStat(&stat);
+  EXPECT_EQ(500500, stat.aver_duration());
+  EXPECT_EQ(1000, stat.sample_size());
+  EXPECT_EQ(distribution.Percentile(0.9), stat.p90_duration());
+}
+
+TEST(LatencyDistributionTest, ProtoRoundTrip) {
+  LatencyDistribution distribution;
+  distribution.Add(10);
+  distribution.Add(10);
+  distribution.Add(5000000);
+
+  LatencyHistogram histogram;
+  distribution.ToProto(&histogram);
+  EXPECT_EQ(2, histogram.bucket_index_size());
+  EXPECT_EQ(2, histogram.bucket_count(0));
+
+  LatencyDistribution merged;
+  merged.Add(20);
+  merged.Merge(histogram);
+  EXPECT_EQ(4, merged.sample_size());
+  EXPECT_EQ(10, merged.min_duration());
+  EXPECT_EQ(5000000, merged.max_duration());
+  EXPECT_EQ(5000040, merged.sum_duration());
+
+  // Empty histograms do not touch min and max.
+  merged.Merge(LatencyHistogram());
+  EXPECT_EQ(10, merged.min_duration());
+}
+
+TEST(ConcurrentLatencyDistributionTest, Drain) {
+  ConcurrentLatencyDistribution concurrent;
+  constexpr int kThreadNum = 4;
+  constexpr uint64_t kLatencyNum = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&concurrent, t]() {
+      for (uint64_t i = 1; i <= kLatencyNum; ++i) {
+        concurrent.Add(i + t);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  LatencyDistribution distribution;
+  concurrent.Drain(&distribution);
+  EXPECT_EQ(kThreadNum * kLatencyNum, distribution.sample_size());
+  EXPECT_EQ(1, distribution.min_duration());
+  EXPECT_EQ(kLatencyNum + kThreadNum - 1, distribution.max_duration());
+
+  // Everything was drained.
+  LatencyDistribution empty;
+  concurrent.Drain(&empty);
+  EXPECT_EQ(0, empty.sample_size());
+  concurrent.Add(7);
+  concurrent.Drain(&empty);
+  EXPECT_EQ(1, empty.sample_size());
+  EXPECT_EQ(7, empty.min_duration());
+}
+
+}  // namespace common
+}  // namespace apollo
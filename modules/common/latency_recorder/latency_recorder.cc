@@ -19,12 +19,48 @@
 #include "modules/common/adapters/adapter_gflags.h"
 #include "modules/common/util/message_util.h"
 
+DEFINE_bool(latency_recording_aggregated, true,
+            "Publish latency histograms with sampled records instead of "
+            "every latency record.");
+
+DEFINE_int32(latency_trace_sample_interval, 10,
+             "One in this many messages is traced in aggregated mode.");
+
+DEFINE_int32(latency_trace_capacity, 256,
+             "Max traced and outlier records per publish in aggregated "
+             "mode.");
+
 using apollo::cyber::Clock;
 using apollo::cyber::Time;
 
 namespace apollo {
 namespace common {
 
+namespace {
+
+const apollo::cyber::Duration kPublishInterval(3.0);
+
+// Message ids are mostly sensor timestamps, whose low digits are often
+// constant, so they are mixed before sampling. All modules pick the same
+// messages.
+bool IsTraced(const uint64_t message_id) {
+  if (FLAGS_latency_trace_sample_interval <= 1) {
+    return true;
+  }
+  uint64_t hash = message_id;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash % FLAGS_latency_trace_sample_interval == 0;
+}
+
+// Outliers are only looked for once the p99 is based on enough samples.
+constexpr uint64_t kMinOutlierSampleSize = 100;
+
+}  // namespace
+
 LatencyRecorder::LatencyRecorder(const std::string& module_name)
     : module_name_(module_name) {
   records_.reset(new LatencyRecordMap);
@@ -57,6 +93,11 @@ void LatencyRecorder::AppendLatencyRecord(const uint64_t message_id,
     return;
   }
 
+  if (FLAGS_latency_recording_aggregated) {
+    AppendAggregatedRecord(message_id, begin_time, end_time, writer);
+    return;
+  }
+
   std::lock_guard<std::mutex> lock(mutex_);
 
   auto* latency_record = records_->add_latency_records();
@@ -65,7 +106,6 @@ void LatencyRecorder::AppendLatencyRecord(const uint64_t message_id,
   latency_record->set_message_id(message_id);
 
   const auto now = Clock::Now();
-  const apollo::cyber::Duration kPublishInterval(3.0);
   if (now - current_time_ > kPublishInterval) {
     PublishLatencyRecords(writer);
     current_time_ = now;
@@ -100,5 +140,68 @@ void LatencyRecorder::PublishLatencyRecords(
   records_.reset(new LatencyRecordMap);
 }
 
+void LatencyRecorder::AppendAggregatedRecord(
+    const uint64_t message_id, const Time& begin_time, const Time& end_time,
+    const std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>>& writer) {
+  const uint64_t duration = (end_time - begin_time).ToNanosecond();
+  histogram_.Add(duration);
+
+  if (IsTraced(message_id) ||
+      duration > outlier_threshold_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (records_->latency_records_size() < FLAGS_latency_trace_capacity) {
+      auto* latency_record = records_->add_latency_records();
+      latency_record->set_begin_time(begin_time.ToNanosecond());
+      latency_record->set_end_time(end_time.ToNanosecond());
+      latency_record->set_message_id(message_id);
+    }
+  }
+
+  const uint64_t now = Clock::Now().ToNanosecond();
+  uint64_t window_begin_time =
+      window_begin_time_.load(std::memory_order_relaxed);
+  if (window_begin_time == 0) {
+    window_begin_time_.compare_exchange_strong(window_begin_time, now);
+    return;
+  }
+  if (now - window_begin_time <= kPublishInterval.ToNanosecond()) {
+    return;
+  }
+  // Whoever fails to take the lock leaves the publishing to its owner.
+  std::unique_lock<std::mutex> lock(publish_mutex_, std::try_to_lock);
+  if (lock.owns_lock() &&
+      window_begin_time_.load(std::memory_order_relaxed) ==
+          window_begin_time) {
+    PublishHistogram(now, writer);
+  }
+}
+
+void LatencyRecorder::PublishHistogram(
+    const uint64_t now,
+    const std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>>& writer) {
+  histogram_delta_.Clear();
+  histogram_.Drain(&histogram_delta_);
+  if (histogram_delta_.sample_size() >= kMinOutlierSampleSize) {
+    outlier_threshold_.store(histogram_delta_.Percentile(0.99),
+                             std::memory_order_relaxed);
+  }
+
+  std::unique_ptr<LatencyRecordMap> records(new LatencyRecordMap);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records.swap(records_);
+  }
+  auto* histogram = records->mutable_latency_histogram();
+  histogram_delta_.ToProto(histogram);
+  histogram->set_begin_time(
+      window_begin_time_.load(std::memory_order_relaxed));
+  histogram->set_end_time(now);
+  window_begin_time_.store(now, std::memory_order_relaxed);
+
+  records->set_module_name(module_name_);
+  apollo::common::util::FillHeader("LatencyRecorderMap", records.get());
+  writer->Write(*records);
+}
+
 }  // namespace common
 }  // namespace apollo
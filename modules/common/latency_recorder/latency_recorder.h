@@ -16,17 +16,31 @@
 
 #pragma once
 
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
 
 #include "cyber/cyber.h"
 
+#include "modules/common/latency_recorder/latency_histogram.h"
 #include "modules/common/latency_recorder/proto/latency_record.pb.h"
 
 namespace apollo {
 namespace common {
 
+/**
+ * @class LatencyRecorder
+ * @brief Publishes the latencies of a module on the latency recording topic
+ * every few seconds.
+ *
+ * With --latency_recording_aggregated, latencies are counted into a
+ * histogram without locking and only a delta of it is published, together
+ * with the records of sampled messages, which all modules trace alike, and
+ * of outliers slower than the previous p99. Otherwise every record is
+ * published.
+ */
 class LatencyRecorder {
  public:
   explicit LatencyRecorder(const std::string& module_name);
@@ -40,12 +54,27 @@ class LatencyRecorder {
   std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>> CreateWriter();
   void PublishLatencyRecords(
       const std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>>& writer);
+  void AppendAggregatedRecord(
+      const uint64_t message_id, const apollo::cyber::Time& begin_time,
+      const apollo::cyber::Time& end_time,
+      const std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>>& writer);
+  void PublishHistogram(
+      const uint64_t now,
+      const std::shared_ptr<apollo::cyber::Writer<LatencyRecordMap>>& writer);
 
   std::string module_name_;
   std::mutex mutex_;
   std::unique_ptr<LatencyRecordMap> records_;
   apollo::cyber::Time current_time_;
   std::shared_ptr<apollo::cyber::Node> node_;
+
+  // Aggregated mode.
+  ConcurrentLatencyDistribution histogram_;
+  LatencyDistribution histogram_delta_;
+  std::mutex publish_mutex_;
+  std::atomic<uint64_t> window_begin_time_{0};
+  std::atomic<uint64_t> outlier_threshold_{
+      std::numeric_limits<uint64_t>::max()};
 };
 
 }  // namespace common
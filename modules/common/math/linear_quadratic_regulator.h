@@ -21,7 +21,11 @@
 
 #pragma once
 
+#include <cmath>
+#include <limits>
+
 #include "Eigen/Core"
+#include "Eigen/LU"
 
 /**
  * @namespace apollo::common::math
@@ -64,6 +68,43 @@ void SolveLQRProblem(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B,
                      const double tolerance, const uint max_num_iteration,
                      Eigen::MatrixXd *ptr_K);
 
+/**
+ * @brief Solver for discrete-time linear quadratic problem with matrices of
+ *        compile-time sizes, which avoids the heap allocations of the
+ *        dynamic-size solver in every Riccati iteration.
+ * @param A The system dynamic matrix
+ * @param B The control matrix
+ * @param Q The cost matrix for system state
+ * @param R The cost matrix for control output
+ * @param tolerance The numerical tolerance for solving Discrete
+ *        Algebraic Riccati equation (DARE)
+ * @param max_num_iteration The maximum iterations for solving ARE
+ * @param ptr_K The feedback control matrix (pointer)
+ */
+template <int N, int M>
+void SolveLQRProblem(const Eigen::Matrix<double, N, N> &A,
+                     const Eigen::Matrix<double, N, M> &B,
+                     const Eigen::Matrix<double, N, N> &Q,
+                     const Eigen::Matrix<double, M, M> &R,
+                     const double tolerance, const uint max_num_iteration,
+                     Eigen::Matrix<double, M, N> *ptr_K) {
+  static_assert(N > 0 && M > 0, "Use the dynamic-size solver instead.");
+  const Eigen::Matrix<double, N, N> AT = A.transpose();
+  const Eigen::Matrix<double, M, N> BT = B.transpose();
+
+  Eigen::Matrix<double, N, N> P = Q;
+  uint num_iteration = 0;
+  double diff = std::numeric_limits<double>::max();
+  while (num_iteration++ < max_num_iteration && diff > tolerance) {
+    const Eigen::Matrix<double, N, N> P_next =
+        AT * P * A - AT * P * B * (R + BT * P * B).inverse() * BT * P * A + Q;
+    // check the difference between P and P_next
+    diff = std::fabs((P_next - P).maxCoeff());
+    P = P_next;
+  }
+  *ptr_K = (R + BT * P * B).inverse() * BT * P * A;
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
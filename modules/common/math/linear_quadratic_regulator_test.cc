@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/linear_quadratic_regulator.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+TEST(LinearQuadraticRegulatorTest, FixedSizeMatchesDynamicSize) {
+  Eigen::Matrix4d A;
+  A << 1.0, 0.01, 0.0, 0.0, 0.0, 0.9, 0.2, 0.0, 0.0, 0.0, 1.0, 0.01, 0.0, 0.05,
+      -0.1, 0.8;
+  Eigen::Matrix<double, 4, 1> B;
+  B << 0.0, 0.05, 0.0, 0.1;
+  Eigen::Matrix4d Q = Eigen::Matrix4d::Zero();
+  Q(0, 0) = 0.05;
+  Q(2, 2) = 1.0;
+  Eigen::Matrix<double, 1, 1> R = Eigen::Matrix<double, 1, 1>::Identity();
+
+  Eigen::Matrix<double, 1, 4> fixed_K;
+  SolveLQRProblem<4, 1>(A, B, Q, R, 1e-6, 1000, &fixed_K);
+
+  Eigen::MatrixXd dynamic_K;
+  SolveLQRProblem(Eigen::MatrixXd(A), Eigen::MatrixXd(B), Eigen::MatrixXd(Q),
+                  Eigen::MatrixXd(R), 1e-6, 1000, &dynamic_K);
+
+  ASSERT_EQ(1, dynamic_K.rows());
+  ASSERT_EQ(4, dynamic_K.cols());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NEAR(dynamic_K(0, i), fixed_K(0, i), 1e-9);
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -104,77 +104,52 @@ void MpcOsqp::CalculateGradient() {
   ADEBUG << gradient_;
 }
 
-// equality constraints x(k+1) = A*x(k)
+// equality constraints x(k+1) = A*x(k) + B*u(k), followed by the identity
+// rows of the state and control bounds. The csc matrix is built column by
+// column, so the sparsity pattern only depends on the non-zeros of A and B.
 void MpcOsqp::CalculateEqualityConstraint(std::vector<c_float> *A_data,
                                           std::vector<c_int> *A_indices,
                                           std::vector<c_int> *A_indptr) {
   static constexpr double kEpsilon = 1e-6;
-  // block matrix
-  Eigen::MatrixXd matrix_constraint = Eigen::MatrixXd::Zero(
-      state_dim_ * (horizon_ + 1) + state_dim_ * (horizon_ + 1) +
-          control_dim_ * horizon_,
-      state_dim_ * (horizon_ + 1) + control_dim_ * horizon_);
-  Eigen::MatrixXd state_identity_mat = Eigen::MatrixXd::Identity(
-      state_dim_ * (horizon_ + 1), state_dim_ * (horizon_ + 1));
-  ADEBUG << "state_identity_mat" << state_identity_mat;
-
-  matrix_constraint.block(0, 0, state_dim_ * (horizon_ + 1),
-                          state_dim_ * (horizon_ + 1)) =
-      -1 * state_identity_mat;
-  ADEBUG << "matrix_constraint";
-  ADEBUG << matrix_constraint;
-
-  Eigen::MatrixXd control_identity_mat =
-      Eigen::MatrixXd::Identity(control_dim_, control_dim_);
-
-  for (size_t i = 0; i < horizon_; i++) {
-    matrix_constraint.block((i + 1) * state_dim_, i * state_dim_, state_dim_,
-                            state_dim_) = matrix_a_;
-  }
-  ADEBUG << "matrix_constraint with A";
-  ADEBUG << matrix_constraint;
-
-  for (size_t i = 0; i < horizon_; i++) {
-    matrix_constraint.block((i + 1) * state_dim_,
-                            i * control_dim_ + (horizon_ + 1) * state_dim_,
-                            state_dim_, control_dim_) = matrix_b_;
-  }
-  ADEBUG << "matrix_constraint with B";
-  ADEBUG << matrix_constraint;
-
-  Eigen::MatrixXd all_identity_mat =
-      Eigen::MatrixXd::Identity(num_param_, num_param_);
-
-  matrix_constraint.block(state_dim_ * (horizon_ + 1), 0, num_param_,
-                          num_param_) = all_identity_mat;
-  ADEBUG << "matrix_constraint with I";
-  ADEBUG << matrix_constraint;
+  const size_t state_total_dim = state_dim_ * (horizon_ + 1);
+  A_data->clear();
+  A_indices->clear();
+  A_indptr->clear();
+  auto add_value = [&](const size_t row, const double value) {
+    A_data->emplace_back(value);
+    A_indices->emplace_back(row);
+  };
 
-  std::vector<std::vector<std::pair<c_int, c_float>>> columns;
-  columns.resize(num_param_ + 1);
-  int value_index = 0;
-  // state and terminal state
-  for (size_t i = 0; i < num_param_; ++i) {  // col
-    for (size_t j = 0; j < num_param_ + state_dim_ * (horizon_ + 1);
-         ++j)  // row
-      if (std::fabs(matrix_constraint(j, i)) > kEpsilon) {
-        // (row, val)
-        columns[i].emplace_back(j, matrix_constraint(j, i));
-        ++value_index;
+  // state columns
+  for (size_t i = 0; i <= horizon_; ++i) {
+    for (size_t k = 0; k < state_dim_; ++k) {
+      A_indptr->emplace_back(A_data->size());
+      add_value(i * state_dim_ + k, -1.0);
+      if (i < horizon_) {
+        for (size_t r = 0; r < state_dim_; ++r) {
+          if (std::fabs(matrix_a_(r, k)) > kEpsilon) {
+            add_value((i + 1) * state_dim_ + r, matrix_a_(r, k));
+          }
+        }
       }
+      add_value(state_total_dim + i * state_dim_ + k, 1.0);
+    }
   }
-  ADEBUG << "value_index";
-  ADEBUG << value_index;
-  int ind_A = 0;
-  for (size_t i = 0; i < num_param_; ++i) {
-    A_indptr->emplace_back(ind_A);
-    for (const auto &row_data_pair : columns[i]) {
-      A_data->emplace_back(row_data_pair.second);    // value
-      A_indices->emplace_back(row_data_pair.first);  // row
-      ++ind_A;
+  // control columns
+  for (size_t i = 0; i < horizon_; ++i) {
+    for (size_t k = 0; k < control_dim_; ++k) {
+      A_indptr->emplace_back(A_data->size());
+      for (size_t r = 0; r < state_dim_; ++r) {
+        if (std::fabs(matrix_b_(r, k)) > kEpsilon) {
+          add_value((i + 1) * state_dim_ + r, matrix_b_(r, k));
+        }
+      }
+      add_value(2 * state_total_dim + i * control_dim_ + k, 1.0);
     }
   }
-  A_indptr->emplace_back(ind_A);
+  A_indptr->emplace_back(A_data->size());
+  ADEBUG << "value_index";
+  ADEBUG << A_data->size();
 }
 
 void MpcOsqp::CalculateConstraintVectors() {
@@ -216,126 +191,84 @@ void MpcOsqp::CalculateConstraintVectors() {
   ADEBUG << " upperBound_";
 }
 
-OSQPSettings *MpcOsqp::Settings() {
+OSQPSettings MpcOsqp::Settings() const {
   // default setting
-  OSQPSettings *settings =
-      reinterpret_cast<OSQPSettings *>(c_malloc(sizeof(OSQPSettings)));
-  if (settings == nullptr) {
-    return nullptr;
-  } else {
-    osqp_set_default_settings(settings);
-    settings->polish = true;
-    settings->scaled_termination = true;
-    settings->verbose = false;
-    settings->max_iter = max_iteration_;
-    settings->eps_abs = eps_abs_;
-    return settings;
-  }
+  OSQPSettings settings;
+  osqp_set_default_settings(&settings);
+  settings.polish = true;
+  settings.scaled_termination = true;
+  settings.verbose = false;
+  settings.max_iter = max_iteration_;
+  settings.eps_abs = eps_abs_;
+  return settings;
 }
 
-OSQPData *MpcOsqp::Data() {
-  OSQPData *data = reinterpret_cast<OSQPData *>(c_malloc(sizeof(OSQPData)));
-  size_t kernel_dim = state_dim_ * (horizon_ + 1) + control_dim_ * horizon_;
-  size_t num_affine_constraint =
-      2 * state_dim_ * (horizon_ + 1) + control_dim_ * horizon_;
-  if (data == nullptr) {
-    return nullptr;
-  } else {
-    data->n = kernel_dim;
-    data->m = num_affine_constraint;
-    std::vector<c_float> P_data;
-    std::vector<c_int> P_indices;
-    std::vector<c_int> P_indptr;
-    ADEBUG << "before CalculateKernel";
-    CalculateKernel(&P_data, &P_indices, &P_indptr);
-    ADEBUG << "CalculateKernel done";
-    data->P =
-        csc_matrix(kernel_dim, kernel_dim, P_data.size(), CopyData(P_data),
-                   CopyData(P_indices), CopyData(P_indptr));
-    ADEBUG << "Get P matrix";
-    data->q = gradient_.data();
-    ADEBUG << "before CalculateEqualityConstraint";
-    std::vector<c_float> A_data;
-    std::vector<c_int> A_indices;
-    std::vector<c_int> A_indptr;
-    CalculateEqualityConstraint(&A_data, &A_indices, &A_indptr);
-    ADEBUG << "CalculateEqualityConstraint done";
-    data->A =
-        csc_matrix(state_dim_ * (horizon_ + 1) + state_dim_ * (horizon_ + 1) +
-                       control_dim_ * horizon_,
-                   kernel_dim, A_data.size(), CopyData(A_data),
-                   CopyData(A_indices), CopyData(A_indptr));
-    ADEBUG << "Get A matrix";
-    data->l = lowerBound_.data();
-    data->u = upperBound_.data();
-    return data;
+// Moves every state and control one step forward in the horizon, keeps the
+// last step and pins the first state to the current initial state.
+void MpcOsqp::ShiftSolution(const std::vector<c_float> &solution,
+                            std::vector<c_float> *warm_start_x) const {
+  warm_start_x->assign(solution.begin(), solution.end());
+  for (size_t i = 0; i < horizon_; ++i) {
+    for (size_t k = 0; k < state_dim_; ++k) {
+      warm_start_x->at(i * state_dim_ + k) =
+          solution[(i + 1) * state_dim_ + k];
+    }
+  }
+  for (size_t k = 0; k < state_dim_; ++k) {
+    warm_start_x->at(k) = matrix_initial_x_(k, 0);
+  }
+  const size_t first_control = state_dim_ * (horizon_ + 1);
+  for (size_t i = 0; i + 1 < horizon_; ++i) {
+    for (size_t k = 0; k < control_dim_; ++k) {
+      warm_start_x->at(first_control + i * control_dim_ + k) =
+          solution[first_control + (i + 1) * control_dim_ + k];
+    }
   }
 }
 
-void MpcOsqp::FreeData(OSQPData *data) {
-  c_free(data->A);
-  c_free(data->P);
-  c_free(data);
+bool MpcOsqp::Solve(std::vector<double> *control_cmd) {
+  PersistentOsqpSolver solver;
+  return Solve(control_cmd, &solver);
 }
 
-bool MpcOsqp::Solve(std::vector<double> *control_cmd) {
+bool MpcOsqp::Solve(std::vector<double> *control_cmd,
+                    PersistentOsqpSolver *solver) {
   ADEBUG << "Before Calc Gradient";
   CalculateGradient();
   ADEBUG << "After Calc Gradient";
   CalculateConstraintVectors();
   ADEBUG << "MPC2Matrix";
 
-  OSQPData *data = Data();
-  ADEBUG << "OSQP data done";
-  ADEBUG << "OSQP data n" << data->n;
-  ADEBUG << "OSQP data m" << data->m;
-  for (int i = 0; i < data->n; ++i) {
-    ADEBUG << "OSQP data q" << i << ":" << (data->q)[i];
-  }
-  ADEBUG << "OSQP data l" << data->l;
-  for (int i = 0; i < data->m; ++i) {
-    ADEBUG << "OSQP data l" << i << ":" << (data->l)[i];
-  }
-  ADEBUG << "OSQP data u" << data->u;
-  for (int i = 0; i < data->m; ++i) {
-    ADEBUG << "OSQP data u" << i << ":" << (data->u)[i];
-  }
+  OsqpProblem problem;
+  problem.n = static_cast<c_int>(num_param_);
+  problem.m = static_cast<c_int>(2 * state_dim_ * (horizon_ + 1) +
+                                control_dim_ * horizon_);
+  CalculateKernel(&problem.P_data, &problem.P_indices, &problem.P_indptr);
+  problem.q.assign(gradient_.data(), gradient_.data() + gradient_.size());
+  CalculateEqualityConstraint(&problem.A_data, &problem.A_indices,
+                              &problem.A_indptr);
+  problem.l.assign(lowerBound_.data(),
+                   lowerBound_.data() + lowerBound_.size());
+  problem.u.assign(upperBound_.data(),
+                   upperBound_.data() + upperBound_.size());
+  ADEBUG << "OSQP data n" << problem.n;
+  ADEBUG << "OSQP data m" << problem.m;
 
-  OSQPSettings *settings = Settings();
-  ADEBUG << "OSQP setting done";
-  OSQPWorkspace *osqp_workspace = nullptr;
-  // osqp_setup(&osqp_workspace, data, settings);
-  osqp_workspace = osqp_setup(data, settings);
-  ADEBUG << "OSQP workspace ready";
-  osqp_solve(osqp_workspace);
-
-  auto status = osqp_workspace->info->status_val;
-  ADEBUG << "status:" << status;
-  // check status
-  if (status < 0 || (status != 1 && status != 2)) {
-    AERROR << "failed optimization status:\t" << osqp_workspace->info->status;
-    osqp_cleanup(osqp_workspace);
-    FreeData(data);
-    c_free(settings);
-    return false;
-  } else if (osqp_workspace->solution == nullptr) {
-    AERROR << "The solution from OSQP is nullptr";
-    osqp_cleanup(osqp_workspace);
-    FreeData(data);
-    c_free(settings);
+  std::vector<c_float> warm_start_x;
+  if (solver->solution().size() == num_param_) {
+    ShiftSolution(solver->solution(), &warm_start_x);
+  }
+  if (!solver->Solve(problem, Settings(),
+                     warm_start_x.empty() ? nullptr : &warm_start_x)) {
     return false;
   }
 
+  const auto &solution = solver->solution();
   size_t first_control = state_dim_ * (horizon_ + 1);
   for (size_t i = 0; i < control_dim_; ++i) {
-    control_cmd->at(i) = osqp_workspace->solution->x[i + first_control];
+    control_cmd->at(i) = solution[i + first_control];
     ADEBUG << "control_cmd:" << i << ":" << control_cmd->at(i);
   }
-
-  // Cleanup
-  osqp_cleanup(osqp_workspace);
-  FreeData(data);
-  c_free(settings);
   return true;
 }
 
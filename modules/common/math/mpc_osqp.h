@@ -26,6 +26,7 @@
 #include "osqp/osqp.h"
 
 #include "cyber/common/log.h"
+#include "modules/common/math/persistent_osqp_solver.h"
 
 namespace apollo {
 namespace common {
@@ -55,6 +56,14 @@ class MpcOsqp {
   // control vector
   bool Solve(std::vector<double> *control_cmd);
 
+  /**
+   * @brief Solves with a solver kept by the caller across control cycles.
+   *        The workspace is updated in place when the problem structure is
+   *        unchanged and the previous solution, shifted by one step, is used
+   *        as the warm start.
+   */
+  bool Solve(std::vector<double> *control_cmd, PersistentOsqpSolver *solver);
+
  private:
   void CalculateKernel(std::vector<c_float> *P_data,
                        std::vector<c_int> *P_indices,
@@ -64,16 +73,9 @@ class MpcOsqp {
                                    std::vector<c_int> *A_indptr);
   void CalculateGradient();
   void CalculateConstraintVectors();
-  OSQPSettings *Settings();
-  OSQPData *Data();
-  void FreeData(OSQPData *data);
-
-  template <typename T>
-  T *CopyData(const std::vector<T> &vec) {
-    T *data = new T[vec.size()];
-    memcpy(data, vec.data(), sizeof(T) * vec.size());
-    return data;
-  }
+  OSQPSettings Settings() const;
+  void ShiftSolution(const std::vector<c_float> &solution,
+                     std::vector<c_float> *warm_start_x) const;
 
  private:
   Eigen::MatrixXd matrix_a_;
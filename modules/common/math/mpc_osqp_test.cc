@@ -174,6 +174,61 @@ TEST(MPCOSQPSolverTest, NullMatrix) {
   EXPECT_NEAR(0.0, control_cmd[0], 1e-7);
 }
 
+TEST(MPCOSQPSolverTest, PersistentSolver) {
+  const int states = 2;
+  const int controls = 1;
+  const int horizon = 10;
+  const int max_iter = 100;
+  const double eps = 0.001;
+  const double max = std::numeric_limits<double>::max();
+
+  Eigen::MatrixXd A(states, states);
+  A << 1, 0.1, 0, 1;
+
+  Eigen::MatrixXd B(states, controls);
+  B << 0.005, 0.1;
+
+  Eigen::MatrixXd Q(states, states);
+  Q << 10, 0, 0, 1;
+
+  Eigen::MatrixXd R(controls, controls);
+  R << 0.1;
+
+  Eigen::MatrixXd lower_bound(controls, 1);
+  lower_bound << -2;
+
+  Eigen::MatrixXd upper_bound(controls, 1);
+  upper_bound << 2;
+
+  Eigen::MatrixXd reference_state(states, 1);
+  reference_state << 0, 0;
+
+  Eigen::MatrixXd state_lower_bound(states, 1);
+  state_lower_bound << -max, -max;
+
+  Eigen::MatrixXd state_upper_bound(states, 1);
+  state_upper_bound << max, max;
+
+  PersistentOsqpSolver persistent_solver;
+  for (int cycle = 0; cycle < 5; ++cycle) {
+    Eigen::MatrixXd initial_state(states, 1);
+    initial_state << 1.0 - 0.2 * cycle, 0.1 * cycle;
+
+    MpcOsqp mpc_osqp_solver(A, B, Q, R, initial_state, lower_bound,
+                            upper_bound, state_lower_bound, state_upper_bound,
+                            reference_state, max_iter, horizon, eps);
+    std::vector<double> control_cmd(controls, 0);
+    std::vector<double> persistent_control_cmd(controls, 0);
+    EXPECT_TRUE(mpc_osqp_solver.Solve(&control_cmd));
+    EXPECT_TRUE(
+        mpc_osqp_solver.Solve(&persistent_control_cmd, &persistent_solver));
+    EXPECT_NEAR(control_cmd[0], persistent_control_cmd[0], 0.05);
+  }
+  // Only the initial state bound changes between cycles.
+  EXPECT_EQ(1, persistent_solver.setup_count());
+  EXPECT_EQ(4, persistent_solver.update_count());
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
@@ -0,0 +1,164 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/persistent_osqp_solver.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+PersistentOsqpSolver::~PersistentOsqpSolver() { Reset(); }
+
+void PersistentOsqpSolver::Reset() {
+  if (work_ != nullptr) {
+    osqp_cleanup(work_);
+    work_ = nullptr;
+  }
+  solution_.clear();
+}
+
+bool PersistentOsqpSolver::Solve(const OsqpProblem& problem,
+                                 const OSQPSettings& settings,
+                                 const std::vector<c_float>* warm_start_x) {
+  CHECK_EQ(problem.q.size(), static_cast<size_t>(problem.n));
+  CHECK_EQ(problem.l.size(), static_cast<size_t>(problem.m));
+  CHECK_EQ(problem.u.size(), static_cast<size_t>(problem.m));
+
+  const bool updated = CanUpdate(problem, settings) &&
+                       Update(problem, settings);
+  if (!updated && !Setup(problem, settings)) {
+    return false;
+  }
+  if (warm_start_x != nullptr) {
+    CHECK_EQ(warm_start_x->size(), static_cast<size_t>(problem.n));
+    osqp_warm_start_x(work_, warm_start_x->data());
+  }
+
+  osqp_solve(work_);
+  const auto status = work_->info->status_val;
+  if (status != OSQP_SOLVED && status != OSQP_SOLVED_INACCURATE) {
+    AERROR << "failed optimization status:\t" << work_->info->status;
+    // Do not start the next solve from a diverged iterate.
+    Reset();
+    return false;
+  } else if (work_->solution == nullptr) {
+    AERROR << "The solution from OSQP is nullptr";
+    Reset();
+    return false;
+  }
+  solution_.assign(work_->solution->x, work_->solution->x + problem.n);
+  return true;
+}
+
+bool PersistentOsqpSolver::CanUpdate(const OsqpProblem& problem,
+                                     const OSQPSettings& settings) const {
+  return work_ != nullptr && problem.n == problem_.n &&
+         problem.m == problem_.m && problem.P_indptr == problem_.P_indptr &&
+         problem.P_indices == problem_.P_indices &&
+         problem.A_indptr == problem_.A_indptr &&
+         problem.A_indices == problem_.A_indices &&
+         settings.rho == settings_.rho && settings.sigma == settings_.sigma &&
+         settings.scaling == settings_.scaling &&
+         settings.adaptive_rho == settings_.adaptive_rho &&
+         settings.linsys_solver == settings_.linsys_solver;
+}
+
+bool PersistentOsqpSolver::Setup(const OsqpProblem& problem,
+                                 const OSQPSettings& settings) {
+  Reset();
+  problem_ = problem;
+  settings_ = settings;
+
+  // osqp copies the data into the workspace, so the csc wrappers only
+  // borrow the vectors of problem_.
+  OSQPData data;
+  data.n = problem_.n;
+  data.m = problem_.m;
+  data.P = csc_matrix(problem_.n, problem_.n,
+                      static_cast<c_int>(problem_.P_data.size()),
+                      problem_.P_data.data(), problem_.P_indices.data(),
+                      problem_.P_indptr.data());
+  data.q = problem_.q.data();
+  data.A = csc_matrix(problem_.m, problem_.n,
+                      static_cast<c_int>(problem_.A_data.size()),
+                      problem_.A_data.data(), problem_.A_indices.data(),
+                      problem_.A_indptr.data());
+  data.l = problem_.l.data();
+  data.u = problem_.u.data();
+
+  work_ = osqp_setup(&data, &settings_);
+  c_free(data.P);
+  c_free(data.A);
+  if (work_ == nullptr) {
+    AERROR << "Failed to set up the OSQP workspace";
+    return false;
+  }
+  ++setup_count_;
+  return true;
+}
+
+bool PersistentOsqpSolver::Update(const OsqpProblem& problem,
+                                  const OSQPSettings& settings) {
+  const bool P_changed = problem.P_data != problem_.P_data;
+  const bool A_changed = problem.A_data != problem_.A_data;
+  c_int error = 0;
+  // Only changed matrix values trigger a numeric refactorization.
+  if (P_changed && A_changed) {
+    error = osqp_update_P_A(work_, problem.P_data.data(), OSQP_NULL,
+                            static_cast<c_int>(problem.P_data.size()),
+                            problem.A_data.data(), OSQP_NULL,
+                            static_cast<c_int>(problem.A_data.size()));
+  } else if (P_changed) {
+    error = osqp_update_P(work_, problem.P_data.data(), OSQP_NULL,
+                          static_cast<c_int>(problem.P_data.size()));
+  } else if (A_changed) {
+    error = osqp_update_A(work_, problem.A_data.data(), OSQP_NULL,
+                          static_cast<c_int>(problem.A_data.size()));
+  }
+  if (error == 0 && problem.q != problem_.q) {
+    error = osqp_update_lin_cost(work_, problem.q.data());
+  }
+  if (error == 0 && (problem.l != problem_.l || problem.u != problem_.u)) {
+    error = osqp_update_bounds(work_, problem.l.data(), problem.u.data());
+  }
+  if (error == 0) {
+    error = osqp_update_max_iter(work_, settings.max_iter) ||
+            osqp_update_eps_abs(work_, settings.eps_abs) ||
+            osqp_update_eps_rel(work_, settings.eps_rel) ||
+            osqp_update_polish(work_, settings.polish) ||
+            osqp_update_verbose(work_, settings.verbose);
+  }
+  if (error != 0) {
+    AWARN << "Failed to update the OSQP workspace, set it up again: "
+          << error;
+    return false;
+  }
+
+  problem_.P_data = problem.P_data;
+  problem_.A_data = problem.A_data;
+  problem_.q = problem.q;
+  problem_.l = problem.l;
+  problem_.u = problem.u;
+  settings_ = settings;
+  ++update_count_;
+  return true;
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "osqp/osqp.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @brief A quadratic program in osqp form:
+ *        min 0.5 * x' * P * x + q' * x, s.t. l <= A * x <= u,
+ *        with P (upper triangular) and A stored as csc matrices.
+ */
+struct OsqpProblem {
+  c_int n = 0;
+  c_int m = 0;
+  std::vector<c_float> P_data;
+  std::vector<c_int> P_indices;
+  std::vector<c_int> P_indptr;
+  std::vector<c_float> q;
+  std::vector<c_float> A_data;
+  std::vector<c_int> A_indices;
+  std::vector<c_int> A_indptr;
+  std::vector<c_float> l;
+  std::vector<c_float> u;
+};
+
+/**
+ * @class PersistentOsqpSolver
+ * @brief Keeps an osqp workspace alive across solves.
+ *
+ * As long as the dimensions and the sparsity patterns of P and A do not
+ * change, a new problem only updates the vectors and the matrix values of
+ * the workspace, which skips the setup and the symbolic factorization, and
+ * the solver starts from the previous (or the given) solution. Otherwise
+ * the workspace is set up again from scratch.
+ */
+class PersistentOsqpSolver {
+ public:
+  PersistentOsqpSolver() = default;
+
+  ~PersistentOsqpSolver();
+
+  PersistentOsqpSolver(const PersistentOsqpSolver&) = delete;
+  PersistentOsqpSolver& operator=(const PersistentOsqpSolver&) = delete;
+
+  /**
+   * @brief Solves the problem.
+   * @param problem The problem to solve.
+   * @param settings The solver settings. Settings that need a new setup
+   *        (scaling, rho, sigma, ...) force one when they change.
+   * @param warm_start_x Optional primal guess of size n. When it is null,
+   *        the solution of the last solve is used if the workspace is kept.
+   * @return True if the problem is solved or solved inaccurately.
+   */
+  bool Solve(const OsqpProblem& problem, const OSQPSettings& settings,
+             const std::vector<c_float>* warm_start_x = nullptr);
+
+  /**
+   * @brief Primal solution of the last successful solve.
+   */
+  const std::vector<c_float>& solution() const { return solution_; }
+
+  /**
+   * @brief Drops the workspace and the last solution, the next solve sets
+   *        the workspace up again.
+   */
+  void Reset();
+
+  int setup_count() const { return setup_count_; }
+
+  int update_count() const { return update_count_; }
+
+ private:
+  bool Setup(const OsqpProblem& problem, const OSQPSettings& settings);
+
+  bool Update(const OsqpProblem& problem, const OSQPSettings& settings);
+
+  bool CanUpdate(const OsqpProblem& problem,
+                 const OSQPSettings& settings) const;
+
+ private:
+  OSQPWorkspace* work_ = nullptr;
+  OSQPSettings settings_;
+  OsqpProblem problem_;
+  std::vector<c_float> solution_;
+  int setup_count_ = 0;
+  int update_count_ = 0;
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
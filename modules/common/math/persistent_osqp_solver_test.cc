@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/persistent_osqp_solver.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+// min 0.5 * (x0^2 + x1^2) - x0 - x1, s.t. 0 <= x <= upper
+OsqpProblem BoxProblem(const double upper0, const double upper1) {
+  OsqpProblem problem;
+  problem.n = 2;
+  problem.m = 2;
+  problem.P_data = {1.0, 1.0};
+  problem.P_indices = {0, 1};
+  problem.P_indptr = {0, 1, 2};
+  problem.q = {-1.0, -1.0};
+  problem.A_data = {1.0, 1.0};
+  problem.A_indices = {0, 1};
+  problem.A_indptr = {0, 1, 2};
+  problem.l = {0.0, 0.0};
+  problem.u = {upper0, upper1};
+  return problem;
+}
+
+OSQPSettings DefaultSettings() {
+  OSQPSettings settings;
+  osqp_set_default_settings(&settings);
+  settings.verbose = false;
+  settings.polish = true;
+  return settings;
+}
+
+}  // namespace
+
+TEST(PersistentOsqpSolverTest, UpdateVectors) {
+  PersistentOsqpSolver solver;
+  ASSERT_TRUE(solver.Solve(BoxProblem(0.5, 2.0), DefaultSettings()));
+  EXPECT_NEAR(0.5, solver.solution()[0], 1e-3);
+  EXPECT_NEAR(1.0, solver.solution()[1], 1e-3);
+
+  ASSERT_TRUE(solver.Solve(BoxProblem(2.0, 0.5), DefaultSettings()));
+  EXPECT_NEAR(1.0, solver.solution()[0], 1e-3);
+  EXPECT_NEAR(0.5, solver.solution()[1], 1e-3);
+  EXPECT_EQ(1, solver.setup_count());
+  EXPECT_EQ(1, solver.update_count());
+}
+
+TEST(PersistentOsqpSolverTest, UpdateMatrixValues) {
+  PersistentOsqpSolver solver;
+  ASSERT_TRUE(solver.Solve(BoxProblem(2.0, 2.0), DefaultSettings()));
+
+  OsqpProblem problem = BoxProblem(2.0, 2.0);
+  problem.P_data = {2.0, 4.0};
+  const std::vector<c_float> warm_start_x = {0.5, 0.25};
+  ASSERT_TRUE(solver.Solve(problem, DefaultSettings(), &warm_start_x));
+  EXPECT_NEAR(0.5, solver.solution()[0], 1e-3);
+  EXPECT_NEAR(0.25, solver.solution()[1], 1e-3);
+  EXPECT_EQ(1, solver.setup_count());
+  EXPECT_EQ(1, solver.update_count());
+}
+
+TEST(PersistentOsqpSolverTest, SetupOnPatternChange) {
+  PersistentOsqpSolver solver;
+  ASSERT_TRUE(solver.Solve(BoxProblem(2.0, 2.0), DefaultSettings()));
+
+  // x0 + x1 <= 1 is added as a third constraint row.
+  OsqpProblem problem = BoxProblem(2.0, 2.0);
+  problem.m = 3;
+  problem.A_data = {1.0, 1.0, 1.0, 1.0};
+  problem.A_indices = {0, 2, 1, 2};
+  problem.A_indptr = {0, 2, 4};
+  problem.l = {0.0, 0.0, -OSQP_INFTY};
+  problem.u = {2.0, 2.0, 1.0};
+  ASSERT_TRUE(solver.Solve(problem, DefaultSettings()));
+  EXPECT_NEAR(0.5, solver.solution()[0], 1e-3);
+  EXPECT_NEAR(0.5, solver.solution()[1], 1e-3);
+  EXPECT_EQ(2, solver.setup_count());
+  EXPECT_EQ(0, solver.update_count());
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/control/control_component/controller_task_base/common/lqr_gain_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace control {
+
+bool LqrGainTable::Init(const double min_speed, const double max_speed,
+                        const double resolution, const GainSolver& solver) {
+  gains_.clear();
+  if (resolution <= 0.0 || max_speed <= min_speed) {
+    AERROR << "Invalid LQR gain table speed grid: [" << min_speed << ", "
+           << max_speed << "] with resolution " << resolution;
+    return false;
+  }
+  min_speed_ = min_speed;
+  resolution_ = resolution;
+  const int grid_size =
+      static_cast<int>(std::ceil((max_speed - min_speed) / resolution)) + 1;
+  gains_.resize(grid_size);
+  for (int i = 0; i < grid_size; ++i) {
+    solver(min_speed_ + i * resolution_, &gains_[i]);
+    if (gains_[i].size() == 0 || gains_[i].size() != gains_[0].size()) {
+      AERROR << "Invalid LQR gain at speed " << min_speed_ + i * resolution_;
+      gains_.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LqrGainTable::Lookup(const double speed, Eigen::MatrixXd* gain) const {
+  if (gains_.empty()) {
+    return false;
+  }
+  const double index = (speed - min_speed_) / resolution_;
+  const int last = static_cast<int>(gains_.size()) - 1;
+  if (index < 0.0 || index > last) {
+    return false;
+  }
+  const int lower = std::min(static_cast<int>(index), last - 1);
+  const double ratio = index - lower;
+  *gain = (1.0 - ratio) * gains_[lower] + ratio * gains_[lower + 1];
+  return true;
+}
+
+}  // namespace control
+}  // namespace apollo
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "Eigen/Core"
+
+namespace apollo {
+namespace control {
+
+/**
+ * @class LqrGainTable
+ * @brief Feedback gains precomputed on a speed grid. Gains between two grid
+ *        speeds are linearly interpolated, which replaces solving the
+ *        Riccati equation in every control cycle.
+ */
+class LqrGainTable {
+ public:
+  // Computes the feedback gain of the given speed.
+  typedef std::function<void(const double speed, Eigen::MatrixXd* gain)>
+      GainSolver;
+
+  LqrGainTable() = default;
+
+  // Solves the gains at speeds min_speed, min_speed + resolution, ...,
+  // max_speed. Return true if init is ok.
+  bool Init(const double min_speed, const double max_speed,
+            const double resolution, const GainSolver& solver);
+
+  // Return false if speed is outside of the grid.
+  bool Lookup(const double speed, Eigen::MatrixXd* gain) const;
+
+  bool IsReady() const { return !gains_.empty(); }
+
+  size_t size() const { return gains_.size(); }
+
+ private:
+  double min_speed_ = 0.0;
+  double resolution_ = 0.0;
+  std::vector<Eigen::MatrixXd> gains_;
+};
+
+}  // namespace control
+}  // namespace apollo
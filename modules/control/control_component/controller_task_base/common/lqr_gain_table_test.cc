@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/control/control_component/controller_task_base/common/lqr_gain_table.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace control {
+
+namespace {
+
+void LinearGain(const double speed, Eigen::MatrixXd* gain) {
+  *gain = Eigen::MatrixXd::Zero(1, 2);
+  (*gain)(0, 0) = speed;
+  (*gain)(0, 1) = 2.0 * speed + 1.0;
+}
+
+}  // namespace
+
+TEST(LqrGainTableTest, Lookup) {
+  LqrGainTable table;
+  EXPECT_FALSE(table.IsReady());
+  ASSERT_TRUE(table.Init(1.0, 5.0, 0.5, LinearGain));
+  EXPECT_EQ(9, table.size());
+
+  Eigen::MatrixXd gain;
+  ASSERT_TRUE(table.Lookup(1.0, &gain));
+  EXPECT_DOUBLE_EQ(1.0, gain(0, 0));
+  ASSERT_TRUE(table.Lookup(2.2, &gain));
+  EXPECT_NEAR(2.2, gain(0, 0), 1e-9);
+  EXPECT_NEAR(5.4, gain(0, 1), 1e-9);
+  ASSERT_TRUE(table.Lookup(5.0, &gain));
+  EXPECT_NEAR(11.0, gain(0, 1), 1e-9);
+
+  EXPECT_FALSE(table.Lookup(0.9, &gain));
+  EXPECT_FALSE(table.Lookup(5.1, &gain));
+}
+
+TEST(LqrGainTableTest, InvalidGrid) {
+  LqrGainTable table;
+  EXPECT_FALSE(table.Init(1.0, 1.0, 0.5, LinearGain));
+  EXPECT_FALSE(table.Init(0.0, 1.0, 0.0, LinearGain));
+  EXPECT_FALSE(table.IsReady());
+}
+
+}  // namespace control
+}  // namespace apollo
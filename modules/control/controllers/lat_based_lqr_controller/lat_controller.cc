@@ -197,43 +197,11 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector) {
   }
   // Matrix init operations.
   const int matrix_size = basic_state_size_ + preview_window_;
-  matrix_a_ = Matrix::Zero(basic_state_size_, basic_state_size_);
-  matrix_ad_ = Matrix::Zero(basic_state_size_, basic_state_size_);
-  matrix_adc_ = Matrix::Zero(matrix_size, matrix_size);
-  /*
-  A matrix (Gear Drive)
-  [0.0, 1.0, 0.0, 0.0;
-   0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
-   (l_r * c_r - l_f * c_f) / m / v;
-   0.0, 0.0, 0.0, 1.0;
-   0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
-   (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
-  */
-  matrix_a_(0, 1) = 1.0;
-  matrix_a_(1, 2) = (cf_ + cr_) / mass_;
-  matrix_a_(2, 3) = 1.0;
-  matrix_a_(3, 2) = (lf_ * cf_ - lr_ * cr_) / iz_;
-
-  matrix_a_coeff_ = Matrix::Zero(matrix_size, matrix_size);
-  matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
-  matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
-  matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
-  matrix_a_coeff_(3, 3) = -1.0 * (lf_ * lf_ * cf_ + lr_ * lr_ * cr_) / iz_;
-
-  /*
-  b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
-  */
-  matrix_b_ = Matrix::Zero(basic_state_size_, 1);
-  matrix_bd_ = Matrix::Zero(basic_state_size_, 1);
-  matrix_bdc_ = Matrix::Zero(matrix_size, 1);
-  matrix_b_(1, 0) = cf_ / mass_;
-  matrix_b_(3, 0) = lf_ * cf_ / iz_;
-  matrix_bd_ = matrix_b_ * ts_;
-
   matrix_state_ = Matrix::Zero(matrix_size, 1);
   matrix_k_ = Matrix::Zero(1, matrix_size);
   matrix_r_ = Matrix::Identity(1, 1);
   matrix_q_ = Matrix::Zero(matrix_size, matrix_size);
+  matrix_reverse_q_ = Matrix::Zero(matrix_size, matrix_size);
 
   int q_param_size = lat_based_lqr_controller_conf_.matrix_q_size();
   int reverse_q_param_size =
@@ -250,11 +218,13 @@ Status LatController::Init(std::shared_ptr<DependencyInjector> injector) {
 
   for (int i = 0; i < q_param_size; ++i) {
     matrix_q_(i, i) = lat_based_lqr_controller_conf_.matrix_q(i);
+    matrix_reverse_q_(i, i) =
+        lat_based_lqr_controller_conf_.reverse_matrix_q(i);
   }
 
-  matrix_q_updated_ = matrix_q_;
   InitializeFilters();
   LoadLatGainScheduler();
+  InitLqrGainTables();
   LogInitParameters();
 
   enable_leadlag_ =
@@ -396,51 +366,17 @@ Status LatController::ComputeControlCommand(
     trajectory_analyzer_.TrajectoryTransformToCOM(lr_);
   }
 
-  // Re-build the vehicle dynamic models at reverse driving (in particular,
-  // replace the lateral translational motion dynamics with the corresponding
-  // kinematic models)
-  if (vehicle_state->gear() == canbus::Chassis::GEAR_REVERSE) {
-    /*
-    A matrix (Gear Reverse)
-    [0.0, 0.0, 1.0 * v 0.0;
-     0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
-     (l_r * c_r - l_f * c_f) / m / v;
-     0.0, 0.0, 0.0, 1.0;
-     0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
-     (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
-    */
+  // The cornering stiffness changes sign at reverse driving, see
+  // SolveLqrGain for the corresponding vehicle dynamic models.
+  const bool reverse =
+      vehicle_state->gear() == canbus::Chassis::GEAR_REVERSE;
+  if (reverse) {
     cf_ = -lat_based_lqr_controller_conf_.cf();
     cr_ = -lat_based_lqr_controller_conf_.cr();
-    matrix_a_(0, 1) = 0.0;
-    matrix_a_coeff_(0, 2) = 1.0;
   } else {
-    /*
-    A matrix (Gear Drive)
-    [0.0, 1.0, 0.0, 0.0;
-     0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
-     (l_r * c_r - l_f * c_f) / m / v;
-     0.0, 0.0, 0.0, 1.0;
-     0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
-     (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
-    */
     cf_ = lat_based_lqr_controller_conf_.cf();
     cr_ = lat_based_lqr_controller_conf_.cr();
-    matrix_a_(0, 1) = 1.0;
-    matrix_a_coeff_(0, 2) = 0.0;
   }
-  matrix_a_(1, 2) = (cf_ + cr_) / mass_;
-  matrix_a_(3, 2) = (lf_ * cf_ - lr_ * cr_) / iz_;
-  matrix_a_coeff_(1, 1) = -(cf_ + cr_) / mass_;
-  matrix_a_coeff_(1, 3) = (lr_ * cr_ - lf_ * cf_) / mass_;
-  matrix_a_coeff_(3, 1) = (lr_ * cr_ - lf_ * cf_) / iz_;
-  matrix_a_coeff_(3, 3) = -1.0 * (lf_ * lf_ * cf_ + lr_ * lr_ * cr_) / iz_;
-
-  /*
-  b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
-  */
-  matrix_b_(1, 0) = cf_ / mass_;
-  matrix_b_(3, 0) = lf_ * cf_ / iz_;
-  matrix_bd_ = matrix_b_ * ts_;
 
   UpdateDrivingOrientation();
 
@@ -451,40 +387,8 @@ Status LatController::ComputeControlCommand(
   // Error Rate, preview lateral error1 , preview lateral error2, ...]
   UpdateState(debug, chassis);
 
-  UpdateMatrix();
-
-  // Compound discrete matrix with road preview model
-  UpdateMatrixCompound();
-
-  // Adjust matrix_q_updated when in reverse gear
-  int q_param_size = lat_based_lqr_controller_conf_.matrix_q_size();
-  int reverse_q_param_size =
-      lat_based_lqr_controller_conf_.reverse_matrix_q_size();
-  if (injector_->vehicle_state()->gear() == canbus::Chassis::GEAR_REVERSE) {
-    for (int i = 0; i < reverse_q_param_size; ++i) {
-      matrix_q_(i, i) = lat_based_lqr_controller_conf_.reverse_matrix_q(i);
-    }
-  } else {
-    for (int i = 0; i < q_param_size; ++i) {
-      matrix_q_(i, i) = lat_based_lqr_controller_conf_.matrix_q(i);
-    }
-  }
-
-  // Add gain scheduler for higher speed steering
-  if (FLAGS_enable_gain_scheduler) {
-    matrix_q_updated_(0, 0) =
-        matrix_q_(0, 0) * lat_err_interpolation_->Interpolate(
-                              std::fabs(vehicle_state->linear_velocity()));
-    matrix_q_updated_(2, 2) =
-        matrix_q_(2, 2) * heading_err_interpolation_->Interpolate(
-                              std::fabs(vehicle_state->linear_velocity()));
-    common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q_updated_,
-                                  matrix_r_, lqr_eps_, lqr_max_iteration_,
-                                  &matrix_k_);
-  } else {
-    common::math::SolveLQRProblem(matrix_adc_, matrix_bdc_, matrix_q_,
-                                  matrix_r_, lqr_eps_, lqr_max_iteration_,
-                                  &matrix_k_);
+  if (!LookupLqrGain(vehicle_state->linear_velocity(), reverse, &matrix_k_)) {
+    SolveLqrGain(vehicle_state->linear_velocity(), reverse, &matrix_k_);
   }
 
   // feedback = - K * state
@@ -710,40 +614,128 @@ void LatController::UpdateState(SimpleLateralDebug *debug,
   }
 }
 
-void LatController::UpdateMatrix() {
-  double v;
+void LatController::InitLqrGainTables() {
+  const auto &table_conf = lat_based_lqr_controller_conf_.lqr_gain_table_conf();
+  if (!table_conf.enabled()) {
+    return;
+  }
+  const double start_time = Clock::NowInSeconds();
+  if (!drive_lqr_gain_table_.Init(
+          table_conf.min_speed(), table_conf.max_speed(),
+          table_conf.speed_resolution(),
+          [this](const double speed, Matrix *matrix_k) {
+            SolveLqrGain(speed, false, matrix_k);
+          }) ||
+      !reverse_lqr_gain_table_.Init(
+          table_conf.min_speed(), table_conf.max_speed(),
+          table_conf.speed_resolution(),
+          [this](const double speed, Matrix *matrix_k) {
+            SolveLqrGain(-speed, true, matrix_k);
+          })) {
+    AWARN << "Failed to precompute LQR gains, solve them online.";
+    return;
+  }
+  AINFO << "Precomputed " << drive_lqr_gain_table_.size()
+        << " LQR gains per gear in "
+        << (Clock::NowInSeconds() - start_time) * 1000 << " ms.";
+}
+
+bool LatController::LookupLqrGain(const double linear_velocity,
+                                  const bool reverse, Matrix *matrix_k) const {
+  if (reverse) {
+    return linear_velocity <= 0.0 &&
+           reverse_lqr_gain_table_.Lookup(-linear_velocity, matrix_k);
+  }
+  return linear_velocity >= 0.0 &&
+         drive_lqr_gain_table_.Lookup(linear_velocity, matrix_k);
+}
+
+void LatController::SolveLqrGain(const double linear_velocity,
+                                 const bool reverse, Matrix *matrix_k) const {
+  const double cf = reverse ? -lat_based_lqr_controller_conf_.cf()
+                            : lat_based_lqr_controller_conf_.cf();
+  const double cr = reverse ? -lat_based_lqr_controller_conf_.cr()
+                            : lat_based_lqr_controller_conf_.cr();
   // At reverse driving, replace the lateral translational motion dynamics with
   // the corresponding kinematic models
-  if (injector_->vehicle_state()->gear() == canbus::Chassis::GEAR_REVERSE &&
-      !lat_based_lqr_controller_conf_.reverse_use_dynamic_model()) {
-    v = std::min(injector_->vehicle_state()->linear_velocity(),
-                 -minimum_speed_protection_);
-    matrix_a_(0, 2) = matrix_a_coeff_(0, 2) * v;
-  } else {
-    v = std::max(injector_->vehicle_state()->linear_velocity(),
-                 minimum_speed_protection_);
-    matrix_a_(0, 2) = 0.0;
-  }
-  matrix_a_(1, 1) = matrix_a_coeff_(1, 1) / v;
-  matrix_a_(1, 3) = matrix_a_coeff_(1, 3) / v;
-  matrix_a_(3, 1) = matrix_a_coeff_(3, 1) / v;
-  matrix_a_(3, 3) = matrix_a_coeff_(3, 3) / v;
-  Matrix matrix_i = Matrix::Identity(matrix_a_.cols(), matrix_a_.cols());
-  matrix_ad_ = (matrix_i - ts_ * 0.5 * matrix_a_).inverse() *
-               (matrix_i + ts_ * 0.5 * matrix_a_);
-}
+  const bool kinematic =
+      reverse && !lat_based_lqr_controller_conf_.reverse_use_dynamic_model();
+  const double v =
+      kinematic ? std::min(linear_velocity, -minimum_speed_protection_)
+                : std::max(linear_velocity, minimum_speed_protection_);
 
-void LatController::UpdateMatrixCompound() {
-  // Initialize preview matrix
-  matrix_adc_.block(0, 0, basic_state_size_, basic_state_size_) = matrix_ad_;
-  matrix_bdc_.block(0, 0, basic_state_size_, 1) = matrix_bd_;
+  /*
+  A matrix (Gear Drive)
+  [0.0, 1.0, 0.0, 0.0;
+   0.0, (-(c_f + c_r) / m) / v, (c_f + c_r) / m,
+   (l_r * c_r - l_f * c_f) / m / v;
+   0.0, 0.0, 0.0, 1.0;
+   0.0, ((lr * cr - lf * cf) / i_z) / v, (l_f * c_f - l_r * c_r) / i_z,
+   (-1.0 * (l_f^2 * c_f + l_r^2 * c_r) / i_z) / v;]
+  A matrix (Gear Reverse)
+  [0.0, 0.0, 1.0 * v 0.0;
+   ...same as Gear Drive...]
+  */
+  Matrix matrix_a = Matrix::Zero(basic_state_size_, basic_state_size_);
+  matrix_a(0, 1) = reverse ? 0.0 : 1.0;
+  matrix_a(0, 2) = kinematic ? v : 0.0;
+  matrix_a(1, 1) = -(cf + cr) / mass_ / v;
+  matrix_a(1, 2) = (cf + cr) / mass_;
+  matrix_a(1, 3) = (lr_ * cr - lf_ * cf) / mass_ / v;
+  matrix_a(2, 3) = 1.0;
+  matrix_a(3, 1) = (lr_ * cr - lf_ * cf) / iz_ / v;
+  matrix_a(3, 2) = (lf_ * cf - lr_ * cr) / iz_;
+  matrix_a(3, 3) = -1.0 * (lf_ * lf_ * cf + lr_ * lr_ * cr) / iz_ / v;
+
+  /*
+  b = [0.0, c_f / m, 0.0, l_f * c_f / i_z]^T
+  */
+  Matrix matrix_b = Matrix::Zero(basic_state_size_, 1);
+  matrix_b(1, 0) = cf / mass_;
+  matrix_b(3, 0) = lf_ * cf / iz_;
+  // Reverse the control matrix if the driving direction is reversed
+  const double b_sign = FLAGS_reverse_heading_control && reverse ? -1.0 : 1.0;
+
+  // Compound discrete matrix with road preview model
+  const int matrix_size = basic_state_size_ + preview_window_;
+  const Matrix matrix_i =
+      Matrix::Identity(basic_state_size_, basic_state_size_);
+  Matrix matrix_adc = Matrix::Zero(matrix_size, matrix_size);
+  Matrix matrix_bdc = Matrix::Zero(matrix_size, 1);
+  matrix_adc.block(0, 0, basic_state_size_, basic_state_size_) =
+      (matrix_i - ts_ * 0.5 * matrix_a).inverse() *
+      (matrix_i + ts_ * 0.5 * matrix_a);
+  matrix_bdc.block(0, 0, basic_state_size_, 1) = b_sign * matrix_b * ts_;
   if (preview_window_ > 0) {
-    matrix_bdc_(matrix_bdc_.rows() - 1, 0) = 1;
-    // Update A matrix;
+    matrix_bdc(matrix_size - 1, 0) = 1;
     for (int i = 0; i < preview_window_ - 1; ++i) {
-      matrix_adc_(basic_state_size_ + i, basic_state_size_ + 1 + i) = 1;
+      matrix_adc(basic_state_size_ + i, basic_state_size_ + 1 + i) = 1;
     }
   }
+
+  // Add gain scheduler for higher speed steering. The scheduled lateral and
+  // heading error weights are put into the forward gear weighting.
+  const Matrix &matrix_gear_q = reverse ? matrix_reverse_q_ : matrix_q_;
+  Matrix matrix_q = matrix_gear_q;
+  if (FLAGS_enable_gain_scheduler) {
+    const double speed = std::fabs(linear_velocity);
+    matrix_q = matrix_q_;
+    matrix_q(0, 0) =
+        matrix_gear_q(0, 0) * lat_err_interpolation_->Interpolate(speed);
+    matrix_q(2, 2) =
+        matrix_gear_q(2, 2) * heading_err_interpolation_->Interpolate(speed);
+  }
+
+  if (preview_window_ == 0) {
+    Eigen::Matrix<double, 1, 4> matrix_k_fixed;
+    common::math::SolveLQRProblem<4, 1>(
+        matrix_adc, matrix_bdc, matrix_q, matrix_r_, lqr_eps_,
+        lqr_max_iteration_, &matrix_k_fixed);
+    *matrix_k = matrix_k_fixed;
+  } else {
+    common::math::SolveLQRProblem(matrix_adc, matrix_bdc, matrix_q, matrix_r_,
+                                  lqr_eps_, lqr_max_iteration_, matrix_k);
+  }
 }
 
 double LatController::ComputeFeedForward(double ref_curvature) const {
@@ -922,15 +914,11 @@ void LatController::ComputeLateralErrors(
 void LatController::UpdateDrivingOrientation() {
   auto vehicle_state = injector_->vehicle_state();
   driving_orientation_ = vehicle_state->heading();
-  matrix_bd_ = matrix_b_ * ts_;
   // Reverse the driving direction if the vehicle is in reverse mode
   if (FLAGS_reverse_heading_control) {
     if (vehicle_state->gear() == canbus::Chassis::GEAR_REVERSE) {
       driving_orientation_ =
           common::math::NormalizeAngle(driving_orientation_ + M_PI);
-      // Update Matrix_b for reverse mode
-      matrix_bd_ = -matrix_b_ * ts_;
-      ADEBUG << "Matrix_b changed due to gear direction";
     }
   }
 }
@@ -36,6 +36,7 @@
 #include "modules/common/filters/mean_filter.h"
 #include "modules/control/control_component/controller_task_base/common/interpolation_1d.h"
 #include "modules/control/control_component/controller_task_base/common/leadlag_controller.h"
+#include "modules/control/control_component/controller_task_base/common/lqr_gain_table.h"
 #include "modules/control/control_component/controller_task_base/common/mrac_controller.h"
 #include "modules/control/control_component/controller_task_base/common/trajectory_analyzer.h"
 #include "modules/control/control_component/controller_task_base/control_task.h"
@@ -110,9 +111,16 @@ class LatController : public ControlTask {
   // logic for reverse driving mode
   void UpdateDrivingOrientation();
 
-  void UpdateMatrix();
+  // Builds the discrete vehicle model compounded with the preview window and
+  // the state weighting at the given velocity and gear, then solves the LQR
+  // feedback gain.
+  void SolveLqrGain(const double linear_velocity, const bool reverse,
+                    Eigen::MatrixXd *matrix_k) const;
 
-  void UpdateMatrixCompound();
+  // Interpolates the feedback gain from the gain table of the gear.
+  // Return false if the velocity is not covered by the table.
+  bool LookupLqrGain(const double linear_velocity, const bool reverse,
+                     Eigen::MatrixXd *matrix_k) const;
 
   double ComputeFeedForward(double ref_curvature) const;
 
@@ -125,6 +133,7 @@ class LatController : public ControlTask {
   bool LoadControlConf();
   void InitializeFilters();
   void LoadLatGainScheduler();
+  void InitLqrGainTables();
   void LogInitParameters();
   void ProcessLogs(const SimpleLateralDebug *debug,
                    const canbus::Chassis *chassis);
@@ -179,28 +188,14 @@ class LatController : public ControlTask {
   // number of states without previews, includes
   // lateral error, lateral error rate, heading error, heading error rate
   const int basic_state_size_ = 4;
-  // vehicle state matrix
-  Eigen::MatrixXd matrix_a_;
-  // vehicle state matrix (discrete-time)
-  Eigen::MatrixXd matrix_ad_;
-  // vehicle state matrix compound; related to preview
-  Eigen::MatrixXd matrix_adc_;
-  // control matrix
-  Eigen::MatrixXd matrix_b_;
-  // control matrix (discrete-time)
-  Eigen::MatrixXd matrix_bd_;
-  // control matrix compound
-  Eigen::MatrixXd matrix_bdc_;
   // gain matrix
   Eigen::MatrixXd matrix_k_;
   // control authority weighting matrix
   Eigen::MatrixXd matrix_r_;
   // state weighting matrix
   Eigen::MatrixXd matrix_q_;
-  // updated state weighting matrix
-  Eigen::MatrixXd matrix_q_updated_;
-  // vehicle state matrix coefficients
-  Eigen::MatrixXd matrix_a_coeff_;
+  // state weighting matrix for reverse gear
+  Eigen::MatrixXd matrix_reverse_q_;
   // 4 by 1 matrix; state matrix
   Eigen::MatrixXd matrix_state_;
 
@@ -215,6 +210,10 @@ class LatController : public ControlTask {
 
   std::unique_ptr<Interpolation1D> heading_err_interpolation_;
 
+  // precomputed lqr gains of forward and reverse driving
+  LqrGainTable drive_lqr_gain_table_;
+  LqrGainTable reverse_lqr_gain_table_;
+
   // MeanFilter heading_rate_filter_;
   common::MeanFilter lateral_error_filter_;
   common::MeanFilter heading_error_filter_;
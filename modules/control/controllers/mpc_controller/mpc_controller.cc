@@ -475,7 +475,7 @@ Status MPCController::ComputeControlCommand(
       matrix_state_, lower_bound, upper_bound, lower_state_bound,
       upper_state_bound, reference_state, mpc_max_iteration_, horizon_,
       mpc_eps_);
-  if (!mpc_osqp.Solve(&control_cmd)) {
+  if (!mpc_osqp.Solve(&control_cmd, &mpc_solver_)) {
     AERROR << "MPC OSQP solver failed";
   } else {
     ADEBUG << "MPC OSQP problem solved! ";
@@ -704,6 +704,7 @@ Status MPCController::ComputeControlCommand(
 Status MPCController::Reset() {
   previous_heading_error_ = 0.0;
   previous_lateral_error_ = 0.0;
+  mpc_solver_.Reset();
   return Status::OK();
 }
 
@@ -244,6 +244,9 @@ class MPCController : public ControlTask {
   // parameters for mpc solver; threshold for computation
   double mpc_eps_ = 0.0;
 
+  // osqp workspace and last solution reused by the next control cycle
+  common::math::PersistentOsqpSolver mpc_solver_;
+
   common::DigitalFilter digital_filter_;
 
   common::DigitalFilter digital_filter_pitch_angle_;
@@ -69,6 +69,17 @@ DEFINE_uint32(max_update_size, 1000000,
 DEFINE_bool(sim_world_with_routing_path, false,
             "Whether the routing_path is included in sim_world proto.");
 
+DEFINE_bool(sim_world_delta_streaming, false,
+            "True to stream SimulationWorldDelta keyframes and deltas to "
+            "clients that ask for them instead of the full world.");
+
+DEFINE_int32(sim_world_keyframe_interval, 50,
+             "Number of sim_world updates between two keyframes.");
+
+DEFINE_int32(sim_world_delta_history_size, 20,
+             "Number of past sim_world versions deltas can be computed "
+             "against.");
+
 DEFINE_string(
     request_timeout_ms, "2000",
     "Timeout for network read and network write operations, in milliseconds.");
@@ -78,6 +89,18 @@ DEFINE_double(voxel_filter_size, 0.3, "VoxelGrid pointcloud filter leaf size");
 DEFINE_double(voxel_filter_height, 0.2,
               "VoxelGrid pointcloud filter leaf height");
 
+DEFINE_bool(enable_voxel_filter, false,
+            "True to downsample pointclouds to one point per voxel of "
+            "voxel_filter_size x voxel_filter_size x voxel_filter_height.");
+
+DEFINE_double(point_cloud_resolution, 0.0,
+              "Resolution in meters of the quantized pointcloud encoding "
+              "sent to the clients that request it, 0 to send floats only.");
+
+DEFINE_double(point_cloud_max_fps, 0.0,
+              "Max pointcloud frames per second sent to each client, 0 for no "
+              "limit.");
+
 DEFINE_double(system_status_lifetime_seconds, 30,
               "Lifetime of a valid SystemStatus message. It's more like a "
               "replay message if the timestamp is old, where we should ignore "
@@ -46,12 +46,24 @@ DECLARE_uint32(max_update_size);
 
 DECLARE_bool(sim_world_with_routing_path);
 
+DECLARE_bool(sim_world_delta_streaming);
+
+DECLARE_int32(sim_world_keyframe_interval);
+
+DECLARE_int32(sim_world_delta_history_size);
+
 DECLARE_string(request_timeout_ms);
 
 DECLARE_double(voxel_filter_size);
 
 DECLARE_double(voxel_filter_height);
 
+DECLARE_bool(enable_voxel_filter);
+
+DECLARE_double(point_cloud_resolution);
+
+DECLARE_double(point_cloud_max_fps);
+
 DECLARE_double(system_status_lifetime_seconds);
 
 DECLARE_string(lidar_height_yaml);
@@ -73,20 +73,8 @@ void WebSocketHandler::handleClose(CivetServer *server,
 }
 
 bool WebSocketHandler::BroadcastData(const std::string &data, bool skippable) {
-  std::vector<Connection *> connections_to_send;
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (connections_.empty()) {
-      return true;
-    }
-    for (auto &kv : connections_) {
-      Connection *conn = kv.first;
-      connections_to_send.push_back(conn);
-    }
-  }
-
   bool all_success = true;
-  for (Connection *conn : connections_to_send) {
+  for (Connection *conn : GetConnections()) {
     if (!SendData(conn, data, skippable)) {
       all_success = false;
     }
@@ -97,20 +85,8 @@ bool WebSocketHandler::BroadcastData(const std::string &data, bool skippable) {
 
 bool WebSocketHandler::BroadcastBinaryData(const std::string &data,
                                            bool skippable) {
-  std::vector<Connection *> connections_to_send;
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (connections_.empty()) {
-      return true;
-    }
-    for (auto &kv : connections_) {
-      Connection *conn = kv.first;
-      connections_to_send.push_back(conn);
-    }
-  }
-
   bool all_success = true;
-  for (Connection *conn : connections_to_send) {
+  for (Connection *conn : GetConnections()) {
     if (!SendData(conn, data, skippable, MG_WEBSOCKET_OPCODE_BINARY)) {
       all_success = false;
     }
@@ -119,6 +95,17 @@ bool WebSocketHandler::BroadcastBinaryData(const std::string &data,
   return all_success;
 }
 
+std::vector<WebSocketHandler::Connection *> WebSocketHandler::GetConnections()
+    const {
+  std::vector<Connection *> connections;
+  std::unique_lock<std::mutex> lock(mutex_);
+  connections.reserve(connections_.size());
+  for (auto &kv : connections_) {
+    connections.push_back(kv.first);
+  }
+  return connections;
+}
+
 bool WebSocketHandler::SendBinaryData(Connection *conn, const std::string &data,
                                       bool skippable) {
   return SendData(conn, data, skippable, MG_WEBSOCKET_OPCODE_BINARY);
@@ -138,6 +138,11 @@ class WebSocketHandler : public CivetWebSocketHandler {
   bool SendBinaryData(Connection *conn, const std::string &data,
                       bool skippable = false);
 
+  /**
+   * @brief Gets the currently maintained connections.
+   */
+  std::vector<Connection *> GetConnections() const;
+
   /**
    * @brief Add a new message handler for a message type.
    * @param type The name/key to identify the message type.
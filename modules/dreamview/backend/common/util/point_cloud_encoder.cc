@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/common/util/point_cloud_encoder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+namespace {
+
+// Voxel indices take 21 bits per axis in the voxel key.
+constexpr int kVoxelIndexBits = 21;
+constexpr int64_t kVoxelIndexOffset = int64_t{1} << (kVoxelIndexBits - 1);
+constexpr int64_t kVoxelIndexMax = (int64_t{1} << kVoxelIndexBits) - 1;
+
+// Quantized coordinates are bounded to +-2^29 so that the difference of
+// two of them, at most 2^30 in magnitude, fits in int32.
+constexpr double kQuantizedMax = static_cast<double>(1 << 29);
+
+uint64_t VoxelIndex(const float value, const double leaf) {
+  const int64_t index =
+      static_cast<int64_t>(std::floor(value / leaf)) + kVoxelIndexOffset;
+  return static_cast<uint64_t>(std::min(std::max<int64_t>(index, 0),
+                                        kVoxelIndexMax));
+}
+
+int32_t QuantizedValue(const float value, const double resolution) {
+  const double quantized = std::round(value / resolution);
+  return static_cast<int32_t>(
+      std::min(std::max(quantized, -kQuantizedMax), kQuantizedMax));
+}
+
+}  // namespace
+
+PointCloudEncoder::PointCloudEncoder(const double leaf_size,
+                                     const double leaf_height,
+                                     const double resolution)
+    : leaf_size_(leaf_size),
+      leaf_height_(leaf_height > 0.0 ? leaf_height : leaf_size),
+      resolution_(resolution) {}
+
+void PointCloudEncoder::Encode(const drivers::PointCloud &cloud,
+                               const float z_offset,
+                               apollo::dreamview::PointCloud *encoded,
+                               apollo::dreamview::PointCloud *quantized) {
+  encoded->Clear();
+  if (quantized != nullptr) {
+    quantized->Clear();
+  }
+  points_.clear();
+  points_.reserve(cloud.point_size());
+  for (const auto &point : cloud.point()) {
+    if (std::isfinite(point.x()) && std::isfinite(point.y()) &&
+        std::isfinite(point.z())) {
+      points_.push_back({point.x(), point.y(), point.z() + z_offset});
+    }
+  }
+
+  if (leaf_size_ > 0.0) {
+    Downsample();
+  }
+
+  if (quantized != nullptr && quantizes()) {
+    Quantize(quantized);
+  }
+  auto *num = encoded->mutable_num();
+  num->Reserve(static_cast<int>(points_.size() * 3));
+  for (const Point &point : points_) {
+    num->AddAlreadyReserved(point.x);
+    num->AddAlreadyReserved(point.y);
+    num->AddAlreadyReserved(point.z);
+  }
+}
+
+void PointCloudEncoder::Downsample() {
+  voxels_.clear();
+  voxels_.reserve(points_.size());
+  for (size_t i = 0; i < points_.size(); ++i) {
+    const Point &point = points_[i];
+    const uint64_t key =
+        (VoxelIndex(point.x, leaf_size_) << (2 * kVoxelIndexBits)) |
+        (VoxelIndex(point.y, leaf_size_) << kVoxelIndexBits) |
+        VoxelIndex(point.z, leaf_height_);
+    voxels_.emplace_back(key, static_cast<uint32_t>(i));
+  }
+  // Sorting keeps neighbouring voxels next to each other, which also keeps
+  // the delta coded coordinates small.
+  std::sort(voxels_.begin(), voxels_.end());
+
+  downsampled_.clear();
+  for (size_t begin = 0; begin < voxels_.size();) {
+    size_t end = begin;
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    for (; end < voxels_.size() && voxels_[end].first == voxels_[begin].first;
+         ++end) {
+      const Point &point = points_[voxels_[end].second];
+      x += point.x;
+      y += point.y;
+      z += point.z;
+    }
+    const double count = static_cast<double>(end - begin);
+    downsampled_.push_back({static_cast<float>(x / count),
+                            static_cast<float>(y / count),
+                            static_cast<float>(z / count)});
+    begin = end;
+  }
+  points_.swap(downsampled_);
+}
+
+void PointCloudEncoder::Quantize(
+    apollo::dreamview::PointCloud *encoded) const {
+  // Quantize with the resolution as sent so that clients decode exactly.
+  const float resolution = static_cast<float>(resolution_);
+  encoded->set_resolution(resolution);
+  auto *delta = encoded->mutable_delta();
+  delta->Reserve(static_cast<int>(points_.size() * 3));
+  int32_t last_x = 0;
+  int32_t last_y = 0;
+  int32_t last_z = 0;
+  for (const Point &point : points_) {
+    const int32_t x = QuantizedValue(point.x, resolution);
+    const int32_t y = QuantizedValue(point.y, resolution);
+    const int32_t z = QuantizedValue(point.z, resolution);
+    delta->AddAlreadyReserved(x - last_x);
+    delta->AddAlreadyReserved(y - last_y);
+    delta->AddAlreadyReserved(z - last_z);
+    last_x = x;
+    last_y = y;
+    last_z = z;
+  }
+}
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
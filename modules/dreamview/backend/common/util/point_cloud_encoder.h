@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Downsamples and encodes pointclouds for the frontend.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
+#include "modules/dreamview/proto/point_cloud.pb.h"
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+/**
+ * @class PointCloudEncoder
+ * @brief Turns a drivers::PointCloud into the PointCloud sent to the
+ * frontend.
+ *
+ * Points are optionally reduced to the centroid of each occupied voxel,
+ * which replaces the pcl::VoxelGrid filter without converting the cloud to
+ * PCL first. They are always sent as floats, and can also be quantized to a
+ * fixed resolution and delta coded for the clients that decode it.
+ * Points stay in the lidar frame, which moves with the car, so quantizing
+ * them keeps the same absolute error anywhere on the map.
+ *
+ * An encoder keeps its buffers between calls and must not be shared by
+ * threads.
+ */
+class PointCloudEncoder {
+ public:
+  /**
+   * @param leaf_size Voxel size along x and y, no downsampling if not
+   * positive.
+   * @param leaf_height Voxel size along z.
+   * @param resolution Quantization step, no quantized encoding if not
+   * positive.
+   */
+  PointCloudEncoder(const double leaf_size, const double leaf_height,
+                    const double resolution);
+
+  /**
+   * @brief Encodes the finite points of the cloud, shifted up by z_offset,
+   * as floats into encoded and, if quantized is given and quantizes() is
+   * true, quantized into quantized.
+   */
+  void Encode(const drivers::PointCloud &cloud, const float z_offset,
+              apollo::dreamview::PointCloud *encoded,
+              apollo::dreamview::PointCloud *quantized = nullptr);
+
+  bool quantizes() const { return resolution_ > 0.0; }
+
+ private:
+  struct Point {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+  };
+
+  void Downsample();
+
+  void Quantize(apollo::dreamview::PointCloud *encoded) const;
+
+  const double leaf_size_;
+  const double leaf_height_;
+  const double resolution_;
+
+  std::vector<Point> points_;
+  // Voxel key and index of each point, sorted to group the voxels.
+  std::vector<std::pair<uint64_t, uint32_t>> voxels_;
+  std::vector<Point> downsampled_;
+};
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/common/util/point_cloud_encoder.h"
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+namespace {
+
+void AddPoint(const float x, const float y, const float z,
+              drivers::PointCloud *cloud) {
+  auto *point = cloud->add_point();
+  point->set_x(x);
+  point->set_y(y);
+  point->set_z(z);
+}
+
+}  // namespace
+
+TEST(PointCloudEncoderTest, floats) {
+  drivers::PointCloud cloud;
+  AddPoint(1.0f, 2.0f, 3.0f, &cloud);
+  AddPoint(std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f, &cloud);
+  AddPoint(-4.0f, 5.0f, -6.0f, &cloud);
+
+  PointCloudEncoder encoder(0.0, 0.0, 0.0);
+  EXPECT_FALSE(encoder.quantizes());
+  apollo::dreamview::PointCloud encoded;
+  apollo::dreamview::PointCloud quantized;
+  quantized.add_delta(1);
+  encoder.Encode(cloud, 1.5f, &encoded, &quantized);
+  ASSERT_EQ(6, encoded.num_size());
+  EXPECT_FLOAT_EQ(1.0f, encoded.num(0));
+  EXPECT_FLOAT_EQ(2.0f, encoded.num(1));
+  EXPECT_FLOAT_EQ(4.5f, encoded.num(2));
+  EXPECT_FLOAT_EQ(-4.0f, encoded.num(3));
+  EXPECT_FLOAT_EQ(-4.5f, encoded.num(5));
+  EXPECT_FALSE(encoded.has_resolution());
+  EXPECT_EQ(0, encoded.delta_size());
+  // Nothing to quantize without a resolution.
+  EXPECT_EQ(0, quantized.ByteSizeLong());
+}
+
+TEST(PointCloudEncoderTest, downsample) {
+  drivers::PointCloud cloud;
+  // Two points in voxel (0, 0, 0), one in (-1, 0, 0) and one in (0, 0, 1).
+  AddPoint(0.1f, 0.2f, 0.05f, &cloud);
+  AddPoint(0.3f, 0.4f, 0.15f, &cloud);
+  AddPoint(-0.1f, 0.2f, 0.05f, &cloud);
+  AddPoint(0.1f, 0.2f, 0.25f, &cloud);
+
+  PointCloudEncoder encoder(0.5, 0.2, 0.0);
+  apollo::dreamview::PointCloud encoded;
+  encoder.Encode(cloud, 0.0f, &encoded);
+  ASSERT_EQ(9, encoded.num_size());
+  EXPECT_FLOAT_EQ(-0.1f, encoded.num(0));
+  EXPECT_FLOAT_EQ(0.2f, encoded.num(3));
+  EXPECT_FLOAT_EQ(0.3f, encoded.num(4));
+  EXPECT_FLOAT_EQ(0.1f, encoded.num(5));
+  EXPECT_FLOAT_EQ(0.25f, encoded.num(8));
+
+  // The buffers are reused by the next cloud.
+  encoder.Encode(cloud, 0.0f, &encoded);
+  EXPECT_EQ(9, encoded.num_size());
+}
+
+TEST(PointCloudEncoderTest, quantize) {
+  drivers::PointCloud cloud;
+  for (int i = 0; i < 100; ++i) {
+    AddPoint(0.37f * static_cast<float>(i) - 20.0f,
+             std::sin(static_cast<float>(i)) * 50.0f,
+             0.01f * static_cast<float>(i), &cloud);
+  }
+
+  const double resolution = 0.02;
+  PointCloudEncoder encoder(0.0, 0.0, resolution);
+  EXPECT_TRUE(encoder.quantizes());
+  apollo::dreamview::PointCloud floats;
+  apollo::dreamview::PointCloud encoded;
+  encoder.Encode(cloud, 0.0f, &floats, &encoded);
+  // The floats are still sent to the clients that do not decode deltas.
+  EXPECT_EQ(300, floats.num_size());
+  EXPECT_EQ(0, floats.delta_size());
+  EXPECT_EQ(0, encoded.num_size());
+  ASSERT_EQ(300, encoded.delta_size());
+
+  // No quantized output unless asked for.
+  encoder.Encode(cloud, 0.0f, &floats);
+  EXPECT_EQ(300, floats.num_size());
+  EXPECT_FALSE(floats.has_resolution());
+
+  int32_t quantized[3] = {0, 0, 0};
+  for (int i = 0; i < 100; ++i) {
+    const auto &point = cloud.point(i);
+    const float expected[3] = {point.x(), point.y(), point.z()};
+    for (int j = 0; j < 3; ++j) {
+      quantized[j] += encoded.delta(i * 3 + j);
+      EXPECT_NEAR(expected[j], quantized[j] * encoded.resolution(),
+                  resolution / 2 + 1e-5);
+    }
+  }
+}
+
+TEST(PointCloudEncoderTest, quantize_extreme) {
+  drivers::PointCloud cloud;
+  const float max = std::numeric_limits<float>::max();
+  AddPoint(max, -max, max, &cloud);
+  AddPoint(-max, max, -max, &cloud);
+  AddPoint(max, -max, 0.0f, &cloud);
+
+  const double resolution = 0.01;
+  PointCloudEncoder encoder(0.0, 0.0, resolution);
+  apollo::dreamview::PointCloud floats;
+  apollo::dreamview::PointCloud encoded;
+  encoder.Encode(cloud, 0.0f, &floats, &encoded);
+  ASSERT_EQ(9, encoded.delta_size());
+
+  // Coordinates are clamped and the deltas between them do not overflow.
+  const int64_t bound = int64_t{1} << 29;
+  int64_t quantized[3] = {0, 0, 0};
+  const int64_t expected[3][3] = {{bound, -bound, bound},
+                                  {-bound, bound, -bound},
+                                  {bound, -bound, 0}};
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      quantized[j] += encoded.delta(i * 3 + j);
+      EXPECT_EQ(expected[i][j], quantized[j]);
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
@@ -0,0 +1,293 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/common/util/simulation_world_delta_encoder.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "google/protobuf/io/coded_stream.h"
+
+#include "modules/common_msgs/dreamview_msgs/simulation_world.pb.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+namespace {
+
+using google::protobuf::io::CodedInputStream;
+
+constexpr uint32_t kWorldField = 3;
+constexpr uint32_t kObjectField = 3;
+constexpr uint32_t kObjectIdField = 1;
+constexpr uint32_t kPlanningDataField = 20;
+
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// Skips the value of a field whose tag has just been read.
+bool SkipValue(const uint32_t tag, CodedInputStream *input) {
+  switch (tag & 0x7) {
+    case kWireTypeVarint: {
+      uint64_t value = 0;
+      return input->ReadVarint64(&value);
+    }
+    case kWireTypeFixed64:
+      return input->Skip(8);
+    case kWireTypeLengthDelimited: {
+      uint32_t length = 0;
+      return input->ReadVarint32(&length) &&
+             input->Skip(static_cast<int>(length));
+    }
+    case kWireTypeFixed32:
+      return input->Skip(4);
+    default:
+      // Groups are not used by SimulationWorld.
+      return false;
+  }
+}
+
+CodedInputStream MakeInput(const std::string &data) {
+  return CodedInputStream(reinterpret_cast<const uint8_t *>(data.data()),
+                          static_cast<int>(data.size()));
+}
+
+// Reads the id of an Object record, i.e. tag, length and payload.
+bool ReadObjectId(const std::string &record, std::string *id) {
+  CodedInputStream input = MakeInput(record);
+  uint32_t length = 0;
+  if (input.ReadTag() == 0 || !input.ReadVarint32(&length)) {
+    return false;
+  }
+  input.PushLimit(static_cast<int>(length));
+  bool found = false;
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    if (tag == ((kObjectIdField << 3) | kWireTypeLengthDelimited)) {
+      uint32_t id_length = 0;
+      if (!input.ReadVarint32(&id_length) ||
+          !input.ReadString(id, static_cast<int>(id_length))) {
+        return false;
+      }
+      found = true;
+    } else if (!SkipValue(tag, &input)) {
+      return false;
+    }
+  }
+  return found;
+}
+
+void AppendVarint(uint64_t value, std::string *data) {
+  while (value >= 0x80) {
+    data->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data->push_back(static_cast<char>(value));
+}
+
+// Appends the world as field 3 of the SimulationWorldDelta in data.
+void AppendWorld(const std::string &world, std::string *data) {
+  AppendVarint((kWorldField << 3) | kWireTypeLengthDelimited, data);
+  AppendVarint(world.size(), data);
+  data->append(world);
+}
+
+}  // namespace
+
+SimulationWorldDeltaEncoder::SimulationWorldDeltaEncoder(
+    const int keyframe_interval, const int history_size)
+    : keyframe_interval_(std::max(keyframe_interval, 1)),
+      history_size_(std::max(history_size, 1)) {}
+
+uint32_t SimulationWorldDeltaEncoder::Update(const std::string &world) {
+  std::map<uint32_t, std::string> fields;
+  std::vector<std::pair<std::string, std::string>> objects;
+  Snapshot snapshot;
+
+  CodedInputStream input = MakeInput(world);
+  for (int begin = input.CurrentPosition();; begin = input.CurrentPosition()) {
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      break;
+    }
+    if (!SkipValue(tag, &input)) {
+      AERROR << "Failed to decode the simulation world.";
+      return 0;
+    }
+    std::string record = world.substr(begin, input.CurrentPosition() - begin);
+    const uint32_t field = tag >> 3;
+    if (field != kObjectField) {
+      fields[field].append(record);
+      continue;
+    }
+    std::string id;
+    if (!ReadObjectId(record, &id) ||
+        !snapshot.object_hashes
+             .emplace(id, std::hash<std::string>()(record))
+             .second) {
+      snapshot.objects_keyed = false;
+    }
+    objects.emplace_back(std::move(id), std::move(record));
+  }
+  if (input.CurrentPosition() != static_cast<int>(world.size())) {
+    AERROR << "Failed to decode the simulation world.";
+    return 0;
+  }
+  for (const auto &field : fields) {
+    snapshot.field_hashes[field.first] =
+        std::hash<std::string>()(field.second);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  snapshot.version = ++version_;
+  if (keyframe_version_ == 0 ||
+      version_ - keyframe_version_ >= keyframe_interval_) {
+    keyframe_version_ = version_;
+  }
+  fields_ = std::move(fields);
+  objects_ = std::move(objects);
+  history_.push_back(std::move(snapshot));
+  while (history_.size() > history_size_) {
+    history_.pop_front();
+  }
+  cache_.clear();
+  return version_;
+}
+
+bool SimulationWorldDeltaEncoder::Encode(const uint32_t base_version,
+                                         const bool with_planning,
+                                         std::string *data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (version_ == 0) {
+    return false;
+  }
+
+  const Snapshot *base = nullptr;
+  if (base_version >= keyframe_version_) {
+    base = FindSnapshot(base_version);
+  }
+  if (base != nullptr &&
+      !(base->objects_keyed && history_.back().objects_keyed)) {
+    base = nullptr;
+  }
+
+  const auto key = std::make_pair(base ? base_version : 0, with_planning);
+  auto iter = cache_.find(key);
+  if (iter == cache_.end()) {
+    std::string encoded;
+    if (base == nullptr) {
+      EncodeKeyframe(with_planning, &encoded);
+    } else {
+      EncodeDelta(*base, with_planning, &encoded);
+    }
+    iter = cache_.emplace(key, std::move(encoded)).first;
+  }
+  *data = iter->second;
+  return true;
+}
+
+uint32_t SimulationWorldDeltaEncoder::version() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return version_;
+}
+
+const SimulationWorldDeltaEncoder::Snapshot *
+SimulationWorldDeltaEncoder::FindSnapshot(const uint32_t version) const {
+  for (const auto &snapshot : history_) {
+    if (snapshot.version == version) {
+      return &snapshot;
+    }
+  }
+  return nullptr;
+}
+
+void SimulationWorldDeltaEncoder::EncodeKeyframe(const bool with_planning,
+                                                 std::string *data) const {
+  SimulationWorldDelta delta;
+  delta.set_version(version_);
+  delta.set_base_version(0);
+  delta.SerializeToString(data);
+
+  std::string world;
+  for (const auto &field : fields_) {
+    if (field.first != kPlanningDataField || with_planning) {
+      world.append(field.second);
+    }
+  }
+  for (const auto &object : objects_) {
+    world.append(object.second);
+  }
+  AppendWorld(world, data);
+}
+
+void SimulationWorldDeltaEncoder::EncodeDelta(const Snapshot &base,
+                                              const bool with_planning,
+                                              std::string *data) const {
+  const Snapshot &latest = history_.back();
+  SimulationWorldDelta delta;
+  delta.set_version(version_);
+  delta.set_base_version(base.version);
+
+  std::string world;
+  for (const auto &field : fields_) {
+    if (field.first == kPlanningDataField) {
+      // Planning data changes every cycle and is only sent on request.
+      if (with_planning) {
+        world.append(field.second);
+      }
+      continue;
+    }
+    auto iter = base.field_hashes.find(field.first);
+    if (iter == base.field_hashes.end() ||
+        iter->second != latest.field_hashes.at(field.first)) {
+      world.append(field.second);
+    }
+  }
+  for (const auto &field : base.field_hashes) {
+    if (field.first != kPlanningDataField &&
+        fields_.find(field.first) == fields_.end()) {
+      delta.add_cleared_field(field.first);
+    }
+  }
+  if (!with_planning || fields_.count(kPlanningDataField) == 0) {
+    delta.add_cleared_field(kPlanningDataField);
+  }
+
+  for (const auto &object : objects_) {
+    auto iter = base.object_hashes.find(object.first);
+    if (iter == base.object_hashes.end() ||
+        iter->second != latest.object_hashes.at(object.first)) {
+      world.append(object.second);
+    }
+  }
+  for (const auto &object : base.object_hashes) {
+    if (latest.object_hashes.find(object.first) ==
+        latest.object_hashes.end()) {
+      delta.add_removed_object_id(object.first);
+    }
+  }
+
+  delta.SerializeToString(data);
+  AppendWorld(world, data);
+}
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Encodes SimulationWorld updates as keyframes and deltas.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+/**
+ * @class SimulationWorldDeltaEncoder
+ * @brief Keeps the latest SimulationWorld in wire format together with
+ * content hashes of a few past versions, and turns them into
+ * SimulationWorldDelta messages for clients that hold one of those versions.
+ *
+ * Top-level fields are compared as a whole, so an unchanged routing path or
+ * map element list is not resent. Objects are compared one by one by id.
+ * The world is handled in wire format only and is never parsed into a
+ * SimulationWorld message.
+ *
+ * Encoded updates are cached until the next Update(), so every client at the
+ * same version shares one serialization. The class is thread-safe.
+ */
+class SimulationWorldDeltaEncoder {
+ public:
+  /**
+   * @param keyframe_interval Number of updates between two keyframes.
+   * @param history_size Number of past versions deltas can be based on.
+   */
+  SimulationWorldDeltaEncoder(const int keyframe_interval,
+                              const int history_size);
+
+  /**
+   * @brief Takes a new SimulationWorld in wire format, which should contain
+   * the planning data.
+   * @return The version assigned to it, or 0 if it could not be decoded.
+   */
+  uint32_t Update(const std::string &world);
+
+  /**
+   * @brief Encodes a SimulationWorldDelta that brings a client holding
+   * base_version to the latest version. A keyframe is encoded instead if
+   * base_version is 0, no longer known or older than the latest keyframe.
+   * @param base_version The version the client holds, 0 if none.
+   * @param with_planning Whether the planning data is sent.
+   * @param data The encoded SimulationWorldDelta.
+   * @return False if no world has been received yet.
+   */
+  bool Encode(const uint32_t base_version, const bool with_planning,
+              std::string *data);
+
+  uint32_t version() const;
+
+ private:
+  struct Snapshot {
+    uint32_t version = 0;
+    // Hash of the records of each top-level field, objects excluded.
+    std::unordered_map<uint32_t, size_t> field_hashes;
+    // Hash of each object record, keyed by object id.
+    std::unordered_map<std::string, size_t> object_hashes;
+    // False if some object has no id or shares it with another one.
+    bool objects_keyed = true;
+  };
+
+  const Snapshot *FindSnapshot(const uint32_t version) const;
+
+  void EncodeKeyframe(const bool with_planning, std::string *data) const;
+
+  void EncodeDelta(const Snapshot &base, const bool with_planning,
+                   std::string *data) const;
+
+  const uint32_t keyframe_interval_;
+  const size_t history_size_;
+
+  mutable std::mutex mutex_;
+
+  uint32_t version_ = 0;
+  uint32_t keyframe_version_ = 0;
+
+  // Records of the latest world grouped by field number, objects excluded.
+  std::map<uint32_t, std::string> fields_;
+  // Object records of the latest world with their ids, in order.
+  std::vector<std::pair<std::string, std::string>> objects_;
+
+  // Snapshots of the latest versions, the newest at the back.
+  std::deque<Snapshot> history_;
+
+  // Updates encoded for the latest version, keyed by
+  // (base_version, with_planning).
+  std::map<std::pair<uint32_t, bool>, std::string> cache_;
+};
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
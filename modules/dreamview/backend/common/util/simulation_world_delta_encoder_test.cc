@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/dreamview/backend/common/util/simulation_world_delta_encoder.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+
+#include "modules/common_msgs/dreamview_msgs/simulation_world.pb.h"
+
+namespace apollo {
+namespace dreamview {
+namespace util {
+
+namespace {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Reflection;
+using google::protobuf::util::MessageDifferencer;
+
+// Applies a SimulationWorldDelta the way a client is expected to.
+void ApplyDelta(const SimulationWorldDelta &delta, SimulationWorld *world) {
+  if (delta.base_version() == 0) {
+    *world = delta.world();
+    return;
+  }
+  const Reflection *reflection = world->GetReflection();
+  std::vector<const FieldDescriptor *> fields;
+  reflection->ListFields(delta.world(), &fields);
+  for (const FieldDescriptor *field : fields) {
+    if (field->number() == SimulationWorld::kObjectFieldNumber) {
+      continue;
+    }
+    reflection->ClearField(world, field);
+  }
+  for (const uint32_t number : delta.cleared_field()) {
+    reflection->ClearField(
+        world, world->GetDescriptor()->FindFieldByNumber(number));
+  }
+  SimulationWorld changed = delta.world();
+  changed.clear_object();
+  world->MergeFrom(changed);
+
+  auto *objects = world->mutable_object();
+  for (const auto &id : delta.removed_object_id()) {
+    objects->erase(std::remove_if(
+                       objects->begin(), objects->end(),
+                       [&id](const Object &object) { return object.id() == id; }),
+                   objects->end());
+  }
+  for (const auto &object : delta.world().object()) {
+    auto iter = std::find_if(
+        objects->begin(), objects->end(),
+        [&object](const Object &other) { return other.id() == object.id(); });
+    if (iter == objects->end()) {
+      *world->add_object() = object;
+    } else {
+      *iter = object;
+    }
+  }
+}
+
+void SortObjects(SimulationWorld *world) {
+  std::sort(world->mutable_object()->begin(), world->mutable_object()->end(),
+            [](const Object &a, const Object &b) { return a.id() < b.id(); });
+}
+
+bool SameWorld(SimulationWorld expected, SimulationWorld actual) {
+  SortObjects(&expected);
+  SortObjects(&actual);
+  return MessageDifferencer::Equals(expected, actual);
+}
+
+Object MakeObject(const std::string &id, const double x) {
+  Object object;
+  object.set_id(id);
+  object.set_position_x(x);
+  object.set_position_y(-x);
+  return object;
+}
+
+SimulationWorld MakeWorld() {
+  SimulationWorld world;
+  world.set_sequence_num(1);
+  world.set_timestamp(1000.0);
+  *world.add_object() = MakeObject("1", 1.0);
+  *world.add_object() = MakeObject("2", 2.0);
+  *world.add_object() = MakeObject("3", 3.0);
+  world.mutable_auto_driving_car()->set_position_x(10.0);
+  world.add_route_path()->add_point()->set_x(1.0);
+  world.set_routing_time(100.0);
+  world.mutable_map_element_ids()->add_lane("lane_1");
+  world.mutable_planning_data()->add_path()->set_name("path");
+  return world;
+}
+
+SimulationWorldDelta EncodeAndParse(SimulationWorldDeltaEncoder *encoder,
+                                    const uint32_t base_version,
+                                    const bool with_planning) {
+  std::string data;
+  EXPECT_TRUE(encoder->Encode(base_version, with_planning, &data));
+  SimulationWorldDelta delta;
+  EXPECT_TRUE(delta.ParseFromString(data));
+  return delta;
+}
+
+}  // namespace
+
+TEST(SimulationWorldDeltaEncoderTest, keyframe) {
+  SimulationWorldDeltaEncoder encoder(10, 5);
+  std::string data;
+  EXPECT_FALSE(encoder.Encode(0, true, &data));
+
+  const SimulationWorld world = MakeWorld();
+  EXPECT_EQ(1, encoder.Update(world.SerializeAsString()));
+
+  SimulationWorldDelta delta = EncodeAndParse(&encoder, 0, true);
+  EXPECT_EQ(1, delta.version());
+  EXPECT_EQ(0, delta.base_version());
+  EXPECT_TRUE(SameWorld(world, delta.world()));
+
+  delta = EncodeAndParse(&encoder, 0, false);
+  SimulationWorld without_planning = world;
+  without_planning.clear_planning_data();
+  EXPECT_TRUE(SameWorld(without_planning, delta.world()));
+}
+
+TEST(SimulationWorldDeltaEncoderTest, delta) {
+  SimulationWorldDeltaEncoder encoder(10, 5);
+  SimulationWorld world = MakeWorld();
+  encoder.Update(world.SerializeAsString());
+  SimulationWorld client = EncodeAndParse(&encoder, 0, true).world();
+
+  world.set_sequence_num(2);
+  world.mutable_object(1)->set_position_x(20.0);
+  world.mutable_object()->DeleteSubrange(2, 1);
+  *world.add_object() = MakeObject("4", 4.0);
+  world.clear_map_element_ids();
+  encoder.Update(world.SerializeAsString());
+
+  const SimulationWorldDelta delta = EncodeAndParse(&encoder, 1, true);
+  EXPECT_EQ(2, delta.version());
+  EXPECT_EQ(1, delta.base_version());
+  // Only the changed and added objects are sent, the route is not resent.
+  ASSERT_EQ(2, delta.world().object_size());
+  EXPECT_EQ("2", delta.world().object(0).id());
+  EXPECT_EQ("4", delta.world().object(1).id());
+  EXPECT_EQ(0, delta.world().route_path_size());
+  ASSERT_EQ(1, delta.removed_object_id_size());
+  EXPECT_EQ("3", delta.removed_object_id(0));
+
+  ApplyDelta(delta, &client);
+  EXPECT_TRUE(SameWorld(world, client));
+
+  // A client that is up to date gets an empty update.
+  const SimulationWorldDelta empty = EncodeAndParse(&encoder, 2, false);
+  EXPECT_EQ(0, empty.world().object_size());
+  EXPECT_FALSE(empty.world().has_sequence_num());
+}
+
+TEST(SimulationWorldDeltaEncoderTest, falls_back_to_keyframe) {
+  SimulationWorldDeltaEncoder encoder(3, 2);
+  SimulationWorld world = MakeWorld();
+  for (int i = 1; i <= 3; ++i) {
+    world.set_sequence_num(i);
+    encoder.Update(world.SerializeAsString());
+  }
+  // Version 1 has left the history.
+  EXPECT_EQ(0, EncodeAndParse(&encoder, 1, true).base_version());
+  EXPECT_EQ(2, EncodeAndParse(&encoder, 2, true).base_version());
+  // Unknown version.
+  EXPECT_EQ(0, EncodeAndParse(&encoder, 7, true).base_version());
+
+  // Version 4 is a keyframe, so older clients resynchronize.
+  world.set_sequence_num(4);
+  encoder.Update(world.SerializeAsString());
+  EXPECT_EQ(0, EncodeAndParse(&encoder, 3, true).base_version());
+
+  // Objects without a unique id cannot be matched.
+  world.set_sequence_num(5);
+  *world.add_object() = MakeObject("1", 5.0);
+  encoder.Update(world.SerializeAsString());
+  EXPECT_EQ(0, EncodeAndParse(&encoder, 4, true).base_version());
+}
+
+TEST(SimulationWorldDeltaEncoderTest, planning_data) {
+  SimulationWorldDeltaEncoder encoder(10, 5);
+  SimulationWorld world = MakeWorld();
+  encoder.Update(world.SerializeAsString());
+  SimulationWorld client = EncodeAndParse(&encoder, 0, true).world();
+
+  world.set_sequence_num(2);
+  encoder.Update(world.SerializeAsString());
+  SimulationWorldDelta delta = EncodeAndParse(&encoder, 1, true);
+  EXPECT_TRUE(delta.world().has_planning_data());
+
+  delta = EncodeAndParse(&encoder, 1, false);
+  EXPECT_FALSE(delta.world().has_planning_data());
+  ApplyDelta(delta, &client);
+  world.clear_planning_data();
+  EXPECT_TRUE(SameWorld(world, client));
+}
+
+}  // namespace util
+}  // namespace dreamview
+}  // namespace apollo
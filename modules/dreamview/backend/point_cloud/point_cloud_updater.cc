@@ -20,7 +20,6 @@
 #include <vector>
 
 #include "nlohmann/json.hpp"
-#include "pcl/filters/voxel_grid.h"
 #include "yaml-cpp/yaml.h"
 
 #include "modules/dreamview/proto/point_cloud.pb.h"
@@ -29,10 +28,12 @@
 #include "cyber/common/log.h"
 #include "cyber/time/clock.h"
 #include "modules/common/adapters/adapter_gflags.h"
+#include "modules/common/util/json_util.h"
 #include "modules/dreamview/backend/common/dreamview_gflags.h"
 namespace apollo {
 namespace dreamview {
 
+using apollo::common::util::JsonUtil;
 using apollo::localization::LocalizationEstimate;
 using Json = nlohmann::json;
 
@@ -44,7 +45,8 @@ PointCloudUpdater::PointCloudUpdater(WebSocketHandler *websocket,
     : node_(cyber::CreateNode("point_cloud")),
       websocket_(websocket),
       point_cloud_str_(""),
-      future_ready_(true),
+      encoder_(FLAGS_enable_voxel_filter ? FLAGS_voxel_filter_size : 0.0,
+               FLAGS_voxel_filter_height, FLAGS_point_cloud_resolution),
       simworld_updater_(simworld_updater) {
   RegisterMessageHandlers();
 }
@@ -83,20 +85,51 @@ void PointCloudUpdater::RegisterMessageHandlers() {
         response["type"] = "PointCloudStatus";
         response["enabled"] = enabled_;
         websocket_->SendData(conn, response.dump());
+        // A new connection may reuse the address of a closed one.
+        {
+          std::lock_guard<std::mutex> lock(last_send_time_mutex_);
+          last_send_time_.erase(conn);
+        }
+        std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+        quantized_clients_.erase(conn);
+      });
+  // Clients that decode the quantized PointCloud opt in with
+  // {"type": "RequestQuantizedPointCloud", "enable": true}, all the others
+  // keep receiving the points as floats.
+  websocket_->RegisterMessageHandler(
+      "RequestQuantizedPointCloud",
+      [this](const Json &json, WebSocketHandler::Connection *conn) {
+        bool enable = true;
+        JsonUtil::GetBoolean(json, "enable", &enable);
+        std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+        if (enable && encoder_.quantizes()) {
+          quantized_clients_.insert(conn);
+        } else {
+          quantized_clients_.erase(conn);
+        }
       });
   websocket_->RegisterMessageHandler(
       "RequestPointCloud",
       [this](const Json &json, WebSocketHandler::Connection *conn) {
+        if (!TakeFrameSlot(conn)) {
+          return;
+        }
+        bool quantized = false;
+        {
+          std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+          quantized = quantized_clients_.count(conn) > 0;
+        }
         std::string to_send;
         // If there is no point_cloud data for more than 2 seconds, reset.
         if (point_cloud_str_ != "" &&
             std::fabs(last_localization_time_ - last_point_cloud_time_) > 2.0) {
           boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
           point_cloud_str_ = "";
+          quantized_point_cloud_str_ = "";
         }
         {
           boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
-          to_send = point_cloud_str_;
+          to_send = quantized ? quantized_point_cloud_str_ : point_cloud_str_;
         }
         websocket_->SendBinaryData(conn, to_send, true);
       });
@@ -212,34 +245,21 @@ void PointCloudUpdater::Start(DvCallback callback_api) {
   LoadLidarHeight(FLAGS_lidar_height_yaml);
 }
 
-void PointCloudUpdater::Stop() {
-  if (enabled_) {
-    async_future_.wait();
-  }
-}
-
-pcl::PointCloud<pcl::PointXYZ>::Ptr PointCloudUpdater::ConvertPCLPointCloud(
-    const std::shared_ptr<drivers::PointCloud> &point_cloud) {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr(
-      new pcl::PointCloud<pcl::PointXYZ>);
-  pcl_ptr->width = point_cloud->width();
-  pcl_ptr->height = point_cloud->height();
-  pcl_ptr->is_dense = false;
+void PointCloudUpdater::Stop() { enabled_ = false; }
 
-  if (point_cloud->width() * point_cloud->height() !=
-      static_cast<unsigned int>(point_cloud->point_size())) {
-    pcl_ptr->width = 1;
-    pcl_ptr->height = point_cloud->point_size();
+bool PointCloudUpdater::TakeFrameSlot(WebSocketHandler::Connection *conn) {
+  if (FLAGS_point_cloud_max_fps <= 0.0) {
+    return true;
   }
-  pcl_ptr->points.resize(point_cloud->point_size());
-
-  for (size_t i = 0; i < pcl_ptr->points.size(); ++i) {
-    const auto &point = point_cloud->point(static_cast<int>(i));
-    pcl_ptr->points[i].x = point.x();
-    pcl_ptr->points[i].y = point.y();
-    pcl_ptr->points[i].z = point.z();
+  const double now = cyber::Clock::NowInSeconds();
+  std::lock_guard<std::mutex> lock(last_send_time_mutex_);
+  auto iter = last_send_time_.find(conn);
+  if (iter != last_send_time_.end() &&
+      now - iter->second < 1.0 / FLAGS_point_cloud_max_fps) {
+    return false;
   }
-  return pcl_ptr;
+  last_send_time_[conn] = now;
+  return true;
 }
 
 void PointCloudUpdater::UpdatePointCloud(
@@ -257,42 +277,9 @@ void PointCloudUpdater::UpdatePointCloud(
     AWARN << "skipping outdated point cloud data";
     return;
   }
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr;
-  // Check if last filter process has finished before processing new data.
-  if (enable_voxel_filter_) {
-    if (future_ready_) {
-      future_ready_ = false;
-      // transform from drivers::PointCloud to pcl::PointCloud
-      pcl_ptr = ConvertPCLPointCloud(point_cloud);
-      std::future<void> f =
-          cyber::Async(&PointCloudUpdater::FilterPointCloud, this, pcl_ptr);
-      async_future_ = std::move(f);
-    }
-  } else {
-    pcl_ptr = ConvertPCLPointCloud(point_cloud);
-    this->FilterPointCloud(pcl_ptr);
-  }
-}
-
-void PointCloudUpdater::FilterPointCloud(
-    pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr) {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_filtered_ptr(
-      new pcl::PointCloud<pcl::PointXYZ>);
-
-  /*
-      By default, disable voxel filter since it's taking more than 500ms
-      ideally the most efficient sampling method is to
-      use per beam random sample for organized cloud(TODO)
-  */
-  if (enable_voxel_filter_) {
-    pcl::VoxelGrid<pcl::PointXYZ> voxel_grid;
-    voxel_grid.setInputCloud(pcl_ptr);
-    voxel_grid.setLeafSize(static_cast<float>(FLAGS_voxel_filter_size),
-                           static_cast<float>(FLAGS_voxel_filter_size),
-                           static_cast<float>(FLAGS_voxel_filter_height));
-    voxel_grid.filter(*pcl_filtered_ptr);
-  } else {
-    pcl_filtered_ptr = pcl_ptr;
+  // Nobody to show the point cloud to.
+  if (websocket_->GetConnections().empty()) {
+    return;
   }
 
   float z_offset;
@@ -300,19 +287,23 @@ void PointCloudUpdater::FilterPointCloud(
     boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
     z_offset = lidar_height_;
   }
-  apollo::dreamview::PointCloud point_cloud_pb;
-  for (size_t idx = 0; idx < pcl_filtered_ptr->size(); ++idx) {
-    pcl::PointXYZ &pt = pcl_filtered_ptr->points[idx];
-    if (!std::isnan(pt.x) && !std::isnan(pt.y) && !std::isnan(pt.z)) {
-      point_cloud_pb.add_num(pt.x);
-      point_cloud_pb.add_num(pt.y);
-      point_cloud_pb.add_num(pt.z + z_offset);
-    }
+  bool has_quantized_clients = false;
+  {
+    std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+    has_quantized_clients = !quantized_clients_.empty();
   }
+  // Encoded once per frame and shared by all the clients.
+  apollo::dreamview::PointCloud point_cloud_pb;
+  apollo::dreamview::PointCloud quantized_pb;
+  encoder_.Encode(*point_cloud, z_offset, &point_cloud_pb,
+                  has_quantized_clients ? &quantized_pb : nullptr);
+  std::string point_cloud_str = point_cloud_pb.SerializeAsString();
+  std::string quantized_str =
+      has_quantized_clients ? quantized_pb.SerializeAsString() : "";
   {
     boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
-    point_cloud_pb.SerializeToString(&point_cloud_str_);
-    future_ready_ = true;
+    point_cloud_str_.swap(point_cloud_str);
+    quantized_point_cloud_str_.swap(quantized_str);
   }
 }
 
@@ -21,15 +21,15 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
-#include "pcl/point_cloud.h"
-#include "pcl/point_types.h"
-
 #include "modules/common_msgs/localization_msgs/localization.pb.h"
 #include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
 
@@ -37,6 +37,7 @@
 #include "cyber/cyber.h"
 #include "modules/common/util/string_util.h"
 #include "modules/dreamview/backend/common/handlers/websocket_handler.h"
+#include "modules/dreamview/backend/common/util/point_cloud_encoder.h"
 #include "modules/dreamview/backend/simulation_world/simulation_world_updater.h"
 /**
  * @namespace apollo::dreamview
@@ -84,13 +85,15 @@ class PointCloudUpdater {
   void UpdatePointCloud(
       const std::shared_ptr<drivers::PointCloud> &point_cloud);
 
-  void FilterPointCloud(pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr);
-
   void UpdateLocalizationTime(
       const std::shared_ptr<apollo::localization::LocalizationEstimate>
           &localization);
-  pcl::PointCloud<pcl::PointXYZ>::Ptr ConvertPCLPointCloud(
-      const std::shared_ptr<drivers::PointCloud> &point_cloud);
+
+  /**
+   * @brief Whether the connection is due for a frame according to
+   * FLAGS_point_cloud_max_fps, which then counts as sent.
+   */
+  bool TakeFrameSlot(WebSocketHandler::Connection *conn);
 
   void GetChannelMsg(std::vector<std::string> *channels);
   bool ChangeChannel(const std::string &channel);
@@ -106,9 +109,18 @@ class PointCloudUpdater {
 
   // The PointCloud to be pushed to frontend.
   std::string point_cloud_str_;
+  // The same PointCloud quantized, for the clients that opted in.
+  std::string quantized_point_cloud_str_;
+
+  util::PointCloudEncoder encoder_;
+
+  // Time of the last frame sent to each connection.
+  std::unordered_map<WebSocketHandler::Connection *, double> last_send_time_;
+  std::mutex last_send_time_mutex_;
 
-  std::future<void> async_future_;
-  std::atomic<bool> future_ready_;
+  // Connections that decode the quantized PointCloud.
+  std::unordered_set<WebSocketHandler::Connection *> quantized_clients_;
+  std::mutex quantized_clients_mutex_;
 
   // Cyber messsage readers.
   std::shared_ptr<cyber::Reader<apollo::localization::LocalizationEstimate>>
@@ -117,7 +129,6 @@ class PointCloudUpdater {
   double last_point_cloud_time_ = 0.0;
   double last_localization_time_ = 0.0;
   SimulationWorldUpdater *simworld_updater_;
-  bool enable_voxel_filter_ = false;
   std::string curr_channel_name = "";
   DvCallback callback_api_;
 };
@@ -295,6 +295,22 @@ void SimulationWorldUpdater::RegisterMessageHandlers() {
           enable_pnc_monitor = json["planning"];
         }
         std::string to_send;
+        // Clients opting in with "delta" send the version they hold as
+        // "baseVersion" and get a SimulationWorldDelta against it.
+        auto delta = json.find("delta");
+        if (FLAGS_sim_world_delta_streaming && delta != json.end() &&
+            delta->is_boolean() && delta->get<bool>()) {
+          uint32_t base_version = 0;
+          auto base = json.find("baseVersion");
+          if (base != json.end() && base->is_number_unsigned()) {
+            base_version = base->get<uint32_t>();
+          }
+          if (delta_encoder_.Encode(base_version, enable_pnc_monitor,
+                                    &to_send)) {
+            websocket_->SendBinaryData(conn, to_send, true);
+          }
+          return;
+        }
         {
           // Pay the price to copy the data instead of sending data over the
           // wire while holding the lock.
@@ -725,6 +741,9 @@ void SimulationWorldUpdater::OnTimer() {
     sim_world_service_.GetRelativeMap().SerializeToString(
         &relative_map_string_);
   }
+  if (FLAGS_sim_world_delta_streaming) {
+    delta_encoder_.Update(simulation_world_with_planning_data_);
+  }
 }
 
 bool SimulationWorldUpdater::LoadPOI() {
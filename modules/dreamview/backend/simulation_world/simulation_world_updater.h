@@ -36,10 +36,12 @@
 
 #include "cyber/common/log.h"
 #include "cyber/cyber.h"
+#include "modules/dreamview/backend/common/dreamview_gflags.h"
 #include "modules/dreamview/backend/common/handlers/websocket_handler.h"
 #include "modules/dreamview/backend/common/map_service/map_service.h"
 #include "modules/dreamview/backend/perception_camera_updater/perception_camera_updater.h"
 #include "modules/dreamview/backend/common/plugins/plugin_manager.h"
+#include "modules/dreamview/backend/common/util/simulation_world_delta_encoder.h"
 #include "modules/common_msgs/localization_msgs/localization.pb.h"
 #include "modules/dreamview/backend/simulation_world/simulation_world_service.h"
 
@@ -202,6 +204,11 @@ class SimulationWorldUpdater {
   std::string simulation_world_;
   std::string simulation_world_with_planning_data_;
 
+  // Keyframes and deltas for clients requesting them, see
+  // FLAGS_sim_world_delta_streaming.
+  util::SimulationWorldDeltaEncoder delta_encoder_{
+      FLAGS_sim_world_keyframe_interval, FLAGS_sim_world_delta_history_size};
+
   // Received relative map data in wire format.
   std::string relative_map_string_;
 
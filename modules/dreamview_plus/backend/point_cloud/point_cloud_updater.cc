@@ -20,7 +20,6 @@
 #include <vector>
 
 #include "nlohmann/json.hpp"
-#include "pcl/filters/voxel_grid.h"
 #include "yaml-cpp/yaml.h"
 
 #include "modules/dreamview/proto/point_cloud.pb.h"
@@ -29,10 +28,12 @@
 #include "cyber/common/log.h"
 #include "cyber/time/clock.h"
 #include "modules/common/adapters/adapter_gflags.h"
+#include "modules/common/util/json_util.h"
 #include "modules/dreamview/backend/common/dreamview_gflags.h"
 namespace apollo {
 namespace dreamview {
 
+using apollo::common::util::JsonUtil;
 using apollo::localization::LocalizationEstimate;
 using Json = nlohmann::json;
 
@@ -48,6 +49,21 @@ PointCloudUpdater::PointCloudUpdater(WebSocketHandler *websocket)
         UpdateLocalizationTime(msg);
       });
   LoadLidarHeight(FLAGS_lidar_height_yaml);
+  // Clients that decode the quantized PointCloud opt in with
+  // {"type": "RequestQuantizedPointCloud", "enable": true}, all the others
+  // keep receiving the points as floats.
+  websocket_->RegisterMessageHandler(
+      "RequestQuantizedPointCloud",
+      [this](const Json &json, WebSocketHandler::Connection *conn) {
+        bool enable = true;
+        JsonUtil::GetBoolean(json, "enable", &enable);
+        std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+        if (enable && FLAGS_point_cloud_resolution > 0.0) {
+          quantized_clients_.insert(conn);
+        } else {
+          quantized_clients_.erase(conn);
+        }
+      });
 }
 
 PointCloudUpdater::~PointCloudUpdater() { Stop(); }
@@ -132,67 +148,100 @@ void PointCloudUpdater::StopStream(const std::string& channel_name) {
   // 回到初始值
   updater->last_point_cloud_time_ = 0.0;
   updater->point_cloud_str_ = "";
-  updater->future_ready_ = true;
+  updater->quantized_point_cloud_str_ = "";
 }
 void PointCloudUpdater::PublishMessage(const std::string &channel_name) {
   PointCloudChannelUpdater *updater = GetPointCloudChannelUpdater(channel_name);
   std::string to_send;
+  std::string quantized_to_send;
   // the channel has no data input, clear the sending object.
   if (!updater->point_cloud_reader_->HasWriter()) {
     updater->last_point_cloud_time_ = 0.0;
     updater->point_cloud_str_ = "";
-    to_send = "";
+    updater->quantized_point_cloud_str_ = "";
   } else {
     if (updater->point_cloud_str_ != "" &&
         std::fabs(last_localization_time_ - updater->last_point_cloud_time_) >
             2.0) {
       boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
       updater->point_cloud_str_ = "";
+      updater->quantized_point_cloud_str_ = "";
     }
     {
       boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
       to_send = updater->point_cloud_str_;
+      quantized_to_send = updater->quantized_point_cloud_str_;
     }
   }
-  StreamData stream_data;
-  std::string stream_data_string;
-  stream_data.set_action("stream");
-  stream_data.set_data_name("pointcloud");
-  stream_data.set_channel_name(channel_name);
-  std::vector<uint8_t> byte_data(to_send.begin(), to_send.end());
-  stream_data.set_data(&(byte_data[0]), byte_data.size());
-  stream_data.set_type("pointcloud");
-  stream_data.SerializeToString(&stream_data_string);
-  websocket_->BroadcastBinaryData(stream_data_string);
-}
+  auto serialize = [&channel_name](const std::string &data) {
+    StreamData stream_data;
+    std::string stream_data_string;
+    stream_data.set_action("stream");
+    stream_data.set_data_name("pointcloud");
+    stream_data.set_channel_name(channel_name);
+    std::vector<uint8_t> byte_data(data.begin(), data.end());
+    stream_data.set_data(&(byte_data[0]), byte_data.size());
+    stream_data.set_type("pointcloud");
+    stream_data.SerializeToString(&stream_data_string);
+    return stream_data_string;
+  };
+  const std::string stream_data_string = serialize(to_send);
+  const bool has_quantized_clients = HasQuantizedClients();
+  if (FLAGS_point_cloud_max_fps <= 0.0 && !has_quantized_clients) {
+    websocket_->BroadcastBinaryData(stream_data_string);
+    return;
+  }
+  const std::string quantized_stream_data_string =
+      has_quantized_clients ? serialize(quantized_to_send) : "";
 
-void PointCloudUpdater::GetChannelMsg(std::vector<std::string> *channels) {
-  enabled_ = true;
-  GetChannelMsgWithFilter(channels, "PointCloud", "sensor");
+  // Serialized once and sent to every client that is due for a frame, in
+  // the encoding it asked for. With a frame rate limit a client still busy
+  // with the previous frame is skipped.
+  const double now = cyber::Clock::NowInSeconds();
+  const bool limit_fps = FLAGS_point_cloud_max_fps > 0.0;
+  const double min_interval = limit_fps ? 1.0 / FLAGS_point_cloud_max_fps : 0;
+  std::unordered_map<WebSocketHandler::Connection *, double> last_send_time;
+  for (auto *conn : websocket_->GetConnections()) {
+    auto iter = updater->last_send_time_.find(conn);
+    if (iter != updater->last_send_time_.end()) {
+      last_send_time[conn] = iter->second;
+      if (now - iter->second < min_interval) {
+        continue;
+      }
+    }
+    bool quantized = false;
+    if (has_quantized_clients) {
+      std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+      quantized = quantized_clients_.count(conn) > 0;
+    }
+    if (websocket_->SendBinaryData(
+            conn,
+            quantized ? quantized_stream_data_string : stream_data_string,
+            limit_fps)) {
+      last_send_time[conn] = now;
+    }
+  }
+  updater->last_send_time_.swap(last_send_time);
 }
 
-pcl::PointCloud<pcl::PointXYZ>::Ptr PointCloudUpdater::ConvertPCLPointCloud(
-    const std::shared_ptr<drivers::PointCloud> &point_cloud) {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr(
-      new pcl::PointCloud<pcl::PointXYZ>);
-  pcl_ptr->width = point_cloud->width();
-  pcl_ptr->height = point_cloud->height();
-  pcl_ptr->is_dense = false;
-
-  if (point_cloud->width() * point_cloud->height() !=
-      static_cast<unsigned int>(point_cloud->point_size())) {
-    pcl_ptr->width = 1;
-    pcl_ptr->height = point_cloud->point_size();
+bool PointCloudUpdater::HasQuantizedClients() {
+  std::lock_guard<std::mutex> lock(quantized_clients_mutex_);
+  if (quantized_clients_.empty()) {
+    return false;
   }
-  pcl_ptr->points.resize(point_cloud->point_size());
-
-  for (size_t i = 0; i < pcl_ptr->points.size(); ++i) {
-    const auto &point = point_cloud->point(static_cast<int>(i));
-    pcl_ptr->points[i].x = point.x();
-    pcl_ptr->points[i].y = point.y();
-    pcl_ptr->points[i].z = point.z();
+  std::unordered_set<WebSocketHandler::Connection *> quantized_clients;
+  for (auto *conn : websocket_->GetConnections()) {
+    if (quantized_clients_.count(conn) > 0) {
+      quantized_clients.insert(conn);
+    }
   }
-  return pcl_ptr;
+  quantized_clients_.swap(quantized_clients);
+  return !quantized_clients_.empty();
+}
+
+void PointCloudUpdater::GetChannelMsg(std::vector<std::string> *channels) {
+  enabled_ = true;
+  GetChannelMsgWithFilter(channels, "PointCloud", "sensor");
 }
 
 void PointCloudUpdater::UpdatePointCloud(
@@ -209,44 +258,9 @@ void PointCloudUpdater::UpdatePointCloud(
     AWARN << "skipping outdated point cloud data";
     return;
   }
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr;
-  // Check if last filter process has finished before processing new data.
-  if (enable_voxel_filter_) {
-    if (updater->future_ready_) {
-      updater->future_ready_ = false;
-      // transform from drivers::PointCloud to pcl::PointCloud
-      pcl_ptr = ConvertPCLPointCloud(point_cloud);
-      std::future<void> f = cyber::Async(&PointCloudUpdater::FilterPointCloud,
-                                         this, pcl_ptr, channel_name);
-      updater->async_future_ = std::move(f);
-    }
-  } else {
-    pcl_ptr = ConvertPCLPointCloud(point_cloud);
-    this->FilterPointCloud(pcl_ptr, channel_name);
-  }
-}
-
-void PointCloudUpdater::FilterPointCloud(
-    pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr,
-    const std::string &channel_name) {
-  PointCloudChannelUpdater *updater = GetPointCloudChannelUpdater(channel_name);
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_filtered_ptr(
-      new pcl::PointCloud<pcl::PointXYZ>);
-
-  /*
-      By default, disable voxel filter since it's taking more than 500ms
-      ideally the most efficient sampling method is to
-      use per beam random sample for organized cloud(TODO)
-  */
-  if (enable_voxel_filter_) {
-    pcl::VoxelGrid<pcl::PointXYZ> voxel_grid;
-    voxel_grid.setInputCloud(pcl_ptr);
-    voxel_grid.setLeafSize(static_cast<float>(FLAGS_voxel_filter_size),
-                           static_cast<float>(FLAGS_voxel_filter_size),
-                           static_cast<float>(FLAGS_voxel_filter_height));
-    voxel_grid.filter(*pcl_filtered_ptr);
-  } else {
-    pcl_filtered_ptr = pcl_ptr;
+  // Nobody to show the point cloud to.
+  if (websocket_->GetConnections().empty()) {
+    return;
   }
 
   float z_offset;
@@ -254,19 +268,18 @@ void PointCloudUpdater::FilterPointCloud(
     boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
     z_offset = lidar_height_;
   }
+  const bool has_quantized_clients = HasQuantizedClients();
   apollo::dreamview::PointCloud point_cloud_pb;
-  for (size_t idx = 0; idx < pcl_filtered_ptr->size(); ++idx) {
-    pcl::PointXYZ &pt = pcl_filtered_ptr->points[idx];
-    if (!std::isnan(pt.x) && !std::isnan(pt.y) && !std::isnan(pt.z)) {
-      point_cloud_pb.add_num(pt.x);
-      point_cloud_pb.add_num(pt.y);
-      point_cloud_pb.add_num(pt.z + z_offset);
-    }
-  }
+  apollo::dreamview::PointCloud quantized_pb;
+  updater->encoder_.Encode(*point_cloud, z_offset, &point_cloud_pb,
+                           has_quantized_clients ? &quantized_pb : nullptr);
+  std::string point_cloud_str = point_cloud_pb.SerializeAsString();
+  std::string quantized_str =
+      has_quantized_clients ? quantized_pb.SerializeAsString() : "";
   {
     boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
-    point_cloud_pb.SerializeToString(&updater->point_cloud_str_);
-    updater->future_ready_ = true;
+    updater->point_cloud_str_.swap(point_cloud_str);
+    updater->quantized_point_cloud_str_.swap(quantized_str);
   }
 }
 
@@ -22,15 +22,14 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <map>
 
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
-#include "pcl/point_cloud.h"
-#include "pcl/point_types.h"
-
 #include "modules/common_msgs/localization_msgs/localization.pb.h"
 #include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
 #include "modules/dreamview_plus/proto/data_handler.pb.h"
@@ -39,7 +38,9 @@
 #include "cyber/common/log.h"
 #include "cyber/cyber.h"
 #include "modules/common/util/string_util.h"
+#include "modules/dreamview/backend/common/dreamview_gflags.h"
 #include "modules/dreamview/backend/common/handlers/websocket_handler.h"
+#include "modules/dreamview/backend/common/util/point_cloud_encoder.h"
 /**
  * @namespace apollo::dreamview
  * @brief apollo::dreamview
@@ -53,15 +54,19 @@ struct PointCloudChannelUpdater {
   double last_point_cloud_time_;
   // The PointCloud to be pushed to frontend.
   std::string point_cloud_str_;
+  // The same PointCloud quantized, for the clients that opted in.
+  std::string quantized_point_cloud_str_;
   std::unique_ptr<cyber::Timer> timer_;
-  std::atomic<bool> future_ready_;
-  std::future<void> async_future_;
+  util::PointCloudEncoder encoder_;
+  // Time of the last frame sent to each connection.
+  std::unordered_map<WebSocketHandler::Connection *, double> last_send_time_;
   explicit PointCloudChannelUpdater(std::string channel_name)
       : curr_channel_name_(channel_name),
         point_cloud_reader_(nullptr),
         last_point_cloud_time_(0.0),
         point_cloud_str_(""),
-        future_ready_(true) {}
+        encoder_(FLAGS_enable_voxel_filter ? FLAGS_voxel_filter_size : 0.0,
+                 FLAGS_voxel_filter_height, FLAGS_point_cloud_resolution) {}
 };
 
 /**
@@ -106,18 +111,19 @@ class PointCloudUpdater : public UpdaterWithChannelsBase {
   void UpdatePointCloud(const std::shared_ptr<drivers::PointCloud> &point_cloud,
                         const std::string &channel_name);
 
-  void FilterPointCloud(pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_ptr,
-                        const std::string &channel_name);
-
   void UpdateLocalizationTime(
       const std::shared_ptr<apollo::localization::LocalizationEstimate>
           &localization);
-  pcl::PointCloud<pcl::PointXYZ>::Ptr ConvertPCLPointCloud(
-      const std::shared_ptr<drivers::PointCloud> &point_cloud);
 
   PointCloudChannelUpdater* GetPointCloudChannelUpdater(
     const std::string &channel_name);
 
+  /**
+   * @brief Whether any open connection opted into the quantized PointCloud,
+   * dropping the closed ones.
+   */
+  bool HasQuantizedClients();
+
   constexpr static float kDefaultLidarHeight = 1.91f;
 
   std::unique_ptr<cyber::Node> node_;
@@ -132,9 +138,12 @@ class PointCloudUpdater : public UpdaterWithChannelsBase {
       localization_reader_;
   std::map<std::string, PointCloudChannelUpdater *> channel_updaters_;
   double last_localization_time_ = 0.0;
-  bool enable_voxel_filter_ = false;
   // DvCallback callback_api_;
   std::mutex channel_updater_map_mutex_;
+
+  // Connections that decode the quantized PointCloud.
+  std::unordered_set<WebSocketHandler::Connection *> quantized_clients_;
+  std::mutex quantized_clients_mutex_;
 };
 }  // namespace dreamview
 }  // namespace apollo
@@ -70,6 +70,28 @@ SimulationWorldUpdater::SimulationWorldUpdater(
       command_id_(0) {
   RegisterRoutingMessageHandlers();
   RegisterMessageHandlers();
+  // A new connection may reuse the address of a closed one.
+  sim_world_ws_->RegisterConnectionReadyHandler(
+      [this](WebSocketHandler::Connection *conn) {
+        std::lock_guard<std::mutex> lock(client_versions_mutex_);
+        client_versions_.erase(conn);
+      });
+  // Clients that can decode SimulationWorldDelta opt in with
+  // {"type": "RequestSimulationWorldDelta", "enable": true}, all the others
+  // keep receiving the full world.
+  sim_world_ws_->RegisterMessageHandler(
+      "RequestSimulationWorldDelta",
+      [this](const Json &json, WebSocketHandler::Connection *conn) {
+        bool enable = true;
+        JsonUtil::GetBoolean(json, "enable", &enable);
+        std::lock_guard<std::mutex> lock(client_versions_mutex_);
+        if (enable && FLAGS_sim_world_delta_streaming) {
+          // Start from a keyframe.
+          client_versions_[conn] = 0;
+        } else {
+          client_versions_.erase(conn);
+        }
+      });
 }
 
 void SimulationWorldUpdater::RegisterRoutingMessageHandlers() {
@@ -1266,6 +1288,9 @@ void SimulationWorldUpdater::OnTimer(const std::string &channel_name) {
     sim_world_service_.GetRelativeMap().SerializeToString(
         &relative_map_string_);
   }
+  if (FLAGS_sim_world_delta_streaming) {
+    delta_encoder_.Update(simulation_world_with_planning_data_);
+  }
   PublishMessage();
 }
 
@@ -1274,6 +1299,13 @@ void SimulationWorldUpdater::PublishMessage(const std::string &channel_name) {
     AWARN_EVERY(time_interval_ms_);
     return;
   }
+  std::vector<WebSocketHandler::Connection *> full_world_clients;
+  if (FLAGS_sim_world_delta_streaming) {
+    PublishDelta(&full_world_clients);
+    if (full_world_clients.empty()) {
+      return;
+    }
+  }
   std::string to_send;
   {
     boost::shared_lock<boost::shared_mutex> writer_lock(mutex_);
@@ -1287,7 +1319,57 @@ void SimulationWorldUpdater::PublishMessage(const std::string &channel_name) {
   stream_data.set_data(&(byte_data[0]), byte_data.size());
   stream_data.set_type("simworld");
   stream_data.SerializeToString(&stream_data_string);
-  sim_world_ws_->BroadcastBinaryData(stream_data_string);
+  if (!FLAGS_sim_world_delta_streaming) {
+    sim_world_ws_->BroadcastBinaryData(stream_data_string);
+    return;
+  }
+  for (auto *conn : full_world_clients) {
+    sim_world_ws_->SendBinaryData(conn, stream_data_string);
+  }
+}
+
+void SimulationWorldUpdater::PublishDelta(
+    std::vector<WebSocketHandler::Connection *> *full_world_clients) {
+  const uint32_t version = delta_encoder_.version();
+  std::lock_guard<std::mutex> lock(client_versions_mutex_);
+  // Drop the closed connections while collecting the open ones.
+  std::unordered_map<WebSocketHandler::Connection *, uint32_t> client_versions;
+  for (auto *conn : sim_world_ws_->GetConnections()) {
+    auto iter = client_versions_.find(conn);
+    if (iter == client_versions_.end()) {
+      full_world_clients->push_back(conn);
+    } else {
+      client_versions.emplace(conn, iter->second);
+    }
+  }
+
+  // Clients at the same version share one message.
+  std::unordered_map<uint32_t, std::string> messages;
+  for (auto &client : client_versions) {
+    if (client.second == version) {
+      continue;
+    }
+    auto iter = messages.find(client.second);
+    if (iter == messages.end()) {
+      std::string delta;
+      if (!delta_encoder_.Encode(client.second, true, &delta)) {
+        break;
+      }
+      StreamData stream_data;
+      stream_data.set_action("stream");
+      stream_data.set_data_name("simworld");
+      stream_data.set_type("simworld_delta");
+      stream_data.set_data(delta);
+      iter = messages.emplace(client.second, stream_data.SerializeAsString())
+                 .first;
+    }
+    // A client still busy with an earlier message is skipped and catches up
+    // from the version it holds on a later cycle.
+    if (sim_world_ws_->SendBinaryData(client.first, iter->second, true)) {
+      client.second = version;
+    }
+  }
+  client_versions_.swap(client_versions);
 }
 
 bool SimulationWorldUpdater::LoadPOI() {
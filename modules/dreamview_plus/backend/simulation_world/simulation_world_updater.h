@@ -21,7 +21,9 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/thread/locks.hpp>
@@ -37,10 +39,12 @@
 
 #include "cyber/common/log.h"
 #include "cyber/cyber.h"
+#include "modules/dreamview/backend/common/dreamview_gflags.h"
 #include "modules/dreamview/backend/common/handlers/websocket_handler.h"
 #include "modules/dreamview_plus/backend/hmi/hmi.h"
 #include "modules/dreamview/backend/common/map_service/map_service.h"
 #include "modules/dreamview/backend/common/plugins/plugin_manager.h"
+#include "modules/dreamview/backend/common/util/simulation_world_delta_encoder.h"
 #include "modules/common_msgs/localization_msgs/localization.pb.h"
 #include "modules/dreamview_plus/backend/simulation_world/simulation_world_service.h"
 #include "modules/dreamview_plus/backend/socket_manager/socket_manager.h"
@@ -97,6 +101,15 @@ class SimulationWorldUpdater : public UpdaterBase {
    */
   void OnTimer(const std::string &channel_name = "");
 
+  /**
+   * @brief Pushes to every sim_world client that opted in a
+   * SimulationWorldDelta against the version it last received.
+   * @param full_world_clients Output of the clients that did not opt in and
+   * still get the full world.
+   */
+  void PublishDelta(
+      std::vector<WebSocketHandler::Connection *> *full_world_clients);
+
   /**
    * @brief The function to construct a LaneFollowCommand from the given json,
    * @param json that contains start, end, and waypoints
@@ -229,6 +242,17 @@ class SimulationWorldUpdater : public UpdaterBase {
   // updated by timer.
   std::string simulation_world_with_planning_data_;
 
+  // Keyframes and deltas pushed instead of the full world, see
+  // FLAGS_sim_world_delta_streaming.
+  util::SimulationWorldDeltaEncoder delta_encoder_{
+      FLAGS_sim_world_keyframe_interval, FLAGS_sim_world_delta_history_size};
+
+  // The version each sim_world client that opted into deltas last received
+  // completely, 0 if none.
+  std::unordered_map<WebSocketHandler::Connection *, uint32_t>
+      client_versions_;
+  std::mutex client_versions_mutex_;
+
   // Received relative map data in wire format.
   std::string relative_map_string_;
 
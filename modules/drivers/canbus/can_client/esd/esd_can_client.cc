@@ -142,6 +142,11 @@ ErrorCode EsdCanClient::Send(const std::vector<CanFrame> &frames,
     AERROR << "Esd can client has not been initiated! Please init first!";
     return ErrorCode::CAN_CLIENT_ERROR_SEND_FAILED;
   }
+  if (*frame_num > MAX_CAN_SEND_FRAME_LEN || *frame_num < 0) {
+    AERROR << "send can frame num not in range[0, " << MAX_CAN_SEND_FRAME_LEN
+           << "], frame_num:" << *frame_num;
+    return ErrorCode::CAN_CLIENT_ERROR_FRAME_NUM;
+  }
   for (size_t i = 0; i < frames.size() && i < MAX_CAN_SEND_FRAME_LEN; ++i) {
     send_frames_[i].id = frames[i].id;
     send_frames_[i].len = frames[i].len;
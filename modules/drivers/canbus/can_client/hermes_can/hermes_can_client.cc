@@ -116,11 +116,11 @@ apollo::common::ErrorCode HermesCanClient::Send(
     AERROR << "Hermes can client is not init! Please init first!";
     return ErrorCode::CAN_CLIENT_ERROR_SEND_FAILED;
   }
-  //    if (*frame_num > MAX_CAN_SEND_FRAME_LEN || *frame_num < 0) {
-  //       AERROR << "send can frame num not in range[0, "
-  //         << MAX_CAN_SEND_FRAME_LEN << "], frame_num:" << *frame_num;
-  //       return ErrorCode::CAN_CLIENT_ERROR_FRAME_NUM;
-  //    }
+  if (*frame_num > MAX_CAN_SEND_FRAME_LEN || *frame_num < 0) {
+    AERROR << "send can frame num not in range[0, " << MAX_CAN_SEND_FRAME_LEN
+           << "], frame_num:" << *frame_num;
+    return ErrorCode::CAN_CLIENT_ERROR_FRAME_NUM;
+  }
   for (int i = 0; i < *frame_num; ++i) {
     _send_frames[i].bcan_msg_id = frames[i].id;
     _send_frames[i].bcan_msg_datalen = frames[i].len;
@@ -22,6 +22,9 @@
 
 #include "modules/drivers/canbus/can_client/socket/socket_can_client_raw.h"
 
+#include <algorithm>
+#include <cerrno>
+
 #include "absl/strings/str_cat.h"
 
 #include "modules/drivers/canbus/sensor_gflags.h"
@@ -178,14 +181,28 @@ ErrorCode SocketCanClientRaw::Send(const std::vector<CanFrame> &frames,
     ADEBUG << "send can id is " << send_frames_[i].can_id;
     send_frames_[i].can_dlc = frames[i].len;
     std::memcpy(send_frames_[i].data, frames[i].data, frames[i].len);
+    send_iovecs_[i].iov_base = &send_frames_[i];
+    send_iovecs_[i].iov_len = sizeof(send_frames_[i]);
+    std::memset(&send_msgs_[i], 0, sizeof(send_msgs_[i]));
+    send_msgs_[i].msg_hdr.msg_iov = &send_iovecs_[i];
+    send_msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
 
-    // Synchronous transmission of CAN messages
-    int ret = static_cast<int>(
-        write(dev_handler_, &send_frames_[i], sizeof(send_frames_[i])));
+  // Synchronous transmission of CAN messages, all frames in one call.
+  const int count = static_cast<int>(
+      std::min<size_t>(frames.size(), MAX_CAN_SEND_FRAME_LEN));
+  int sent = 0;
+  while (sent < count) {
+    int ret = sendmmsg(dev_handler_, &send_msgs_[sent],
+                       static_cast<unsigned int>(count - sent), 0);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
     if (ret <= 0) {
       AERROR << "send message failed, error code: " << ret;
       return ErrorCode::CAN_CLIENT_ERROR_BASE;
     }
+    sent += ret;
   }
 
   return ErrorCode::OK;
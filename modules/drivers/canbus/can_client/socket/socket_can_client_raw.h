@@ -27,6 +27,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <linux/can.h>
 #include <linux/can/raw.h>
@@ -114,6 +115,8 @@ class SocketCanClientRaw : public CanClient {
   CANCardParameter::CANChannelId port_;
   CANCardParameter::CANInterface interface_;
   can_frame send_frames_[MAX_CAN_SEND_FRAME_LEN];
+  struct iovec send_iovecs_[MAX_CAN_SEND_FRAME_LEN];
+  struct mmsghdr send_msgs_[MAX_CAN_SEND_FRAME_LEN];
   can_frame recv_frames_[MAX_CAN_RECV_FRAME_LEN];
 };
 
@@ -169,6 +169,8 @@ void CanReceiver<SensorType>::RecvThreadFunc() {
     }
     receive_none_count = 0;
 
+    // The frames of one receive are published to the readers together.
+    pt_manager_->BeginParseBatch();
     for (const auto &frame : buf) {
       uint8_t len = frame.len;
       uint32_t uid = frame.id;
@@ -178,6 +180,7 @@ void CanReceiver<SensorType>::RecvThreadFunc() {
         ADEBUG << "recv_can_frame#" << frame.CanFrameString();
       }
     }
+    pt_manager_->EndParseBatch();
     cyber::Yield();
   }
   AINFO << "Can client receiver thread stopped.";
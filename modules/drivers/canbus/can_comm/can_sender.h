@@ -21,12 +21,21 @@
 
 #pragma once
 
+#include <time.h>
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest_prod.h"
@@ -77,15 +86,14 @@ class SenderMessage {
                 ProtocolData<SensorType> *protocol_data, bool init_with_one);
 
   /**
-   * @brief Destructor.
+   * @brief Copy constructor, the payload is copied as last published.
    */
-  virtual ~SenderMessage() = default;
+  SenderMessage(const SenderMessage &other);
 
   /**
-   * @brief Update the current period for sending messages by a difference.
-   * @param delta_period Update the current period by reducing delta_period.
+   * @brief Destructor.
    */
-  void UpdateCurrPeriod(const int32_t delta_period);
+  virtual ~SenderMessage() = default;
 
   /**
    * @brief Update the protocol data. But the updating process depends on
@@ -100,10 +108,10 @@ class SenderMessage {
   void Update_Heartbeat();
 
   /**
-   * @brief Get the CAN frame to send.
+   * @brief Get the CAN frame to send. It never blocks on Update().
    * @return The CAN frame to send.
    */
-  struct CanFrame CanFrame();
+  struct CanFrame CanFrame() const;
 
   /**
    * @brief Get the message ID.
@@ -112,23 +120,41 @@ class SenderMessage {
   uint32_t message_id() const;
 
   /**
-   * @brief Get the current period to send messages. It may be different from
-   *        the period from protocol data by updating.
-   * @return The current period.
+   * @brief Get the period from protocol data.
+   * @return The period in us.
    */
-  int32_t curr_period() const;
+  int32_t period() const;
 
  private:
+  void Publish();
+
   uint32_t message_id_ = 0;
   ProtocolData<SensorType> *protocol_data_ = nullptr;
 
   int32_t period_ = 0;
-  int32_t curr_period_ = 0;
 
  private:
+  // Serializes the updates, the sender thread does not take it.
   static std::mutex mutex_;
-  struct CanFrame can_frame_to_send_;
+  // The update buffer is filled by the protocol data and then published to
+  // payload_ in one atomic store.
   struct CanFrame can_frame_to_update_;
+  std::atomic<uint64_t> payload_{0};
+};
+
+/**
+ * @struct PeriodJitter
+ * @brief How far the intervals between two sends of a message were from its
+ *        period.
+ */
+struct PeriodJitter {
+  uint32_t message_id = 0;
+  uint64_t send_count = 0;
+  /// Sends that came more than a whole period late, the missed ones are
+  /// skipped.
+  uint64_t overrun_count = 0;
+  int64_t max_jitter_us = 0;
+  double mean_jitter_us = 0.0;
 };
 
 /**
@@ -198,15 +224,32 @@ class CanSender {
   bool IsRunning() const;
   bool enable_log() const;
 
+  /**
+   * @brief Get the period jitter of each message since Start().
+   * @return The jitter statistics in the order the messages were added.
+   */
+  std::vector<PeriodJitter> GetPeriodJitter() const;
+
   FRIEND_TEST(CanSenderTest, OneRunCase);
 
  private:
+  struct SendStatistics {
+    int64_t last_send_ns = 0;
+    int64_t jitter_sum_us = 0;
+    PeriodJitter jitter;
+  };
+
   void PowerSendThreadFunc();
 
-  bool NeedSend(const SenderMessage<SensorType> &msg,
-                const int32_t delta_period);
+  void SendFrames(const std::vector<CanFrame> &can_frames);
+
+  void RecordSend(size_t index, int64_t send_ns, bool overrun);
+
+  static int64_t MonotonicNanoseconds();
+
+  static void SleepUntil(int64_t deadline_ns);
   bool is_init_ = false;
-  bool is_running_ = false;
+  std::atomic<bool> is_running_{false};
 
   CanClient *can_client_ = nullptr;  // Owned by global canbus.cc
   MessageManager<SensorType> *pt_manager_ = nullptr;
@@ -214,10 +257,18 @@ class CanSender {
   std::unique_ptr<std::thread> thread_;
   bool enable_log_ = false;
 
+  mutable std::mutex statistics_mutex_;
+  std::vector<SendStatistics> statistics_;
+
   DISALLOW_COPY_AND_ASSIGN(CanSender);
 };
 
 const uint32_t kSenderInterval = 6000;
+// Messages are first sent this long before one period has passed since
+// Start(), as the period countdown the sender used before did.
+const int32_t kSenderInitPeriod = 5000;
+// The sender wakes up at least this often to check whether it was stopped.
+const int64_t kMaxSenderSleepNs = 100000000;
 
 template <typename SensorType>
 std::mutex SenderMessage<SensorType>::mutex_;
@@ -243,18 +294,17 @@ SenderMessage<SensorType>::SenderMessage(
   can_frame_to_update_.len = static_cast<uint8_t>(len);
 
   period_ = protocol_data_->GetPeriod();
-  curr_period_ = period_;
 
   Update();
 }
 
 template <typename SensorType>
-void SenderMessage<SensorType>::UpdateCurrPeriod(const int32_t period_delta) {
-  curr_period_ -= period_delta;
-  if (curr_period_ <= 0) {
-    curr_period_ = period_;
-  }
-}
+SenderMessage<SensorType>::SenderMessage(const SenderMessage &other)
+    : message_id_(other.message_id_),
+      protocol_data_(other.protocol_data_),
+      period_(other.period_),
+      can_frame_to_update_(other.can_frame_to_update_),
+      payload_(other.payload_.load(std::memory_order_acquire)) {}
 
 template <typename SensorType>
 void SenderMessage<SensorType>::Update() {
@@ -262,10 +312,9 @@ void SenderMessage<SensorType>::Update() {
     AERROR << "Attention: ProtocolData is nullptr!";
     return;
   }
-  protocol_data_->UpdateData(can_frame_to_update_.data);
-
   std::lock_guard<std::mutex> lock(mutex_);
-  can_frame_to_send_ = can_frame_to_update_;
+  protocol_data_->UpdateData(can_frame_to_update_.data);
+  Publish();
 }
 
 template <typename SensorType>
@@ -274,10 +323,18 @@ void SenderMessage<SensorType>::Update_Heartbeat() {
     AERROR << "Attention: ProtocolData is nullptr!";
     return;
   }
+  std::lock_guard<std::mutex> lock(mutex_);
   protocol_data_->UpdateData_Heartbeat(can_frame_to_update_.data);
+  Publish();
+}
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  can_frame_to_send_ = can_frame_to_update_;
+template <typename SensorType>
+void SenderMessage<SensorType>::Publish() {
+  static_assert(sizeof(can_frame_to_update_.data) == sizeof(uint64_t),
+                "CAN payload must fit in the published word.");
+  uint64_t payload = 0;
+  std::memcpy(&payload, can_frame_to_update_.data, sizeof(payload));
+  payload_.store(payload, std::memory_order_release);
 }
 
 template <typename SensorType>
@@ -286,14 +343,19 @@ uint32_t SenderMessage<SensorType>::message_id() const {
 }
 
 template <typename SensorType>
-struct CanFrame SenderMessage<SensorType>::CanFrame() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return can_frame_to_send_;
+struct CanFrame SenderMessage<SensorType>::CanFrame() const {
+  struct CanFrame can_frame;
+  // Id and length do not change after construction.
+  can_frame.id = message_id_;
+  can_frame.len = can_frame_to_update_.len;
+  const uint64_t payload = payload_.load(std::memory_order_acquire);
+  std::memcpy(can_frame.data, &payload, sizeof(payload));
+  return can_frame;
 }
 
 template <typename SensorType>
-int32_t SenderMessage<SensorType>::curr_period() const {
-  return curr_period_;
+int32_t SenderMessage<SensorType>::period() const {
+  return period_;
 }
 
 template <typename SensorType>
@@ -304,58 +366,140 @@ void CanSender<SensorType>::PowerSendThreadFunc() {
   sch.sched_priority = 99;
   pthread_setschedparam(pthread_self(), SCHED_FIFO, &sch);
 
-  const int32_t INIT_PERIOD = 5000;  // 5ms
-  int32_t delta_period = INIT_PERIOD;
-  int32_t new_delta_period = INIT_PERIOD;
-
-  int64_t tm_start = 0;
-  int64_t tm_end = 0;
-  int64_t sleep_interval = 0;
-
   AINFO << "Can client sender thread starts.";
 
-  while (is_running_) {
-    tm_start = cyber::Time::Now().ToNanosecond() / 1e3;
-    new_delta_period = INIT_PERIOD;
-
-    for (auto &message : send_messages_) {
-      bool need_send = NeedSend(message, delta_period);
-      message.UpdateCurrPeriod(delta_period);
-      new_delta_period = std::min(new_delta_period, message.curr_period());
+  // Absolute deadline of the next send of each message, the earliest first.
+  using Deadline = std::pair<int64_t, size_t>;
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+      deadlines;
+  const int64_t start_ns = MonotonicNanoseconds();
+  for (size_t i = 0; i < send_messages_.size(); ++i) {
+    const int32_t first_delay =
+        std::max(send_messages_[i].period() - kSenderInitPeriod, 0);
+    deadlines.emplace(start_ns + first_delay * int64_t{1000}, i);
+  }
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    statistics_.assign(send_messages_.size(), SendStatistics());
+    for (size_t i = 0; i < send_messages_.size(); ++i) {
+      statistics_[i].jitter.message_id = send_messages_[i].message_id();
+    }
+  }
 
-      if (!need_send) {
-        continue;
+  std::vector<CanFrame> can_frames;
+  std::vector<std::pair<size_t, bool>> sent;
+  while (is_running_) {
+    const int64_t now_ns = MonotonicNanoseconds();
+    if (deadlines.empty() || deadlines.top().first > now_ns) {
+      int64_t wake_ns = now_ns + kMaxSenderSleepNs;
+      if (!deadlines.empty()) {
+        wake_ns = std::min(wake_ns, deadlines.top().first);
       }
-      std::vector<CanFrame> can_frames;
-      CanFrame can_frame = message.CanFrame();
-      can_frames.push_back(can_frame);
-      if (can_client_->SendSingleFrame(can_frames) != common::ErrorCode::OK) {
-        AERROR << "Send msg failed:" << can_frame.CanFrameString();
+      SleepUntil(wake_ns);
+      continue;
+    }
+
+    // Everything that is due goes out in one write.
+    can_frames.clear();
+    sent.clear();
+    while (!deadlines.empty() && deadlines.top().first <= now_ns) {
+      const Deadline deadline = deadlines.top();
+      deadlines.pop();
+      const size_t index = deadline.second;
+      const SenderMessage<SensorType> &message = send_messages_[index];
+      can_frames.push_back(message.CanFrame());
+
+      const int64_t period_ns =
+          (message.period() > 0 ? message.period() : kSenderInterval) *
+          int64_t{1000};
+      int64_t next_ns = deadline.first + period_ns;
+      const bool overrun = next_ns <= now_ns;
+      if (overrun) {
+        // Keep the phase, but do not try to catch up on missed sends.
+        next_ns += ((now_ns - next_ns) / period_ns + 1) * period_ns;
       }
-      if (enable_log()) {
+      deadlines.emplace(next_ns, index);
+      sent.emplace_back(index, overrun);
+    }
+    SendFrames(can_frames);
+    for (const auto &item : sent) {
+      RecordSend(item.first, now_ns, item.second);
+    }
+
+    if (enable_log()) {
+      for (const auto &can_frame : can_frames) {
         ADEBUG << "send_can_frame#" << can_frame.CanFrameString()
                << "echo send_can_frame# in chssis_detail.";
-        uint32_t uid = can_frame.id;
-        const uint8_t *data = can_frame.data;
-        uint8_t len = can_frame.len;
-        pt_manager_->Parse(uid, data, len);
+        pt_manager_->Parse(can_frame.id, can_frame.data, can_frame.len);
       }
     }
-    delta_period = new_delta_period;
-    tm_end = cyber::Time::Now().ToNanosecond() / 1e3;
-    sleep_interval = delta_period - (tm_end - tm_start);
-
-    if (sleep_interval > 0) {
-      std::this_thread::sleep_for(std::chrono::microseconds(sleep_interval));
-    } else {
-      // do not sleep
-      AWARN << "Too much time for calculation: " << tm_end - tm_start
-            << "us is more than minimum period: " << delta_period << "us";
-    }
   }
   AINFO << "Can client sender thread stopped!";
 }
 
+template <typename SensorType>
+void CanSender<SensorType>::SendFrames(
+    const std::vector<CanFrame> &can_frames) {
+  const size_t batch_size = static_cast<size_t>(MAX_CAN_SEND_FRAME_LEN);
+  if (can_frames.size() <= batch_size) {
+    int32_t frame_num = static_cast<int32_t>(can_frames.size());
+    if (can_client_->Send(can_frames, &frame_num) != common::ErrorCode::OK) {
+      AERROR << "Send " << can_frames.size() << " msgs failed, first:"
+             << can_frames.front().CanFrameString();
+    }
+    return;
+  }
+  for (size_t begin = 0; begin < can_frames.size(); begin += batch_size) {
+    const size_t end = std::min(begin + batch_size, can_frames.size());
+    std::vector<CanFrame> batch(can_frames.begin() + begin,
+                                can_frames.begin() + end);
+    int32_t frame_num = static_cast<int32_t>(batch.size());
+    if (can_client_->Send(batch, &frame_num) != common::ErrorCode::OK) {
+      AERROR << "Send " << batch.size() << " msgs failed, first:"
+             << batch.front().CanFrameString();
+    }
+  }
+}
+
+template <typename SensorType>
+void CanSender<SensorType>::RecordSend(const size_t index,
+                                       const int64_t send_ns,
+                                       const bool overrun) {
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  SendStatistics &statistics = statistics_[index];
+  PeriodJitter &jitter = statistics.jitter;
+  if (jitter.send_count > 0) {
+    const int64_t interval_us = (send_ns - statistics.last_send_ns) / 1000;
+    const int64_t period_us = send_messages_[index].period();
+    const int64_t jitter_us = std::abs(interval_us - period_us);
+    statistics.jitter_sum_us += jitter_us;
+    jitter.max_jitter_us = std::max(jitter.max_jitter_us, jitter_us);
+  }
+  if (overrun) {
+    ++jitter.overrun_count;
+  }
+  ++jitter.send_count;
+  statistics.last_send_ns = send_ns;
+}
+
+template <typename SensorType>
+int64_t CanSender<SensorType>::MonotonicNanoseconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+template <typename SensorType>
+void CanSender<SensorType>::SleepUntil(const int64_t deadline_ns) {
+  struct timespec deadline;
+  deadline.tv_sec = static_cast<time_t>(deadline_ns / 1000000000);
+  deadline.tv_nsec = static_cast<long>(deadline_ns % 1000000000);  // NOLINT
+  // Absolute deadlines do not drift with the time spent sending.
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline,
+                         nullptr) == EINTR) {
+  }
+}
+
 template <typename SensorType>
 common::ErrorCode CanSender<SensorType>::Init(
     CanClient *can_client, MessageManager<SensorType> *pt_manager,
@@ -432,6 +576,13 @@ void CanSender<SensorType>::Stop() {
     AERROR << "CanSender is not running.";
   }
 
+  for (const auto &jitter : GetPeriodJitter()) {
+    AINFO << "Send msg:" << std::hex << jitter.message_id << std::dec
+          << " count:" << jitter.send_count
+          << " overrun:" << jitter.overrun_count
+          << " mean jitter:" << jitter.mean_jitter_us
+          << "us max jitter:" << jitter.max_jitter_us << "us";
+  }
   AINFO << "Can client sender stopped [ok].";
 }
 
@@ -446,9 +597,19 @@ bool CanSender<SensorType>::enable_log() const {
 }
 
 template <typename SensorType>
-bool CanSender<SensorType>::NeedSend(const SenderMessage<SensorType> &msg,
-                                     const int32_t delta_period) {
-  return msg.curr_period() <= delta_period;
+std::vector<PeriodJitter> CanSender<SensorType>::GetPeriodJitter() const {
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  std::vector<PeriodJitter> jitters;
+  jitters.reserve(statistics_.size());
+  for (const auto &statistics : statistics_) {
+    PeriodJitter jitter = statistics.jitter;
+    if (jitter.send_count > 1) {
+      jitter.mean_jitter_us = static_cast<double>(statistics.jitter_sum_us) /
+                              static_cast<double>(jitter.send_count - 1);
+    }
+    jitters.push_back(jitter);
+  }
+  return jitters;
 }
 
 }  // namespace canbus
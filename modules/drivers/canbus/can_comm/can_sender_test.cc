@@ -16,6 +16,11 @@
 
 #include "modules/drivers/canbus/can_comm/can_sender.h"
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "modules/common_msgs/chassis_msgs/chassis_detail.pb.h"
@@ -27,6 +32,43 @@ namespace apollo {
 namespace drivers {
 namespace canbus {
 
+namespace {
+
+class PeriodicProtocolData
+    : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  explicit PeriodicProtocolData(uint32_t period) : period_(period) {}
+  uint32_t GetPeriod() const override { return period_; }
+  void UpdateData(uint8_t *data) override { data[0] = value_; }
+  void set_value(uint8_t value) { value_ = value; }
+
+ private:
+  uint32_t period_ = 0;
+  uint8_t value_ = 0;
+};
+
+// Records the frames of each Send call.
+class RecordingCanClient : public can::FakeCanClient {
+ public:
+  common::ErrorCode Send(const std::vector<CanFrame> &frames,
+                         int32_t *const frame_num) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_.push_back(frames);
+    return common::ErrorCode::OK;
+  }
+
+  std::vector<std::vector<CanFrame>> batches() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::vector<CanFrame>> batches_;
+};
+
+}  // namespace
+
 TEST(CanSenderTest, OneRunCase) {
   CanSender<::apollo::canbus::ChassisDetail> sender;
   MessageManager<::apollo::canbus::ChassisDetail> pm;
@@ -35,11 +77,7 @@ TEST(CanSenderTest, OneRunCase) {
 
   ProtocolData<::apollo::canbus::ChassisDetail> mpd;
   SenderMessage<::apollo::canbus::ChassisDetail> msg(1, &mpd);
-  EXPECT_FALSE(sender.NeedSend(msg, 1));
   EXPECT_EQ(msg.message_id(), 1);
-  int32_t period = msg.curr_period();
-  msg.UpdateCurrPeriod(-50);
-  EXPECT_EQ(msg.curr_period(), period + 50);
   EXPECT_EQ(msg.CanFrame().id, 1);
 
   sender.AddMessage(1, &mpd);
@@ -52,6 +90,76 @@ TEST(CanSenderTest, OneRunCase) {
   EXPECT_FALSE(sender.IsRunning());
 }
 
+TEST(CanSenderTest, CanFrameFollowsUpdate) {
+  PeriodicProtocolData mpd(10000);
+  mpd.set_value(1);
+  SenderMessage<::apollo::canbus::ChassisDetail> msg(2, &mpd);
+  EXPECT_EQ(1, msg.CanFrame().data[0]);
+  mpd.set_value(2);
+  EXPECT_EQ(1, msg.CanFrame().data[0]);
+  msg.Update();
+  EXPECT_EQ(2, msg.CanFrame().data[0]);
+  EXPECT_EQ(2, msg.CanFrame().id);
+  EXPECT_EQ(10000, msg.period());
+}
+
+TEST(CanSenderTest, DeadlineSchedule) {
+  CanSender<::apollo::canbus::ChassisDetail> sender;
+  MessageManager<::apollo::canbus::ChassisDetail> pm;
+  RecordingCanClient can_client;
+  sender.Init(&can_client, &pm, false);
+
+  PeriodicProtocolData fast(10000);
+  PeriodicProtocolData fast_too(10000);
+  PeriodicProtocolData slow(50000);
+  sender.AddMessage(1, &fast);
+  sender.AddMessage(2, &fast_too);
+  sender.AddMessage(3, &slow);
+  EXPECT_EQ(sender.Start(), common::ErrorCode::OK);
+  // Run until the slow message was sent a few times, however long the
+  // machine takes to get there.
+  for (int i = 0; i < 500; ++i) {
+    const auto jitters = sender.GetPeriodJitter();
+    if (jitters.size() == 3 && jitters[2].send_count >= 3) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  sender.Stop();
+
+  const auto jitters = sender.GetPeriodJitter();
+  ASSERT_EQ(3, jitters.size());
+  EXPECT_EQ(1, jitters[0].message_id);
+  EXPECT_EQ(2, jitters[1].message_id);
+  EXPECT_EQ(3, jitters[2].message_id);
+  ASSERT_GE(jitters[2].send_count, 3);
+
+  // The first sends are 5 ms before one period has passed, at 5 + 10k ms
+  // and 45 + 50k ms. Late sends keep that phase, so the slow deadlines
+  // always fall on fast ones, and messages with the same deadline share a
+  // write in the order they were added.
+  const auto batches = can_client.batches();
+  size_t slow_batches = 0;
+  size_t frames = 0;
+  for (const auto &batch : batches) {
+    ASSERT_GE(batch.size(), 2);
+    ASSERT_LE(batch.size(), 3);
+    EXPECT_EQ(1, batch[0].id);
+    EXPECT_EQ(2, batch[1].id);
+    if (batch.size() == 3) {
+      EXPECT_EQ(3, batch[2].id);
+      ++slow_batches;
+    }
+    frames += batch.size();
+  }
+  EXPECT_EQ(batches.size(), jitters[0].send_count);
+  EXPECT_EQ(batches.size(), jitters[1].send_count);
+  EXPECT_EQ(slow_batches, jitters[2].send_count);
+  EXPECT_EQ(jitters[0].send_count + jitters[1].send_count +
+                jitters[2].send_count,
+            frames);
+}
+
 }  // namespace canbus
 }  // namespace drivers
 }  // namespace apollo
@@ -20,6 +20,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -64,6 +65,14 @@ struct CheckIdArg {
  *
  * @brief message manager manages protocols. It supports parse and can get
  * protocol data by message id.
+ *
+ * Parsed data is kept in three snapshots rotated as a triple buffer: Parse
+ * writes one and publishes it by swapping an atomic index, GetSensorData
+ * copies the latest published one. Each frame is parsed once, into the
+ * back snapshot after it is brought up to date from the latest one, so
+ * protocols may keep state across calls and parsing never waits for a
+ * reader. Frames parsed between BeginParseBatch and EndParseBatch share
+ * one snapshot, which is brought up to date and published once.
  */
 template <typename SensorType>
 class MessageManager {
@@ -86,6 +95,18 @@ class MessageManager {
   virtual void Parse(const uint32_t message_id, const uint8_t *data,
                      int32_t length);
 
+  /**
+   * @brief start a batch of Parse calls from the calling thread, published
+   * together by EndParseBatch. Parse calls from other threads wait until
+   * the batch ends.
+   */
+  void BeginParseBatch();
+
+  /**
+   * @brief publish the frames parsed since BeginParseBatch
+   */
+  void EndParseBatch();
+
   void ClearSensorData();
 
   std::condition_variable *GetMutableCVar();
@@ -99,8 +120,8 @@ class MessageManager {
       const uint32_t message_id);
 
   /**
-   * @brief get chassis detail. used lock_guard in this function to avoid
-   * concurrent read/write issue.
+   * @brief get chassis detail, as of the latest parsed frame. It does not
+   * block on Parse.
    * @param chassis_detail chassis_detail to be filled.
    */
   common::ErrorCode GetSensorData(SensorType *const sensor_data);
@@ -124,11 +145,46 @@ class MessageManager {
   std::unordered_map<uint32_t, CheckIdArg> check_ids_;
   std::set<uint32_t> received_ids_;
 
+  // Used by the managers that parse into sensor_data_ themselves.
   std::mutex sensor_data_mutex_;
   SensorType sensor_data_;
   bool is_received_on_time_ = false;
 
   std::condition_variable cvar_;
+
+ private:
+  void AddProtocolData(const uint32_t message_id,
+                       ProtocolData<SensorType> *protocol_data);
+
+  // Returns the back snapshot, holding the latest published data.
+  SensorType *BackSnapshot();
+
+  void Publish();
+
+  // Standard 11 bit ids are looked up in the flat table, others in the map.
+  static constexpr uint32_t kFlatTableSize = 0x800;
+  std::vector<ProtocolData<SensorType> *> protocol_data_table_;
+
+  static constexpr int kSnapshotNum = 3;
+  static constexpr uint8_t kSnapshotFresh = 0x4;
+  static constexpr uint8_t kSnapshotIndexMask = 0x3;
+
+  // Serializes Parse and ClearSensorData, held during a parse batch.
+  std::recursive_mutex parse_mutex_;
+  bool in_parse_batch_ = false;
+  // The back snapshot of the batch, taken by its first parsed frame.
+  SensorType *batch_snapshot_ = nullptr;
+  SensorType snapshots_[kSnapshotNum];
+  int write_index_ = 0;
+  int latest_index_ = 0;
+  // Index of the snapshot between writer and readers, with kSnapshotFresh
+  // set if it has not been read yet.
+  std::atomic<uint8_t> middle_index_{1};
+  std::atomic<bool> has_snapshot_{false};
+
+  // Serializes the readers only.
+  std::mutex read_mutex_;
+  int read_index_ = 2;
 };
 
 template <typename SensorType>
@@ -139,7 +195,7 @@ void MessageManager<SensorType>::AddRecvProtocolData() {
   if (dt == nullptr) {
     return;
   }
-  protocol_data_map_[T::ID] = dt;
+  AddProtocolData(T::ID, dt);
   if (need_check) {
     check_ids_[T::ID].period = dt->GetPeriod();
     check_ids_[T::ID].real_period = 0;
@@ -156,7 +212,7 @@ void MessageManager<SensorType>::AddSendProtocolData() {
   if (dt == nullptr) {
     return;
   }
-  protocol_data_map_[T::ID] = dt;
+  AddProtocolData(T::ID, dt);
   if (need_check) {
     check_ids_[T::ID].period = dt->GetPeriod();
     check_ids_[T::ID].real_period = 0;
@@ -165,11 +221,28 @@ void MessageManager<SensorType>::AddSendProtocolData() {
   }
 }
 
+template <typename SensorType>
+void MessageManager<SensorType>::AddProtocolData(
+    const uint32_t message_id, ProtocolData<SensorType> *protocol_data) {
+  protocol_data_map_[message_id] = protocol_data;
+  if (message_id < kFlatTableSize) {
+    protocol_data_table_.resize(kFlatTableSize, nullptr);
+    protocol_data_table_[message_id] = protocol_data;
+  }
+}
+
 template <typename SensorType>
 ProtocolData<SensorType> *
 MessageManager<SensorType>::GetMutableProtocolDataById(
     const uint32_t message_id) {
   ADEBUG << "get protocol data message_id is:" << Byte::byte_to_hex(message_id);
+  if (message_id < protocol_data_table_.size()) {
+    if (protocol_data_table_[message_id] == nullptr) {
+      ADEBUG << "Unable to get protocol data because of invalid message_id:"
+             << Byte::byte_to_hex(message_id);
+    }
+    return protocol_data_table_[message_id];
+  }
   if (protocol_data_map_.find(message_id) == protocol_data_map_.end()) {
     ADEBUG << "Unable to get protocol data because of invalid message_id:"
            << Byte::byte_to_hex(message_id);
@@ -186,9 +259,15 @@ void MessageManager<SensorType>::Parse(const uint32_t message_id,
   if (protocol_data == nullptr) {
     return;
   }
-  {
-    std::lock_guard<std::mutex> lock(sensor_data_mutex_);
-    protocol_data->Parse(data, length, &sensor_data_);
+  std::lock_guard<std::recursive_mutex> lock(parse_mutex_);
+  if (!in_parse_batch_) {
+    protocol_data->Parse(data, length, BackSnapshot());
+    Publish();
+  } else {
+    if (batch_snapshot_ == nullptr) {
+      batch_snapshot_ = BackSnapshot();
+    }
+    protocol_data->Parse(data, length, batch_snapshot_);
   }
   received_ids_.insert(message_id);
   // check if need to check period
@@ -208,10 +287,56 @@ void MessageManager<SensorType>::Parse(const uint32_t message_id,
   }
 }
 
+template <typename SensorType>
+void MessageManager<SensorType>::BeginParseBatch() {
+  parse_mutex_.lock();
+  in_parse_batch_ = true;
+}
+
+template <typename SensorType>
+void MessageManager<SensorType>::EndParseBatch() {
+  in_parse_batch_ = false;
+  // Nothing is published if no frame went through Parse, as for the
+  // managers that parse into sensor_data_ themselves.
+  if (batch_snapshot_ != nullptr) {
+    batch_snapshot_ = nullptr;
+    Publish();
+  }
+  parse_mutex_.unlock();
+}
+
+template <typename SensorType>
+SensorType *MessageManager<SensorType>::BackSnapshot() {
+  SensorType *snapshot = &snapshots_[write_index_];
+  if (has_snapshot_.load(std::memory_order_relaxed)) {
+    // Readers may copy the latest snapshot at the same time, which is fine
+    // as nobody writes it.
+    snapshot->CopyFrom(snapshots_[latest_index_]);
+  }
+  return snapshot;
+}
+
+template <typename SensorType>
+void MessageManager<SensorType>::Publish() {
+  latest_index_ = write_index_;
+  write_index_ = middle_index_.exchange(
+                     static_cast<uint8_t>(write_index_ | kSnapshotFresh),
+                     std::memory_order_acq_rel) &
+                 kSnapshotIndexMask;
+  has_snapshot_.store(true, std::memory_order_release);
+}
+
 template <typename SensorType>
 void MessageManager<SensorType>::ClearSensorData() {
-  std::lock_guard<std::mutex> lock(sensor_data_mutex_);
-  sensor_data_.Clear();
+  {
+    std::lock_guard<std::mutex> lock(sensor_data_mutex_);
+    sensor_data_.Clear();
+  }
+  std::lock_guard<std::recursive_mutex> lock(parse_mutex_);
+  if (has_snapshot_.load(std::memory_order_relaxed)) {
+    snapshots_[write_index_].Clear();
+    Publish();
+  }
 }
 
 template <typename SensorType>
@@ -226,8 +351,21 @@ ErrorCode MessageManager<SensorType>::GetSensorData(
     AERROR << "Failed to get sensor_data due to nullptr.";
     return ErrorCode::CANBUS_ERROR;
   }
-  std::lock_guard<std::mutex> lock(sensor_data_mutex_);
-  sensor_data->CopyFrom(sensor_data_);
+  if (!has_snapshot_.load(std::memory_order_acquire)) {
+    // Nothing went through Parse, the sensor data may still have been
+    // parsed by a derived manager.
+    std::lock_guard<std::mutex> lock(sensor_data_mutex_);
+    sensor_data->CopyFrom(sensor_data_);
+    return ErrorCode::OK;
+  }
+  std::lock_guard<std::mutex> lock(read_mutex_);
+  if (middle_index_.load(std::memory_order_relaxed) & kSnapshotFresh) {
+    read_index_ =
+        middle_index_.exchange(static_cast<uint8_t>(read_index_),
+                               std::memory_order_acq_rel) &
+        kSnapshotIndexMask;
+  }
+  sensor_data->CopyFrom(snapshots_[read_index_]);
   return ErrorCode::OK;
 }
 
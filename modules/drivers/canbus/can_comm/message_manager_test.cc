@@ -16,8 +16,11 @@
 
 #include "modules/drivers/canbus/can_comm/message_manager.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <set>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -36,19 +39,65 @@ class MockProtocolData : public ProtocolData<::apollo::canbus::ChassisDetail> {
   MockProtocolData() {}
 };
 
+// Keeps data[0] as the gas pedal position.
+class GasProtocolData : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  static const int32_t ID = 0x222;
+  void Parse(const uint8_t *bytes, int32_t length,
+             ::apollo::canbus::ChassisDetail *chassis_detail) const override {
+    chassis_detail->mutable_gas()->set_gas_pedal_position(bytes[0]);
+  }
+};
+
+// Uses an extended id, which is not in the flat table.
+class ExtendedProtocolData
+    : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  static const int32_t ID = 0x18FF0001;
+  void Parse(const uint8_t *bytes, int32_t length,
+             ::apollo::canbus::ChassisDetail *chassis_detail) const override {
+    chassis_detail->mutable_basic()->set_odo_meter(bytes[0]);
+  }
+};
+
+// Like the lincoln License7e, writes the vin on the first parse only.
+class VinProtocolData : public ProtocolData<::apollo::canbus::ChassisDetail> {
+ public:
+  static const int32_t ID = 0x7E;
+  void Parse(const uint8_t *bytes, int32_t length,
+             ::apollo::canbus::ChassisDetail *chassis_detail) const override {
+    if (!parse_success_) {
+      chassis_detail->mutable_vehicle_id()->set_vin("LINCOLN");
+      parse_success_ = true;
+    }
+  }
+
+ private:
+  mutable bool parse_success_ = false;
+};
+
 class MockMessageManager
     : public MessageManager<::apollo::canbus::ChassisDetail> {
  public:
   MockMessageManager() {
     AddRecvProtocolData<MockProtocolData, true>();
     AddSendProtocolData<MockProtocolData, true>();
+    AddRecvProtocolData<GasProtocolData, false>();
+    AddRecvProtocolData<ExtendedProtocolData, false>();
+    AddRecvProtocolData<VinProtocolData, false>();
   }
 };
 
+double GasPedalPosition(MockMessageManager *manager) {
+  ::apollo::canbus::ChassisDetail chassis_detail;
+  EXPECT_EQ(manager->GetSensorData(&chassis_detail), ErrorCode::OK);
+  return chassis_detail.gas().gas_pedal_position();
+}
+
 TEST(MessageManagerTest, GetMutableProtocolDataById) {
-  uint8_t mock_data = 1;
+  uint8_t mock_data[CANBUS_MESSAGE_LENGTH] = {1};
   MockMessageManager manager;
-  manager.Parse(MockProtocolData::ID, &mock_data, 8);
+  manager.Parse(MockProtocolData::ID, mock_data, 8);
   manager.ResetSendMessages();
   EXPECT_NE(manager.GetMutableProtocolDataById(MockProtocolData::ID), nullptr);
 
@@ -56,6 +105,127 @@ TEST(MessageManagerTest, GetMutableProtocolDataById) {
   chassis_detail.set_car_type(::apollo::canbus::ChassisDetail::QIRUI_EQ_15);
   EXPECT_EQ(manager.GetSensorData(&chassis_detail), ErrorCode::OK);
   EXPECT_EQ(manager.GetSensorData(nullptr), ErrorCode::CANBUS_ERROR);
+  EXPECT_NE(manager.GetMutableProtocolDataById(ExtendedProtocolData::ID),
+            nullptr);
+  EXPECT_EQ(manager.GetMutableProtocolDataById(0x333), nullptr);
+  EXPECT_EQ(manager.GetMutableProtocolDataById(0x1FFFFFFF), nullptr);
+}
+
+TEST(MessageManagerTest, SnapshotFollowsParse) {
+  MockMessageManager manager;
+  EXPECT_EQ(0.0, GasPedalPosition(&manager));
+
+  uint8_t data[CANBUS_MESSAGE_LENGTH] = {0};
+  for (uint8_t i = 1; i <= 200; ++i) {
+    data[0] = i;
+    manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+    if (i % 7 == 0) {
+      EXPECT_EQ(i, GasPedalPosition(&manager));
+    }
+  }
+  EXPECT_EQ(200, GasPedalPosition(&manager));
+  EXPECT_EQ(200, GasPedalPosition(&manager));
+
+  data[0] = 5;
+  manager.Parse(ExtendedProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  ::apollo::canbus::ChassisDetail chassis_detail;
+  manager.GetSensorData(&chassis_detail);
+  EXPECT_EQ(5, chassis_detail.basic().odo_meter());
+  EXPECT_EQ(200, chassis_detail.gas().gas_pedal_position());
+
+  manager.ClearSensorData();
+  EXPECT_EQ(0.0, GasPedalPosition(&manager));
+  data[0] = 9;
+  manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  manager.GetSensorData(&chassis_detail);
+  EXPECT_EQ(9, chassis_detail.gas().gas_pedal_position());
+  EXPECT_FALSE(chassis_detail.has_basic());
+}
+
+TEST(MessageManagerTest, StatefulParser) {
+  MockMessageManager manager;
+  uint8_t data[CANBUS_MESSAGE_LENGTH] = {0};
+  manager.Parse(VinProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  manager.Parse(VinProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  for (uint8_t i = 1; i <= 10; ++i) {
+    data[0] = i;
+    manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+    // Every snapshot handed out keeps the vin parsed once.
+    ::apollo::canbus::ChassisDetail chassis_detail;
+    EXPECT_EQ(manager.GetSensorData(&chassis_detail), ErrorCode::OK);
+    EXPECT_EQ("LINCOLN", chassis_detail.vehicle_id().vin());
+    EXPECT_EQ(i, chassis_detail.gas().gas_pedal_position());
+  }
+}
+
+TEST(MessageManagerTest, ParseBatch) {
+  MockMessageManager manager;
+  uint8_t data[CANBUS_MESSAGE_LENGTH] = {0};
+  data[0] = 1;
+  manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+
+  manager.BeginParseBatch();
+  data[0] = 2;
+  manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  data[0] = 3;
+  manager.Parse(ExtendedProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  // Parsing from another thread waits for the batch.
+  std::atomic<bool> echo_parsed(false);
+  std::thread echo([&]() {
+    uint8_t echo_data[CANBUS_MESSAGE_LENGTH] = {4};
+    manager.Parse(GasProtocolData::ID, echo_data, CANBUS_MESSAGE_LENGTH);
+    echo_parsed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(echo_parsed);
+  // Readers do not see a batch before it ends.
+  ::apollo::canbus::ChassisDetail chassis_detail;
+  manager.GetSensorData(&chassis_detail);
+  EXPECT_EQ(1, chassis_detail.gas().gas_pedal_position());
+  EXPECT_FALSE(chassis_detail.has_basic());
+  manager.EndParseBatch();
+  echo.join();
+
+  manager.GetSensorData(&chassis_detail);
+  EXPECT_EQ(4, chassis_detail.gas().gas_pedal_position());
+  EXPECT_EQ(3, chassis_detail.basic().odo_meter());
+
+  // A batch without known frames publishes nothing.
+  MockMessageManager empty_manager;
+  empty_manager.BeginParseBatch();
+  empty_manager.Parse(0x333, data, CANBUS_MESSAGE_LENGTH);
+  empty_manager.EndParseBatch();
+  EXPECT_EQ(0.0, GasPedalPosition(&empty_manager));
+}
+
+TEST(MessageManagerTest, ConcurrentReaders) {
+  MockMessageManager manager;
+  std::atomic<bool> running(true);
+  std::atomic<bool> monotonic(true);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&]() {
+      double last = 0.0;
+      while (running) {
+        const double position = GasPedalPosition(&manager);
+        if (position < last) {
+          monotonic = false;
+        }
+        last = position;
+      }
+    });
+  }
+  uint8_t data[CANBUS_MESSAGE_LENGTH] = {0};
+  for (int i = 0; i < 20000; ++i) {
+    data[0] = static_cast<uint8_t>(i / 100);
+    manager.Parse(GasProtocolData::ID, data, CANBUS_MESSAGE_LENGTH);
+  }
+  running = false;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_TRUE(monotonic);
+  EXPECT_EQ(199, GasPedalPosition(&manager));
 }
 
 }  // namespace canbus
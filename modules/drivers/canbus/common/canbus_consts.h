@@ -31,7 +31,8 @@ namespace drivers {
 namespace canbus {
 
 const int32_t CAN_FRAME_SIZE = 8;
-const int32_t MAX_CAN_SEND_FRAME_LEN = 1;
+// Frames a CanClient sends in one call.
+const int32_t MAX_CAN_SEND_FRAME_LEN = 16;
 const int32_t MAX_CAN_RECV_FRAME_LEN = 10;
 
 const int32_t CANBUS_MESSAGE_LENGTH = 8;  // according to ISO-11891-1
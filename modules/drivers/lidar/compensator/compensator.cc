@@ -19,49 +19,44 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace apollo {
 namespace drivers {
 namespace compensator {
 
-bool Compensator::QueryPoseAffineFromTF2(
-        const uint64_t& timestamp,
-        void* pose,
-        const std::string& child_frame_id) {
-    cyber::Time query_time(timestamp);
+bool Compensator::QueryPoseAffinesFromTF2(
+        const std::vector<uint64_t>& timestamps,
+        const std::string& child_frame_id,
+        std::vector<Eigen::Affine3d>* poses) {
     std::string err_string;
-    if (!tf2_buffer_ptr_->canTransform(
-                config_.world_frame_id(),
-                child_frame_id,
-                query_time,
+    std::vector<transform::TransformSample> transforms;
+    if (!tf2_buffer_ptr_->LookupTransforms(
+                tf2_buffer_ptr_->GetFrameId(config_.world_frame_id()),
+                tf2_buffer_ptr_->GetFrameId(child_frame_id),
+                timestamps,
                 config_.transform_query_timeout(),
+                &transforms,
                 &err_string)) {
-        AERROR << "Can not find transform. " << timestamp
+        AERROR << "Can not find transform. " << timestamps.back()
                << " frame_id:" << child_frame_id
                << " Error info: " << err_string;
         return false;
     }
 
-    apollo::transform::TransformStamped stamped_transform;
-
-    try {
-        stamped_transform = tf2_buffer_ptr_->lookupTransform(
-                config_.world_frame_id(), child_frame_id, query_time);
-    } catch (tf2::TransformException& ex) {
-        AERROR << ex.what();
-        return false;
+    poses->clear();
+    for (const auto& transform : transforms) {
+        poses->push_back(
+                Eigen::Translation3d(
+                        transform.translation[0],
+                        transform.translation[1],
+                        transform.translation[2])
+                * Eigen::Quaterniond(
+                        transform.rotation[3],
+                        transform.rotation[0],
+                        transform.rotation[1],
+                        transform.rotation[2]));
     }
-
-    Eigen::Affine3d* tmp_pose = (Eigen::Affine3d*)pose;
-    *tmp_pose = Eigen::Translation3d(
-                        stamped_transform.transform().translation().x(),
-                        stamped_transform.transform().translation().y(),
-                        stamped_transform.transform().translation().z())
-            * Eigen::Quaterniond(
-                        stamped_transform.transform().rotation().qw(),
-                        stamped_transform.transform().rotation().qx(),
-                        stamped_transform.transform().rotation().qy(),
-                        stamped_transform.transform().rotation().qz());
     return true;
 }
 
@@ -73,8 +68,7 @@ bool Compensator::MotionCompensation(
         return false;
     }
     uint64_t start = cyber::Time::Now().ToNanosecond();
-    Eigen::Affine3d pose_min_time;
-    Eigen::Affine3d pose_max_time;
+    std::vector<Eigen::Affine3d> poses;
 
     uint64_t timestamp_min = 0;
     uint64_t timestamp_max = 0;
@@ -96,8 +90,8 @@ bool Compensator::MotionCompensation(
     msg_compensated->mutable_point()->Reserve(240000);
 
     // compensate point cloud, remove nan point
-    if (QueryPoseAffineFromTF2(timestamp_min, &pose_min_time, frame_id)
-        && QueryPoseAffineFromTF2(timestamp_max, &pose_max_time, frame_id)) {
+    if (QueryPoseAffinesFromTF2(
+                {timestamp_min, timestamp_max}, frame_id, &poses)) {
         uint64_t tf_time = cyber::Time().Now().ToNanosecond();
         AINFO << "compenstator tf msg diff:" << tf_time - new_time
               << ";meta:" << msg->header().lidar_timestamp();
@@ -106,8 +100,8 @@ bool Compensator::MotionCompensation(
                 msg_compensated,
                 timestamp_min,
                 timestamp_max,
-                pose_min_time,
-                pose_max_time);
+                poses[0],
+                poses[1]);
         uint64_t com_time = cyber::Time().Now().ToNanosecond();
         msg_compensated->set_width(
                 msg_compensated->point_size() / msg->height());
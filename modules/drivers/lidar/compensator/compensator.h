@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Eigen/Eigen"
 
@@ -49,13 +50,13 @@ class Compensator {
 
  private:
     /**
-     * @brief get pose affine from tf2 by gps timestamp
+     * @brief get pose affines from tf2 by gps timestamps in one batch
      *   novatel-preprocess broadcast the tf2 transfrom.
      */
-    bool QueryPoseAffineFromTF2(
-            const uint64_t& timestamp,
-            void* pose,
-            const std::string& child_frame_id);
+    bool QueryPoseAffinesFromTF2(
+            const std::vector<uint64_t>& timestamps,
+            const std::string& child_frame_id,
+            std::vector<Eigen::Affine3d>* poses);
 
     /**
      * @brief motion compensation for point cloud
@@ -81,6 +81,14 @@ DEFINE_double(lidar_imu_max_delay_time, 0.4,
 DEFINE_double(lidar_map_coverage_theshold, 0.9,
               "Threshold to detect whether vehicle is out of map");
 DEFINE_bool(lidar_debug_log_flag, false, "Lidar Debug switch.");
+DEFINE_bool(lidar_map_prefetch, false,
+            "Prefetch the map nodes ahead of the vehicle in the background.");
+DEFINE_int32(lidar_map_prefetch_threads, 2,
+             "Number of threads loading prefetched map nodes.");
+DEFINE_int32(lidar_map_prefetch_nodes, 8,
+             "Maximum number of map nodes prefetched ahead.");
+DEFINE_double(lidar_map_prefetch_horizon, 3.0,
+              "Time in seconds the map nodes are prefetched ahead.");
 DEFINE_int32(point_cloud_step, 2, "Point cloud step");
 DEFINE_bool(if_use_avx, false,
             "if use avx to accelerate lidar localization, "
@@ -191,3 +199,7 @@ DEFINE_int32(ndt_bad_score_count_threshold, 10,
 DEFINE_double(ndt_warnning_ndt_score, 1.0,
               "warnning ndt fitness score threshold");
 DEFINE_double(ndt_error_ndt_score, 2.0, "error ndt fitness score threshold");
+DEFINE_int32(ndt_num_threads, 1,
+             "number of threads accumulating ndt derivatives");
+DEFINE_string(ndt_neighbor_search_method, "kdtree",
+              "ndt voxel neighbor search: kdtree, direct1, direct7, direct27");
@@ -61,6 +61,10 @@ DECLARE_int32(lidar_filter_size);
 DECLARE_double(lidar_imu_max_delay_time);
 DECLARE_double(lidar_map_coverage_theshold);
 DECLARE_bool(lidar_debug_log_flag);
+DECLARE_bool(lidar_map_prefetch);
+DECLARE_int32(lidar_map_prefetch_threads);
+DECLARE_int32(lidar_map_prefetch_nodes);
+DECLARE_double(lidar_map_prefetch_horizon);
 DECLARE_int32(point_cloud_step);
 DECLARE_bool(if_use_avx);
 
@@ -141,3 +145,5 @@ DECLARE_int32(ndt_filter_size_y);
 DECLARE_int32(ndt_bad_score_count_threshold);
 DECLARE_double(ndt_warnning_ndt_score);
 DECLARE_double(ndt_error_ndt_score);
+DECLARE_int32(ndt_num_threads);
+DECLARE_string(ndt_neighbor_search_method);
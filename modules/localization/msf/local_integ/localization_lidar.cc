@@ -41,6 +41,9 @@ LocalizationLidar::LocalizationLidar()
 }
 
 LocalizationLidar::~LocalizationLidar() {
+  // The loading tasks use map_node_pool_, which is destroyed before map_.
+  map_.StopPrefetcher();
+
   if (lidar_map_node_) {
     delete lidar_map_node_;
     lidar_map_node_ = nullptr;
@@ -115,6 +118,17 @@ void LocalizationLidar::SetDeltaPitchRollLimit(double limit) {
   lidar_locator_->SetDeltaPitchRollLimit(limit);
 }
 
+void LocalizationLidar::SetMapPrefetch(
+    const pyramid_map::MapPrefetchConfig& config) {
+  map_.InitPrefetcher(config);
+  enable_map_prefetch_ = true;
+}
+
+void LocalizationLidar::SetPrefetchPath(
+    const std::vector<Eigen::Vector3d>& path) {
+  prefetch_path_ = path;
+}
+
 int LocalizationLidar::Update(const unsigned int frame_idx,
                               const Eigen::Affine3d& pose,
                               const Eigen::Vector3d velocity,
@@ -137,6 +151,26 @@ int LocalizationLidar::Update(const unsigned int frame_idx,
 
   // preload map for next locate
   map_.PreloadMapArea(pose_trans, velocity, resolution_id_, zone_id_);
+  if (enable_map_prefetch_) {
+    // velocity is the displacement since the previous frame
+    const double dt = lidar_frame.measurement_time - pre_measurement_time_;
+    if (pre_measurement_time_ > 0.0 && dt > 0.0) {
+      map_.PrefetchMapArea(pose_trans, velocity / dt, resolution_id_,
+                           zone_id_, prefetch_path_);
+    }
+    pre_measurement_time_ = lidar_frame.measurement_time;
+    if (frame_idx % 100 == 0) {
+      const pyramid_map::MapNodeLoadStats stats = map_.GetLoadStats();
+      AINFO << "Map node hit: " << stats.hit_count
+            << ", late: " << stats.late_count
+            << ", miss: " << stats.miss_count
+            << ", loaded: " << stats.load_count << ", mean load time: "
+            << (stats.load_count > 0
+                    ? stats.total_load_time / stats.load_count
+                    : 0.0)
+            << " ms, max load time: " << stats.max_load_time << " ms";
+    }
+  }
 
   // generate composed map for compare
   ComposeMapNode(pose_trans);
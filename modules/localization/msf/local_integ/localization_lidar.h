@@ -106,6 +106,13 @@ class LocalizationLidar {
 
   void SetDeltaPitchRollLimit(double limit);
 
+  /**@brief Prefetch the map nodes ahead of the vehicle in the background. */
+  void SetMapPrefetch(const pyramid_map::MapPrefetchConfig& config);
+
+  /**@brief Set the path the map nodes are prefetched along, e.g. the routing
+   * path. An empty path prefetches along the velocity direction. */
+  void SetPrefetchPath(const std::vector<Eigen::Vector3d>& path);
+
   int Update(const unsigned int frame_idx, const Eigen::Affine3d& pose,
              const Eigen::Vector3d velocity, const LidarFrame& lidar_frame,
              bool use_avx = false);
@@ -133,6 +140,9 @@ class LocalizationLidar {
 
   PyramidMapConfig config_;
   PyramidMap map_;
+  bool enable_map_prefetch_ = false;
+  std::vector<Eigen::Vector3d> prefetch_path_;
+  double pre_measurement_time_ = 0.0;
   PyramidMapNodePool map_node_pool_;
   Eigen::Vector2d map_left_top_corner_;
   unsigned int resolution_id_ = 0;
@@ -16,6 +16,8 @@
 
 #include "modules/localization/msf/local_integ/localization_lidar_process.h"
 
+#include <algorithm>
+
 #include "yaml-cpp/yaml.h"
 
 #include "cyber/common/file.h"
@@ -137,6 +139,15 @@ Status LocalizationLidarProcess::Init(const LocalizationIntegParam& params) {
   locator_->SetValidThreshold(static_cast<float>(map_coverage_theshold_));
   locator_->SetVehicleHeight(lidar_height_.height);
   locator_->SetDeltaPitchRollLimit(compensate_pitch_roll_limit_);
+  if (params.enable_map_prefetch) {
+    pyramid_map::MapPrefetchConfig prefetch_config;
+    prefetch_config.num_io_threads =
+        static_cast<unsigned int>(std::max(params.map_prefetch_threads, 1));
+    prefetch_config.max_prefetch_nodes =
+        static_cast<unsigned int>(std::max(params.map_prefetch_nodes, 0));
+    prefetch_config.horizon_time = params.map_prefetch_horizon;
+    locator_->SetMapPrefetch(prefetch_config);
+  }
 
   const double deg_to_rad = 0.017453292519943;
   const double max_gyro_input = 200 * deg_to_rad;  // 200 degree
@@ -90,6 +90,10 @@ struct LocalizationIntegParam {
   bool is_lidar_unstable_reset = true;
   double unstable_reset_threshold = 0.3;
   bool if_use_avx = false;
+  bool enable_map_prefetch = false;
+  int map_prefetch_threads = 2;
+  int map_prefetch_nodes = 8;
+  double map_prefetch_horizon = 3.0;
 
   bool is_using_novatel_heading = true;
   std::string ant_imu_leverarm_file = "";
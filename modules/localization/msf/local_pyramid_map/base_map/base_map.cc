@@ -16,6 +16,9 @@
 
 #include "modules/localization/msf/local_pyramid_map/base_map/base_map.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <set>
 #include <string>
 
@@ -35,7 +38,7 @@ BaseMap::BaseMap(BaseMapConfig* config)
       map_node_cache_lvl2_(nullptr),
       map_node_pool_(nullptr) {}
 
-BaseMap::~BaseMap() {}
+BaseMap::~BaseMap() { StopPrefetcher(); }
 
 void BaseMap::InitMapNodeCaches(int cacheL1_size, int cahceL2_size) {
   destroy_func_lvl1_ =
@@ -125,6 +128,7 @@ void BaseMap::LoadMapNodes(std::set<MapNodeIndex>* map_ids) {
     std::cerr << "map_ids's size is bigger than cache's capacity" << std::endl;
     return;
   }
+  const size_t num_requested = map_ids->size();
 
   // check in cacheL1
   std::set<MapNodeIndex>::iterator itr = map_ids->begin();
@@ -142,6 +146,33 @@ void BaseMap::LoadMapNodes(std::set<MapNodeIndex>* map_ids) {
   }
   // check and update cache
   CheckAndUpdateCache(map_ids);
+  const size_t num_hits = num_requested - map_ids->size();
+  // wait for the nodes still being preloaded rather than loading them twice
+  std::vector<std::shared_future<void>> running_tasks;
+  boost::unique_lock<boost::recursive_mutex> lock2(map_load_mutex_);
+  for (const MapNodeIndex& index : *map_ids) {
+    auto task_itr = map_loading_tasks_.find(index);
+    if (task_itr != map_loading_tasks_.end()) {
+      running_tasks.push_back(task_itr->second);
+    }
+  }
+  lock2.unlock();
+  for (auto& task : running_tasks) {
+    task.wait();
+  }
+  // the waited tasks are consumed, others may have finished meanwhile
+  lock2.lock();
+  EraseFinishedLoadingTasks();
+  lock2.unlock();
+  if (!running_tasks.empty()) {
+    CheckAndUpdateCache(map_ids);
+  }
+  {
+    std::lock_guard<std::mutex> stats_lock(load_stats_mutex_);
+    load_stats_.hit_count += num_hits;
+    load_stats_.late_count += num_requested - num_hits - map_ids->size();
+    load_stats_.miss_count += map_ids->size();
+  }
   // load from disk sync
   std::vector<std::future<void>> load_futures_;
   itr = map_ids->begin();
@@ -210,21 +241,44 @@ void BaseMap::PreloadMapNodes(std::set<MapNodeIndex>* map_ids) {
       ++itr;
     }
   }
-  // load form disk sync
-  std::vector<std::future<void>> preload_futures;
+  // load form disk async
   itr = map_ids->begin();
   AINFO << "Preload map node size: " << map_ids->size();
   while (itr != map_ids->end()) {
     AINFO << "Preload map node: " << *itr << std::endl;
-    boost::unique_lock<boost::recursive_mutex> lock3(map_load_mutex_);
-    map_preloading_task_index_.insert(*itr);
-    lock3.unlock();
-    preload_futures.emplace_back(
-        cyber::Async(&BaseMap::LoadMapNodeThreadSafety, this, *itr, false));
+    StartLoadingTask(*itr);
     ++itr;
   }
 }
 
+void BaseMap::StartLoadingTask(const MapNodeIndex& index) {
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  map_preloading_task_index_.insert(index);
+  EraseFinishedLoadingTasks();
+  if (prefetch_pool_) {
+    map_loading_tasks_[index] =
+        prefetch_pool_
+            ->Enqueue(&BaseMap::LoadMapNodeThreadSafety, this, index, false)
+            .share();
+  } else {
+    map_loading_tasks_[index] =
+        cyber::Async(&BaseMap::LoadMapNodeThreadSafety, this, index, false)
+            .share();
+  }
+}
+
+void BaseMap::EraseFinishedLoadingTasks() {
+  for (auto itr = map_loading_tasks_.begin();
+       itr != map_loading_tasks_.end();) {
+    if (itr->second.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      itr = map_loading_tasks_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
 void BaseMap::LoadMapNodeThreadSafety(const MapNodeIndex& index,
                                       bool is_reserved) {
   BaseMapNode* map_node = nullptr;
@@ -241,11 +295,21 @@ void BaseMap::LoadMapNodeThreadSafety(const MapNodeIndex& index,
   }
   map_node->SetMapNodeIndex(index);
 
+  const auto start_time = std::chrono::steady_clock::now();
   if (!map_node->Load()) {
     AINFO << "Created map node: " << index;
   } else {
     AINFO << "Loaded map node: " << index;
   }
+  const double load_time = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start_time)
+                               .count();
+  {
+    std::lock_guard<std::mutex> stats_lock(load_stats_mutex_);
+    ++load_stats_.load_count;
+    load_stats_.total_load_time += load_time;
+    load_stats_.max_load_time = std::max(load_stats_.max_load_time, load_time);
+  }
   map_node->SetIsReserved(is_reserved);
   boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
   BaseMapNode* node_remove = map_node_cache_lvl2_->Put(index, map_node);
@@ -487,6 +551,171 @@ bool BaseMap::LoadMapArea(const Eigen::Vector3d& seed_pt3d,
   return true;
 }
 
+void BaseMap::InitPrefetcher(const MapPrefetchConfig& config) {
+  StopPrefetcher();
+  prefetch_config_ = config;
+  prefetch_pool_.reset(new cyber::base::ThreadPool(
+      std::max(config.num_io_threads, 1u)));
+  AINFO << "Map node prefetcher: " << config.num_io_threads
+        << " io threads, " << config.max_prefetch_nodes << " nodes, "
+        << config.horizon_time << " s ahead.";
+}
+
+void BaseMap::StopPrefetcher() {
+  WaitPrefetchTasks();
+  prefetch_pool_.reset();
+}
+
+void BaseMap::WaitPrefetchTasks() {
+  std::vector<std::shared_future<void>> running_tasks;
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  for (const auto& task : map_loading_tasks_) {
+    running_tasks.push_back(task.second);
+  }
+  lock.unlock();
+  for (auto& task : running_tasks) {
+    if (task.valid()) {
+      task.wait();
+    }
+  }
+  lock.lock();
+  map_loading_tasks_.clear();
+}
+
+MapNodeLoadStats BaseMap::GetLoadStats() const {
+  std::lock_guard<std::mutex> lock(load_stats_mutex_);
+  return load_stats_;
+}
+
+void BaseMap::PrefetchMapArea(const Eigen::Vector3d& location,
+                              const Eigen::Vector3d& velocity,
+                              unsigned int resolution_id, unsigned int zone_id,
+                              const std::vector<Eigen::Vector3d>& path) {
+  if (map_node_pool_ == nullptr) {
+    std::cerr << "Map node pool is nullptr!" << std::endl;
+    return;
+  }
+  std::vector<MapNodeIndex> map_ids;
+  PredictMapNodes(location, velocity, resolution_id, zone_id, path, &map_ids);
+
+  // Leave the level 1 cache's worth of level 2 slots to the nodes in use, so
+  // that the predicted nodes never evict them or each other.
+  const unsigned int capacity_lvl1 = map_node_cache_lvl1_->Capacity();
+  const unsigned int capacity_lvl2 = map_node_cache_lvl2_->Capacity();
+  const size_t max_nodes =
+      capacity_lvl2 > capacity_lvl1 ? capacity_lvl2 - capacity_lvl1 : 0;
+  if (map_ids.size() > max_nodes) {
+    map_ids.resize(max_nodes);
+  }
+
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  EraseFinishedLoadingTasks();
+  for (const MapNodeIndex& index : map_ids) {
+    if (map_loading_tasks_.size() >= prefetch_config_.max_prefetch_nodes) {
+      break;
+    }
+    // IsExist also refreshes the node in the LRU list.
+    if (map_node_cache_lvl2_->IsExist(index) ||
+        map_loading_tasks_.count(index) > 0) {
+      continue;
+    }
+    ADEBUG << "Prefetch map node: " << index;
+    StartLoadingTask(index);
+  }
+}
+
+void BaseMap::PredictMapNodes(const Eigen::Vector3d& location,
+                              const Eigen::Vector3d& velocity,
+                              unsigned int resolution_id, unsigned int zone_id,
+                              const std::vector<Eigen::Vector3d>& path,
+                              std::vector<MapNodeIndex>* map_ids) const {
+  map_ids->clear();
+  const double resolution = map_config_->map_resolutions_[resolution_id];
+  const double node_size_x = map_config_->map_node_size_x_ * resolution;
+  const double node_size_y = map_config_->map_node_size_y_ * resolution;
+  // Sample the predicted trajectory every half node so that no node it
+  // crosses is skipped.
+  const double step = 0.5 * std::min(node_size_x, node_size_y);
+  const double speed = velocity.head<2>().norm();
+  const double lookahead = speed * prefetch_config_.horizon_time;
+  const unsigned int max_nodes = prefetch_config_.max_prefetch_nodes;
+  if (lookahead < step || max_nodes == 0) {
+    return;
+  }
+
+  std::vector<Eigen::Vector2d> samples;
+  if (path.size() >= 2) {
+    // Follow the path from its point nearest to the vehicle.
+    size_t nearest = 0;
+    double min_dist = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < path.size(); ++i) {
+      const double dist = (path[i] - location).head<2>().squaredNorm();
+      if (dist < min_dist) {
+        min_dist = dist;
+        nearest = i;
+      }
+    }
+    double accumulated = 0.0;
+    double next_sample = step;
+    for (size_t i = nearest + 1; i < path.size() && next_sample <= lookahead;
+         ++i) {
+      const Eigen::Vector2d start = path[i - 1].head<2>();
+      const Eigen::Vector2d segment = path[i].head<2>() - start;
+      const double length = segment.norm();
+      while (next_sample <= accumulated + length && next_sample <= lookahead) {
+        samples.push_back(start +
+                          segment * (next_sample - accumulated) / length);
+        next_sample += step;
+      }
+      accumulated += length;
+    }
+  } else {
+    const Eigen::Vector2d direction = velocity.head<2>() / speed;
+    for (double dist = step; dist <= lookahead; dist += step) {
+      samples.push_back(location.head<2>() + direction * dist);
+    }
+  }
+
+  for (const Eigen::Vector2d& sample : samples) {
+    AddMapNodesAround(sample, resolution_id, zone_id, max_nodes, map_ids);
+    if (map_ids->size() >= max_nodes) {
+      break;
+    }
+  }
+}
+
+void BaseMap::AddMapNodesAround(const Eigen::Vector2d& pt,
+                                unsigned int resolution_id,
+                                unsigned int zone_id, unsigned int max_nodes,
+                                std::vector<MapNodeIndex>* map_ids) const {
+  const double resolution = map_config_->map_resolutions_[resolution_id];
+  const double half_x = map_config_->map_node_size_x_ * resolution / 2.0;
+  const double half_y = map_config_->map_node_size_y_ * resolution / 2.0;
+  // The node containing the point first, then the ones under the corners of
+  // the window LoadMapArea will load there.
+  const Eigen::Vector2d offsets[] = {{0.0, 0.0},
+                                     {-half_x, -half_y},
+                                     {half_x, -half_y},
+                                     {-half_x, half_y},
+                                     {half_x, half_y}};
+  const Rect2D<double>& range = map_config_->map_range_;
+  for (const Eigen::Vector2d& offset : offsets) {
+    const Eigen::Vector2d corner = pt + offset;
+    if (corner[0] < range.GetMinX() || corner[0] >= range.GetMaxX() ||
+        corner[1] < range.GetMinY() || corner[1] >= range.GetMaxY()) {
+      continue;
+    }
+    const MapNodeIndex index = MapNodeIndex::GetMapNodeIndex(
+        *map_config_, corner, resolution_id, zone_id);
+    if (std::find(map_ids->begin(), map_ids->end(), index) == map_ids->end()) {
+      map_ids->push_back(index);
+      if (map_ids->size() >= max_nodes) {
+        return;
+      }
+    }
+  }
+}
+
 MapNodeIndex BaseMap::GetMapIndexFromMapPath(const std::string& map_path) {
   MapNodeIndex index;
   char buf[100];
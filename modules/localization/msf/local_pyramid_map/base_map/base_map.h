@@ -15,12 +15,16 @@
  *****************************************************************************/
 #pragma once
 
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/task/task.h"
 #include "modules/localization/msf/common/util/base_map_cache.h"
 #include "modules/localization/msf/local_pyramid_map/base_map/base_map_config.h"
@@ -34,6 +38,31 @@ namespace localization {
 namespace msf {
 namespace pyramid_map {
 
+/**@brief The settings of the velocity-aware map node prefetcher. */
+struct MapPrefetchConfig {
+  /**@brief The number of threads loading map nodes from disk. */
+  unsigned int num_io_threads = 2;
+  /**@brief The maximum number of nodes predicted and loaded ahead. */
+  unsigned int max_prefetch_nodes = 8;
+  /**@brief How far ahead the vehicle motion is predicted, in seconds. */
+  double horizon_time = 3.0;
+};
+
+/**@brief The map node loading statistics. */
+struct MapNodeLoadStats {
+  /**@brief Nodes already in the caches when LoadMapArea needs them. */
+  uint64_t hit_count = 0;
+  /**@brief Nodes still being prefetched when LoadMapArea needs them. */
+  uint64_t late_count = 0;
+  /**@brief Nodes LoadMapArea has to load from disk itself. */
+  uint64_t miss_count = 0;
+  /**@brief Nodes loaded from disk, by any caller. */
+  uint64_t load_count = 0;
+  /**@brief Total and maximum time of loading a node, in ms. */
+  double total_load_time = 0.0;
+  double max_load_time = 0.0;
+};
+
 /**@brief The data structure of the base map. */
 class BaseMap {
  public:
@@ -85,6 +114,31 @@ class BaseMap {
                            unsigned int resolution_id, unsigned int zone_id,
                            int filter_size_x, int filter_size_y);
 
+  /**@brief Start the prefetcher and its dedicated io threads. */
+  void InitPrefetcher(const MapPrefetchConfig& config);
+  /**@brief Wait for the running prefetch tasks and stop the io threads. */
+  void StopPrefetcher();
+  /**@brief Predict the map nodes the vehicle will need within the prefetch
+   * horizon and load the missing ones in the background, nearest first.
+   * The optional path, e.g. the routing path, is followed instead of the
+   * velocity direction when it is given.
+   * @param velocity The vehicle velocity in m/s. */
+  void PrefetchMapArea(const Eigen::Vector3d& location,
+                       const Eigen::Vector3d& velocity,
+                       unsigned int resolution_id, unsigned int zone_id,
+                       const std::vector<Eigen::Vector3d>& path = {});
+  /**@brief Predict the map nodes to prefetch, ordered by the distance the
+   * vehicle travels before it needs them. */
+  void PredictMapNodes(const Eigen::Vector3d& location,
+                       const Eigen::Vector3d& velocity,
+                       unsigned int resolution_id, unsigned int zone_id,
+                       const std::vector<Eigen::Vector3d>& path,
+                       std::vector<MapNodeIndex>* map_ids) const;
+  /**@brief Wait until all the running preload and prefetch tasks finish. */
+  void WaitPrefetchTasks();
+  /**@brief Get the map node loading statistics. */
+  MapNodeLoadStats GetLoadStats() const;
+
   /**@brief Compute md5 for all map node file in map. */
   void ComputeMd5ForAllMapNodes();
 
@@ -120,6 +174,15 @@ class BaseMap {
                                bool is_reserved = false);
   /**@brief Check map node in L2 Cache.*/
   void CheckAndUpdateCache(std::set<MapNodeIndex>* map_ids);
+  /**@brief Start loading a map node in the background. */
+  void StartLoadingTask(const MapNodeIndex& index);
+  /**@brief Drop the loading tasks that have finished. The caller must hold
+   * map_load_mutex_. */
+  void EraseFinishedLoadingTasks();
+  /**@brief Add the nodes covered by a node sized window around the point. */
+  void AddMapNodesAround(const Eigen::Vector2d& pt, unsigned int resolution_id,
+                         unsigned int zone_id, unsigned int max_nodes,
+                         std::vector<MapNodeIndex>* map_ids) const;
 
   /**@brief The map settings. */
   BaseMapConfig* map_config_ = nullptr;
@@ -136,6 +199,9 @@ class BaseMap {
   BaseMapNodePool* map_node_pool_ = nullptr;
   /**@bried Keep the index of preloading nodes. */
   std::set<MapNodeIndex> map_preloading_task_index_;
+  /**@brief The running preload and prefetch tasks, so that LoadMapNodes
+   * can wait for them instead of loading the same node again. */
+  std::map<MapNodeIndex, std::shared_future<void>> map_loading_tasks_;
   /**@brief The mutex for preload map node. **/
   boost::recursive_mutex map_load_mutex_;
 
@@ -145,6 +211,14 @@ class BaseMap {
 
   /**@brief All the map nodes' md5 in the Map (in the disk). */
   std::vector<std::string> all_map_node_md5s_;
+
+  /**@brief The map node loading statistics. */
+  MapNodeLoadStats load_stats_;
+  mutable std::mutex load_stats_mutex_;
+
+  /**@brief The prefetcher settings and io threads. */
+  MapPrefetchConfig prefetch_config_;
+  std::unique_ptr<cyber::base::ThreadPool> prefetch_pool_ = nullptr;
 };
 
 }  // namespace pyramid_map
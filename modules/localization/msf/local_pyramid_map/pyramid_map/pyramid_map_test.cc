@@ -224,6 +224,75 @@ TEST_F(PyramidMapTestSuite, test_init) {
   EXPECT_TRUE(pyramid_map.LoadMapArea(loc, 0, 50, 0, 0));
 }
 
+TEST_F(PyramidMapTestSuite, test_prefetch) {
+  // init config
+  PyramidMapConfig* config = new PyramidMapConfig("lossy_full_alt");
+  config->SetMapNodeSize(2, 2);
+  config->resolution_num_ = 1;
+  config->map_folder_path_ = "test_map";
+
+  // create and save nodes, each of them is 0.25m x 0.25m
+  unsigned int M = 4;
+  unsigned int N = 4;
+  for (unsigned int m = 0; m < M; ++m) {
+    for (unsigned int n = 0; n < N; ++n) {
+      MapNodeIndex index;
+      index.resolution_id_ = 0;
+      index.zone_id_ = 50;
+      index.m_ = m;
+      index.n_ = n;
+      CreateTestMapNode(m, n, index, config);
+    }
+  }
+  config->Save("test_map/config.xml");
+
+  PyramidMapNodePool pm_node_pool(16, 4);
+  pm_node_pool.Initial(config);
+
+  PyramidMap pyramid_map(config);
+  pyramid_map.InitMapNodeCaches(4, 15);
+  pyramid_map.AttachMapNodePool(&pm_node_pool);
+  EXPECT_TRUE(pyramid_map.SetMapFolderPath(config->map_folder_path_));
+  MapPrefetchConfig prefetch_config;
+  prefetch_config.num_io_threads = 2;
+  prefetch_config.max_prefetch_nodes = 8;
+  prefetch_config.horizon_time = 2.0;
+  pyramid_map.InitPrefetcher(prefetch_config);
+
+  // moving east at 0.25m/s from node (m = 0, n = 1)
+  Eigen::Vector3d loc(0.375, 0.125, 1.0);
+  Eigen::Vector3d velocity(0.25, 0.0, 0.0);
+  std::vector<MapNodeIndex> map_ids;
+  pyramid_map.PredictMapNodes(loc, velocity, 0, 50, {}, &map_ids);
+  ASSERT_FALSE(map_ids.empty());
+  EXPECT_LE(map_ids.size(), prefetch_config.max_prefetch_nodes);
+  EXPECT_EQ(map_ids[0].m_, 0);
+  EXPECT_EQ(map_ids[0].n_, 2);
+  bool has_far_node = false;
+  for (const MapNodeIndex& index : map_ids) {
+    has_far_node |= index.m_ == 0 && index.n_ == 3;
+  }
+  EXPECT_TRUE(has_far_node);
+
+  // a stopped vehicle predicts nothing
+  std::vector<MapNodeIndex> stopped_ids;
+  pyramid_map.PredictMapNodes(loc, Eigen::Vector3d::Zero(), 0, 50, {},
+                              &stopped_ids);
+  EXPECT_TRUE(stopped_ids.empty());
+
+  // the nodes ahead are served from the cache once prefetched
+  pyramid_map.PrefetchMapArea(loc, velocity, 0, 50);
+  pyramid_map.WaitPrefetchTasks();
+  MapNodeLoadStats stats = pyramid_map.GetLoadStats();
+  EXPECT_GT(stats.load_count, 0);
+  Eigen::Vector3d ahead(0.625, 0.125, 1.0);
+  EXPECT_TRUE(pyramid_map.LoadMapArea(ahead, 0, 50, 0, 0));
+  stats = pyramid_map.GetLoadStats();
+  EXPECT_GT(stats.hit_count, 0);
+  EXPECT_EQ(stats.miss_count, 0);
+  pyramid_map.StopPrefetcher();
+}
+
 }  // namespace pyramid_map
 }  // namespace msf
 }  // namespace localization
@@ -72,6 +72,10 @@ void MSFLocalization::InitParams() {
   localization_param_.map_coverage_theshold = FLAGS_lidar_map_coverage_theshold;
   localization_param_.imu_lidar_max_delay_time = FLAGS_lidar_imu_max_delay_time;
   localization_param_.if_use_avx = FLAGS_if_use_avx;
+  localization_param_.enable_map_prefetch = FLAGS_lidar_map_prefetch;
+  localization_param_.map_prefetch_threads = FLAGS_lidar_map_prefetch_threads;
+  localization_param_.map_prefetch_nodes = FLAGS_lidar_map_prefetch_nodes;
+  localization_param_.map_prefetch_horizon = FLAGS_lidar_map_prefetch_horizon;
 
   AINFO << "map: " << localization_param_.map_path;
   AINFO << "lidar_extrin: " << localization_param_.lidar_extrinsic_file;
@@ -85,6 +85,14 @@ void LidarLocatorNdt::Init(const Eigen::Affine3d& init_location,
   reg_.SetResolution(static_cast<float>(ndt_target_resolution_));
   reg_.SetStepSize(ndt_line_search_step_size_);
   reg_.SetTransformationEpsilon(ndt_transformation_epsilon_);
+  reg_.SetNumThreads(FLAGS_ndt_num_threads);
+  NeighborSearchMethod search_method = NeighborSearchMethod::KDTREE;
+  if (!ParseNeighborSearchMethod(FLAGS_ndt_neighbor_search_method,
+                                 &search_method)) {
+    AWARN << "Unknown NDT neighbor search method: "
+          << FLAGS_ndt_neighbor_search_method << ", use kdtree instead.";
+  }
+  reg_.SetNeighborSearchMethod(search_method);
 
   is_initialized_ = true;
 }
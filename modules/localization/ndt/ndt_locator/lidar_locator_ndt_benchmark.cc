@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Times LidarLocatorNdt::Update on the NDT test map and pcds for every
+ *        neighbor search method and thread count.
+ *
+ * bazel run //modules/localization/ndt/ndt_locator:lidar_locator_ndt_benchmark
+ *     -- --benchmark_max_threads=8
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/log.h"
+#include "modules/localization/common/localization_gflags.h"
+#include "modules/localization/msf/common/io/velodyne_utility.h"
+#include "modules/localization/ndt/ndt_locator/lidar_locator_ndt.h"
+
+DEFINE_string(benchmark_data_dir, "/apollo/modules/localization/ndt/test_data",
+              "directory containing ndt_map and pcds");
+DEFINE_int32(benchmark_repeats, 20, "number of updates timed per frame");
+DEFINE_int32(benchmark_max_threads, 4,
+             "thread counts 1, 2, 4, ... up to this value are timed");
+
+namespace apollo {
+namespace localization {
+namespace ndt {
+namespace {
+
+typedef std::vector<Eigen::Affine3d, Eigen::aligned_allocator<Eigen::Affine3d>>
+    PoseVector;
+
+void LoadFrames(const std::string& pcd_folder, const PoseVector& poses,
+                const std::vector<double>& timestamps,
+                std::vector<LidarFrame>* frames) {
+  for (unsigned int frame_idx = 0; frame_idx < poses.size(); ++frame_idx) {
+    ::apollo::common::EigenVector3dVec pt3ds;
+    std::vector<unsigned char> intensities;
+    const std::string pcd_file =
+        absl::StrCat(pcd_folder, "/", frame_idx + 1, ".pcd");
+    msf::velodyne::LoadPcds(pcd_file, frame_idx, poses[frame_idx], &pt3ds,
+                            &intensities);
+    LidarFrame lidar_frame;
+    lidar_frame.measurement_time = timestamps[frame_idx];
+    lidar_frame.pt_xs.reserve(pt3ds.size());
+    lidar_frame.pt_ys.reserve(pt3ds.size());
+    lidar_frame.pt_zs.reserve(pt3ds.size());
+    lidar_frame.intensities.reserve(pt3ds.size());
+    for (unsigned int i = 0; i < pt3ds.size(); ++i) {
+      lidar_frame.pt_xs.push_back(static_cast<float>(pt3ds[i][0]));
+      lidar_frame.pt_ys.push_back(static_cast<float>(pt3ds[i][1]));
+      lidar_frame.pt_zs.push_back(static_cast<float>(pt3ds[i][2]));
+      lidar_frame.intensities.push_back(intensities[i]);
+    }
+    frames->push_back(std::move(lidar_frame));
+  }
+}
+
+void RunBenchmark(const std::string& method, int num_threads,
+                  const PoseVector& poses,
+                  const std::vector<LidarFrame>& frames) {
+  FLAGS_ndt_neighbor_search_method = method;
+  FLAGS_ndt_num_threads = num_threads;
+
+  LidarLocatorNdt locator;
+  locator.SetMapFolderPath(absl::StrCat(FLAGS_benchmark_data_dir, "/ndt_map"));
+  locator.SetVelodyneExtrinsic(Eigen::Affine3d::Identity());
+  locator.SetOnlineCloudResolution(1.0);
+  locator.SetLidarHeight(1.7);
+  locator.Init(poses[0], 0, 10);
+
+  double total_ms = 0.0;
+  double max_ms = 0.0;
+  double max_error = 0.0;
+  int num_updates = 0;
+  for (unsigned int frame_idx = 1; frame_idx < frames.size(); ++frame_idx) {
+    for (int i = 0; i < FLAGS_benchmark_repeats; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      locator.Update(frame_idx, poses[frame_idx], frames[frame_idx]);
+      const double ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+      total_ms += ms;
+      max_ms = std::max(max_ms, ms);
+      ++num_updates;
+      max_error = std::max(max_error, (locator.GetPose().translation() -
+                                       poses[frame_idx].translation())
+                                          .head<2>()
+                                          .norm());
+    }
+  }
+  std::printf("%-9s threads %2d: mean %8.3f ms, max %8.3f ms, "
+              "max xy error %.3f m, fitness %.3f\n",
+              method.c_str(), num_threads, total_ms / num_updates, max_ms,
+              max_error, locator.GetFitnessScore());
+}
+
+}  // namespace
+}  // namespace ndt
+}  // namespace localization
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  using apollo::localization::ndt::PoseVector;
+
+  PoseVector poses;
+  std::vector<double> timestamps;
+  const std::string pcd_folder =
+      absl::StrCat(FLAGS_benchmark_data_dir, "/pcds");
+  apollo::localization::msf::velodyne::LoadPcdPoses(
+      absl::StrCat(pcd_folder, "/poses.txt"), &poses, &timestamps);
+  if (poses.size() < 2) {
+    AERROR << "At least two pcds are needed in " << pcd_folder;
+    return -1;
+  }
+  std::vector<apollo::localization::ndt::LidarFrame> frames;
+  apollo::localization::ndt::LoadFrames(pcd_folder, poses, timestamps,
+                                        &frames);
+
+  for (const std::string method : {"kdtree", "direct1", "direct7",
+                                   "direct27"}) {
+    for (int num_threads = 1; num_threads <= FLAGS_benchmark_max_threads;
+         num_threads *= 2) {
+      apollo::localization::ndt::RunBenchmark(method, num_threads, poses,
+                                              frames);
+    }
+  }
+  return 0;
+}
@@ -55,13 +55,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
+#include "Eigen/StdVector"
+
 #include "pcl/registration/registration.h"
 #include "unsupported/Eigen/NonLinearOptimization"
 
 #include "cyber/common/log.h"
+#include "cyber/task/task.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/localization/ndt/ndt_locator/ndt_voxel_grid_covariance.h"
 
@@ -124,7 +128,8 @@ class NormalDistributionsTransform {
     target_ = cloud;
     target_cells_.SetVoxelGridResolution(resolution_, resolution_, resolution_);
     target_cells_.SetInputCloud(cloud);
-    target_cells_.filter(cell_leaf, true);
+    target_cells_.filter(cell_leaf,
+                         search_method_ == NeighborSearchMethod::KDTREE);
   }
 
   /**@brief Provide a pointer to the input target. */
@@ -148,6 +153,25 @@ class NormalDistributionsTransform {
   /**@brief Get voxel grid resolution. */
   inline float GetResolution() const { return resolution_; }
 
+  /**@brief Set the number of threads accumulating the derivatives. */
+  inline void SetNumThreads(int num_threads) {
+    num_threads_ = std::max(num_threads, 1);
+  }
+
+  /**@brief Get the number of threads accumulating the derivatives. */
+  inline int GetNumThreads() const { return num_threads_; }
+
+  /**@brief Set the method to find the voxels around a transformed point. Takes
+   * effect from the next SetInputTarget. */
+  inline void SetNeighborSearchMethod(NeighborSearchMethod method) {
+    search_method_ = method;
+  }
+
+  /**@brief Get the method to find the voxels around a transformed point. */
+  inline NeighborSearchMethod GetNeighborSearchMethod() const {
+    return search_method_;
+  }
+
   /**@brief Get the newton line search maximum step length.
    * \return maximum step length
    */
@@ -235,6 +259,32 @@ class NormalDistributionsTransform {
   void Align(PointCloudSourcePtr output, const Eigen::Matrix4f &guess);
 
  protected:
+  /**@brief Partial sums of the score, gradient and hessian over a range of
+   * points, together with the scratch data of the thread computing them. */
+  struct DerivativeAccumulator {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    double score;
+    Eigen::Matrix<double, 6, 1> score_gradient;
+    Eigen::Matrix<double, 6, 6> hessian;
+    /**@brief The first order derivative of the transformation of a point
+     * w.r.t. the transform vector, Equation 6.18 [Magnusson 2009]. */
+    Eigen::Matrix<double, 3, 6> point_gradient;
+    /**@brief The second order derivative of the transformation of a point
+     * w.r.t. the transform vector, Equation 6.20 [Magnusson 2009]. */
+    Eigen::Matrix<double, 18, 6> point_hessian;
+    std::vector<TargetGridLeafConstPtr> neighborhood;
+    std::vector<float> distances;
+
+    void Reset() {
+      score = 0.0;
+      score_gradient.setZero();
+      hessian.setZero();
+      point_gradient.setZero();
+      point_gradient.block<3, 3>(0, 0).setIdentity();
+      point_hessian.setZero();
+    }
+  };
+
   /**@brief Estimate the transformation and returns the transformed source
    * (input) as output. */
   void ComputeTransformation(PointCloudSourcePtr output) {
@@ -254,21 +304,36 @@ class NormalDistributionsTransform {
                             Eigen::Matrix<double, 6, 1> *p,
                             bool ComputeHessian = true);
 
+  /**@brief Accumulate the score, gradient and hessian of all the points,
+   * split over num_threads_ threads. Returns the score. */
+  double ReduceDerivatives(const PointCloudSource &trans_cloud,
+                           Eigen::Matrix<double, 6, 1> *score_gradient,
+                           Eigen::Matrix<double, 6, 6> *hessian,
+                           bool compute_gradient, bool compute_hessian);
+
+  /**@brief Accumulate the contributions of the points in [begin, end). */
+  void AccumulateDerivatives(const PointCloudSource &trans_cloud, size_t begin,
+                             size_t end, bool compute_gradient,
+                             bool compute_hessian,
+                             DerivativeAccumulator *acc);
+
+  /**@brief Find the occupied voxels around a transformed point. */
+  void FindNeighbors(const PointSource &x_trans_pt,
+                     DerivativeAccumulator *acc);
+
   /**@brief Compute individual point contributions to derivatives of
    * probability function w.r.t. the transformation vector. */
-  double UpdateDerivatives(Eigen::Matrix<double, 6, 1> *score_gradient,
-                           Eigen::Matrix<double, 6, 6> *hessian,
-                           const Eigen::Vector3d &x_trans,
+  double UpdateDerivatives(const Eigen::Vector3d &x_trans,
                            const Eigen::Matrix3d &c_inv,
-                           bool ComputeHessian = true);
+                           bool ComputeHessian, DerivativeAccumulator *acc);
 
   /**@brief Precompute anglular components of derivatives. */
   void ComputeAngleDerivatives(const Eigen::Matrix<double, 6, 1> &p,
                                bool ComputeHessian = true);
 
   /**@brief Compute point derivatives. */
-  void ComputePointDerivatives(const Eigen::Vector3d &x,
-                               bool ComputeHessian = true);
+  void ComputePointDerivatives(const Eigen::Vector3d &x, bool ComputeHessian,
+                               DerivativeAccumulator *acc);
 
   /**@brief Compute hessian of probability function w.r.t. the transformation
    * vector. */
@@ -278,9 +343,8 @@ class NormalDistributionsTransform {
 
   /**@brief Compute individual point contributions to hessian of probability
    * function. */
-  void UpdateHessian(Eigen::Matrix<double, 6, 6> *hessian,
-                     const Eigen::Vector3d &x_trans,
-                     const Eigen::Matrix3d &c_inv);
+  void UpdateHessian(const Eigen::Vector3d &x_trans,
+                     const Eigen::Matrix3d &c_inv, DerivativeAccumulator *acc);
 
   /**@brief Compute line search step length and update transform and probability
    * derivatives. */
@@ -363,12 +427,16 @@ class NormalDistributionsTransform {
   Eigen::Vector3d h_ang_a2_, h_ang_a3_, h_ang_b2_, h_ang_b3_, h_ang_c2_,
       h_ang_c3_, h_ang_d1_, h_ang_d2_, h_ang_d3_, h_ang_e1_, h_ang_e2_,
       h_ang_e3_, h_ang_f1_, h_ang_f2_, h_ang_f3_;
-  /**@brief The first order derivative of the transformation of a point
-   * w.r.t. the transform vector, Equation 6.18 [Magnusson 2009]. */
-  Eigen::Matrix<double, 3, 6> point_gradient_;
-  /**@brief The second order derivative of the transformation of a point
-   * w.r.t. the transform vector, Equation 6.20 [Magnusson 2009]. */
-  Eigen::Matrix<double, 18, 6> point_hessian_;
+
+  /**@brief The number of threads accumulating the derivatives. */
+  int num_threads_;
+  /**@brief The method to find the voxels around a transformed point. */
+  NeighborSearchMethod search_method_;
+  /**@brief One accumulator per thread, merged in order so that the result
+   * does not depend on scheduling. */
+  std::vector<DerivativeAccumulator,
+              Eigen::aligned_allocator<DerivativeAccumulator>>
+      accumulators_;
 
  public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -55,6 +55,7 @@
  */
 
 #include <algorithm>
+#include <future>
 #include <limits>
 #include <vector>
 
@@ -192,8 +193,8 @@ NormalDistributionsTransform<PointSource,
       h_ang_f1_(),
       h_ang_f2_(),
       h_ang_f3_(),
-      point_gradient_(),
-      point_hessian_() {
+      num_threads_(1),
+      search_method_(NeighborSearchMethod::KDTREE) {
   double gauss_c1, gauss_c2, gauss_d3;
 
   // Initializes the guassian fitting parameters (eq. 6.8) [Magnusson 2009]
@@ -234,11 +235,6 @@ void NormalDistributionsTransform<PointSource, PointTarget>::
     transformPointCloud(*output, *output, guess);
   }
 
-  // Initialize Point Gradient and Hessian
-  point_gradient_.setZero();
-  point_gradient_.block<3, 3>(0, 0).setIdentity();
-  point_hessian_.setZero();
-
   Eigen::Transform<float, 3, Eigen::Affine, Eigen::ColMajor> eig_transformation;
   eig_transformation.matrix() = final_transformation_;
 
@@ -324,59 +320,117 @@ NormalDistributionsTransform<PointSource, PointTarget>::ComputeDerivatives(
     Eigen::Matrix<double, 6, 1> *score_gradient,
     Eigen::Matrix<double, 6, 6> *hessian, PointCloudSourcePtr trans_cloud,
     Eigen::Matrix<double, 6, 1> *p, bool compute_hessian) {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  score_gradient->setZero();
-  hessian->setZero();
-  double score = 0;
-
   // Precompute Angular Derivatives (eq. 6.19 and 6.21)[Magnusson 2009]
   ComputeAngleDerivatives(*p);
 
   // Update gradient and hessian for each point, line 17 in Algorithm 2
   // [Magnusson 2009]
-  for (size_t idx = 0; idx < input_->points.size(); idx++) {
-    x_trans_pt = trans_cloud->points[idx];
+  return ReduceDerivatives(*trans_cloud, score_gradient, hessian, true,
+                           compute_hessian);
+}
 
-    // Find neighbors (Radius search has been experimentally faster than
-    // direct neighbor checking.
-    std::vector<TargetGridLeafConstPtr> neighborhood;
-    std::vector<float> distances;
-    target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
-                               &distances);
+template <typename PointSource, typename PointTarget>
+double
+NormalDistributionsTransform<PointSource, PointTarget>::ReduceDerivatives(
+    const PointCloudSource &trans_cloud,
+    Eigen::Matrix<double, 6, 1> *score_gradient,
+    Eigen::Matrix<double, 6, 6> *hessian, bool compute_gradient,
+    bool compute_hessian) {
+  // Below this many points per thread the task overhead outweighs the gain.
+  static constexpr size_t kMinPointsPerThread = 256;
+  const size_t num_points = input_->points.size();
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(static_cast<size_t>(num_threads_),
+                          num_points / kMinPointsPerThread));
+  const size_t chunk_size = (num_points + num_chunks - 1) / num_chunks;
+  if (accumulators_.size() < num_chunks) {
+    accumulators_.resize(num_chunks);
+  }
 
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator
-             neighborhood_it = neighborhood.begin();
-         neighborhood_it != neighborhood.end(); neighborhood_it++) {
-      cell = *neighborhood_it;
-      x_pt = input_->points[idx];
-      x = Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z);
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_chunks - 1);
+  for (size_t i = 1; i < num_chunks; ++i) {
+    const size_t begin = i * chunk_size;
+    const size_t end = std::min(num_points, begin + chunk_size);
+    DerivativeAccumulator *acc = &accumulators_[i];
+    futures.emplace_back(cyber::Async([&trans_cloud, begin, end,
+                                       compute_gradient, compute_hessian, acc,
+                                       this]() {
+      AccumulateDerivatives(trans_cloud, begin, end, compute_gradient,
+                            compute_hessian, acc);
+    }));
+  }
+  AccumulateDerivatives(trans_cloud, 0, std::min(num_points, chunk_size),
+                        compute_gradient, compute_hessian, &accumulators_[0]);
+  for (auto &future : futures) {
+    future.wait();
+  }
 
-      x_trans = Eigen::Vector3d(x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
+  double score = 0;
+  if (compute_gradient) {
+    score_gradient->setZero();
+  }
+  hessian->setZero();
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const DerivativeAccumulator &acc = accumulators_[i];
+    score += acc.score;
+    if (compute_gradient) {
+      *score_gradient += acc.score_gradient;
+    }
+    *hessian += acc.hessian;
+  }
+  return score;
+}
 
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform<PointSource, PointTarget>::
+    AccumulateDerivatives(const PointCloudSource &trans_cloud, size_t begin,
+                          size_t end, bool compute_gradient,
+                          bool compute_hessian, DerivativeAccumulator *acc) {
+  // Original Point and Transformed Point (for math)
+  Eigen::Vector3d x, x_trans;
+  acc->Reset();
+
+  for (size_t idx = begin; idx < end; idx++) {
+    const PointSource &x_trans_pt = trans_cloud.points[idx];
+    FindNeighbors(x_trans_pt, acc);
+
+    const PointSource &x_pt = input_->points[idx];
+    x = Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z);
+    for (TargetGridLeafConstPtr cell : acc->neighborhood) {
       // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
-      x_trans -= cell->GetMean();
-      // Uses precomputed covariance for speed.
-      c_inv = cell->GetInverseCov();
+      x_trans = Eigen::Vector3d(x_trans_pt.x, x_trans_pt.y, x_trans_pt.z) -
+                cell->mean_;
 
       // Compute derivative of transform function w.r.t. transform vector,
       // J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
-      ComputePointDerivatives(x);
-      // Update score, gradient and hessian, lines 19-21 in Algorithm 2,
-      // according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson
-      // 2009]
-      score += UpdateDerivatives(score_gradient, hessian, x_trans, c_inv,
-                                 compute_hessian);
+      ComputePointDerivatives(x, compute_hessian || !compute_gradient, acc);
+      if (compute_gradient) {
+        // Update score, gradient and hessian, lines 19-21 in Algorithm 2,
+        // according to Equations 6.10, 6.12 and 6.13, respectively
+        // [Magnusson 2009]. Uses precomputed covariance for speed.
+        acc->score +=
+            UpdateDerivatives(x_trans, cell->icov_, compute_hessian, acc);
+      } else {
+        // Update hessian, lines 21 in Algorithm 2, according to Equations
+        // 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
+        UpdateHessian(x_trans, cell->icov_, acc);
+      }
     }
   }
-  return (score);
+}
+
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform<PointSource, PointTarget>::FindNeighbors(
+    const PointSource &x_trans_pt, DerivativeAccumulator *acc) {
+  if (search_method_ == NeighborSearchMethod::KDTREE) {
+    // Find neighbors (Radius search has been experimentally faster than
+    // direct neighbor checking.
+    target_cells_.RadiusSearch(x_trans_pt, resolution_, &acc->neighborhood,
+                               &acc->distances);
+  } else {
+    target_cells_.DirectSearch(x_trans_pt, search_method_, &acc->neighborhood);
+  }
 }
 
 template <typename PointSource, typename PointTarget>
@@ -450,20 +504,21 @@ void NormalDistributionsTransform<PointSource, PointTarget>::
 }
 
 template <typename PointSource, typename PointTarget>
-void NormalDistributionsTransform<
-    PointSource, PointTarget>::ComputePointDerivatives(const Eigen::Vector3d &x,
-                                                       bool compute_hessian) {
+void NormalDistributionsTransform<PointSource, PointTarget>::
+    ComputePointDerivatives(const Eigen::Vector3d &x, bool compute_hessian,
+                            DerivativeAccumulator *acc) {
+  Eigen::Matrix<double, 3, 6> &point_gradient = acc->point_gradient;
   // Calculate first derivative of Transformation Equation 6.17 w.r.t. transform
   // vector p. Derivative w.r.t. ith element of transform vector corresponds to
   // column i, Equation 6.18 and 6.19 [Magnusson 2009]
-  point_gradient_(1, 3) = x.dot(j_ang_a_);
-  point_gradient_(2, 3) = x.dot(j_ang_b_);
-  point_gradient_(0, 4) = x.dot(j_ang_c_);
-  point_gradient_(1, 4) = x.dot(j_ang_d_);
-  point_gradient_(2, 4) = x.dot(j_ang_e_);
-  point_gradient_(0, 5) = x.dot(j_ang_f_);
-  point_gradient_(1, 5) = x.dot(j_ang_g_);
-  point_gradient_(2, 5) = x.dot(j_ang_h_);
+  point_gradient(1, 3) = x.dot(j_ang_a_);
+  point_gradient(2, 3) = x.dot(j_ang_b_);
+  point_gradient(0, 4) = x.dot(j_ang_c_);
+  point_gradient(1, 4) = x.dot(j_ang_d_);
+  point_gradient(2, 4) = x.dot(j_ang_e_);
+  point_gradient(0, 5) = x.dot(j_ang_f_);
+  point_gradient(1, 5) = x.dot(j_ang_g_);
+  point_gradient(2, 5) = x.dot(j_ang_h_);
 
   if (compute_hessian) {
     // Vectors from Equation 6.21 [Magnusson 2009]
@@ -476,28 +531,32 @@ void NormalDistributionsTransform<
     e << x.dot(h_ang_e1_), x.dot(h_ang_e2_), x.dot(h_ang_e3_);
     f << x.dot(h_ang_f1_), x.dot(h_ang_f2_), x.dot(h_ang_f3_);
 
+    Eigen::Matrix<double, 18, 6> &point_hessian = acc->point_hessian;
     // Calculate second derivative of Transformation Equation 6.17 w.r.t.
     // transform vector p. Derivative w.r.t. ith and jth elements of transform
     // vector corresponds to the 3x1 block matrix starting at (3i,j),
     // Equation 6.20 and 6.21 [Magnusson 2009]
-    point_hessian_.block<3, 1>(9, 3) = a;
-    point_hessian_.block<3, 1>(12, 3) = b;
-    point_hessian_.block<3, 1>(15, 3) = c;
-    point_hessian_.block<3, 1>(9, 4) = b;
-    point_hessian_.block<3, 1>(12, 4) = d;
-    point_hessian_.block<3, 1>(15, 4) = e;
-    point_hessian_.block<3, 1>(9, 5) = c;
-    point_hessian_.block<3, 1>(12, 5) = e;
-    point_hessian_.block<3, 1>(15, 5) = f;
+    point_hessian.block<3, 1>(9, 3) = a;
+    point_hessian.block<3, 1>(12, 3) = b;
+    point_hessian.block<3, 1>(15, 3) = c;
+    point_hessian.block<3, 1>(9, 4) = b;
+    point_hessian.block<3, 1>(12, 4) = d;
+    point_hessian.block<3, 1>(15, 4) = e;
+    point_hessian.block<3, 1>(9, 5) = c;
+    point_hessian.block<3, 1>(12, 5) = e;
+    point_hessian.block<3, 1>(15, 5) = f;
   }
 }
 
 template <typename PointSource, typename PointTarget>
 double
 NormalDistributionsTransform<PointSource, PointTarget>::UpdateDerivatives(
-    Eigen::Matrix<double, 6, 1> *score_gradient,
-    Eigen::Matrix<double, 6, 6> *hessian, const Eigen::Vector3d &x_trans,
-    const Eigen::Matrix3d &c_inv, bool compute_hessian) {
+    const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv,
+    bool compute_hessian, DerivativeAccumulator *acc) {
+  const Eigen::Matrix<double, 3, 6> &point_gradient = acc->point_gradient;
+  const Eigen::Matrix<double, 18, 6> &point_hessian = acc->point_hessian;
+  Eigen::Matrix<double, 6, 1> *score_gradient = &acc->score_gradient;
+  Eigen::Matrix<double, 6, 6> *hessian = &acc->hessian;
   Eigen::Vector3d cov_dxd_pi;
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson
   // 2009]
@@ -519,7 +578,7 @@ NormalDistributionsTransform<PointSource, PointTarget>::UpdateDerivatives(
   for (int i = 0; i < 6; i++) {
     // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13
     // [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col(i);
+    cov_dxd_pi = c_inv * point_gradient.col(i);
 
     // Update gradient, Equation 6.12 [Magnusson 2009]
     (*score_gradient)(i) += x_trans.dot(cov_dxd_pi) * e_x_cov_x;
@@ -530,9 +589,9 @@ NormalDistributionsTransform<PointSource, PointTarget>::UpdateDerivatives(
         (*hessian)(i, j) +=
             e_x_cov_x *
             (-gauss_d2_ * x_trans.dot(cov_dxd_pi) *
-                 x_trans.dot(c_inv * point_gradient_.col(j)) +
-             x_trans.dot(c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-             point_gradient_.col(j).dot(cov_dxd_pi));
+                 x_trans.dot(c_inv * point_gradient.col(j)) +
+             x_trans.dot(c_inv * point_hessian.block<3, 1>(3 * i, j)) +
+             point_gradient.col(j).dot(cov_dxd_pi));
       }
     }
   }
@@ -544,63 +603,20 @@ template <typename PointSource, typename PointTarget>
 void NormalDistributionsTransform<PointSource, PointTarget>::ComputeHessian(
     Eigen::Matrix<double, 6, 6> *hessian, const PointCloudSource &trans_cloud,
     Eigen::Matrix<double, 6, 1> *p) {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  hessian->setZero();
-
   // Precompute Angular Derivatives unnecessary because only used after regular
   // derivative calculation
 
   // Update hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
-  for (size_t idx = 0; idx < input_->points.size(); idx++) {
-    x_trans_pt = trans_cloud.points[idx];
-
-    // Find neighbors (Radius search has been experimentally faster than
-    // direct neighbor checking.
-    std::vector<TargetGridLeafConstPtr> neighborhood;
-    std::vector<float> distances;
-    target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
-                               &distances);
-
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator
-             neighborhood_it = neighborhood.begin();
-         neighborhood_it != neighborhood.end(); neighborhood_it++) {
-      cell = *neighborhood_it;
-      {
-        x_pt = input_->points[idx];
-        x = Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z);
-
-        x_trans = Eigen::Vector3d(x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
-
-        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson
-        // 2009]
-        x_trans -= cell->GetMean();
-        // Uses precomputed covariance for speed.
-        c_inv = cell->GetInverseCov();
-
-        // Compute derivative of transform function w.r.t. transform
-        // vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson
-        // 2009]
-        ComputePointDerivatives(x);
-        // Update hessian, lines 21 in Algorithm 2, according to
-        // Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
-        UpdateHessian(hessian, x_trans, c_inv);
-      }
-    }
-  }
+  ReduceDerivatives(trans_cloud, nullptr, hessian, false, true);
 }
 
 template <typename PointSource, typename PointTarget>
 void NormalDistributionsTransform<PointSource, PointTarget>::UpdateHessian(
-    Eigen::Matrix<double, 6, 6> *hessian, const Eigen::Vector3d &x_trans,
-    const Eigen::Matrix3d &c_inv) {
+    const Eigen::Vector3d &x_trans, const Eigen::Matrix3d &c_inv,
+    DerivativeAccumulator *acc) {
+  const Eigen::Matrix<double, 3, 6> &point_gradient = acc->point_gradient;
+  const Eigen::Matrix<double, 18, 6> &point_hessian = acc->point_hessian;
+  Eigen::Matrix<double, 6, 6> *hessian = &acc->hessian;
   Eigen::Vector3d cov_dxd_pi;
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9
   // [Magnusson 2009]
@@ -618,16 +634,16 @@ void NormalDistributionsTransform<PointSource, PointTarget>::UpdateHessian(
   for (int i = 0; i < 6; i++) {
     // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13
     // [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col(i);
+    cov_dxd_pi = c_inv * point_gradient.col(i);
 
     for (int j = 0; j < hessian->cols(); j++) {
       // Update hessian, Equation 6.13 [Magnusson 2009]
       (*hessian)(i, j) +=
           e_x_cov_x *
           (-gauss_d2_ * x_trans.dot(cov_dxd_pi) *
-               x_trans.dot(c_inv * point_gradient_.col(j)) +
-           x_trans.dot(c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-           point_gradient_.col(j).dot(cov_dxd_pi));
+               x_trans.dot(c_inv * point_gradient.col(j)) +
+           x_trans.dot(c_inv * point_hessian.block<3, 1>(3 * i, j)) +
+           point_gradient.col(j).dot(cov_dxd_pi));
     }
   }
 }
@@ -78,12 +78,14 @@ class NdtSolverTestSuite : public ::testing::Test {
   virtual void TearDown() {}
 };
 
-TEST_F(NdtSolverTestSuite, NdtSolver) {
+void AlignTestData(NeighborSearchMethod search_method, int num_threads) {
   // Set NDT
   NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> reg;
   reg.SetMaximumIterations(5);
   reg.SetStepSize(0.1);
   reg.SetTransformationEpsilon(0.01);
+  reg.SetNeighborSearchMethod(search_method);
+  reg.SetNumThreads(num_threads);
 
   // Load input source.
   pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_source(
@@ -217,6 +219,20 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
   ASSERT_LE(iteration, 7);
 }
 
+TEST_F(NdtSolverTestSuite, NdtSolver) {
+  AlignTestData(NeighborSearchMethod::KDTREE, 1);
+}
+
+TEST_F(NdtSolverTestSuite, NdtSolverDirectSearch) {
+  AlignTestData(NeighborSearchMethod::DIRECT7, 1);
+  AlignTestData(NeighborSearchMethod::DIRECT27, 1);
+}
+
+TEST_F(NdtSolverTestSuite, NdtSolverMultiThread) {
+  AlignTestData(NeighborSearchMethod::KDTREE, 4);
+  AlignTestData(NeighborSearchMethod::DIRECT7, 4);
+}
+
 }  // namespace ndt
 }  // namespace localization
 }  // namespace apollo
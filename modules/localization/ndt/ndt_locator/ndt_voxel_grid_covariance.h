@@ -52,7 +52,11 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "pcl/filters/boost.h"
@@ -92,6 +96,29 @@ struct Leaf {
   /**@brief Inverse of voxel covariance matrix. */
   Eigen::Matrix3d icov_;
 };
+/**@brief Methods to find the occupied voxels around a query point. KDTREE
+ * searches the voxel centroids within the resolution radius, the DIRECT
+ * methods look up the voxel containing the point and its face (7) or all
+ * adjacent (27) voxels in a hash table. */
+enum class NeighborSearchMethod { KDTREE, DIRECT1, DIRECT7, DIRECT27 };
+
+/**@brief Parse a neighbor search method name, e.g. "direct7". */
+inline bool ParseNeighborSearchMethod(const std::string &name,
+                                      NeighborSearchMethod *method) {
+  if (name == "kdtree") {
+    *method = NeighborSearchMethod::KDTREE;
+  } else if (name == "direct1") {
+    *method = NeighborSearchMethod::DIRECT1;
+  } else if (name == "direct7") {
+    *method = NeighborSearchMethod::DIRECT7;
+  } else if (name == "direct27") {
+    *method = NeighborSearchMethod::DIRECT27;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 /**@brief Pointer to VoxelGridCovariance leaf structure */
 typedef Leaf *LeafPtr;
 /**@brief Const pointer to VoxelGridCovariance leaf structure */
@@ -126,7 +153,8 @@ class VoxelGridCovariance {
         leaves_(),
         voxel_centroids_(),
         voxel_centroids_leaf_indices_(),
-        kdtree_() {
+        kdtree_(),
+        direct_leaves_() {
     leaf_size_.setZero();
     min_b_.setZero();
     max_b_.setZero();
@@ -155,7 +183,7 @@ class VoxelGridCovariance {
                      bool searchable = true) {
     voxel_centroids_ = PointCloudPtr(new PointCloud);
     SetMap(cell_leaf, voxel_centroids_);
-    if (voxel_centroids_->size() > 0) {
+    if (searchable && voxel_centroids_->size() > 0) {
       kdtree_.setInputCloud(voxel_centroids_);
     }
   }
@@ -241,6 +269,11 @@ class VoxelGridCovariance {
                    std::vector<float> *k_sqr_distances,
                    unsigned int max_nn = 0);
 
+  /**@brief Look up the occupied voxels at and around the voxel containing
+   * the query point. Safe to call concurrently once the map is set. */
+  int DirectSearch(const PointT &point, NeighborSearchMethod method,
+                   std::vector<LeafConstPtr> *k_leaves) const;
+
   void GetDisplayCloud(pcl::PointCloud<pcl::PointXYZ> *cell_cloud);
 
   inline void SetMapLeftTopCorner(const Eigen::Vector3d &left_top_corner) {
@@ -277,6 +310,18 @@ class VoxelGridCovariance {
   /**@brief KdTree generated using voxel_centroids_ (used for searching). */
   pcl::KdTreeFLANN<PointT> kdtree_;
 
+  /**@brief Hash key of the voxel (i, j, k) relative to the left top corner,
+   * 21 bits per axis. */
+  static int64_t VoxelKey(int i, int j, int k) {
+    constexpr int64_t kMask = (1 << 21) - 1;
+    return ((static_cast<int64_t>(i) & kMask) << 42) |
+           ((static_cast<int64_t>(j) & kMask) << 21) |
+           (static_cast<int64_t>(k) & kMask);
+  }
+
+  /**@brief Hash table of the searchable leaves used by DirectSearch. */
+  std::unordered_map<int64_t, LeafConstPtr> direct_leaves_;
+
   /**@brief Left top corner. */
   Eigen::Vector3d map_left_top_corner_;
 };
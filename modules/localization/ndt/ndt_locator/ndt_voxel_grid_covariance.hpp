@@ -108,6 +108,8 @@ void VoxelGridCovariance<PointT>::SetMap(const std::vector<Leaf>& map_leaves,
 
   // Clear the leaves
   leaves_.clear();
+  direct_leaves_.clear();
+  direct_leaves_.reserve(map_leaves.size());
 
   output->points.reserve(map_leaves.size());
   voxel_centroids_leaf_indices_.reserve(leaves_.size());
@@ -134,6 +136,11 @@ void VoxelGridCovariance<PointT>::SetMap(const std::vector<Leaf>& map_leaves,
       output->points.back().y = static_cast<float>(leaf.mean_[1]);
       output->points.back().z = static_cast<float>(leaf.mean_[2]);
       voxel_centroids_leaf_indices_.push_back(idx);
+      const int64_t key = VoxelKey(
+          static_cast<int>(std::floor(local_mean(0) * inverse_leaf_size_[0])),
+          static_cast<int>(std::floor(local_mean(1) * inverse_leaf_size_[1])),
+          static_cast<int>(std::floor(local_mean(2) * inverse_leaf_size_[2])));
+      direct_leaves_[key] = &leaf;
     }
   }
   output->width = static_cast<uint32_t>(output->points.size());
@@ -154,11 +161,49 @@ int VoxelGridCovariance<PointT>::RadiusSearch(
   k_leaves->reserve(k);
   for (std::vector<int>::iterator iter = k_indices.begin();
        iter != k_indices.end(); iter++) {
-    k_leaves->push_back(&leaves_[voxel_centroids_leaf_indices_[*iter]]);
+    k_leaves->push_back(&leaves_.at(voxel_centroids_leaf_indices_[*iter]));
   }
   return k;
 }
 
+template <typename PointT>
+int VoxelGridCovariance<PointT>::DirectSearch(
+    const PointT& point, NeighborSearchMethod method,
+    std::vector<LeafConstPtr>* k_leaves) const {
+  // The containing voxel first, then its 6 face neighbors, then the 20 edge
+  // and corner neighbors.
+  static const int kOffsets[27][3] = {
+      {0, 0, 0},    {-1, 0, 0},  {1, 0, 0},   {0, -1, 0},  {0, 1, 0},
+      {0, 0, -1},   {0, 0, 1},   {-1, -1, 0}, {-1, 1, 0},  {1, -1, 0},
+      {1, 1, 0},    {-1, 0, -1}, {-1, 0, 1},  {1, 0, -1},  {1, 0, 1},
+      {0, -1, -1},  {0, -1, 1},  {0, 1, -1},  {0, 1, 1},   {-1, -1, -1},
+      {-1, -1, 1},  {-1, 1, -1}, {-1, 1, 1},  {1, -1, -1}, {1, -1, 1},
+      {1, 1, -1},   {1, 1, 1}};
+  k_leaves->clear();
+
+  int num_offsets = 1;
+  if (method == NeighborSearchMethod::DIRECT7) {
+    num_offsets = 7;
+  } else if (method == NeighborSearchMethod::DIRECT27) {
+    num_offsets = 27;
+  }
+
+  const int i = static_cast<int>(std::floor(
+      (point.x - map_left_top_corner_(0)) * inverse_leaf_size_[0]));
+  const int j = static_cast<int>(std::floor(
+      (point.y - map_left_top_corner_(1)) * inverse_leaf_size_[1]));
+  const int k = static_cast<int>(std::floor(
+      (point.z - map_left_top_corner_(2)) * inverse_leaf_size_[2]));
+  for (int n = 0; n < num_offsets; ++n) {
+    auto iter = direct_leaves_.find(VoxelKey(
+        i + kOffsets[n][0], j + kOffsets[n][1], k + kOffsets[n][2]));
+    if (iter != direct_leaves_.end()) {
+      k_leaves->push_back(iter->second);
+    }
+  }
+  return static_cast<int>(k_leaves->size());
+}
+
 template <typename PointT>
 void VoxelGridCovariance<PointT>::GetDisplayCloud(
     pcl::PointCloud<pcl::PointXYZ>* cell_cloud) {
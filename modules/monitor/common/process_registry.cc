@@ -0,0 +1,401 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/common/process_registry.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "absl/strings/str_cat.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+
+DEFINE_bool(process_registry_use_proc_connector, true,
+            "Whether the process registry follows process events from the "
+            "netlink proc connector when it is available.");
+
+DEFINE_double(process_registry_reload_interval, 60.0,
+              "Interval in seconds to re-read all command lines in the "
+              "process registry.");
+
+DEFINE_double(process_registry_exec_window, 10.0,
+              "Processes started within this many seconds have their "
+              "command lines re-read, as they may still exec. Only used "
+              "without the proc connector.");
+
+namespace apollo {
+namespace monitor {
+
+namespace {
+
+// Inode of the initial pid namespace, the only one proc events describe.
+constexpr ino_t kInitPidNamespaceInode = 0xEFFFFFFCU;
+
+// Values of proc_event::what, whose enum moved out of proc_event in newer
+// kernel headers.
+constexpr uint32_t kProcEventFork = 0x00000001;
+constexpr uint32_t kProcEventExec = 0x00000002;
+constexpr uint32_t kProcEventExit = 0x80000000;
+
+double SteadyNow() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool ParsePid(const char* name, int* pid) {
+  if (*name == '\0') {
+    return false;
+  }
+  int value = 0;
+  for (const char* c = name; *c != '\0'; ++c) {
+    if (*c < '0' || *c > '9') {
+      return false;
+    }
+    value = value * 10 + (*c - '0');
+  }
+  *pid = value;
+  return true;
+}
+
+}  // namespace
+
+ProcFile::~ProcFile() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool ProcFile::Read(std::string* content) {
+  if (fd_ < 0) {
+    fd_ = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+      return false;
+    }
+  }
+  content->clear();
+  char buffer[4096];
+  off_t offset = 0;
+  while (true) {
+    const ssize_t size = pread(fd_, buffer, sizeof(buffer), offset);
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size < 0) {
+      // The process is gone, or the file has to be reopened.
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    if (size == 0) {
+      return true;
+    }
+    content->append(buffer, size);
+    offset += size;
+  }
+}
+
+ProcessRegistry::ProcessRegistry() {
+  if (FLAGS_process_registry_use_proc_connector && OpenProcConnector()) {
+    AINFO << "Process registry follows proc connector events.";
+  }
+}
+
+bool ProcessRegistry::OpenProcConnector() {
+  // Listening needs CAP_NET_ADMIN, and events carry pids of the initial pid
+  // namespace, which differ from ours in a container.
+  struct stat ns_stat;
+  if (geteuid() != 0 || stat("/proc/self/ns/pid", &ns_stat) != 0 ||
+      ns_stat.st_ino != kInitPidNamespaceInode) {
+    return false;
+  }
+  const int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        NETLINK_CONNECTOR);
+  if (fd < 0) {
+    return false;
+  }
+  struct sockaddr_nl address = {};
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = CN_IDX_PROC;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) != 0) {
+    close(fd);
+    return false;
+  }
+
+  alignas(struct nlmsghdr) char buffer[NLMSG_SPACE(
+      sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] = {};
+  auto* header = reinterpret_cast<struct nlmsghdr*>(buffer);
+  header->nlmsg_len =
+      NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+  header->nlmsg_type = NLMSG_DONE;
+  header->nlmsg_pid = static_cast<__u32>(getpid());
+  auto* message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+  message->id.idx = CN_IDX_PROC;
+  message->id.val = CN_VAL_PROC;
+  message->len = sizeof(enum proc_cn_mcast_op);
+  const enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+  std::memcpy(message->data, &op, sizeof(op));
+  if (send(fd, buffer, header->nlmsg_len, 0) < 0) {
+    close(fd);
+    return false;
+  }
+  proc_connector_fd_ = fd;
+  return true;
+}
+
+bool ProcessRegistry::ReadProcEvents() {
+  alignas(struct nlmsghdr) char buffer[8192];
+  while (true) {
+    const ssize_t size = recv(proc_connector_fd_, buffer, sizeof(buffer), 0);
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;
+      }
+      // ENOBUFS if events were dropped.
+      return false;
+    }
+    int length = static_cast<int>(size);
+    for (auto* header = reinterpret_cast<struct nlmsghdr*>(buffer);
+         NLMSG_OK(header, length); header = NLMSG_NEXT(header, length)) {
+      if (header->nlmsg_type == NLMSG_ERROR ||
+          header->nlmsg_type == NLMSG_NOOP) {
+        continue;
+      }
+      const auto* message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+      if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+        continue;
+      }
+      const auto* event =
+          reinterpret_cast<const struct proc_event*>(message->data);
+      switch (static_cast<uint32_t>(event->what)) {
+        case kProcEventFork:
+          // Threads share the process of their creator.
+          if (event->event_data.fork.child_pid ==
+              event->event_data.fork.child_tgid) {
+            dirty_pids_.insert(event->event_data.fork.child_tgid);
+          }
+          break;
+        case kProcEventExec:
+          dirty_pids_.insert(event->event_data.exec.process_tgid);
+          break;
+        case kProcEventExit:
+          if (event->event_data.exit.process_pid ==
+              event->event_data.exit.process_tgid) {
+            dirty_pids_.insert(event->event_data.exit.process_tgid);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+void ProcessRegistry::Update() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double now = SteadyNow();
+  const bool reload_all =
+      !loaded_ ||
+      now - last_reload_time_ >= FLAGS_process_registry_reload_interval;
+  if (proc_connector_fd_ >= 0) {
+    const bool complete = ReadProcEvents();
+    if (complete && !reload_all) {
+      for (const int pid : dirty_pids_) {
+        UpdateProcess(pid, now);
+      }
+      dirty_pids_.clear();
+      return;
+    }
+    if (!complete) {
+      AWARN << "Lost proc connector events, listing all processes.";
+    }
+    dirty_pids_.clear();
+  }
+  if (ListProcesses(now, reload_all) && reload_all) {
+    loaded_ = true;
+    last_reload_time_ = now;
+  }
+}
+
+bool ProcessRegistry::ListProcesses(const double now, const bool reload_all) {
+  DIR* dir = opendir("/proc");
+  if (dir == nullptr) {
+    AERROR << "Failed to list /proc: " << std::strerror(errno);
+    return false;
+  }
+  ++list_round_;
+  int pid = 0;
+  for (struct dirent* dir_entry = readdir(dir); dir_entry != nullptr;
+       dir_entry = readdir(dir)) {
+    if (!ParsePid(dir_entry->d_name, &pid)) {
+      continue;
+    }
+    auto iter = processes_.find(pid);
+    Entry* entry = nullptr;
+    if (iter == processes_.end() || iter->second.inode != dir_entry->d_ino) {
+      entry = AddProcess(pid, dir_entry->d_ino, now);
+    } else {
+      entry = &iter->second;
+      if (reload_all ||
+          (proc_connector_fd_ < 0 &&
+           now - entry->first_seen_time < FLAGS_process_registry_exec_window)) {
+        ReadCommand(pid, entry);
+      }
+    }
+    entry->list_round = list_round_;
+  }
+  closedir(dir);
+
+  for (auto iter = processes_.begin(); iter != processes_.end();) {
+    if (iter->second.list_round != list_round_) {
+      iter = processes_.erase(iter);
+      ++generation_;
+    } else {
+      ++iter;
+    }
+  }
+  return true;
+}
+
+void ProcessRegistry::UpdateProcess(const int pid, const double now) {
+  struct stat proc_stat;
+  if (stat(absl::StrCat("/proc/", pid).c_str(), &proc_stat) != 0) {
+    if (processes_.erase(pid) > 0) {
+      ++generation_;
+    }
+    return;
+  }
+  auto iter = processes_.find(pid);
+  if (iter == processes_.end() || iter->second.inode != proc_stat.st_ino) {
+    AddProcess(pid, proc_stat.st_ino, now);
+  } else {
+    ReadCommand(pid, &iter->second);
+  }
+}
+
+ProcessRegistry::Entry* ProcessRegistry::AddProcess(const int pid,
+                                                    const ino_t inode,
+                                                    const double now) {
+  Entry& entry = processes_[pid];
+  entry = Entry();
+  entry.inode = inode;
+  entry.first_seen_time = now;
+  ++generation_;
+  ReadCommand(pid, &entry);
+  return &entry;
+}
+
+void ProcessRegistry::ReadCommand(const int pid, Entry* entry) {
+  std::string command;
+  if (!cyber::common::GetContent(absl::StrCat("/proc/", pid, "/cmdline"),
+                                 &command)) {
+    return;
+  }
+  // In /proc/<PID>/cmdline, the parts are separated with \0, which will be
+  // converted back to whitespaces here.
+  std::replace(command.begin(), command.end(), '\0', ' ');
+  if (command != entry->command) {
+    entry->command = std::move(command);
+    ++generation_;
+  }
+}
+
+bool ProcessRegistry::FindProcess(const std::vector<std::string>& keywords,
+                                  Process* process) {
+  const auto matches = [&keywords](const std::string& command) {
+    if (command.empty()) {
+      return false;
+    }
+    for (const std::string& keyword : keywords) {
+      if (command.find(keyword) == std::string::npos) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key;
+  for (const std::string& keyword : keywords) {
+    absl::StrAppend(&key, keyword, "\n");
+  }
+  Match& match = matches_[key];
+  if (match.pid != 0) {
+    auto iter = processes_.find(match.pid);
+    if (iter != processes_.end() && matches(iter->second.command)) {
+      process->pid = match.pid;
+      process->command = iter->second.command;
+      return true;
+    }
+  } else if (match.generation == generation_) {
+    return false;
+  }
+
+  match.pid = 0;
+  match.generation = generation_;
+  for (const auto& entry : processes_) {
+    if (matches(entry.second.command)) {
+      match.pid = entry.first;
+      process->pid = entry.first;
+      process->command = entry.second.command;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ProcessRegistry::ReadStat(const int pid, std::string* content) {
+  return ReadProcessFile(pid, false, content);
+}
+
+bool ProcessRegistry::ReadStatm(const int pid, std::string* content) {
+  return ReadProcessFile(pid, true, content);
+}
+
+bool ProcessRegistry::ReadProcessFile(const int pid, const bool statm,
+                                      std::string* content) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = processes_.find(pid);
+  if (iter == processes_.end()) {
+    return false;
+  }
+  auto& file = statm ? iter->second.statm : iter->second.stat;
+  if (file == nullptr) {
+    file.reset(new ProcFile(
+        absl::StrCat("/proc/", pid, statm ? "/statm" : "/stat")));
+  }
+  return file->Read(content);
+}
+
+}  // namespace monitor
+}  // namespace apollo
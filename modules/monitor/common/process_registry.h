@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace monitor {
+
+// A /proc file kept open and re-read from the start, which makes procfs
+// regenerate its content without another open.
+class ProcFile {
+ public:
+  explicit ProcFile(const std::string& path) : path_(path) {}
+  ~ProcFile();
+
+  bool Read(std::string* content);
+
+ private:
+  const std::string path_;
+  int fd_ = -1;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcFile);
+};
+
+// Running processes and their command lines, shared by the monitors.
+//
+// The registry is updated incrementally. With the netlink proc connector,
+// which needs CAP_NET_ADMIN and the initial pid namespace, only processes
+// that forked, exec'ed or exited since the last update are looked at.
+// Otherwise /proc is listed without reading any file: a process is
+// identified by its pid and the inode of its /proc directory, so only new
+// processes have their command line read, plus recently started ones which
+// may still exec. All command lines are re-read once in a while in either
+// case.
+class ProcessRegistry {
+ public:
+  struct Process {
+    int pid = 0;
+    // Command line with arguments separated by whitespaces.
+    std::string command;
+  };
+
+  // Brings the registry up to date.
+  void Update();
+
+  // Finds a process whose command contains all keywords, preferring the one
+  // found last time.
+  bool FindProcess(const std::vector<std::string>& keywords,
+                   Process* process);
+
+  // Reads /proc/<pid>/stat or /proc/<pid>/statm through a kept open file.
+  bool ReadStat(const int pid, std::string* content);
+  bool ReadStatm(const int pid, std::string* content);
+
+ private:
+  struct Entry {
+    ino_t inode = 0;
+    std::string command;
+    double first_seen_time = 0.0;
+    uint64_t list_round = 0;
+    std::unique_ptr<ProcFile> stat;
+    std::unique_ptr<ProcFile> statm;
+  };
+
+  struct Match {
+    // 0 if nothing matched.
+    int pid = 0;
+    // Generation the match was looked for at.
+    uint64_t generation = 0;
+  };
+
+  bool OpenProcConnector();
+  // Returns false if events were lost.
+  bool ReadProcEvents();
+  // Lists /proc, returns false on failure.
+  bool ListProcesses(const double now, const bool reload_all);
+  // Adds, updates or removes the process after a proc event.
+  void UpdateProcess(const int pid, const double now);
+  Entry* AddProcess(const int pid, const ino_t inode, const double now);
+  void ReadCommand(const int pid, Entry* entry);
+  bool ReadProcessFile(const int pid, const bool statm, std::string* content);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<int, Entry> processes_;
+  // Changes whenever a process is added, removed or changes its command.
+  uint64_t generation_ = 1;
+  uint64_t list_round_ = 0;
+  double last_reload_time_ = 0.0;
+  bool loaded_ = false;
+
+  int proc_connector_fd_ = -1;
+  // Processes to look at on the next update, from proc events.
+  std::unordered_set<int> dirty_pids_;
+
+  // Last match of each keyword set, keyed by the joined keywords.
+  std::unordered_map<std::string, Match> matches_;
+
+  DECLARE_SINGLETON(ProcessRegistry)
+};
+
+}  // namespace monitor
+}  // namespace apollo
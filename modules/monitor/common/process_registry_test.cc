@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/monitor/common/process_registry.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace monitor {
+
+namespace {
+
+// Starts "sleep <seconds>", after a delay so that its parent's command line
+// can be seen first.
+pid_t StartSleep(const char* seconds, const int exec_delay_ms) {
+  const pid_t pid = fork();
+  if (pid == 0) {
+    usleep(exec_delay_ms * 1000);
+    execlp("sleep", "sleep", seconds, nullptr);
+    _exit(1);
+  }
+  return pid;
+}
+
+void Stop(const pid_t pid) {
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+}
+
+}  // namespace
+
+TEST(ProcessRegistryTest, FindProcess) {
+  auto* registry = ProcessRegistry::Instance();
+  const pid_t pid = StartSleep("31.25", 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  registry->Update();
+
+  ProcessRegistry::Process process;
+  ASSERT_TRUE(registry->FindProcess({"sleep", "31.25"}, &process));
+  EXPECT_EQ(pid, process.pid);
+  EXPECT_EQ("sleep 31.25 ", process.command);
+  EXPECT_FALSE(registry->FindProcess({"sleep", "31.26"}, &process));
+
+  std::string stat;
+  ASSERT_TRUE(registry->ReadStat(pid, &stat));
+  EXPECT_EQ(0, stat.find(std::to_string(pid) + " (sleep)"));
+  std::string statm;
+  EXPECT_TRUE(registry->ReadStatm(pid, &statm));
+  EXPECT_FALSE(statm.empty());
+
+  Stop(pid);
+  registry->Update();
+  EXPECT_FALSE(registry->FindProcess({"sleep", "31.25"}, &process));
+  EXPECT_FALSE(registry->ReadStat(pid, &stat));
+}
+
+TEST(ProcessRegistryTest, Exec) {
+  auto* registry = ProcessRegistry::Instance();
+  const pid_t pid = StartSleep("32.5", 300);
+  registry->Update();
+  ProcessRegistry::Process process;
+  EXPECT_FALSE(registry->FindProcess({"sleep", "32.5"}, &process));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  registry->Update();
+  ASSERT_TRUE(registry->FindProcess({"sleep", "32.5"}, &process));
+  EXPECT_EQ(pid, process.pid);
+  Stop(pid);
+}
+
+TEST(ProcFileTest, Reread) {
+  ProcFile file("/proc/self/stat");
+  std::string first;
+  std::string second;
+  ASSERT_TRUE(file.Read(&first));
+  ASSERT_TRUE(file.Read(&second));
+  EXPECT_EQ(0, second.find(std::to_string(getpid()) + " ("));
+  EXPECT_FALSE(ProcFile("/proc/no_such_file").Read(&first));
+}
+
+}  // namespace monitor
+}  // namespace apollo
@@ -23,7 +23,6 @@
 
 #include <boost/filesystem.hpp>
 
-#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "cyber/common/file.h"
@@ -31,6 +30,7 @@
 #include "gflags/gflags.h"
 #include "modules/common/util/map_util.h"
 #include "modules/monitor/common/monitor_manager.h"
+#include "modules/monitor/common/process_registry.h"
 #include "modules/monitor/software/summary_monitor.h"
 
 DEFINE_string(resource_monitor_name, "ResourceMonitor",
@@ -45,49 +45,47 @@ namespace monitor {
 namespace {
 
 bool GetPIDByCmdLine(const std::string& process_dag_path, int* pid) {
-  const std::string system_proc_path = "/proc";
-  const std::string proc_cmdline_path = "/cmdline";
-  const auto dirs = cyber::common::ListSubPaths(system_proc_path);
-  std::string cmd_line;
-  for (const auto& dir_name : dirs) {
-    if (!std::all_of(dir_name.begin(), dir_name.end(), isdigit)) {
-      continue;
-    }
-    *pid = std::stoi(dir_name);
-    std::ifstream cmdline_file(
-        absl::StrCat(system_proc_path, "/", dir_name, proc_cmdline_path));
-    std::getline(cmdline_file, cmd_line);
-    if (absl::StrContains(cmd_line, process_dag_path)) {
-      return true;
-    }
+  ProcessRegistry::Process process;
+  if (!ProcessRegistry::Instance()->FindProcess({process_dag_path},
+                                                &process)) {
+    return false;
   }
-  return false;
+  *pid = process.pid;
+  return true;
 }
 
-std::vector<std::string> GetStatsLines(const std::string& stat_file,
+std::vector<std::string> GetStatsLines(const std::string& content,
                                        const int line_count) {
   std::vector<std::string> stats_lines;
-  std::ifstream buffer(stat_file);
-  for (int line_num = 0; line_num < line_count; ++line_num) {
-    std::string line;
-    std::getline(buffer, line);
-    if (line.empty()) {
+  for (absl::string_view line : absl::StrSplit(content, '\n')) {
+    if (static_cast<int>(stats_lines.size()) >= line_count || line.empty()) {
       break;
     }
-    stats_lines.push_back(line);
+    stats_lines.emplace_back(line);
   }
   return stats_lines;
 }
 
+// Reads a system wide /proc file through a kept open file.
+std::vector<std::string> GetSystemStatsLines(ProcFile* stat_file,
+                                             const int line_count) {
+  std::string content;
+  if (!stat_file->Read(&content)) {
+    return {};
+  }
+  return GetStatsLines(content, line_count);
+}
+
 float GetMemoryUsage(const int pid, const std::string& process_name) {
-  const std::string memory_stat_file = absl::StrCat("/proc/", pid, "/statm");
   const uint32_t page_size_kb = (sysconf(_SC_PAGE_SIZE) >> 10);
   const int resident_idx = 1, gb_2_kb = (1 << 20);
   constexpr static int kMemoryInfo = 0;
 
-  const auto stat_lines = GetStatsLines(memory_stat_file, kMemoryInfo + 1);
+  std::string content;
+  ProcessRegistry::Instance()->ReadStatm(pid, &content);
+  const auto stat_lines = GetStatsLines(content, kMemoryInfo + 1);
   if (stat_lines.size() <= kMemoryInfo) {
-    AERROR << "failed to load contents from " << memory_stat_file;
+    AERROR << "failed to load contents from /proc/" << pid << "/statm";
     return 0.f;
   }
   const std::vector<std::string> stats =
@@ -102,14 +100,15 @@ float GetMemoryUsage(const int pid, const std::string& process_name) {
 
 float GetCPUUsage(const int pid, const std::string& process_name,
                   std::unordered_map<std::string, uint64_t>* prev_jiffies_map) {
-  const std::string cpu_stat_file = absl::StrCat("/proc/", pid, "/stat");
   const int hertz = sysconf(_SC_CLK_TCK);
   const int utime = 13, stime = 14, cutime = 15, cstime = 16;
   constexpr static int kCpuInfo = 0;
 
-  const auto stat_lines = GetStatsLines(cpu_stat_file, kCpuInfo + 1);
+  std::string content;
+  ProcessRegistry::Instance()->ReadStat(pid, &content);
+  const auto stat_lines = GetStatsLines(content, kCpuInfo + 1);
   if (stat_lines.size() <= kCpuInfo) {
-    AERROR << "failed to load contents from " << cpu_stat_file;
+    AERROR << "failed to load contents from /proc/" << pid << "/stat";
     return 0.f;
   }
   const std::vector<std::string> stats =
@@ -145,7 +144,8 @@ float GetSystemMemoryUsage() {
   const std::string system_mem_stat_file = "/proc/meminfo";
   const int mem_total = 0, mem_free = 1, buffers = 3, cached = 4,
             swap_total = 14, swap_free = 15, slab = 21;
-  const auto stat_lines = GetStatsLines(system_mem_stat_file, slab + 1);
+  static ProcFile stat_file(system_mem_stat_file);
+  const auto stat_lines = GetSystemStatsLines(&stat_file, slab + 1);
   if (stat_lines.size() <= slab) {
     AERROR << "failed to load contents from " << system_mem_stat_file;
     return 0.f;
@@ -168,8 +168,8 @@ float GetSystemCPUUsage() {
   const int users = 1, system = 3, total = 7;
   constexpr static int kSystemCpuInfo = 0;
   static uint64_t prev_jiffies = 0, prev_work_jiffies = 0;
-  const auto stat_lines =
-      GetStatsLines(system_cpu_stat_file, kSystemCpuInfo + 1);
+  static ProcFile stat_file(system_cpu_stat_file);
+  const auto stat_lines = GetSystemStatsLines(&stat_file, kSystemCpuInfo + 1);
   if (stat_lines.size() <= kSystemCpuInfo) {
     AERROR << "failed to load contents from " << system_cpu_stat_file;
     return 0.f;
@@ -205,8 +205,9 @@ float GetSystemDiskload(const std::string& device_name) {
   const int seconds_to_ms = 1000;
   constexpr static int kDiskInfo = 128;
   static uint64_t prev_disk_stats = 0;
+  static ProcFile stat_file(disks_stat_file);
 
-  const auto stat_lines = GetStatsLines(disks_stat_file, kDiskInfo);
+  const auto stat_lines = GetSystemStatsLines(&stat_file, kDiskInfo);
   uint64_t disk_stats = 0;
   for (const auto& line : stat_lines) {
     const std::vector<std::string> stats =
@@ -233,6 +234,7 @@ ResourceMonitor::ResourceMonitor()
                       FLAGS_resource_monitor_interval) {}
 
 void ResourceMonitor::RunOnce(const double current_time) {
+  ProcessRegistry::Instance()->Update();
   auto manager = MonitorManager::Instance();
   const auto& mode = manager->GetHMIMode();
   auto* components = manager->GetStatus()->mutable_components();
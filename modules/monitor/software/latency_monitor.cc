@@ -18,9 +18,7 @@
 
 #include <algorithm>
 #include <memory>
-#include <unordered_set>
 #include <utility>
-#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "cyber/common/log.h"
@@ -49,39 +47,16 @@ namespace {
 
 using apollo::common::LatencyRecordMap;
 using apollo::common::LatencyReport;
-using apollo::common::LatencyStat;
 using apollo::common::LatencyTrack;
 
-LatencyStat GenerateStat(const std::vector<uint64_t>& numbers) {
-  LatencyStat stat;
-  uint64_t min_number = (1UL << 63), max_number = 0, sum = 0;
-  for (const auto number : numbers) {
-    min_number = std::min(min_number, number);
-    max_number = std::max(max_number, number);
-    sum += number;
-  }
-  const uint32_t sample_size = static_cast<uint32_t>(numbers.size());
-  stat.set_min_duration(min_number);
-  stat.set_max_duration(max_number);
-  stat.set_aver_duration(
-      sample_size == 0 ? 0 : static_cast<uint64_t>(sum / sample_size));
-  stat.set_sample_size(sample_size);
-  return stat;
-}
-
-void SetStat(const LatencyStat& src, LatencyStat* dst) {
-  dst->set_min_duration(src.min_duration());
-  dst->set_max_duration(src.max_duration());
-  dst->set_aver_duration(src.aver_duration());
-  dst->set_sample_size(src.sample_size());
-}
+using apollo::common::LatencyDistribution;
 
 void SetLatency(const std::string& latency_name,
-                const std::vector<uint64_t>& latency_values,
+                const LatencyDistribution& latency_values,
                 LatencyTrack* track) {
   auto* latency_track = track->add_latency_track();
   latency_track->set_latency_name(latency_name);
-  SetStat(GenerateStat(latency_values), latency_track->mutable_latency_stat());
+  latency_values.ToStat(latency_track->mutable_latency_stat());
 }
 
 }  // namespace
@@ -114,7 +89,7 @@ void LatencyMonitor::RunOnce(const double current_time) {
 
   if (current_time - flush_time_ > FLAGS_latency_report_interval) {
     flush_time_ = current_time;
-    if (!track_map_.empty()) {
+    if (!track_map_.empty() || !modules_histogram_.empty()) {
       PublishLatencyReport();
     }
   }
@@ -128,6 +103,25 @@ void LatencyMonitor::UpdateStat(
                                             record.end_time(), module_name);
   }
 
+  // Records are only sampled if a histogram is published, which then holds
+  // all module latencies.
+  auto& module_histogram = modules_histogram_[module_name];
+  if (records->has_latency_histogram()) {
+    const auto& histogram = records->latency_histogram();
+    const uint64_t sample_size = module_histogram.sample_size();
+    module_histogram.Merge(histogram);
+    if (histogram.end_time() > histogram.begin_time()) {
+      freq_map_[module_name] =
+          static_cast<double>(module_histogram.sample_size() - sample_size) /
+          apollo::cyber::Time(histogram.end_time() - histogram.begin_time())
+              .ToSecond();
+    }
+    return;
+  }
+
+  for (const auto& record : records->latency_records()) {
+    module_histogram.Add(record.end_time() - record.begin_time());
+  }
   if (!records->latency_records().empty()) {
     const auto begin_time = records->latency_records().begin()->begin_time();
     const auto end_time = records->latency_records().rbegin()->end_time();
@@ -147,29 +141,18 @@ void LatencyMonitor::PublishLatencyReport() {
   writer->Write(latency_report_);
   latency_report_.clear_header();
   track_map_.clear();
+  modules_histogram_.clear();
   latency_report_.clear_modules_latency();
   latency_report_.clear_e2es_latency();
 }
 
 void LatencyMonitor::AggregateLatency() {
   static const std::string kE2EStartPoint = FLAGS_pointcloud_topic;
-  std::unordered_map<std::string, std::vector<uint64_t>> modules_track;
-  std::unordered_map<std::string, std::vector<uint64_t>> e2es_track;
-  std::unordered_set<std::string> all_modules;
+  std::unordered_map<std::string, LatencyDistribution> e2es_track;
 
-  // Aggregate modules latencies
+  // Aggregate E2E latencies over the traced messages
   std::string module_name;
-  uint64_t begin_time = 0, end_time = 0;
-  for (const auto& message : track_map_) {
-    auto iter = message.second.begin();
-    while (iter != message.second.end()) {
-      std::tie(begin_time, end_time, module_name) = *iter;
-      modules_track[module_name].push_back(end_time - begin_time);
-      all_modules.emplace(module_name);
-      ++iter;
-    }
-  }
-  // Aggregate E2E latencies
+  uint64_t begin_time = 0;
   std::unordered_map<std::string, uint64_t> e2e_latencies;
   for (const auto& message : track_map_) {
     uint64_t e2e_begin_time = 0;
@@ -183,7 +166,7 @@ void LatencyMonitor::AggregateLatency() {
                  e2e_latencies.find(module_name) == e2e_latencies.end()) {
         const auto duration = begin_time - e2e_begin_time;
         e2e_latencies[module_name] = duration;
-        e2es_track[module_name].push_back(duration);
+        e2es_track[module_name].Add(duration);
       }
       ++iter;
     }
@@ -203,7 +186,10 @@ void LatencyMonitor::AggregateLatency() {
   // ...
 
   auto* modules_latency = latency_report_.mutable_modules_latency();
-  for (const auto& module : modules_track) {
+  for (const auto& module : modules_histogram_) {
+    if (module.second.sample_size() == 0) {
+      continue;
+    }
     SetLatency(module.first, module.second, modules_latency);
   }
   auto* e2es_latency = latency_report_.mutable_e2es_latency();
@@ -22,6 +22,7 @@
 #include <tuple>
 #include <unordered_map>
 
+#include "modules/common/latency_recorder/latency_histogram.h"
 #include "modules/common/latency_recorder/proto/latency_record.pb.h"
 #include "modules/monitor/common/recurrent_runner.h"
 
@@ -41,9 +42,13 @@ class LatencyMonitor : public RecurrentRunner {
   void AggregateLatency();
 
   apollo::common::LatencyReport latency_report_;
+  // Records by message id, for end-to-end latencies.
   std::unordered_map<uint64_t,
                      std::set<std::tuple<uint64_t, uint64_t, std::string>>>
       track_map_;
+  // Latencies of each module since the last report.
+  std::unordered_map<std::string, apollo::common::LatencyDistribution>
+      modules_histogram_;
   std::unordered_map<std::string, double> freq_map_;
   double flush_time_ = 0.0;
 };
@@ -16,12 +16,15 @@
 
 #include "modules/monitor/software/process_monitor.h"
 
+#include <string>
+#include <vector>
+
 #include "gflags/gflags.h"
 
-#include "cyber/common/file.h"
 #include "cyber/common/log.h"
 #include "modules/common/util/map_util.h"
 #include "modules/monitor/common/monitor_manager.h"
+#include "modules/monitor/common/process_registry.h"
 #include "modules/monitor/software/summary_monitor.h"
 
 DEFINE_string(process_monitor_name, "ProcessMonitor",
@@ -38,19 +41,8 @@ ProcessMonitor::ProcessMonitor()
                       FLAGS_process_monitor_interval) {}
 
 void ProcessMonitor::RunOnce(const double current_time) {
-  // Get running processes.
-  std::vector<std::string> running_processes;
-  for (const auto& cmd_file : cyber::common::Glob("/proc/*/cmdline")) {
-    // Get process command string.
-    std::string cmd_string;
-    if (cyber::common::GetContent(cmd_file, &cmd_string) &&
-        !cmd_string.empty()) {
-      // In /proc/<PID>/cmdline, the parts are separated with \0, which will be
-      // converted back to whitespaces here.
-      std::replace(cmd_string.begin(), cmd_string.end(), '\0', ' ');
-      running_processes.push_back(cmd_string);
-    }
-  }
+  // Catch up with the processes started or stopped since the last run.
+  ProcessRegistry::Instance()->Update();
 
   auto manager = MonitorManager::Instance();
   const auto& mode = manager->GetHMIMode();
@@ -60,7 +52,7 @@ void ProcessMonitor::RunOnce(const double current_time) {
   for (const auto& iter : mode.modules()) {
     const std::string& module_name = iter.first;
     const auto& config = iter.second.process_monitor_config();
-    UpdateStatus(running_processes, config, &hmi_modules->at(module_name));
+    UpdateStatus(config, &hmi_modules->at(module_name));
   }
 
   // Check monitored components.
@@ -71,7 +63,7 @@ void ProcessMonitor::RunOnce(const double current_time) {
         apollo::common::util::ContainsKey(*components, name)) {
       const auto& config = iter.second.process();
       auto* status = components->at(name).mutable_process_status();
-      UpdateStatus(running_processes, config, status);
+      UpdateStatus(config, status);
     }
   }
 
@@ -80,7 +72,7 @@ void ProcessMonitor::RunOnce(const double current_time) {
   for (const auto& iter : mode.other_components()) {
     const std::string& name = iter.first;
     const auto& config = iter.second;
-    UpdateStatus(running_processes, config, &other_components->at(name));
+    UpdateStatus(config, &other_components->at(name));
   }
 
   // Check global components.
@@ -91,29 +83,23 @@ void ProcessMonitor::RunOnce(const double current_time) {
         apollo::common::util::ContainsKey(*global_components, name)) {
       const auto& config = iter.second.process();
       auto* status = global_components->at(name).mutable_process_status();
-      UpdateStatus(running_processes, config, status);
+      UpdateStatus(config, status);
     }
   }
 }
 
 void ProcessMonitor::UpdateStatus(
-    const std::vector<std::string>& running_processes,
     const apollo::dreamview::ProcessMonitorConfig& config,
     ComponentStatus* status) {
   status->clear_status();
-  for (const std::string& command : running_processes) {
-    bool all_keywords_matched = true;
-    for (const std::string& keyword : config.command_keywords()) {
-      if (command.find(keyword) == std::string::npos) {
-        all_keywords_matched = false;
-        break;
-      }
-    }
-    if (all_keywords_matched) {
-      // Process command keywords are all matched. The process is running.
-      SummaryMonitor::EscalateStatus(ComponentStatus::OK, command, status);
-      return;
-    }
+  const std::vector<std::string> keywords(config.command_keywords().begin(),
+                                          config.command_keywords().end());
+  ProcessRegistry::Process process;
+  if (ProcessRegistry::Instance()->FindProcess(keywords, &process)) {
+    // Process command keywords are all matched. The process is running.
+    SummaryMonitor::EscalateStatus(ComponentStatus::OK, process.command,
+                                   status);
+    return;
   }
   SummaryMonitor::EscalateStatus(ComponentStatus::FATAL, "", status);
 }
@@ -15,9 +15,6 @@
  *****************************************************************************/
 #pragma once
 
-#include <string>
-#include <vector>
-
 #include "modules/common_msgs/dreamview_msgs/hmi_mode.pb.h"
 #include "modules/common_msgs/monitor_msgs/system_status.pb.h"
 
@@ -33,7 +30,6 @@ class ProcessMonitor : public RecurrentRunner {
 
  private:
   static void UpdateStatus(
-      const std::vector<std::string>& running_processes,
       const apollo::dreamview::ProcessMonitorConfig& config,
       ComponentStatus* status);
 };
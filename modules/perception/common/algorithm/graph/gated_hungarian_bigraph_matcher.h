@@ -26,6 +26,7 @@
 
 #include "modules/perception/common/algorithm/graph/connected_component_analysis.h"
 #include "modules/perception/common/algorithm/graph/hungarian_optimizer.h"
+#include "modules/perception/common/algorithm/graph/sparse_assignment_solver.h"
 
 namespace apollo {
 namespace perception {
@@ -36,9 +37,17 @@ class GatedHungarianMatcher {
  public:
   enum class OptimizeFlag { OPTMAX, OPTMIN };
 
+  /* HUNGARIAN runs the dense Munkres optimizer on every connected component,
+   * SPARSE runs the sparse shortest augmenting path solver on the gated
+   * edges only. Both give an optimal assignment, but may pick different
+   * ones among equally good candidates. */
+  enum class SolverType { HUNGARIAN, SPARSE };
+
   explicit GatedHungarianMatcher(int max_matching_size = 1000) {
     global_costs_.Reserve(max_matching_size, max_matching_size);
     optimizer_.costs()->Reserve(max_matching_size, max_matching_size);
+    sparse_solver_.Reserve(max_matching_size, max_matching_size,
+                           max_matching_size);
   }
   ~GatedHungarianMatcher() {}
 
@@ -52,6 +61,9 @@ class GatedHungarianMatcher {
   const SecureMat<T>& global_costs() const { return global_costs_; }
   SecureMat<T>* mutable_global_costs() { return &global_costs_; }
 
+  SolverType solver_type() const { return solver_type_; }
+  void set_solver_type(SolverType solver_type) { solver_type_ = solver_type; }
+
   void Match(T cost_thresh, OptimizeFlag opt_flag,
              std::vector<std::pair<size_t, size_t>>* assignments,
              std::vector<size_t>* unassigned_rows,
@@ -97,9 +109,17 @@ class GatedHungarianMatcher {
   void OptimizeAdapter(
       std::vector<std::pair<size_t, size_t>>* local_assignments);
 
+  /* replaces steps 2 & 3 for SolverType::SPARSE: collect the gated edges and
+   * optimize all components in a single pass of the sparse solver. */
+  void OptimizeSparse();
+
   /* Hungarian optimizer */
   HungarianOptimizer<T> optimizer_;
 
+  /* sparse optimizer */
+  SparseAssignmentSolver<T> sparse_solver_;
+  SolverType solver_type_ = SolverType::HUNGARIAN;
+
   /* global costs matrix */
   SecureMat<T> global_costs_;
 
@@ -147,6 +167,12 @@ void GatedHungarianMatcher<T>::Match(
   assignments_ptr_ = assignments;
   MatchInit();
 
+  if (solver_type_ == SolverType::SPARSE) {
+    this->OptimizeSparse();
+    this->GenerateUnassignedData(unassigned_rows, unassigned_cols);
+    return;
+  }
+
   /* compute components */
   std::vector<std::vector<size_t>> row_components;
   std::vector<std::vector<size_t>> col_components;
@@ -318,6 +344,25 @@ void GatedHungarianMatcher<T>::OptimizeAdapter(
   }
 }
 
+template <typename T>
+void GatedHungarianMatcher<T>::OptimizeSparse() {
+  sparse_solver_.Resize(rows_num_, cols_num_);
+  for (size_t i = 0; i < rows_num_; ++i) {
+    for (size_t j = 0; j < cols_num_; ++j) {
+      const T cost = global_costs_(i, j);
+      if (is_valid_cost_(cost)) {
+        sparse_solver_.AddEdge(i, j, cost);
+      }
+    }
+  }
+  /* a row left out costs as much as a gated-out cell in the dense problem */
+  if (opt_flag_ == OptimizeFlag::OPTMAX) {
+    sparse_solver_.Maximize(bound_value_, assignments_ptr_);
+  } else {
+    sparse_solver_.Minimize(bound_value_, assignments_ptr_);
+  }
+}
+
 }  // namespace algorithm
 }  // namespace perception
 }  // namespace apollo
@@ -0,0 +1,308 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace algorithm {
+
+/* Sparse linear assignment solver in the spirit of Jonker-Volgenant: every
+ * row is assigned by one Dijkstra search for a shortest augmenting path
+ * over the gated edges only, with column potentials keeping reduced costs
+ * non-negative. Leaving a row unmatched costs unmatched_cost, so the result
+ * minimizes
+ *   sum(cost of matched edges) + unmatched_cost * (number of unmatched rows)
+ * which is what the dense Hungarian optimizer computes when every gated-out
+ * cell is filled with the bound value.
+ *
+ * A search never leaves the connected component of its row, so solving the
+ * whole gated graph at once costs the same as solving the components one
+ * by one, and the dense matrix is never scanned. */
+template <typename T>
+class SparseAssignmentSolver {
+ public:
+  SparseAssignmentSolver() {}
+  ~SparseAssignmentSolver() {}
+
+  /* Reserve memory for the given problem size, to avoid reallocation while
+   * matching. */
+  void Reserve(size_t rows, size_t cols, size_t edges);
+
+  /* Start a new problem with rows x cols nodes and no edges. */
+  void Resize(size_t rows, size_t cols);
+
+  /* Add a gated edge; edges may be added in any order, but at most once per
+   * (row, col) pair. */
+  void AddEdge(size_t row, size_t col, T cost);
+
+  size_t rows() const { return rows_num_; }
+  size_t cols() const { return cols_num_; }
+  size_t edges() const { return edges_.size(); }
+
+  /* Find the assignment of minimal total cost. Only edges cheaper than
+   * unmatched_cost can be part of it. The assignments are sorted by row. */
+  void Minimize(T unmatched_cost,
+                std::vector<std::pair<size_t, size_t>>* assignments);
+
+  /* Same as Minimize(), with costs to be maximized and unmatched_cost being
+   * the reward of leaving a row unmatched. */
+  void Maximize(T unmatched_cost,
+                std::vector<std::pair<size_t, size_t>>* assignments);
+
+ private:
+  struct Edge {
+    size_t row;
+    size_t col;
+    T cost;
+  };
+
+  void Solve(bool maximize, T unmatched_cost,
+             std::vector<std::pair<size_t, size_t>>* assignments);
+
+  /* Build the row-major adjacency, mapping costs to be minimized and
+   * non-negative. Column cols_num_ + i is the private "unmatched" column of
+   * row i. */
+  void BuildGraph(bool maximize, T unmatched_cost);
+
+  /* Assign row 'row' by a shortest augmenting path. */
+  void Augment(size_t row);
+
+  static constexpr int kUnassigned = -1;
+
+  std::vector<Edge> edges_;
+  size_t rows_num_ = 0;
+  size_t cols_num_ = 0;
+
+  /* adjacency in compressed sparse row form */
+  std::vector<size_t> row_offsets_;
+  std::vector<size_t> adj_cols_;
+  std::vector<T> adj_costs_;
+
+  /* dual variables and matching */
+  std::vector<T> row_potentials_;
+  std::vector<T> col_potentials_;
+  std::vector<int> row_to_col_;
+  std::vector<int> col_to_row_;
+
+  /* Dijkstra state, reset lazily through scanned_cols_ and touched_cols_ */
+  std::vector<T> dist_;
+  std::vector<int> pred_;
+  std::vector<bool> scanned_;
+  std::vector<size_t> scanned_cols_;
+  std::vector<size_t> touched_cols_;
+};  // class SparseAssignmentSolver
+
+template <typename T>
+void SparseAssignmentSolver<T>::Reserve(size_t rows, size_t cols,
+                                        size_t edges) {
+  edges_.reserve(edges);
+  row_offsets_.reserve(rows + 1);
+  adj_cols_.reserve(edges + rows);
+  adj_costs_.reserve(edges + rows);
+  row_potentials_.reserve(rows);
+  col_potentials_.reserve(cols + rows);
+  row_to_col_.reserve(rows);
+  col_to_row_.reserve(cols + rows);
+  dist_.reserve(cols + rows);
+  pred_.reserve(cols + rows);
+  scanned_.reserve(cols + rows);
+  scanned_cols_.reserve(cols + rows);
+  touched_cols_.reserve(cols + rows);
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Resize(size_t rows, size_t cols) {
+  rows_num_ = rows;
+  cols_num_ = cols;
+  edges_.clear();
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::AddEdge(size_t row, size_t col, T cost) {
+  edges_.push_back({row, col, cost});
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Minimize(
+    T unmatched_cost, std::vector<std::pair<size_t, size_t>>* assignments) {
+  Solve(false, unmatched_cost, assignments);
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Maximize(
+    T unmatched_cost, std::vector<std::pair<size_t, size_t>>* assignments) {
+  Solve(true, unmatched_cost, assignments);
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Solve(
+    bool maximize, T unmatched_cost,
+    std::vector<std::pair<size_t, size_t>>* assignments) {
+  assignments->clear();
+  BuildGraph(maximize, unmatched_cost);
+  for (size_t row = 0; row < rows_num_; ++row) {
+    Augment(row);
+  }
+  for (size_t row = 0; row < rows_num_; ++row) {
+    const int col = row_to_col_[row];
+    if (col != kUnassigned && static_cast<size_t>(col) < cols_num_) {
+      assignments->push_back(std::make_pair(row, static_cast<size_t>(col)));
+    }
+  }
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::BuildGraph(bool maximize, T unmatched_cost) {
+  /* Every row ends up either on an edge or on its unmatched column, so
+   * shifting all costs by the same offset does not change the optimum; use
+   * it to make them non-negative, which gives trivially feasible zero
+   * potentials. */
+  const T sign = maximize ? static_cast<T>(-1) : static_cast<T>(1);
+  T min_cost = sign * unmatched_cost;
+  for (const auto& edge : edges_) {
+    min_cost = std::min(min_cost, sign * edge.cost);
+  }
+
+  row_offsets_.assign(rows_num_ + 1, 0);
+  for (const auto& edge : edges_) {
+    ++row_offsets_[edge.row + 1];
+  }
+  for (size_t row = 0; row < rows_num_; ++row) {
+    /* one more slot for the unmatched column */
+    row_offsets_[row + 1] += row_offsets_[row] + 1;
+  }
+  const size_t adj_size = row_offsets_[rows_num_];
+  adj_cols_.resize(adj_size);
+  adj_costs_.resize(adj_size);
+  std::vector<size_t> fill(row_offsets_.begin(), row_offsets_.end() - 1);
+  for (const auto& edge : edges_) {
+    const size_t pos = fill[edge.row]++;
+    adj_cols_[pos] = edge.col;
+    adj_costs_[pos] = sign * edge.cost - min_cost;
+  }
+  for (size_t row = 0; row < rows_num_; ++row) {
+    const size_t pos = fill[row];
+    adj_cols_[pos] = cols_num_ + row;
+    adj_costs_[pos] = sign * unmatched_cost - min_cost;
+  }
+
+  const size_t all_cols = cols_num_ + rows_num_;
+  row_potentials_.assign(rows_num_, static_cast<T>(0));
+  col_potentials_.assign(all_cols, static_cast<T>(0));
+  row_to_col_.assign(rows_num_, kUnassigned);
+  col_to_row_.assign(all_cols, kUnassigned);
+  dist_.assign(all_cols, std::numeric_limits<T>::max());
+  pred_.assign(all_cols, kUnassigned);
+  scanned_.assign(all_cols, false);
+  scanned_cols_.clear();
+  touched_cols_.clear();
+}
+
+template <typename T>
+void SparseAssignmentSolver<T>::Augment(size_t row) {
+  typedef std::pair<T, size_t> HeapItem;
+  std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>>
+      heap;
+
+  /* relax the edges leaving 'from', which is reached at distance 'base' */
+  auto relax = [&](size_t from, T base) {
+    for (size_t k = row_offsets_[from]; k < row_offsets_[from + 1]; ++k) {
+      const size_t col = adj_cols_[k];
+      if (scanned_[col]) {
+        continue;
+      }
+      const T reduced =
+          adj_costs_[k] - row_potentials_[from] - col_potentials_[col];
+      const T dist = base + std::max(reduced, static_cast<T>(0));
+      if (dist < dist_[col]) {
+        if (pred_[col] == kUnassigned) {
+          touched_cols_.push_back(col);
+        }
+        dist_[col] = dist;
+        pred_[col] = static_cast<int>(from);
+        heap.push(std::make_pair(dist, col));
+      }
+    }
+  };
+
+  relax(row, static_cast<T>(0));
+  size_t sink = 0;
+  T sink_dist = static_cast<T>(0);
+  while (!heap.empty()) {
+    const HeapItem item = heap.top();
+    heap.pop();
+    const size_t col = item.second;
+    if (scanned_[col] || item.first > dist_[col]) {
+      continue;
+    }
+    scanned_[col] = true;
+    scanned_cols_.push_back(col);
+    if (col_to_row_[col] == kUnassigned) {
+      sink = col;
+      sink_dist = item.first;
+      break;
+    }
+    relax(static_cast<size_t>(col_to_row_[col]), item.first);
+  }
+  /* the private unmatched column of 'row' is always reachable */
+
+  /* update the potentials of everything closer than the sink, which keeps
+   * all reduced costs non-negative and the new path tight */
+  row_potentials_[row] += sink_dist;
+  for (const size_t col : scanned_cols_) {
+    const T delta = sink_dist - dist_[col];
+    col_potentials_[col] -= delta;
+    const int matched_row = col_to_row_[col];
+    if (matched_row != kUnassigned) {
+      row_potentials_[matched_row] += delta;
+    }
+  }
+
+  /* flip the augmenting path */
+  size_t col = sink;
+  while (true) {
+    const size_t from = static_cast<size_t>(pred_[col]);
+    const int prev_col = row_to_col_[from];
+    row_to_col_[from] = static_cast<int>(col);
+    col_to_row_[col] = static_cast<int>(from);
+    if (from == row) {
+      break;
+    }
+    col = static_cast<size_t>(prev_col);
+  }
+
+  for (const size_t c : scanned_cols_) {
+    scanned_[c] = false;
+  }
+  for (const size_t c : touched_cols_) {
+    dist_[c] = std::numeric_limits<T>::max();
+    pred_[c] = kUnassigned;
+  }
+  scanned_cols_.clear();
+  touched_cols_.clear();
+}
+
+}  // namespace algorithm
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/algorithm/graph/sparse_assignment_solver.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/common/algorithm/graph/gated_hungarian_bigraph_matcher.h"
+
+namespace apollo {
+namespace perception {
+namespace algorithm {
+
+namespace {
+
+float AssignmentCost(SecureMat<float>* costs, float bound_value,
+                     const std::vector<std::pair<size_t, size_t>>& pairs) {
+  const size_t unmatched = costs->height() - pairs.size();
+  float total = bound_value * static_cast<float>(unmatched);
+  for (const auto& pair : pairs) {
+    total += (*costs)(pair.first, pair.second);
+  }
+  return total;
+}
+
+}  // namespace
+
+TEST(SparseAssignmentSolverTest, test_Minimize) {
+  SparseAssignmentSolver<float> solver;
+  std::vector<std::pair<size_t, size_t>> assignments;
+
+  solver.Resize(0, 3);
+  solver.Minimize(10.0f, &assignments);
+  EXPECT_TRUE(assignments.empty());
+
+  // greedy would take (0, 0) and leave row 1 unmatched
+  solver.Resize(2, 2);
+  solver.AddEdge(0, 0, 1.0f);
+  solver.AddEdge(0, 1, 2.0f);
+  solver.AddEdge(1, 0, 1.5f);
+  solver.Minimize(10.0f, &assignments);
+  ASSERT_EQ(2, assignments.size());
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(1)), assignments[0]);
+  EXPECT_EQ(std::make_pair(size_t(1), size_t(0)), assignments[1]);
+
+  // leaving both rows alone is cheaper than matching through the long edge
+  solver.Resize(2, 2);
+  solver.AddEdge(0, 0, 1.0f);
+  solver.AddEdge(0, 1, 9.5f);
+  solver.AddEdge(1, 0, 1.5f);
+  solver.Minimize(5.0f, &assignments);
+  ASSERT_EQ(1, assignments.size());
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(0)), assignments[0]);
+}
+
+TEST(SparseAssignmentSolverTest, test_Maximize) {
+  SparseAssignmentSolver<float> solver;
+  std::vector<std::pair<size_t, size_t>> assignments;
+  solver.Resize(2, 3);
+  solver.AddEdge(0, 0, 0.9f);
+  solver.AddEdge(1, 0, 0.8f);
+  solver.AddEdge(1, 2, 0.7f);
+  solver.Maximize(0.0f, &assignments);
+  ASSERT_EQ(2, assignments.size());
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(0)), assignments[0]);
+  EXPECT_EQ(std::make_pair(size_t(1), size_t(2)), assignments[1]);
+}
+
+TEST(SparseAssignmentSolverTest, test_SameCostAsHungarian) {
+  const float cost_thresh = 4.0f;
+  const float bound_value = 100.0f;
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<float> cost_dist(0.0f, 12.0f);
+  std::uniform_int_distribution<int> size_dist(1, 40);
+
+  GatedHungarianMatcher<float> dense(100);
+  GatedHungarianMatcher<float> sparse(100);
+  sparse.set_solver_type(GatedHungarianMatcher<float>::SolverType::SPARSE);
+  const auto opt_flag = GatedHungarianMatcher<float>::OptimizeFlag::OPTMIN;
+  for (int trial = 0; trial < 200; ++trial) {
+    const size_t rows = size_dist(engine);
+    const size_t cols = size_dist(engine);
+    SecureMat<float>* costs = dense.mutable_global_costs();
+    costs->Resize(rows, cols);
+    sparse.mutable_global_costs()->Resize(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        (*costs)(i, j) = cost_dist(engine);
+        (*sparse.mutable_global_costs())(i, j) = (*costs)(i, j);
+      }
+    }
+
+    std::vector<std::pair<size_t, size_t>> dense_assignments;
+    std::vector<std::pair<size_t, size_t>> sparse_assignments;
+    std::vector<size_t> unassigned_rows;
+    std::vector<size_t> unassigned_cols;
+    dense.Match(cost_thresh, bound_value, opt_flag, &dense_assignments,
+                &unassigned_rows, &unassigned_cols);
+    sparse.Match(cost_thresh, bound_value, opt_flag, &sparse_assignments,
+                 &unassigned_rows, &unassigned_cols);
+    EXPECT_EQ(rows, sparse_assignments.size() + unassigned_rows.size());
+    EXPECT_EQ(cols, sparse_assignments.size() + unassigned_cols.size());
+    for (const auto& pair : sparse_assignments) {
+      EXPECT_LT((*costs)(pair.first, pair.second), cost_thresh);
+    }
+    EXPECT_NEAR(AssignmentCost(costs, bound_value, dense_assignments),
+                AssignmentCost(costs, bound_value, sparse_assignments),
+                1e-2);
+  }
+}
+
+}  // namespace algorithm
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/common/inference/cpu/cpu_net.h"
+
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+using apollo::perception::base::Blob;
+
+namespace {
+
+// number of input shapes whose oneDNN primitives are kept
+constexpr int kMkldnnCacheCapacity = 10;
+
+// PaddleNet running on oneDNN instead of the gpu
+class MkldnnPaddleNet : public PaddleNet {
+ public:
+  MkldnnPaddleNet(const std::string &model_file,
+                  const std::string &params_file,
+                  const std::vector<std::string> &outputs,
+                  const std::vector<std::string> &inputs,
+                  const int num_threads, const CpuPrecision precision)
+      : PaddleNet(model_file, params_file, outputs, inputs),
+        num_threads_(num_threads),
+        precision_(precision) {
+    gpu_id_ = -1;
+  }
+
+ protected:
+  bool ConfigDevice(paddle_infer::Config *config) override {
+    config->DisableGpu();
+    config->EnableMKLDNN();
+    config->SetMkldnnCacheCapacity(kMkldnnCacheCapacity);
+    if (num_threads_ > 0) {
+      config->SetCpuMathLibraryNumThreads(num_threads_);
+    }
+    if (precision_ == CpuPrecision::kInt8) {
+      config->EnableMkldnnInt8();
+    } else if (precision_ == CpuPrecision::kBFloat16) {
+      config->EnableMkldnnBfloat16();
+    }
+    return true;
+  }
+
+ private:
+  int num_threads_;
+  CpuPrecision precision_;
+};
+
+}  // namespace
+
+CpuNet::CpuNet(const std::string &model_file, const std::string &params_file,
+               const std::vector<std::string> &outputs,
+               const std::vector<std::string> &inputs)
+    : model_file_(model_file),
+      params_file_(params_file),
+      output_names_(outputs),
+      input_names_(inputs) {}
+
+bool CpuNet::Init(const std::map<std::string, std::vector<int>> &shapes) {
+  // TorchScript models are a single file, paddle models come with params
+  const bool use_paddle = !params_file_.empty();
+  if (use_paddle) {
+    paddle_net_.reset(new MkldnnPaddleNet(model_file_, params_file_,
+                                          output_names_, input_names_,
+                                          num_threads_, precision_));
+    if (!paddle_net_->Init(shapes)) {
+      AERROR << "Failed to init cpu net " << model_file_;
+      return false;
+    }
+  } else {
+    if (!InitTorch()) {
+      AERROR << "Failed to init cpu net " << model_file_;
+      return false;
+    }
+    // add blobs, they are kept for the lifetime of the net
+    for (const auto &shape : shapes) {
+      auto blob = std::make_shared<Blob<float>>(shape.second);
+      blobs_.emplace(shape.first, blob);
+    }
+    torch_inputs_.reserve(input_names_.size());
+  }
+
+  AINFO << "Cpu net " << model_file_ << " backend: "
+        << (use_paddle ? "paddle" : "torch")
+        << " num_threads: " << num_threads_
+        << " precision: " << static_cast<int>(precision_);
+  return true;
+}
+
+bool CpuNet::InitTorch() {
+  // the intra-op pool of libtorch is shared by the whole process, so it
+  // is sized once instead of by every net
+  static std::once_flag num_threads_flag;
+  if (num_threads_ > 0) {
+    std::call_once(num_threads_flag,
+                   [this]() { torch::set_num_threads(num_threads_); });
+  }
+  try {
+    net_ = torch::jit::load(model_file_, torch::Device(torch::kCPU));
+  } catch (const c10::Error &e) {
+    AERROR << "Failed to load TorchScript model " << model_file_ << ": "
+           << e.what();
+    return false;
+  }
+  net_.eval();
+  if (precision_ == CpuPrecision::kBFloat16) {
+    net_.to(torch::kBFloat16);
+  } else if (precision_ == CpuPrecision::kInt8) {
+    // int8 TorchScript models have to be quantized when exported
+    AWARN << "Int8 is not supported for torch cpu net, use float32.";
+    precision_ = CpuPrecision::kFloat32;
+  }
+  return true;
+}
+
+void CpuNet::Infer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (paddle_net_ != nullptr) {
+    paddle_net_->Infer();
+  } else {
+    InferTorch();
+  }
+}
+
+void CpuNet::InferTorch() {
+  torch::NoGradGuard no_grad;
+  // wrap the input blobs without copying
+  torch_inputs_.clear();
+  for (const auto &name : input_names_) {
+    auto blob = get_blob(name);
+    if (blob == nullptr) {
+      continue;
+    }
+    std::vector<int64_t> shape(blob->shape().begin(), blob->shape().end());
+    torch::Tensor torch_blob =
+        torch::from_blob(blob->mutable_cpu_data(), shape, torch::kFloat32);
+    if (precision_ == CpuPrecision::kBFloat16) {
+      torch_blob = torch_blob.to(torch::kBFloat16);
+    }
+    torch_inputs_.emplace_back(torch_blob);
+  }
+
+  torch::jit::IValue result = net_.forward(torch_inputs_);
+  std::vector<torch::Tensor> output;
+  if (result.isTensor()) {
+    output.push_back(result.toTensor());
+  } else if (result.isTuple()) {
+    for (const auto &element : result.toTuple()->elements()) {
+      output.push_back(element.toTensor());
+    }
+  } else {
+    output = result.toTensorVector();
+  }
+
+  for (size_t i = 0; i < output_names_.size() && i < output.size(); ++i) {
+    auto blob = get_blob(output_names_[i]);
+    if (blob == nullptr) {
+      continue;
+    }
+    torch::Tensor tensor = output[i].to(torch::kFloat32).contiguous();
+    std::vector<int64_t> output_size = tensor.sizes().vec();
+    std::vector<int> shape(output_size.begin(), output_size.end());
+    FillBlob(shape, tensor.data_ptr<float>(), blob.get());
+  }
+}
+
+void CpuNet::FillBlob(const std::vector<int> &shape, const float *data,
+                      Blob<float> *blob) {
+  blob->Reshape(shape);
+  memcpy(blob->mutable_cpu_data(), data, blob->count() * sizeof(float));
+}
+
+base::BlobPtr<float> CpuNet::get_blob(const std::string &name) {
+  if (paddle_net_ != nullptr) {
+    return paddle_net_->get_blob(name);
+  }
+  auto iter = blobs_.find(name);
+  if (iter == blobs_.end()) {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <torch/script.h>
+#include <torch/torch.h>
+
+#include "modules/perception/common/inference/inference.h"
+#include "modules/perception/common/inference/paddlepaddle/paddle_net.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+enum class CpuPrecision { kFloat32 = 0, kInt8 = 1, kBFloat16 = 2 };
+
+/**
+ * @brief Inference on hosts without gpu. Paddle models (model and params
+ * file) run on a PaddleNet configured for oneDNN, TorchScript models
+ * (single model file) on the libtorch cpu kernels. Blobs stay in host
+ * memory and are reused between frames, the whole batch in the input
+ * blobs is inferred at once.
+ */
+class CpuNet : public Inference {
+ public:
+  CpuNet(const std::string &model_file, const std::string &params_file,
+         const std::vector<std::string> &outputs,
+         const std::vector<std::string> &inputs);
+
+  virtual ~CpuNet() = default;
+
+  bool Init(const std::map<std::string, std::vector<int>> &shapes) override;
+
+  void Infer() override;
+
+  base::BlobPtr<float> get_blob(const std::string &name) override;
+
+  /**
+   * @brief Set the number of math library threads, 0 keeps the library
+   * default. Paddle predictors are sized per net, while the libtorch
+   * thread pool is process-wide and only sized by the first TorchScript
+   * net that is initialized.
+   */
+  void set_num_threads(const int num_threads) { num_threads_ = num_threads; }
+
+  void set_precision(const CpuPrecision precision) { precision_ = precision; }
+
+  CpuPrecision precision() const { return precision_; }
+
+ private:
+  bool InitTorch();
+  void InferTorch();
+
+  // copy an output into the blob, which only reallocates when it grows
+  void FillBlob(const std::vector<int> &shape, const float *data,
+                base::Blob<float> *blob);
+
+  std::string model_file_;
+  std::string params_file_;
+  std::vector<std::string> output_names_;
+  std::vector<std::string> input_names_;
+  BlobMap blobs_;
+
+  int num_threads_ = 0;
+  CpuPrecision precision_ = CpuPrecision::kFloat32;
+
+  // paddle models are run by a PaddleNet which owns their blobs
+  std::unique_ptr<PaddleNet> paddle_net_;
+  torch::jit::script::Module net_;
+  std::vector<torch::jit::IValue> torch_inputs_;
+
+  // predictors are not reentrant, components may share a net
+  std::mutex mutex_;
+};
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
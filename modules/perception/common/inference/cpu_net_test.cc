@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/inference/cpu/cpu_net.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/common/inference/inference_factory.h"
+#include "modules/perception/common/perception_gflags.h"
+
+namespace apollo {
+namespace perception {
+namespace inference {
+
+class CpuNetTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    use_cpu_inference_ = FLAGS_use_cpu_inference;
+    cpu_inference_precision_ = FLAGS_cpu_inference_precision;
+  }
+
+  void TearDown() override {
+    FLAGS_use_cpu_inference = use_cpu_inference_;
+    FLAGS_cpu_inference_precision = cpu_inference_precision_;
+  }
+
+  CpuNet *Create(const std::string &frame_work) {
+    inference_.reset(CreateInferenceByName(frame_work, "model", "params",
+                                           outputs_, inputs_));
+    return dynamic_cast<CpuNet *>(inference_.get());
+  }
+
+  std::vector<std::string> outputs_{"output"};
+  std::vector<std::string> inputs_{"input"};
+  std::unique_ptr<Inference> inference_;
+
+ private:
+  bool use_cpu_inference_ = false;
+  int cpu_inference_precision_ = 0;
+};
+
+TEST_F(CpuNetTest, create_by_name) {
+  FLAGS_use_cpu_inference = false;
+  EXPECT_NE(Create("CpuNet"), nullptr);
+  EXPECT_EQ(Create("TorchNet"), nullptr);
+  EXPECT_EQ(Create("PaddleNet"), nullptr);
+
+  FLAGS_use_cpu_inference = true;
+  EXPECT_NE(Create("TorchNet"), nullptr);
+  EXPECT_NE(Create("PaddleNet"), nullptr);
+
+  inference_.reset(
+      CreateInferenceByName(common::PyTorch, "model", "", outputs_, inputs_));
+  EXPECT_NE(dynamic_cast<CpuNet *>(inference_.get()), nullptr);
+}
+
+TEST_F(CpuNetTest, precision) {
+  FLAGS_cpu_inference_precision = 2;
+  CpuNet *net = Create("CpuNet");
+  ASSERT_NE(net, nullptr);
+  EXPECT_EQ(net->precision(), CpuPrecision::kBFloat16);
+
+  // out of range values fall back to float32
+  FLAGS_cpu_inference_precision = 3;
+  net = Create("CpuNet");
+  ASSERT_NE(net, nullptr);
+  EXPECT_EQ(net->precision(), CpuPrecision::kFloat32);
+
+  FLAGS_cpu_inference_precision = -1;
+  net = Create("CpuNet");
+  ASSERT_NE(net, nullptr);
+  EXPECT_EQ(net->precision(), CpuPrecision::kFloat32);
+}
+
+TEST_F(CpuNetTest, init_missing_model) {
+  CpuNet net("/not/exist/model.pt", "", outputs_, inputs_);
+  std::map<std::string, std::vector<int>> shapes{{"input", {1, 3, 8, 8}}};
+  EXPECT_FALSE(net.Init(shapes));
+  EXPECT_EQ(net.get_blob("input"), nullptr);
+}
+
+}  // namespace inference
+}  // namespace perception
+}  // namespace apollo
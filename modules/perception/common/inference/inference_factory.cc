@@ -16,10 +16,13 @@
 
 #include "modules/perception/common/inference/inference_factory.h"
 
+#include "cyber/common/log.h"
+#include "modules/perception/common/inference/cpu/cpu_net.h"
 #include "modules/perception/common/inference/libtorch/torch_net.h"
 #include "modules/perception/common/inference/onnx/libtorch_obstacle_detector.h"
 #include "modules/perception/common/inference/onnx/onnx_single_batch_infer.h"
 #include "modules/perception/common/inference/paddlepaddle/paddle_net.h"
+#include "modules/perception/common/perception_gflags.h"
 #if GPU_PLATFORM == NVIDIA
 #include "modules/perception/common/inference/tensorrt/rt_net.h"
 #define RTNET RTNet(proto_file, weight_file, outputs, inputs)
@@ -36,6 +39,28 @@ namespace apollo {
 namespace perception {
 namespace inference {
 
+namespace {
+
+Inference *CreateCpuNet(const std::string &proto_file,
+                        const std::string &weight_file,
+                        const std::vector<std::string> &outputs,
+                        const std::vector<std::string> &inputs) {
+  CpuNet *net = new CpuNet(proto_file, weight_file, outputs, inputs);
+  net->set_num_threads(FLAGS_cpu_inference_threads);
+  const int precision = FLAGS_cpu_inference_precision;
+  if (precision < static_cast<int>(CpuPrecision::kFloat32) ||
+      precision > static_cast<int>(CpuPrecision::kBFloat16)) {
+    AERROR << "Cpu inference precision can only support 0, 1, 2, but "
+           << "received is " << precision << ", use float32.";
+    net->set_precision(CpuPrecision::kFloat32);
+  } else {
+    net->set_precision(static_cast<CpuPrecision>(precision));
+  }
+  return net;
+}
+
+}  // namespace
+
 Inference *CreateInferenceByName(const std::string &frame_work,
                                  const std::string &proto_file,
                                  const std::string &weight_file,
@@ -48,13 +73,21 @@ Inference *CreateInferenceByName(const std::string &frame_work,
     return new RTNET8;
   } else if (frame_work == "TorchNet") {
     // PyTorch just have model file, we use proto_file as model file
+    if (FLAGS_use_cpu_inference) {
+      return CreateCpuNet(proto_file, "", outputs, inputs);
+    }
     return new TorchNet(proto_file, outputs, inputs);
   } else if (frame_work == "Obstacle") {
     return new ObstacleDetector(proto_file, weight_file, outputs, inputs);
   } else if (frame_work == "Onnx") {
     return new SingleBatchInference(proto_file, outputs, inputs);
   } else if (frame_work == "PaddleNet") {
+    if (FLAGS_use_cpu_inference) {
+      return CreateCpuNet(proto_file, weight_file, outputs, inputs);
+    }
     return new PaddleNet(proto_file, weight_file, outputs, inputs);
+  } else if (frame_work == "CpuNet") {
+    return CreateCpuNet(proto_file, weight_file, outputs, inputs);
   }
   return nullptr;
 }
@@ -72,13 +105,21 @@ Inference *CreateInferenceByName(const common::Framework &frame_work,
       }
       return new RTNET8;
     case common::PyTorch:
+      if (FLAGS_use_cpu_inference) {
+        return CreateCpuNet(proto_file, "", outputs, inputs);
+      }
       return new TorchNet(proto_file, outputs, inputs);
     case common::PaddlePaddle:
+      if (FLAGS_use_cpu_inference) {
+        return CreateCpuNet(proto_file, weight_file, outputs, inputs);
+      }
       return new PaddleNet(proto_file, weight_file, outputs, inputs);
     case common::Obstacle:
       return new ObstacleDetector(proto_file, weight_file, outputs, inputs);
     case common::Onnx:
       return new SingleBatchInference(proto_file, outputs, inputs);
+    case common::Cpu:
+      return CreateCpuNet(proto_file, weight_file, outputs, inputs);
     default:
       break;
   }
@@ -37,33 +37,8 @@ PaddleNet::~PaddleNet() {}
 bool PaddleNet::Init(const std::map<std::string, std::vector<int>>& shapes) {
   paddle_infer::Config config;
   config.SetModel(model_file_, params_file_);
-
-  if (gpu_id_ >= 0) {
-    config.EnableUseGpu(MemoryPoolInitSizeMb, gpu_id_);
-  }
-
-  if (FLAGS_use_trt) {
-    paddle::AnalysisConfig::Precision precision;
-    if (FLAGS_trt_precision == 0) {
-      precision = paddle_infer::PrecisionType::kFloat32;
-    } else if (FLAGS_trt_precision == 1) {
-      precision = paddle_infer::PrecisionType::kInt8;
-    } else if (FLAGS_trt_precision == 2) {
-      precision = paddle_infer::PrecisionType::kHalf;
-    } else {
-      AERROR << "Tensorrt type can only support 0, 1, 2, but recieved is"
-             << FLAGS_trt_precision << "\n";
-      return false;
-    }
-    config.EnableTensorRtEngine(1 << 30, 1, 3, precision, FLAGS_trt_use_static,
-                                FLAGS_use_calibration);
-
-    if (FLAGS_collect_shape_info) {
-      config.CollectShapeRangeInfo(FLAGS_dynamic_shape_file);
-    }
-
-    if (FLAGS_use_dynamicshape)
-      config.EnableTunedTensorRtDynamicShape(FLAGS_dynamic_shape_file, true);
+  if (!ConfigDevice(&config)) {
+    return false;
   }
 
   config.EnableMemoryOptim();
@@ -123,7 +98,7 @@ void PaddleNet::Infer() {
   // then no copy happends after `enqueue`.
   for (const auto& name : output_names_) {
     auto blob = get_blob(name);
-    if (blob != nullptr) {
+    if (blob != nullptr && gpu_id_ >= 0) {
       blob->gpu_data();
     }
   }
@@ -154,6 +129,37 @@ void PaddleNet::Infer() {
   }
 }
 
+bool PaddleNet::ConfigDevice(paddle_infer::Config* config) {
+  if (gpu_id_ >= 0) {
+    config->EnableUseGpu(MemoryPoolInitSizeMb, gpu_id_);
+  }
+
+  if (FLAGS_use_trt) {
+    paddle::AnalysisConfig::Precision precision;
+    if (FLAGS_trt_precision == 0) {
+      precision = paddle_infer::PrecisionType::kFloat32;
+    } else if (FLAGS_trt_precision == 1) {
+      precision = paddle_infer::PrecisionType::kInt8;
+    } else if (FLAGS_trt_precision == 2) {
+      precision = paddle_infer::PrecisionType::kHalf;
+    } else {
+      AERROR << "Tensorrt type can only support 0, 1, 2, but recieved is"
+             << FLAGS_trt_precision << "\n";
+      return false;
+    }
+    config->EnableTensorRtEngine(1 << 30, 1, 3, precision,
+                                 FLAGS_trt_use_static, FLAGS_use_calibration);
+
+    if (FLAGS_collect_shape_info) {
+      config->CollectShapeRangeInfo(FLAGS_dynamic_shape_file);
+    }
+
+    if (FLAGS_use_dynamicshape)
+      config->EnableTunedTensorRtDynamicShape(FLAGS_dynamic_shape_file, true);
+  }
+  return true;
+}
+
 bool PaddleNet::shape(const std::string& name, std::vector<int>* res) {
   auto blob = get_blob(name);
   if (blob == nullptr) {
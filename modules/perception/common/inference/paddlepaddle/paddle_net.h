@@ -47,6 +47,8 @@ class PaddleNet : public Inference {
   base::BlobPtr<float> get_blob(const std::string& name) override;
 
  protected:
+  // set up the device of the predictor, gpu and tensorrt by default
+  virtual bool ConfigDevice(paddle_infer::Config* config);
   bool shape(const std::string &name, std::vector<int> *res);
   std::shared_ptr<paddle_infer::Predictor> predictor_;
 
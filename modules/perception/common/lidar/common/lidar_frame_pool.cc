@@ -21,6 +21,63 @@ namespace apollo {
 namespace perception {
 namespace lidar {
 
+LidarFramePool::LidarFramePool(const size_t capacity) : capacity_(capacity) {
+  frames_.reserve(capacity_);
+}
+
+std::shared_ptr<LidarFrame> LidarFramePool::Get() {
+  LidarFrame* frame = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!frames_.empty()) {
+      frame = frames_.back().release();
+      frames_.pop_back();
+      ++reuse_num_;
+    }
+  }
+  if (frame == nullptr) {
+    frame = new LidarFrame;
+  }
+  return std::shared_ptr<LidarFrame>(
+      frame, [this](LidarFrame* frame_ptr) { Recycle(frame_ptr); });
+}
+
+size_t LidarFramePool::RemainedNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_.size();
+}
+
+size_t LidarFramePool::ReuseNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reuse_num_;
+}
+
+void LidarFramePool::Recycle(LidarFrame* frame) {
+  // The frame is no longer referenced, so a use count of one means that
+  // nobody else can get hold of the buffer any more.
+  if (frame->cloud.use_count() > 1) {
+    frame->cloud.reset();
+  }
+  if (frame->world_cloud.use_count() > 1) {
+    frame->world_cloud.reset();
+  }
+  if (frame->hdmap_struct.use_count() > 1) {
+    frame->hdmap_struct.reset();
+  }
+  // For efficiency consideration, reset the frame before taking the mutex
+  frame->Reset();
+  frame->lidar2novatel_extrinsics = Eigen::Affine3d::Identity();
+  frame->sensor_info.Reset();
+  frame->reserve.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (frames_.size() < capacity_) {
+    frames_.emplace_back(frame);
+  } else {
+    delete frame;
+  }
+}
+
 // @brief call pool instance once to initialize memory
 __attribute__((constructor)) void LidarFramePoolInitialize() {
   LidarFramePool::Instance();
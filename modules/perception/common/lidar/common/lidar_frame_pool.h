@@ -15,22 +15,53 @@
  *****************************************************************************/
 #pragma once
 
-#include "modules/perception/common/base/concurrent_object_pool.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "modules/perception/common/lidar/common/lidar_frame.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
-struct LidarFrameInitializer {
-  void operator()(LidarFrame* frame) const { frame->Reset(); }
-};
-
 static const size_t kLidarFramePoolSize = 50;
 
-typedef base::ConcurrentObjectPool<LidarFrame, kLidarFramePoolSize,
-                                   LidarFrameInitializer>
-    LidarFramePool;
+// @brief Pool of lidar frames which are recycled once the last stage of the
+// lidar pipeline releases them. Unlike base::ConcurrentObjectPool it is
+// always enabled, since only buffers private to the frame are kept: point
+// clouds and hdmap structs still shared with downstream modules (e.g. the
+// cloud referenced by fusion's lidar_frame_supplement) are dropped instead
+// of being cleared in place.
+class LidarFramePool {
+ public:
+  // @brief the pool is never destroyed, so frames can be released safely
+  // during program exit
+  static LidarFramePool& Instance() {
+    static LidarFramePool* pool = new LidarFramePool(kLidarFramePoolSize);
+    return *pool;
+  }
+
+  // @brief get a reset frame, whose index buffers and private point clouds
+  // keep the capacity of previous frames
+  std::shared_ptr<LidarFrame> Get();
+
+  // @brief number of frames ready to be reused
+  size_t RemainedNum();
+
+  // @brief number of Get calls served by a recycled frame
+  size_t ReuseNum();
+
+ private:
+  explicit LidarFramePool(const size_t capacity);
+
+  void Recycle(LidarFrame* frame);
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<LidarFrame>> frames_;
+  size_t reuse_num_ = 0;
+};
 
 }  // namespace lidar
 }  // namespace perception
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/common/lidar/common/lidar_frame_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+TEST(LidarFramePoolTest, recycle_private_buffers) {
+  auto& pool = LidarFramePool::Instance();
+  base::PointFCloudPtr cloud;
+  {
+    auto frame = pool.Get();
+    frame->cloud = base::PointFCloudPool::Instance().Get();
+    frame->cloud->resize(100);
+    frame->roi_indices.indices.resize(100);
+    frame->timestamp = 1.0;
+    cloud = frame->cloud;
+  }
+  const size_t reuse_num = pool.ReuseNum();
+  EXPECT_GE(pool.RemainedNum(), 1);
+
+  auto frame = pool.Get();
+  EXPECT_EQ(reuse_num + 1, pool.ReuseNum());
+  EXPECT_DOUBLE_EQ(0.0, frame->timestamp);
+  EXPECT_TRUE(frame->roi_indices.indices.empty());
+  // the cloud was still referenced when the frame was released, so it must
+  // neither be cleared nor kept by the recycled frame
+  EXPECT_EQ(nullptr, frame->cloud);
+  EXPECT_EQ(100, cloud->size());
+
+  frame->cloud = base::PointFCloudPool::Instance().Get();
+  frame->cloud->resize(10);
+  auto* private_cloud = frame->cloud.get();
+  frame.reset();
+  frame = pool.Get();
+  EXPECT_EQ(private_cloud, frame->cloud.get());
+  EXPECT_EQ(0, frame->cloud->size());
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
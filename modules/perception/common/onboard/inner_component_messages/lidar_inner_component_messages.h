@@ -15,7 +15,10 @@
  *****************************************************************************/
 #pragma once
 
+#include <array>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "cyber/cyber.h"
@@ -27,6 +30,15 @@ namespace apollo {
 namespace perception {
 namespace onboard {
 
+// @brief processing time of one stage of the lidar pipeline
+struct LidarStageLatency {
+  const char* stage = "";
+  double start_time = 0.0;
+  double end_time = 0.0;
+};
+
+static const size_t kMaxLidarStageNum = 8;
+
 class LidarFrameMessage {
  public:
   LidarFrameMessage() : lidar_frame_(nullptr) {
@@ -39,6 +51,40 @@ class LidarFrameMessage {
 
   LidarFrameMessage* New() const { return new LidarFrameMessage; }
 
+  // @brief record the processing interval of a stage, in seconds. Stages
+  // run one after another on the same message, which is handed over by
+  // pointer, so it must be called before writing the message downstream.
+  void AddStageLatency(const char* stage, const double start_time,
+                       const double end_time) {
+    if (stage_num_ >= kMaxLidarStageNum) {
+      return;
+    }
+    auto& latency = stage_latencies_[stage_num_++];
+    latency.stage = stage;
+    latency.start_time = start_time;
+    latency.end_time = end_time;
+  }
+
+  // @brief per stage processing and handover time in milliseconds, the
+  // first handover is measured from the lidar timestamp
+  std::string StageLatencyDebugString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    double last_end_time = timestamp_;
+    double total_proc_time = 0.0;
+    for (size_t i = 0; i < stage_num_; ++i) {
+      const auto& latency = stage_latencies_[i];
+      const double proc_time = (latency.end_time - latency.start_time) * 1e3;
+      oss << latency.stage << "[proc:" << proc_time
+          << ",wait:" << (latency.start_time - last_end_time) * 1e3 << "]:";
+      total_proc_time += proc_time;
+      last_end_time = latency.end_time;
+    }
+    oss << "total[proc:" << total_proc_time
+        << ",latency:" << (last_end_time - timestamp_) * 1e3 << "]";
+    return oss.str();
+  }
+
  public:
   double timestamp_ = 0.0;
   uint64_t lidar_timestamp_ = 0;
@@ -47,6 +93,8 @@ class LidarFrameMessage {
   ProcessStage process_stage_ = ProcessStage::UNKNOWN_STAGE;
   apollo::common::ErrorCode error_code_ = apollo::common::ErrorCode::OK;
   std::shared_ptr<lidar::LidarFrame> lidar_frame_;
+  std::array<LidarStageLatency, kMaxLidarStageNum> stage_latencies_;
+  size_t stage_num_ = 0;
 };
 
 }  // namespace onboard
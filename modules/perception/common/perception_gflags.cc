@@ -86,6 +86,16 @@ DEFINE_string(dynamic_shape_file,
               "center_point_paddle/collect_shape_info_3lidar_20.pbtxt",
               "Path of a dynamic shape file for tensorrt");
 
+// cpu inference
+DEFINE_bool(use_cpu_inference, false,
+            "True if run PyTorch and PaddlePaddle models on cpu inference.");
+DEFINE_int32(cpu_inference_threads, 0,
+             "Number of threads of cpu inference, 0 means the library "
+             "default. The libtorch thread pool is process-wide.");
+DEFINE_int32(cpu_inference_precision, 0,
+             "Precision type of cpu inference, 0: kFloat32, 1: kInt8, "
+             "2: kBFloat16");
+
 // scene manager
 DEFINE_string(scene_manager_file, "scene_manager.conf",
               "scene manager config file");
@@ -53,6 +53,11 @@ DECLARE_bool(use_dynamicshape);
 DECLARE_bool(collect_shape_info);
 DECLARE_string(dynamic_shape_file);
 
+// cpu inference
+DECLARE_bool(use_cpu_inference);
+DECLARE_int32(cpu_inference_threads);
+DECLARE_int32(cpu_inference_precision);
+
 DECLARE_string(object_template_file);
 
 DECLARE_int32(hdmap_sample_step);
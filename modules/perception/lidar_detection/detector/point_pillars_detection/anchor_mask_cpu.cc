@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/anchor_mask_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/cpu_parallel.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+AnchorMaskCpu::AnchorMaskCpu(const int num_threads, const int num_inds_for_scan,
+                             const int num_anchor, const float min_x_range,
+                             const float min_y_range, const float pillar_x_size,
+                             const float pillar_y_size, const int grid_x_size,
+                             const int grid_y_size)
+    : num_threads_(num_threads),
+      num_inds_for_scan_(num_inds_for_scan),
+      num_anchor_(num_anchor),
+      min_x_range_(min_x_range),
+      min_y_range_(min_y_range),
+      pillar_x_size_(pillar_x_size),
+      pillar_y_size_(pillar_y_size),
+      grid_x_size_(grid_x_size),
+      grid_y_size_(grid_y_size),
+      cumsum_(num_inds_for_scan * num_inds_for_scan) {}
+
+void AnchorMaskCpu::DoAnchorMaskCpu(const float* sparse_pillar_map,
+                                    const float* box_anchors_min_x,
+                                    const float* box_anchors_min_y,
+                                    const float* box_anchors_max_x,
+                                    const float* box_anchors_max_y,
+                                    int* anchor_mask) {
+  const int n = num_inds_for_scan_;
+  int* cumsum = cumsum_.data();
+
+  // inclusive scan along x, one row per task
+  ParallelFor(num_threads_, 0, n, [&](const int begin, const int end) {
+    for (int y = begin; y < end; ++y) {
+      const float* in_row = sparse_pillar_map + y * n;
+      int* out_row = cumsum + y * n;
+      int sum = 0;
+      for (int x = 0; x < n; ++x) {
+        sum += static_cast<int>(in_row[x]);
+        out_row[x] = sum;
+      }
+    }
+  });
+
+  // inclusive scan along y, columns are split between tasks and the rows
+  // are added in order so the inner loop is contiguous
+  ParallelFor(num_threads_, 0, n, [&](const int begin, const int end) {
+    for (int y = 1; y < n; ++y) {
+      int* row = cumsum + y * n;
+      const int* prev_row = row - n;
+      for (int x = begin; x < end; ++x) {
+        row[x] += prev_row[x];
+      }
+    }
+  });
+
+  const int grid_x_size_1 = grid_x_size_ - 1;
+  const int grid_y_size_1 = grid_y_size_ - 1;
+  ParallelFor(num_threads_, 0, num_anchor_, [&](const int begin,
+                                                const int end) {
+    for (int i = begin; i < end; ++i) {
+      int min_x = std::floor((box_anchors_min_x[i] - min_x_range_) /
+                             pillar_x_size_);
+      int min_y = std::floor((box_anchors_min_y[i] - min_y_range_) /
+                             pillar_y_size_);
+      int max_x = std::floor((box_anchors_max_x[i] - min_x_range_) /
+                             pillar_x_size_);
+      int max_y = std::floor((box_anchors_max_y[i] - min_y_range_) /
+                             pillar_y_size_);
+      min_x = std::max(min_x, 0);
+      min_y = std::max(min_y, 0);
+      max_x = std::min(max_x, grid_x_size_1);
+      max_y = std::min(max_y, grid_y_size_1);
+
+      const int right_top = cumsum[max_y * n + max_x];
+      const int left_bottom = cumsum[min_y * n + min_x];
+      const int left_top = cumsum[max_y * n + min_x];
+      const int right_bottom = cumsum[min_y * n + max_x];
+      const int area = right_top - left_top - right_bottom + left_bottom;
+      anchor_mask[i] = area > 1 ? 1 : 0;
+    }
+  });
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
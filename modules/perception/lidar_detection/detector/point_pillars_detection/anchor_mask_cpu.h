@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+/**
+ * @file anchor_mask_cpu.h
+ * @brief Make anchor mask for filtering output on CPU
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+class AnchorMaskCpu {
+ private:
+  const int num_threads_;
+  const int num_inds_for_scan_;
+  const int num_anchor_;
+  const float min_x_range_;
+  const float min_y_range_;
+  const float pillar_x_size_;
+  const float pillar_y_size_;
+  const int grid_x_size_;
+  const int grid_y_size_;
+
+  // summed area table of the sparse pillar map, reused between frames
+  std::vector<int> cumsum_;
+
+ public:
+  /**
+   * @brief Constructor
+   * @param[in] num_threads Number of cpu threads
+   * @param[in] num_inds_for_scan Number of indexes for scan(cumsum)
+   * @param[in] num_anchor Number of anchors in total
+   * @param[in] min_x_range Minimum x value for point cloud
+   * @param[in] min_y_range Minimum y value for point cloud
+   * @param[in] pillar_x_size Size of x-dimension for a pillar
+   * @param[in] pillar_y_size Size of y-dimension for a pillar
+   * @param[in] grid_x_size Number of pillars in x-coordinate
+   * @param[in] grid_y_size Number of pillars in y-coordinate
+   */
+  AnchorMaskCpu(const int num_threads, const int num_inds_for_scan,
+                const int num_anchor, const float min_x_range,
+                const float min_y_range, const float pillar_x_size,
+                const float pillar_y_size, const int grid_x_size,
+                const int grid_y_size);
+
+  /**
+   * @brief Make anchor mask, same result as AnchorMaskCuda
+   * @param[in] sparse_pillar_map Grid map representation for pillar occupancy
+   * @param[in] box_anchors_min_x Array for storing min x value for each anchor
+   * @param[in] box_anchors_min_y Array for storing min y value for each anchor
+   * @param[in] box_anchors_max_x Array for storing max x value for each anchor
+   * @param[in] box_anchors_max_y Array for storing max y value for each anchor
+   * @param[out] anchor_mask Anchor mask for filtering the network output
+   */
+  void DoAnchorMaskCpu(const float* sparse_pillar_map,
+                       const float* box_anchors_min_x,
+                       const float* box_anchors_min_y,
+                       const float* box_anchors_max_x,
+                       const float* box_anchors_max_y, int* anchor_mask);
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include "cyber/task/task.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+/**
+ * @brief Split [begin, end) into at most num_threads contiguous chunks and
+ * call func(chunk_begin, chunk_end) on each of them, the calling thread
+ * processes the first chunk
+ * @details Chunks are fixed by the range and num_threads only, so any
+ * per chunk reduction done by the caller is deterministic
+ */
+template <typename Func>
+void ParallelFor(const int num_threads, const int begin, const int end,
+                 const Func& func) {
+  const int size = end - begin;
+  if (size <= 0) {
+    return;
+  }
+  const int num_chunks = std::max(1, std::min(num_threads, size));
+  const int chunk_size = (size + num_chunks - 1) / num_chunks;
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_chunks - 1);
+  for (int chunk_begin = begin + chunk_size; chunk_begin < end;
+       chunk_begin += chunk_size) {
+    futures.emplace_back(cyber::Async(
+        func, chunk_begin, std::min(end, chunk_begin + chunk_size)));
+  }
+  func(begin, std::min(end, begin + chunk_size));
+  for (auto& future : futures) {
+    future.wait();
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
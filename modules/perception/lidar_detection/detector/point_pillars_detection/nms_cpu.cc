@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/nms_cpu.h"
+
+#include <algorithm>
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/cpu_parallel.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+namespace {
+
+constexpr int kBlockBits = 64;
+
+// same as devIoU in nms_cuda.cu
+inline float IoU(const float* a, const float* b) {
+  float left = std::max(a[0], b[0]), right = std::min(a[2], b[2]);
+  float top = std::max(a[1], b[1]), bottom = std::min(a[3], b[3]);
+  float width = std::max(right - left + 1, 0.f);
+  float height = std::max(bottom - top + 1, 0.f);
+  float interS = width * height;
+  float Sa = (a[2] - a[0] + 1) * (a[3] - a[1] + 1);
+  float Sb = (b[2] - b[0] + 1) * (b[3] - b[1] + 1);
+  return interS / (Sa + Sb - interS);
+}
+
+}  // namespace
+
+NmsCpu::NmsCpu(const int num_threads, const int num_box_corners,
+               const float nms_overlap_threshold)
+    : num_threads_(num_threads),
+      num_box_corners_(num_box_corners),
+      nms_overlap_threshold_(nms_overlap_threshold) {}
+
+void NmsCpu::DoNmsCpu(const int host_filter_count,
+                      const float* sorted_box_for_nms, int* out_keep_inds,
+                      int* out_num_to_keep) {
+  const int col_blocks = (host_filter_count + kBlockBits - 1) / kBlockBits;
+  mask_.resize(static_cast<size_t>(host_filter_count) * col_blocks);
+  uint64_t* mask = mask_.data();
+
+  // only boxes behind the current one can be suppressed by it
+  ParallelFor(num_threads_, 0, host_filter_count, [&](const int begin,
+                                                      const int end) {
+    for (int i = begin; i < end; ++i) {
+      const float* cur_box = sorted_box_for_nms + i * num_box_corners_;
+      uint64_t* row = mask + static_cast<size_t>(i) * col_blocks;
+      std::fill(row + i / kBlockBits, row + col_blocks, 0);
+      for (int j = i + 1; j < host_filter_count; ++j) {
+        if (IoU(cur_box, sorted_box_for_nms + j * num_box_corners_) >
+            nms_overlap_threshold_) {
+          row[j / kBlockBits] |= 1ULL << (j % kBlockBits);
+        }
+      }
+    }
+  });
+
+  remv_.assign(col_blocks, 0);
+  for (int i = 0; i < host_filter_count; ++i) {
+    const int nblock = i / kBlockBits;
+    const int inblock = i % kBlockBits;
+    if (!(remv_[nblock] & (1ULL << inblock))) {
+      out_keep_inds[(*out_num_to_keep)++] = i;
+      const uint64_t* p = mask + static_cast<size_t>(i) * col_blocks;
+      for (int j = nblock; j < col_blocks; ++j) {
+        remv_[j] |= p[j];
+      }
+    }
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+/**
+ * @file nms_cpu.h
+ * @brief Non-Maximum Suppresion on CPU
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+class NmsCpu {
+ private:
+  const int num_threads_;
+  const int num_box_corners_;
+  const float nms_overlap_threshold_;
+
+  // overlap bit mask, one row of 64 bit blocks per box
+  std::vector<uint64_t> mask_;
+  std::vector<uint64_t> remv_;
+
+ public:
+  /**
+   * @brief Constructor
+   * @param[in] num_threads Number of cpu threads
+   * @param[in] num_box_corners Number of corners for 2D box
+   * @param[in] nms_overlap_threshold IOU threshold for NMS
+   */
+  NmsCpu(const int num_threads, const int num_box_corners,
+         const float nms_overlap_threshold);
+
+  /**
+   * @brief CPU Non-Maximum Suppresion, same result as NmsCuda
+   * @param[in] host_filter_count Number of filtered output
+   * @param[in] sorted_box_for_nms Bounding box output sorted by score
+   * @param[out] out_keep_inds Indexes of selected bounding box
+   * @param[out] out_num_to_keep Number of kept bounding boxes
+   * @details The overlap mask is built in parallel, the greedy selection
+   * over the mask is sequential
+   */
+  void DoNmsCpu(const int host_filter_count, const float* sorted_box_for_nms,
+                int* out_keep_inds, int* out_num_to_keep);
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -103,12 +103,40 @@ PointPillars::PointPillars(const bool reproduce_result_mode,
                            const float score_threshold,
                            const float nms_overlap_threshold,
                            const common::Framework& model_type,
-                           const std::string& model_file)
+                           const std::string& model_file,
+                           const bool use_cpu, const int num_cpu_threads)
     : reproduce_result_mode_(reproduce_result_mode),
       score_threshold_(score_threshold),
       nms_overlap_threshold_(nms_overlap_threshold),
       model_type_(model_type),
-      model_file_(model_file) {
+      model_file_(model_file),
+      use_cpu_(use_cpu),
+      num_cpu_threads_(std::max(num_cpu_threads, 1)) {
+  if (use_cpu_) {
+    preprocess_points_ptr_.reset(new PreprocessPoints(
+        kMaxNumPillars, kMaxNumPointsPerPillar, kNumPointFeature, kGridXSize,
+        kGridYSize, kGridZSize, kPillarXSize, kPillarYSize, kPillarZSize,
+        kMinXRange, kMinYRange, kMinZRange, kNumIndsForScan));
+    preprocess_points_ptr_->set_num_threads(num_cpu_threads_);
+    anchor_mask_cpu_ptr_.reset(new AnchorMaskCpu(
+        num_cpu_threads_, kNumIndsForScan, kNumAnchor, kMinXRange, kMinYRange,
+        kPillarXSize, kPillarYSize, kGridXSize, kGridYSize));
+    postprocess_cpu_ptr_.reset(new PostprocessCpu(
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::max(), kNumAnchor, kNumClass,
+        score_threshold_, num_cpu_threads_, nms_overlap_threshold_,
+        kNumBoxCorners, kNumOutputBoxFeature));
+
+    host_x_coors_.resize(kMaxNumPillars);
+    host_y_coors_.resize(kMaxNumPillars);
+    host_sparse_pillar_map_.resize(kNumIndsForScan * kNumIndsForScan);
+    host_anchor_mask_.resize(kNumAnchor);
+
+    InitTorch();
+    InitAnchors();
+    return;
+  }
+
   if (reproduce_result_mode_) {
     preprocess_points_ptr_.reset(new PreprocessPoints(
         kMaxNumPillars, kMaxNumPointsPerPillar, kNumPointFeature, kGridXSize,
@@ -150,6 +178,10 @@ PointPillars::~PointPillars() {
   delete[] box_anchors_max_x_;
   delete[] box_anchors_max_y_;
 
+  if (use_cpu_) {
+    return;
+  }
+
   GPU_CHECK(cudaFree(dev_x_coors_));
   GPU_CHECK(cudaFree(dev_y_coors_));
   GPU_CHECK(cudaFree(dev_num_points_per_pillar_));
@@ -293,7 +325,9 @@ void PointPillars::InitAnchors() {
                             box_anchors_min_y_, box_anchors_max_x_,
                             box_anchors_max_y_);
 
-  PutAnchorsInDeviceMemory();
+  if (!use_cpu_) {
+    PutAnchorsInDeviceMemory();
+  }
 }
 
 void PointPillars::GenerateAnchors(float* anchors_px_, float* anchors_py_,
@@ -445,8 +479,13 @@ void PointPillars::ConvertAnchors2BoxAnchors(float* anchors_px,
 
 void PointPillars::InitTorch() {
   // Init inference and data shape
-  inference_.reset(inference::CreateInferenceByName(
-      model_type_, model_file_, "", output_blob_names_, input_blob_names_));
+  if (use_cpu_) {
+    inference_.reset(inference::CreateInferenceByName(
+        "CpuNet", model_file_, "", output_blob_names_, input_blob_names_));
+  } else {
+    inference_.reset(inference::CreateInferenceByName(
+        model_type_, model_file_, "", output_blob_names_, input_blob_names_));
+  }
   CHECK_NOTNULL(inference_.get());
 
   std::map<std::string, std::vector<int>> shape_map;
@@ -625,6 +664,11 @@ void PointPillars::DoInference(const float* in_points_array,
                                const int in_num_points,
                                std::vector<float>* out_detections,
                                std::vector<int>* out_labels) {
+  if (use_cpu_) {
+    DoInferenceCPU(in_points_array, in_num_points, out_detections, out_labels);
+    return;
+  }
+
   if (device_id_ < 0) {
     AERROR << "Torch is not using GPU!";
     return;
@@ -677,6 +721,39 @@ void PointPillars::DoInference(const float* in_points_array,
   cudaStreamDestroy(stream);
 }
 
+void PointPillars::DoInferenceCPU(const float* in_points_array,
+                                  const int in_num_points,
+                                  std::vector<float>* out_detections,
+                                  std::vector<int>* out_labels) {
+  auto pillar_point_feature = inference_->get_blob(input_blob_names_.at(0));
+  auto points_per_pillar = inference_->get_blob(input_blob_names_.at(1));
+  auto pillar_coors = inference_->get_blob(input_blob_names_.at(2));
+
+  float* num_points_per_pillar = points_per_pillar->mutable_cpu_data();
+  std::fill(num_points_per_pillar, num_points_per_pillar + kMaxNumPillars, 0);
+  preprocess_points_ptr_->Preprocess(
+      in_points_array, in_num_points, host_x_coors_.data(),
+      host_y_coors_.data(), num_points_per_pillar,
+      pillar_point_feature->mutable_cpu_data(),
+      pillar_coors->mutable_cpu_data(), host_sparse_pillar_map_.data(),
+      host_pillar_count_);
+
+  anchor_mask_cpu_ptr_->DoAnchorMaskCpu(
+      host_sparse_pillar_map_.data(), box_anchors_min_x_, box_anchors_min_y_,
+      box_anchors_max_x_, box_anchors_max_y_, host_anchor_mask_.data());
+
+  inference_->Infer();
+
+  auto cls_score = inference_->get_blob(output_blob_names_.at(0));
+  auto bbox_pred = inference_->get_blob(output_blob_names_.at(1));
+  auto dir_cls_preds = inference_->get_blob(output_blob_names_.at(2));
+  postprocess_cpu_ptr_->DoPostprocessCpu(
+      bbox_pred->cpu_data(), cls_score->cpu_data(), dir_cls_preds->cpu_data(),
+      host_anchor_mask_.data(), anchors_px_, anchors_py_, anchors_pz_,
+      anchors_dx_, anchors_dy_, anchors_dz_, anchors_ro_, out_detections,
+      out_labels);
+}
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
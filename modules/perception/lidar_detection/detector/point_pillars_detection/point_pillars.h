@@ -60,9 +60,11 @@
 // headers in local files
 #include "modules/perception/common/inference/inference.h"
 #include "modules/perception/common/inference/inference_factory.h"
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/anchor_mask_cpu.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/anchor_mask_cuda.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/common.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/params.h"
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/postprocess_cpu.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/postprocess_cuda.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/preprocess_points.h"
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/preprocess_points_cuda.h"
@@ -164,6 +166,8 @@ class PointPillars {
   const std::string rpn_onnx_file_;
   const common::Framework& model_type_;
   const std::string model_file_;
+  const bool use_cpu_;
+  const int num_cpu_threads_;
   // end initializer list
 
   int host_pillar_count_[1];
@@ -220,6 +224,14 @@ class PointPillars {
   std::unique_ptr<PreprocessPointsCuda> preprocess_points_cuda_ptr_;
   std::unique_ptr<AnchorMaskCuda> anchor_mask_cuda_ptr_;
   std::unique_ptr<PostprocessCuda> postprocess_cuda_ptr_;
+  std::unique_ptr<AnchorMaskCpu> anchor_mask_cpu_ptr_;
+  std::unique_ptr<PostprocessCpu> postprocess_cpu_ptr_;
+
+  // host buffers of the cpu path
+  std::vector<int> host_x_coors_;
+  std::vector<int> host_y_coors_;
+  std::vector<float> host_sparse_pillar_map_;
+  std::vector<int> host_anchor_mask_;
 
   Logger g_logger_;
   nvinfer1::ICudaEngine* pfe_engine_;
@@ -321,6 +333,19 @@ class PointPillars {
    */
   void PreprocessGPU(const float* in_points_array, const int in_num_points);
 
+  /**
+   * @brief Run all stages on CPU
+   * @param[in] in_points_array Point cloud array
+   * @param[in] in_num_points Number of points
+   * @param[out] out_detections Network output bounding box
+   * @param[out] out_labels Network output object's label
+   * @details Preprocess writes directly into the input blobs of the network,
+   * the output is reproducible for the same input
+   */
+  void DoInferenceCPU(const float* in_points_array, const int in_num_points,
+                      std::vector<float>* out_detections,
+                      std::vector<int>* out_labels);
+
   /**
    * @brief Convert anchors to box form like min_x, min_y, max_x, max_y anchors
    * @param[in] anchors_px_
@@ -358,13 +383,17 @@ class PointPillars {
    * @param[in] nms_overlap_threshold IOU threshold for NMS
    * @param[in] model_type Pillar Model type
    * @param[in] model_file Pillar Model file path
+   * @param[in] use_cpu Boolean, if true, all stages run on CPU
+   * @param[in] num_cpu_threads Number of threads of the CPU stages
    * @details Variables could be changed through point_pillars_detection
    */
   PointPillars(const bool reproduce_result_mode,
                const float score_threshold,
                const float nms_overlap_threshold,
                const common::Framework& model_type,
-               const std::string& model_file);
+               const std::string& model_file,
+               const bool use_cpu = false,
+               const int num_cpu_threads = 1);
 
   /**
    * @brief Destroy the Point Pillars object
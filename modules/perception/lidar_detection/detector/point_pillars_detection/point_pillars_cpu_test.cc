@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/anchor_mask_cpu.h"
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/nms_cpu.h"
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/preprocess_points.h"
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/scatter_cpu.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+TEST(PointPillarsCpuTest, anchor_mask_matches_brute_force) {
+  const int num_inds_for_scan = 16;
+  const int grid_size = 12;
+  const float pillar_size = 1.0f;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> occupied(0, 3);
+  std::vector<float> sparse_pillar_map(num_inds_for_scan * num_inds_for_scan);
+  for (int y = 0; y < grid_size; ++y) {
+    for (int x = 0; x < grid_size; ++x) {
+      sparse_pillar_map[y * num_inds_for_scan + x] = occupied(rng) == 0;
+    }
+  }
+
+  std::uniform_real_distribution<float> coor(-2.0f, 14.0f);
+  const int num_anchor = 200;
+  std::vector<float> min_x(num_anchor), min_y(num_anchor);
+  std::vector<float> max_x(num_anchor), max_y(num_anchor);
+  for (int i = 0; i < num_anchor; ++i) {
+    min_x[i] = coor(rng);
+    min_y[i] = coor(rng);
+    max_x[i] = min_x[i] + 3.0f;
+    max_y[i] = min_y[i] + 2.0f;
+  }
+
+  AnchorMaskCpu anchor_mask_cpu(3, num_inds_for_scan, num_anchor, 0.0f, 0.0f,
+                                pillar_size, pillar_size, grid_size,
+                                grid_size);
+  std::vector<int> anchor_mask(num_anchor, -1);
+  anchor_mask_cpu.DoAnchorMaskCpu(sparse_pillar_map.data(), min_x.data(),
+                                  min_y.data(), max_x.data(), max_y.data(),
+                                  anchor_mask.data());
+
+  for (int i = 0; i < num_anchor; ++i) {
+    const int x0 = std::max(static_cast<int>(std::floor(min_x[i])), 0);
+    const int y0 = std::max(static_cast<int>(std::floor(min_y[i])), 0);
+    const int x1 =
+        std::min(static_cast<int>(std::floor(max_x[i])), grid_size - 1);
+    const int y1 =
+        std::min(static_cast<int>(std::floor(max_y[i])), grid_size - 1);
+    // same half open area as the summed area table lookup
+    int area = 0;
+    for (int y = y0 + 1; y <= y1; ++y) {
+      for (int x = x0 + 1; x <= x1; ++x) {
+        area += static_cast<int>(sparse_pillar_map[y * num_inds_for_scan + x]);
+      }
+    }
+    EXPECT_EQ(area > 1 ? 1 : 0, anchor_mask[i]) << "anchor " << i;
+  }
+}
+
+TEST(PointPillarsCpuTest, nms_matches_greedy) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> center(0.0f, 30.0f);
+  std::uniform_real_distribution<float> size(1.0f, 5.0f);
+  const int num_boxes = 150;
+  std::vector<float> boxes(num_boxes * 4);
+  for (int i = 0; i < num_boxes; ++i) {
+    const float cx = center(rng);
+    const float cy = center(rng);
+    const float half = size(rng) / 2;
+    boxes[i * 4 + 0] = cx - half;
+    boxes[i * 4 + 1] = cy - half;
+    boxes[i * 4 + 2] = cx + half;
+    boxes[i * 4 + 3] = cy + half;
+  }
+
+  const float threshold = 0.3f;
+  auto iou = [&boxes](const int a, const int b) {
+    const float* p = &boxes[a * 4];
+    const float* q = &boxes[b * 4];
+    float w = std::max(std::min(p[2], q[2]) - std::max(p[0], q[0]) + 1, 0.f);
+    float h = std::max(std::min(p[3], q[3]) - std::max(p[1], q[1]) + 1, 0.f);
+    float inter = w * h;
+    float sa = (p[2] - p[0] + 1) * (p[3] - p[1] + 1);
+    float sb = (q[2] - q[0] + 1) * (q[3] - q[1] + 1);
+    return inter / (sa + sb - inter);
+  };
+  std::vector<int> expected;
+  std::vector<bool> removed(num_boxes, false);
+  for (int i = 0; i < num_boxes; ++i) {
+    if (removed[i]) {
+      continue;
+    }
+    expected.push_back(i);
+    for (int j = i + 1; j < num_boxes; ++j) {
+      if (iou(i, j) > threshold) {
+        removed[j] = true;
+      }
+    }
+  }
+
+  NmsCpu nms_cpu(4, 4, threshold);
+  std::vector<int> keep_inds(num_boxes);
+  int num_to_keep = 0;
+  nms_cpu.DoNmsCpu(num_boxes, boxes.data(), keep_inds.data(), &num_to_keep);
+  keep_inds.resize(num_to_keep);
+  EXPECT_EQ(expected, keep_inds);
+}
+
+TEST(PointPillarsCpuTest, preprocess_independent_of_threads) {
+  const int max_num_pillars = 64;
+  const int max_points_per_pillar = 4;
+  const int num_point_feature = 5;
+  const int grid_size = 16;
+  const int num_inds_for_scan = 16;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> coor(-1.0f, 17.0f);
+  const int num_points = 1000;
+  std::vector<float> points(num_points * num_point_feature);
+  for (auto& value : points) {
+    value = coor(rng);
+  }
+
+  auto run = [&](const int num_threads, std::vector<float>* feature,
+                 std::vector<float>* num_points_per_pillar,
+                 std::vector<float>* coors, std::vector<float>* sparse_map,
+                 int* pillar_count) {
+    PreprocessPoints preprocess(max_num_pillars, max_points_per_pillar,
+                                num_point_feature, grid_size, grid_size, 1,
+                                1.0f, 1.0f, 20.0f, 0.0f, 0.0f, -1.0f,
+                                num_inds_for_scan);
+    preprocess.set_num_threads(num_threads);
+    std::vector<int> x_coors(max_num_pillars), y_coors(max_num_pillars);
+    feature->assign(
+        max_num_pillars * max_points_per_pillar * num_point_feature, -1);
+    num_points_per_pillar->assign(max_num_pillars, 0);
+    coors->assign(max_num_pillars * 4, -1);
+    sparse_map->assign(num_inds_for_scan * num_inds_for_scan, -1);
+    preprocess.Preprocess(points.data(), num_points, x_coors.data(),
+                          y_coors.data(), num_points_per_pillar->data(),
+                          feature->data(), coors->data(), sparse_map->data(),
+                          pillar_count);
+  };
+
+  std::vector<float> feature_1, num_1, coors_1, map_1;
+  std::vector<float> feature_4, num_4, coors_4, map_4;
+  int count_1 = 0;
+  int count_4 = 0;
+  run(1, &feature_1, &num_1, &coors_1, &map_1, &count_1);
+  run(4, &feature_4, &num_4, &coors_4, &map_4, &count_4);
+  EXPECT_EQ(max_num_pillars, count_1);
+  EXPECT_EQ(count_1, count_4);
+  EXPECT_EQ(feature_1, feature_4);
+  EXPECT_EQ(num_1, num_4);
+  EXPECT_EQ(coors_1, coors_4);
+  EXPECT_EQ(map_1, map_4);
+}
+
+TEST(PointPillarsCpuTest, scatter) {
+  const int num_features = 3;
+  const int grid_size = 4;
+  std::vector<int> x_coors = {0, 3, 2};
+  std::vector<int> y_coors = {1, 0, 3};
+  std::vector<float> pfe_output(x_coors.size() * num_features);
+  for (size_t i = 0; i < pfe_output.size(); ++i) {
+    pfe_output[i] = static_cast<float>(i + 1);
+  }
+  std::vector<float> scattered(num_features * grid_size * grid_size, 0);
+  ScatterCpu scatter_cpu(2, num_features, grid_size, grid_size);
+  scatter_cpu.DoScatterCpu(static_cast<int>(x_coors.size()), x_coors.data(),
+                           y_coors.data(), pfe_output.data(),
+                           scattered.data());
+  for (size_t p = 0; p < x_coors.size(); ++p) {
+    for (int f = 0; f < num_features; ++f) {
+      EXPECT_EQ(pfe_output[p * num_features + f],
+                scattered[f * grid_size * grid_size +
+                          y_coors[p] * grid_size + x_coors[p]]);
+    }
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -61,7 +61,9 @@ bool PointPillarsDetection::Init(const LidarDetectorInitOptions& options) {
                        param_.postprocess().score_threshold(),
                        param_.postprocess().nms_overlap_threshold(),
                        model_info.framework(),
-                       weight_file));
+                       weight_file,
+                       param_.use_cpu(),
+                       param_.num_cpu_threads()));
 
   if (param_.preprocess().enable_ground_removal()) {
     z_min_ = std::max(z_min_,
@@ -95,7 +97,8 @@ bool PointPillarsDetection::Detect(const LidarDetectorOptions& options,
   // check output
   frame->segmented_objects.clear();
 
-  if (cudaSetDevice(param_.preprocess().gpu_id()) != cudaSuccess) {
+  if (!param_.use_cpu() &&
+      cudaSetDevice(param_.preprocess().gpu_id()) != cudaSuccess) {
     AERROR << "Failed to set device to gpu " << param_.preprocess().gpu_id();
     return false;
   }
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/postprocess_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/cpu_parallel.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+namespace {
+
+// sigmoid of the class scores, returns the top score and its label
+inline float TopScore(const float* cls_preds, const int num_class,
+                      int* top_label) {
+  float top_score = 0;
+  *top_label = 0;
+  for (int i = 0; i < num_class; ++i) {
+    float score = 1 / (1 + std::exp(-cls_preds[i]));
+    if (score > top_score) {
+      top_score = score;
+      *top_label = i;
+    }
+  }
+  return top_score;
+}
+
+}  // namespace
+
+PostprocessCpu::PostprocessCpu(const float float_min, const float float_max,
+                               const int num_anchor, const int num_class,
+                               const float score_threshold,
+                               const int num_threads,
+                               const float nms_overlap_threshold,
+                               const int num_box_corners,
+                               const int num_output_box_feature)
+    : float_min_(float_min),
+      float_max_(float_max),
+      num_anchor_(num_anchor),
+      num_class_(num_class),
+      score_threshold_(score_threshold),
+      num_threads_(num_threads),
+      num_box_corners_(num_box_corners),
+      num_output_box_feature_(num_output_box_feature),
+      anchor_kept_(num_anchor) {
+  nms_cpu_ptr_.reset(
+      new NmsCpu(num_threads, num_box_corners, nms_overlap_threshold));
+}
+
+void PostprocessCpu::DoPostprocessCpu(
+    const float* rpn_box_output, const float* rpn_cls_output,
+    const float* rpn_dir_output, const int* anchor_mask,
+    const float* anchors_px, const float* anchors_py, const float* anchors_pz,
+    const float* anchors_dx, const float* anchors_dy, const float* anchors_dz,
+    const float* anchors_ro, std::vector<float>* out_detection,
+    std::vector<int>* out_label) {
+  // score every anchor
+  uint8_t* anchor_kept = anchor_kept_.data();
+  ParallelFor(num_threads_, 0, num_anchor_, [&](const int begin,
+                                                const int end) {
+    int top_label = 0;
+    for (int i = begin; i < end; ++i) {
+      anchor_kept[i] =
+          anchor_mask[i] == 1 &&
+          TopScore(rpn_cls_output + i * num_class_, num_class_, &top_label) >
+              score_threshold_;
+    }
+  });
+
+  // compact in anchor order, then sort by score
+  filtered_anchor_.clear();
+  for (int i = 0; i < num_anchor_; ++i) {
+    if (anchor_kept[i]) {
+      filtered_anchor_.push_back(i);
+    }
+  }
+  const int filter_count = static_cast<int>(filtered_anchor_.size());
+  if (filter_count == 0) {
+    return;
+  }
+  filtered_score_.resize(filter_count);
+  int top_label = 0;
+  for (int i = 0; i < filter_count; ++i) {
+    filtered_score_[i] =
+        TopScore(rpn_cls_output + filtered_anchor_[i] * num_class_, num_class_,
+                 &top_label);
+  }
+  sorted_index_.resize(filter_count);
+  std::iota(sorted_index_.begin(), sorted_index_.end(), 0);
+  std::stable_sort(sorted_index_.begin(), sorted_index_.end(),
+                   [this](const int lhs, const int rhs) {
+                     return filtered_score_[lhs] > filtered_score_[rhs];
+                   });
+
+  // decode the sorted boxes
+  sorted_box_.resize(filter_count * num_output_box_feature_);
+  sorted_label_.resize(filter_count);
+  sorted_dir_.resize(filter_count);
+  sorted_box_for_nms_.resize(filter_count * num_box_corners_);
+  ParallelFor(num_threads_, 0, filter_count, [&](const int begin,
+                                                 const int end) {
+    for (int k = begin; k < end; ++k) {
+      const int tid = filtered_anchor_[sorted_index_[k]];
+      const float* box_preds = rpn_box_output + tid * num_output_box_feature_;
+      int label = 0;
+      TopScore(rpn_cls_output + tid * num_class_, num_class_, &label);
+
+      float za = anchors_pz[tid] + anchors_dz[tid] / 2;
+      float diagonal = std::sqrt(anchors_dx[tid] * anchors_dx[tid] +
+                                 anchors_dy[tid] * anchors_dy[tid]);
+      float box_px = box_preds[0] * diagonal + anchors_px[tid];
+      float box_py = box_preds[1] * diagonal + anchors_py[tid];
+      float box_pz = box_preds[2] * anchors_dz[tid] + za;
+      float box_dx = std::exp(box_preds[3]) * anchors_dx[tid];
+      float box_dy = std::exp(box_preds[4]) * anchors_dy[tid];
+      float box_dz = std::exp(box_preds[5]) * anchors_dz[tid];
+      float box_ro = box_preds[6] + anchors_ro[tid];
+      box_pz = box_pz - box_dz / 2;
+
+      float* box = &sorted_box_[k * num_output_box_feature_];
+      box[0] = box_px;
+      box[1] = box_py;
+      box[2] = box_pz;
+      box[3] = box_dx;
+      box[4] = box_dy;
+      box[5] = box_dz;
+      box[6] = box_ro;
+      sorted_label_[k] = label;
+      sorted_dir_[k] = rpn_dir_output[tid * 2 + 0] <
+                       rpn_dir_output[tid * 2 + 1] ? 1 : 0;
+
+      // rotated corners to axis aligned box (xmin, ymin, xmax, ymax)
+      const float corners[8] = {
+          static_cast<float>(-0.5 * box_dx), static_cast<float>(-0.5 * box_dy),
+          static_cast<float>(-0.5 * box_dx), static_cast<float>(0.5 * box_dy),
+          static_cast<float>(0.5 * box_dx),  static_cast<float>(0.5 * box_dy),
+          static_cast<float>(0.5 * box_dx),  static_cast<float>(-0.5 * box_dy)};
+      float sin_yaw = std::sin(box_ro);
+      float cos_yaw = std::cos(box_ro);
+      float xmin = float_max_;
+      float ymin = float_max_;
+      float xmax = float_min_;
+      float ymax = float_min_;
+      for (int i = 0; i < num_box_corners_; ++i) {
+        float x = cos_yaw * corners[i * 2 + 0] - sin_yaw * corners[i * 2 + 1] +
+                  box_px;
+        float y = sin_yaw * corners[i * 2 + 0] + cos_yaw * corners[i * 2 + 1] +
+                  box_py;
+        xmin = std::fmin(xmin, x);
+        ymin = std::fmin(ymin, y);
+        xmax = std::fmax(xmax, x);
+        ymax = std::fmax(ymax, y);
+      }
+      float* box_for_nms = &sorted_box_for_nms_[k * num_box_corners_];
+      box_for_nms[0] = xmin;
+      box_for_nms[1] = ymin;
+      box_for_nms[2] = xmax;
+      box_for_nms[3] = ymax;
+    }
+  });
+
+  keep_inds_.assign(filter_count, 0);
+  int out_num_objects = 0;
+  nms_cpu_ptr_->DoNmsCpu(filter_count, sorted_box_for_nms_.data(),
+                         keep_inds_.data(), &out_num_objects);
+
+  for (int i = 0; i < out_num_objects; ++i) {
+    const float* box = &sorted_box_[keep_inds_[i] * num_output_box_feature_];
+    for (int j = 0; j < 6; ++j) {
+      out_detection->push_back(box[j]);
+    }
+    if (sorted_dir_[keep_inds_[i]] == 0) {
+      out_detection->push_back(box[6] + M_PI);
+    } else {
+      out_detection->push_back(box[6]);
+    }
+    out_label->push_back(sorted_label_[keep_inds_[i]]);
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+/**
+ * @file postprocess_cpu.h
+ * @brief Postprocess for the network output on CPU
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/nms_cpu.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+class PostprocessCpu {
+ private:
+  const float float_min_;
+  const float float_max_;
+  const int num_anchor_;
+  const int num_class_;
+  const float score_threshold_;
+  const int num_threads_;
+  const int num_box_corners_;
+  const int num_output_box_feature_;
+
+  std::unique_ptr<NmsCpu> nms_cpu_ptr_;
+
+  // buffers reused between frames
+  std::vector<uint8_t> anchor_kept_;
+  std::vector<int> filtered_anchor_;
+  std::vector<float> filtered_score_;
+  std::vector<int> sorted_index_;
+  std::vector<float> sorted_box_;
+  std::vector<int> sorted_label_;
+  std::vector<int> sorted_dir_;
+  std::vector<float> sorted_box_for_nms_;
+  std::vector<int> keep_inds_;
+
+ public:
+  /**
+   * @brief Constructor
+   * @param[in] float_min The lowest float value
+   * @param[in] float_max The maximum float value
+   * @param[in] num_anchor Number of anchors in total
+   * @param[in] num_class Number of object's classes
+   * @param[in] score_threshold Score threshold for filtering output
+   * @param[in] num_threads Number of cpu threads
+   * @param[in] nms_overlap_threshold IOU threshold for NMS
+   * @param[in] num_box_corners Number of box's corner
+   * @param[in] num_output_box_feature Number of output box's feature
+   */
+  PostprocessCpu(const float float_min, const float float_max,
+                 const int num_anchor, const int num_class,
+                 const float score_threshold, const int num_threads,
+                 const float nms_overlap_threshold, const int num_box_corners,
+                 const int num_output_box_feature);
+
+  /**
+   * @brief Postprocessing for the network output, same steps as
+   * PostprocessCuda
+   * @param[in] rpn_box_output Box predictions from the network output
+   * @param[in] rpn_cls_output Class predictions from the network output
+   * @param[in] rpn_dir_output Direction predictions from the network output
+   * @param[in] anchor_mask Anchor mask for filtering the network output
+   * @param[in] anchors_px X-coordinate values for corresponding anchors
+   * @param[in] anchors_py Y-coordinate values for corresponding anchors
+   * @param[in] anchors_pz Z-coordinate values for corresponding anchors
+   * @param[in] anchors_dx X-dimension values for corresponding anchors
+   * @param[in] anchors_dy Y-dimension values for corresponding anchors
+   * @param[in] anchors_dz Z-dimension values for corresponding anchors
+   * @param[in] anchors_ro Rotation values for corresponding anchors
+   * @param[out] out_detection Output bounding boxes
+   * @param[out] out_label Output labels of objects
+   * @details Boxes with equal scores keep the anchor order, so the output
+   * is reproducible for the same network output
+   */
+  void DoPostprocessCpu(const float* rpn_box_output,
+                        const float* rpn_cls_output,
+                        const float* rpn_dir_output, const int* anchor_mask,
+                        const float* anchors_px, const float* anchors_py,
+                        const float* anchors_pz, const float* anchors_dx,
+                        const float* anchors_dy, const float* anchors_dz,
+                        const float* anchors_ro,
+                        std::vector<float>* out_detection,
+                        std::vector<int>* out_label);
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -31,12 +31,15 @@
  */
 
 // headers in STL
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
 // headers in local files
 #include "modules/perception/lidar_detection/detector/point_pillars_detection/preprocess_points.h"
 
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/cpu_parallel.h"
+
 namespace apollo {
 namespace perception {
 namespace lidar {
@@ -59,33 +62,25 @@ PreprocessPoints::PreprocessPoints(
       min_x_range_(min_x_range),
       min_y_range_(min_y_range),
       min_z_range_(min_z_range),
-      num_inds_for_scan_(num_inds_for_scan) {}
+      num_inds_for_scan_(num_inds_for_scan),
+      coor_to_pillaridx_(grid_y_size * grid_x_size) {}
 
 void PreprocessPoints::InitializeVariables(int* coor_to_pillaridx,
                                            float* sparse_pillar_map,
                                            float* pillar_point_feature,
                                            float* pillar_coors) {
-  for (int i = 0; i < grid_y_size_; ++i) {
-    for (int j = 0; j < grid_x_size_; ++j) {
-      coor_to_pillaridx[i * grid_x_size_ + j] = -1;
-    }
-  }
-
-  for (int i = 0; i < num_inds_for_scan_; ++i) {
-    for (int j = 0; j < num_inds_for_scan_; ++j) {
-      sparse_pillar_map[i * num_inds_for_scan_ + j] = 0;
-    }
-  }
-
-  for (int i = 0;
-       i < max_num_pillars_ * max_num_points_per_pillar_ * num_point_feature_;
-       ++i) {
-    pillar_point_feature[i] = 0;
-  }
-
-  for (int i = 0; i < max_num_pillars_ * 4; ++i) {
-    pillar_coors[i] = 0;
-  }
+  std::fill(coor_to_pillaridx, coor_to_pillaridx + grid_y_size_ * grid_x_size_,
+            -1);
+  std::fill(sparse_pillar_map,
+            sparse_pillar_map + num_inds_for_scan_ * num_inds_for_scan_, 0);
+  const int feature_size =
+      max_num_pillars_ * max_num_points_per_pillar_ * num_point_feature_;
+  ParallelFor(num_threads_, 0, feature_size,
+              [pillar_point_feature](const int begin, const int end) {
+                std::fill(pillar_point_feature + begin,
+                          pillar_point_feature + end, 0);
+              });
+  std::fill(pillar_coors, pillar_coors + max_num_pillars_ * 4, 0);
 }
 
 void PreprocessPoints::Preprocess(const float* in_points_array,
@@ -96,23 +91,39 @@ void PreprocessPoints::Preprocess(const float* in_points_array,
                                   int* host_pillar_count) {
   int pillar_count = 0;
   // init variables
-  int* coor_to_pillaridx = new int[grid_y_size_ * grid_x_size_];
+  int* coor_to_pillaridx = coor_to_pillaridx_.data();
   InitializeVariables(coor_to_pillaridx, sparse_pillar_map,
                       pillar_point_feature, pillar_coors);
+
+  // grid index of every point, -1 for points out of range
+  point_grid_index_.resize(in_num_points);
+  int* point_grid_index = point_grid_index_.data();
+  ParallelFor(num_threads_, 0, in_num_points, [&](const int begin,
+                                                  const int end) {
+    for (int i = begin; i < end; ++i) {
+      int x_coor = std::floor(
+          (in_points_array[i * num_point_feature_ + 0] - min_x_range_) /
+          pillar_x_size_);
+      int y_coor = std::floor(
+          (in_points_array[i * num_point_feature_ + 1] - min_y_range_) /
+          pillar_y_size_);
+      int z_coor = std::floor(
+          (in_points_array[i * num_point_feature_ + 2] - min_z_range_) /
+          pillar_z_size_);
+      bool in_range = x_coor >= 0 && x_coor < grid_x_size_ && y_coor >= 0 &&
+                      y_coor < grid_y_size_ && z_coor >= 0 &&
+                      z_coor < grid_z_size_;
+      point_grid_index[i] = in_range ? y_coor * grid_x_size_ + x_coor : -1;
+    }
+  });
+
+  // pillars are created in point order
   for (int i = 0; i < in_num_points; ++i) {
-    int x_coor = std::floor(
-        (in_points_array[i * num_point_feature_ + 0] - min_x_range_) /
-        pillar_x_size_);
-    int y_coor = std::floor(
-        (in_points_array[i * num_point_feature_ + 1] - min_y_range_) /
-        pillar_y_size_);
-    int z_coor = std::floor(
-        (in_points_array[i * num_point_feature_ + 2] - min_z_range_) /
-        pillar_z_size_);
-    if (x_coor < 0 || x_coor >= grid_x_size_ || y_coor < 0 ||
-        y_coor >= grid_y_size_ || z_coor < 0 || z_coor >= grid_z_size_) {
+    if (point_grid_index[i] < 0) {
       continue;
     }
+    int y_coor = point_grid_index[i] / grid_x_size_;
+    int x_coor = point_grid_index[i] % grid_x_size_;
     // reverse index
     int pillar_index = coor_to_pillaridx[y_coor * grid_x_size_ + x_coor];
     if (pillar_index == -1) {
@@ -153,8 +164,6 @@ void PreprocessPoints::Preprocess(const float* in_points_array,
     pillar_coors[i * 4 + 3] = x;
   }
   host_pillar_count[0] = pillar_count;
-
-  delete[] coor_to_pillaridx;
 }
 
 }  // namespace lidar
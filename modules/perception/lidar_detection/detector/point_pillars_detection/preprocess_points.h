@@ -39,6 +39,8 @@
 
 #pragma once
 
+#include <vector>
+
 namespace apollo {
 namespace perception {
 namespace lidar {
@@ -60,6 +62,11 @@ class PreprocessPoints {
   const float min_z_range_;
   const int num_inds_for_scan_;
 
+  int num_threads_ = 1;
+  // buffers reused between frames
+  std::vector<int> coor_to_pillaridx_;
+  std::vector<int> point_grid_index_;
+
  public:
   /**
    * @brief Constructor
@@ -118,6 +125,13 @@ class PreprocessPoints {
    */
   void InitializeVariables(int* coor_to_pillaridx, float* sparse_pillar_map,
                            float* pillar_point_feature, float* pillar_coors);
+
+  /**
+   * @brief Set the number of threads used to compute the point coordinates
+   * @details Points are still assigned to pillars in input order, so the
+   * output does not depend on the number of threads
+   */
+  void set_num_threads(const int num_threads) { num_threads_ = num_threads; }
 };
 
 }  // namespace lidar
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/scatter_cpu.h"
+
+#include "modules/perception/lidar_detection/detector/point_pillars_detection/cpu_parallel.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+ScatterCpu::ScatterCpu(const int num_threads, const int num_features,
+                       const int grid_x_size, const int grid_y_size)
+    : num_threads_(num_threads),
+      num_features_(num_features),
+      grid_x_size_(grid_x_size),
+      grid_y_size_(grid_y_size) {}
+
+void ScatterCpu::DoScatterCpu(const int pillar_count, const int* x_coors,
+                              const int* y_coors, const float* pfe_output,
+                              float* scattered_feature) {
+  const int grid_size = grid_x_size_ * grid_y_size_;
+  // each task owns a range of feature planes, so writes never overlap
+  ParallelFor(num_threads_, 0, num_features_, [&](const int begin,
+                                                  const int end) {
+    for (int i_feature = begin; i_feature < end; ++i_feature) {
+      float* plane = scattered_feature + i_feature * grid_size;
+      for (int i_pillar = 0; i_pillar < pillar_count; ++i_pillar) {
+        plane[y_coors[i_pillar] * grid_x_size_ + x_coors[i_pillar]] =
+            pfe_output[i_pillar * num_features_ + i_feature];
+      }
+    }
+  });
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
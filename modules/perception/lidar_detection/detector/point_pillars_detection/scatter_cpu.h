@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+/**
+ * @file scatter_cpu.h
+ * @brief Scatter pillar features into the bird's eye view map on CPU
+ */
+
+#pragma once
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+class ScatterCpu {
+ private:
+  const int num_threads_;
+  const int num_features_;
+  const int grid_x_size_;
+  const int grid_y_size_;
+
+ public:
+  /**
+   * @brief Constructor
+   * @param[in] num_threads Number of cpu threads
+   * @param[in] num_features Number of features of a pillar
+   * @param[in] grid_x_size Number of pillars in x-coordinate
+   * @param[in] grid_y_size Number of pillars in y-coordinate
+   */
+  ScatterCpu(const int num_threads, const int num_features,
+             const int grid_x_size, const int grid_y_size);
+
+  /**
+   * @brief Scatter pillar features, same result as ScatterCuda
+   * @param[in] pillar_count The valid number of pillars
+   * @param[in] x_coors X-coordinate indexes for corresponding pillars
+   * @param[in] y_coors Y-coordinate indexes for corresponding pillars
+   * @param[in] pfe_output Output from Pillar Feature Extractor
+   * @param[out] scattered_feature Gridmap representation for pillars' feature
+   */
+  void DoScatterCpu(const int pillar_count, const int* x_coors,
+                    const int* y_coors, const float* pfe_output,
+                    float* scattered_feature);
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -18,11 +18,14 @@
 
 #include "cyber/common/log.h"
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool LidarDetectionComponent::Init() {
   LidarDetectionComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -71,8 +74,10 @@ bool LidarDetectionComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
   // internal proc
+  const double start_time = Clock::NowInSeconds();
   bool status = InternalProc(message);
   if (status) {
+    message->AddStageLatency("detection", start_time, Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send Lidar detection output message.";
   }
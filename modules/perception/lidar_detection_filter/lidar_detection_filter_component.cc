@@ -18,11 +18,14 @@
 
 #include "cyber/common/log.h"
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool LidarDetectionFilterComponent::Init() {
   LidarDetectionFilterComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -51,8 +54,11 @@ bool LidarDetectionFilterComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
   // internal proc
+  const double start_time = Clock::NowInSeconds();
   bool status = InternalProc(message);
   if (status) {
+    message->AddStageLatency("detection_filter", start_time,
+                             Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send lidar detection filter message.";
   }
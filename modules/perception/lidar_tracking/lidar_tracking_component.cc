@@ -75,7 +75,13 @@ bool LidarTrackingComponent::Proc(
 
   auto out_message = std::make_shared<SensorFrameMessage>();
 
+  const double start_time = Clock::NowInSeconds();
   if (InternalProc(message, out_message)) {
+    // lidar tracking is the last stage handling the lidar frame message
+    message->AddStageLatency("tracking", start_time, Clock::NowInSeconds());
+    AINFO << std::setprecision(16) << "FRAME_STATISTICS:LidarPipeline:msg_time["
+          << message->timestamp_ << "]:"
+          << message->StageLatencyDebugString();
     writer_->Write(out_message);
     return true;
   }
@@ -42,7 +42,13 @@ void MultiHmBipartiteGraphMatcher::Match(
                    assignments, unassigned_rows, unassigned_cols);
 }
 
+SparseHmBipartiteGraphMatcher::SparseHmBipartiteGraphMatcher() {
+  optimizer_.set_solver_type(
+      algorithm::GatedHungarianMatcher<float>::SolverType::SPARSE);
+}
+
 PERCEPTION_REGISTER_BIPARTITEGRAPHMATCHER(MultiHmBipartiteGraphMatcher);
+PERCEPTION_REGISTER_BIPARTITEGRAPHMATCHER(SparseHmBipartiteGraphMatcher);
 
 }  // namespace lidar
 }  // namespace perception
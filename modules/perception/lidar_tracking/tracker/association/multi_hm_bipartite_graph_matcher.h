@@ -54,6 +54,20 @@ class MultiHmBipartiteGraphMatcher : public BaseBipartiteGraphMatcher {
   algorithm::GatedHungarianMatcher<float> optimizer_;
 };  // class MultiHmObjectMatcher
 
+/**
+ * @brief Same gating and cost semantics as MultiHmBipartiteGraphMatcher, but
+ * the assignment is solved by the sparse shortest augmenting path solver on
+ * the gated edges, which scales with the number of candidate pairs instead of
+ * the size of the dense cost matrix.
+ */
+class SparseHmBipartiteGraphMatcher : public MultiHmBipartiteGraphMatcher {
+ public:
+  SparseHmBipartiteGraphMatcher();
+  ~SparseHmBipartiteGraphMatcher() = default;
+
+  std::string Name() const { return "SparseHmBipartiteGraphMatcher"; }
+};  // class SparseHmBipartiteGraphMatcher
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
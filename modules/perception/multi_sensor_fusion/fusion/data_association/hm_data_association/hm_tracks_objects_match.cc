@@ -15,11 +15,18 @@
  *****************************************************************************/
 #include "modules/perception/multi_sensor_fusion/fusion/data_association/hm_data_association/hm_tracks_objects_match.h"
 
+#include <algorithm>
+#include <future>
 #include <map>
 #include <numeric>
 #include <utility>
 
+#include "modules/perception/multi_sensor_fusion/proto/hm_data_association_config.pb.h"
+
+#include "cyber/common/file.h"
+#include "cyber/task/task.h"
 #include "modules/perception/common/algorithm/graph/secure_matrix.h"
+#include "modules/perception/common/util.h"
 
 namespace apollo {
 namespace perception {
@@ -33,6 +40,11 @@ double HMTrackersObjectsAssociation::s_match_distance_bound_ = 100.0;
 double HMTrackersObjectsAssociation::s_association_center_dist_threshold_ =
     30.0;
 
+namespace {
+// below this many pairs per thread the hand-off costs more than it saves
+constexpr size_t kMinPairsPerThread = 32;
+}  // namespace
+
 template <typename T>
 void extract_vector(const std::vector<T>& vec,
                     const std::vector<size_t>& subset_inds,
@@ -176,6 +188,33 @@ void HMTrackersObjectsAssociation::PostIdAssign(
   }
 }
 
+bool HMTrackersObjectsAssociation::Init(
+    const AssociationInitOptions& options) {
+  track_object_distance_.set_distance_thresh(
+      static_cast<float>(s_match_distance_thresh_));
+
+  // the config is optional, the dense Hungarian optimizer is used without it
+  if (options.config_file.empty()) {
+    return true;
+  }
+  std::string config_file =
+      GetConfigFile(options.config_path, options.config_file);
+  HmDataAssociationConfig config;
+  if (!cyber::common::GetProtoFromFile(config_file, &config)) {
+    AERROR << "Read config failed: " << config_file;
+    return false;
+  }
+  if (config.use_sparse_solver()) {
+    optimizer_.set_solver_type(
+        algorithm::GatedHungarianMatcher<float>::SolverType::SPARSE);
+  }
+  num_threads_ = std::max(config.num_threads(), 1);
+  AINFO << "HMTrackersObjectsAssociation uses "
+        << (config.use_sparse_solver() ? "sparse" : "hungarian")
+        << " assignment solver, num_threads: " << num_threads_;
+  return true;
+}
+
 bool HMTrackersObjectsAssociation::MinimizeAssignment(
     const std::vector<std::vector<double>>& association_mat,
     const std::vector<size_t>& track_ind_l2g,
@@ -305,21 +344,28 @@ void HMTrackersObjectsAssociation::ComputeAssociationDistanceMat(
   TrackObjectDistanceOptions opt;
   Eigen::Vector3d tmp = Eigen::Vector3d::Zero();
   opt.ref_point = &tmp;
-  association_mat->resize(unassigned_tracks.size());
+  association_mat->assign(
+      unassigned_tracks.size(),
+      std::vector<double>(unassigned_measurements.size(),
+                          s_match_distance_thresh_));
+
+  // 1. gate on the center distance, which is cheap, and keep the pairs that
+  // need the full distance as (row, col) of the association matrix
+  std::vector<std::pair<size_t, size_t>> gated_cells;
+  std::vector<std::pair<size_t, size_t>> gated_pairs;
   for (size_t i = 0; i < unassigned_tracks.size(); ++i) {
-    size_t fusion_idx = unassigned_tracks[i];
-    (*association_mat)[i].resize(unassigned_measurements.size());
-    const TrackPtr& fusion_track = fusion_tracks[fusion_idx];
+    const TrackPtr& fusion_track = fusion_tracks[unassigned_tracks[i]];
+    const Eigen::Vector3d& track_center =
+        fusion_track->GetFusedObject()->GetBaseObject()->center;
     for (size_t j = 0; j < unassigned_measurements.size(); ++j) {
-      size_t sensor_idx = unassigned_measurements[j];
-      const SensorObjectPtr& sensor_object = sensor_objects[sensor_idx];
-      double distance = s_match_distance_thresh_;
+      const SensorObjectPtr& sensor_object =
+          sensor_objects[unassigned_measurements[j]];
       double center_dist =
-          (sensor_object->GetBaseObject()->center -
-           fusion_track->GetFusedObject()->GetBaseObject()->center).norm();
+          (sensor_object->GetBaseObject()->center - track_center).norm();
       if (center_dist < s_association_center_dist_threshold_) {
-        distance =
-            track_object_distance_.Compute(fusion_track, sensor_object, opt);
+        gated_cells.emplace_back(i, j);
+        gated_pairs.emplace_back(unassigned_tracks[i],
+                                 unassigned_measurements[j]);
       } else {
         ADEBUG << "center_distance " << center_dist
                << " exceeds slack threshold "
@@ -327,12 +373,44 @@ void HMTrackersObjectsAssociation::ComputeAssociationDistanceMat(
                << ", track_id: " << fusion_track->GetTrackId()
                << ", obs_id: " << sensor_object->GetBaseObject()->track_id;
       }
-      (*association_mat)[i][j] = distance;
+    }
+  }
+
+  // 2. per-object geometry and camera projections are prepared once, after
+  // which the distances of the gated pairs are independent
+  track_object_distance_.PrepareBatch(fusion_tracks, sensor_objects,
+                                      gated_pairs, opt);
+  auto compute = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k) {
+      const TrackPtr& fusion_track = fusion_tracks[gated_pairs[k].first];
+      const SensorObjectPtr& sensor_object =
+          sensor_objects[gated_pairs[k].second];
+      double distance =
+          track_object_distance_.Compute(fusion_track, sensor_object, opt);
+      (*association_mat)[gated_cells[k].first][gated_cells[k].second] =
+          distance;
       ADEBUG << "track_id: " << fusion_track->GetTrackId()
              << ", obs_id: " << sensor_object->GetBaseObject()->track_id
              << ", distance: " << distance;
     }
+  };
+
+  // 3. compute the gated pairs in parallel
+  const size_t size = gated_pairs.size();
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(num_threads_, size / kMinPairsPerThread));
+  const size_t chunk_size = (size + num_chunks - 1) / num_chunks;
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_chunks - 1);
+  for (size_t begin = chunk_size; begin < size; begin += chunk_size) {
+    futures.emplace_back(
+        cyber::Async(compute, begin, std::min(size, begin + chunk_size)));
+  }
+  compute(0, std::min(size, chunk_size));
+  for (auto& future : futures) {
+    future.wait();
   }
+  track_object_distance_.FinishBatch();
 }
 
 void HMTrackersObjectsAssociation::IdAssign(
@@ -39,11 +39,7 @@ class HMTrackersObjectsAssociation : public BaseDataAssociation {
    * @return true
    * @return false
    */
-  bool Init(const AssociationInitOptions &options) override {
-    track_object_distance_.set_distance_thresh(
-        static_cast<float>(s_match_distance_thresh_));
-    return true;
-  }
+  bool Init(const AssociationInitOptions &options) override;
 
   /**
    * @brief Associate the obstacles measured by the sensor with the obstacles
@@ -176,6 +172,8 @@ class HMTrackersObjectsAssociation : public BaseDataAssociation {
 
   /// @brief TrackObjectDistance
   TrackObjectDistance track_object_distance_;
+  /// @brief number of threads computing the association distance matrix
+  int num_threads_ = 1;
   /// @brief match distance thresh
   static double s_match_distance_thresh_;
   /// @brief match distance bound
@@ -46,6 +46,12 @@ size_t
 size_t TrackObjectDistance::s_lidar2camera_projection_vertices_check_pts_num_ =
     20;
 
+TrackObjectDistance::TrackObjectDistance() {
+  // set once here, Compute() may run concurrently and only reads the params
+  rc_x_similarity_params_2_.welsh_loss_scale_ =
+      rc_x_similarity_params_2_welsh_loss_scale_;
+}
+
 void TrackObjectDistance::GetModified2DRadarBoxVertices(
     const EigenVector<Eigen::Vector3d>& radar_box_vertices,
     const SensorObjectConstPtr& camera,
@@ -234,7 +240,15 @@ ProjectionCacheObject* TrackObjectDistance::QueryProjectionCacheObject(
       projection_timestamp, lidar_object_id);
   if (cache_object != nullptr) {
     return cache_object;
-  }  // 2. if query failed, build projection and cache it
+  }
+  // the cache is shared by concurrent Compute() calls of a batch, and
+  // PrepareBatch() has already built every object they need
+  if (in_batch_) {
+    AERROR << "Projection of lidar object " << lidar_object_id
+           << " was not prepared for the batch";
+    return nullptr;
+  }
+  // 2. if query failed, build projection and cache it
   return BuildProjectionCacheObject(
       lidar, camera, camera_model, measurement_sensor_id, measurement_timestamp,
       projection_sensor_id, projection_timestamp);
@@ -261,6 +275,13 @@ bool TrackObjectDistance::QueryPolygonDCenter(
   if (object == nullptr) {
     return false;
   }
+  if (in_batch_ && range == kBatchPolygonRange && ref_pos == batch_ref_point_) {
+    auto it = polygon_centers_.find(object.get());
+    if (it != polygon_centers_.end()) {
+      *polygon_ct = it->second.center;
+      return it->second.valid;
+    }
+  }
   const base::PolygonDType& polygon = object->polygon;
   if (!ComputePolygonCenter(polygon, ref_pos, range, polygon_ct)) {
     return false;
@@ -300,6 +321,78 @@ bool TrackObjectDistance::LidarCameraCenterDistanceExceedDynamicThreshold(
   return false;
 }
 
+void TrackObjectDistance::PrepareLidarCameraProjection(
+    const SensorObjectConstPtr& lidar, const SensorObjectConstPtr& camera,
+    const bool measurement_is_lidar, const bool is_track_id_consistent) {
+  // same early outs as ComputeLidarCamera() before it queries the cache
+  if (!is_track_id_consistent &&
+      LidarCameraCenterDistanceExceedDynamicThreshold(lidar, camera)) {
+    return;
+  }
+  if (lidar->GetBaseObject()->lidar_supplement.cloud.size() == 0) {
+    return;
+  }
+  base::BaseCameraModelPtr camera_model = QueryCameraModel(camera);
+  if (camera_model == nullptr) {
+    return;
+  }
+  QueryProjectionCacheObject(lidar, camera, camera_model,
+                             measurement_is_lidar);
+}
+
+void TrackObjectDistance::PrepareBatch(
+    const std::vector<TrackPtr>& fused_tracks,
+    const std::vector<SensorObjectPtr>& sensor_objects,
+    const std::vector<std::pair<size_t, size_t>>& pairs,
+    const TrackObjectDistanceOptions& options) {
+  FinishBatch();
+  if (options.ref_point == nullptr) {
+    return;
+  }
+  batch_ref_point_ = *options.ref_point;
+  auto cache_polygon_center = [this](const SensorObjectConstPtr& object) {
+    if (object == nullptr || object->GetBaseObject() == nullptr) {
+      return;
+    }
+    const base::Object* base_object = object->GetBaseObject().get();
+    if (polygon_centers_.count(base_object) > 0) {
+      return;
+    }
+    PolygonCenter& entry = polygon_centers_[base_object];
+    entry.valid = ComputePolygonCenter(base_object->polygon, batch_ref_point_,
+                                       kBatchPolygonRange, &entry.center);
+  };
+
+  for (const auto& pair : pairs) {
+    const TrackPtr& fused_track = fused_tracks[pair.first];
+    const SensorObjectPtr& sensor_object = sensor_objects[pair.second];
+    if (fused_track->GetFusedObject() == nullptr) {
+      continue;
+    }
+    SensorObjectConstPtr lidar_object = fused_track->GetLatestLidarObject();
+    SensorObjectConstPtr radar_object = fused_track->GetLatestRadarObject();
+    SensorObjectConstPtr camera_object = fused_track->GetLatestCameraObject();
+    cache_polygon_center(lidar_object);
+    cache_polygon_center(radar_object);
+    cache_polygon_center(sensor_object);
+    if (IsLidar(sensor_object) && camera_object != nullptr) {
+      PrepareLidarCameraProjection(
+          sensor_object, camera_object, true,
+          IsTrackIdConsistent(lidar_object, sensor_object));
+    } else if (IsCamera(sensor_object) && lidar_object != nullptr) {
+      PrepareLidarCameraProjection(
+          lidar_object, sensor_object, false,
+          IsTrackIdConsistent(camera_object, sensor_object));
+    }
+  }
+  in_batch_ = true;
+}
+
+void TrackObjectDistance::FinishBatch() {
+  in_batch_ = false;
+  polygon_centers_.clear();
+}
+
 // @brief: compute the distance between input fused track and sensor object
 // @return track object distance
 float TrackObjectDistance::Compute(const TrackPtr& fused_track,
@@ -703,8 +796,6 @@ double TrackObjectDistance::ComputeRadarCameraSimilarity(
         static_cast<float>(local_pt[2]);
     Eigen::Vector3d pt3d = pt3f.cast<double>();
     if (IsPtInFrustum(pt3d, width, height)) {
-      rc_x_similarity_params_2_.welsh_loss_scale_ =
-          rc_x_similarity_params_2_welsh_loss_scale_;
       // compute similarity on x direction
       double x_similarity = ComputeRadarCameraXSimilarity(
           pt3d.x(), box2d_ct.x(), box2d_size.x(), rc_x_similarity_params_2_);
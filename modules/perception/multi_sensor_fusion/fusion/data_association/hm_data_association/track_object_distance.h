@@ -16,6 +16,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "cyber/common/macros.h"
 #include "modules/common/util/eigen_defs.h"
@@ -44,7 +47,7 @@ class TrackObjectDistance {
   using EigenVector = apollo::common::EigenVector<EigenType>;
 
  public:
-  TrackObjectDistance() = default;
+  TrackObjectDistance();
   ~TrackObjectDistance() = default;
 
   /**
@@ -66,6 +69,23 @@ class TrackObjectDistance {
     projection_cache_.Reset(sensor_id, timestamp);
   }
 
+  // @brief: prepare a batch of Compute() calls on the given track-object
+  // pairs. Polygon centers are computed once per object, and the camera
+  // projections needed by lidar-camera distances are built into the
+  // projection cache, which is then frozen until FinishBatch(). Compute()
+  // on these pairs only reads shared state afterwards, so the calls can
+  // run concurrently.
+  // @params [in] fused_tracks: maintained fused tracks
+  // @params [in] sensor_objects: sensor observations
+  // @params [in] pairs: (track index, object index) pairs of the batch
+  // @params [in] options: options of the following Compute() calls
+  void PrepareBatch(const std::vector<TrackPtr>& fused_tracks,
+                    const std::vector<SensorObjectPtr>& sensor_objects,
+                    const std::vector<std::pair<size_t, size_t>>& pairs,
+                    const TrackObjectDistanceOptions& options);
+  // @brief: drop the per-batch state and unfreeze the projection cache
+  void FinishBatch();
+
   // @brief: compute the distance between input fused track and sensor object
   // @params [in] fused_track: maintained fused track
   // @params [in] sensor_object: sensor observation
@@ -182,6 +202,16 @@ class TrackObjectDistance {
                            const SensorObjectConstPtr& object2);
   bool LidarCameraCenterDistanceExceedDynamicThreshold(
       const SensorObjectConstPtr& lidar, const SensorObjectConstPtr& camera);
+  // build the projection cache object ComputeLidarCamera() would query
+  void PrepareLidarCameraProjection(const SensorObjectConstPtr& lidar,
+                                    const SensorObjectConstPtr& camera,
+                                    const bool measurement_is_lidar,
+                                    const bool is_track_id_consistent);
+
+  struct PolygonCenter {
+    bool valid = false;
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+  };
 
   ProjectionCache projection_cache_;
   float distance_thresh_ = 4.0f;
@@ -198,6 +228,13 @@ class TrackObjectDistance {
   LocSimilarityParams rc_loc_similarity_params_ = LocSimilarityParams();
   XSimilarityParams rc_x_similarity_params_2_ = XSimilarityParams();
 
+  // per-batch state, see PrepareBatch()
+  bool in_batch_ = false;
+  Eigen::Vector3d batch_ref_point_ = Eigen::Vector3d::Zero();
+  std::unordered_map<const base::Object*, PolygonCenter> polygon_centers_;
+  // the polygon center range used by Compute()
+  static const int kBatchPolygonRange = 3;
+
  private:
   static double s_lidar2lidar_association_center_dist_threshold_;
   static double s_lidar2radar_association_center_dist_threshold_;
@@ -17,11 +17,13 @@
 #include "modules/perception/pointcloud_ground_detection/pointcloud_ground_detection_component.h"
 
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
 using apollo::cyber::common::GetAbsolutePath;
 
 bool PointCloudGroundDetectComponent::Init() {
@@ -55,8 +57,11 @@ bool PointCloudGroundDetectComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
   // internal proc
+  const double start_time = Clock::NowInSeconds();
   bool status = InternalProc(message);
   if (status) {
+    message->AddStageLatency("ground_detection", start_time,
+                             Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send pointcloud ground detect output message.";
   }
@@ -17,12 +17,16 @@
 #include "modules/perception/pointcloud_map_based_roi/pointcloud_map_based_roi_component.h"
 
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 #include "modules/perception/common/lidar/common/config_util.h"
+#include "modules/perception/common/lidar/common/lidar_timer.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool PointCloudMapROIComponent::Init() {
   PointCloudMapROIComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -73,8 +77,10 @@ bool PointCloudMapROIComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
   // internal proc
+  const double start_time = Clock::NowInSeconds();
   bool status = InternalProc(message);
   if (status) {
+    message->AddStageLatency("map_roi", start_time, Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send pointcloud map based roi output message.";
   }
@@ -83,6 +89,7 @@ bool PointCloudMapROIComponent::Proc(
 
 bool PointCloudMapROIComponent::InternalProc(
     const std::shared_ptr<LidarFrameMessage>& message) {
+  Timer timer;
   // map update
   PERF_BLOCK("map_manager")
   if (use_map_manager_) {
@@ -94,6 +101,7 @@ bool PointCloudMapROIComponent::InternalProc(
     }
   }
   PERF_BLOCK_END
+  const double map_manager_time = timer.toc(true);
 
   ROIFilterOptions roi_filter_options;
   auto lidar_frame_ref = message->lidar_frame_.get();
@@ -110,7 +118,12 @@ bool PointCloudMapROIComponent::InternalProc(
               lidar_frame_ref->roi_indices.indices.end(), 0);
   }
   PERF_BLOCK_END
+  const double roi_filter_time = timer.toc(true);
 
+  AINFO << "PointCloudMapROI: map_manager: " << map_manager_time
+        << "\troi_filter: " << roi_filter_time << "\troi_points: "
+        << lidar_frame_ref->roi_indices.indices.size() << "/"
+        << original_cloud->size();
   return true;
 }
 
@@ -17,8 +17,12 @@
 #include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
 
 #include "cyber/common/file.h"
+#include "cyber/task/task.h"
 #include "modules/perception/common/util.h"
 #include "modules/perception/common/lidar/common/lidar_point_label.h"
 #include "modules/perception/common/lidar/scene_manager/scene_manager.h"
@@ -35,6 +39,27 @@ using base::PolygonDType;
 template <typename T>
 using Polygon = typename PolygonScanCvter<T>::Polygon;
 
+namespace {
+
+// minimal number of points classified by one thread
+constexpr size_t kMinPointsPerThread = 16384;
+
+// the bitmap is drawn from x and y only
+bool SamePolygon(const std::vector<base::PointD>& lhs,
+                 const PolygonDType& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i].x != rhs[i].x || lhs[i].y != rhs[i].y) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   // load model config
   std::string config_file =
@@ -46,6 +71,9 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   extend_dist_ = config.extend_dist();
   no_edge_table_ = config.no_edge_table();
   set_roi_service_ = config.set_roi_service();
+  use_cached_bitmap_ = config.use_cached_bitmap();
+  cache_margin_ = config.cache_margin();
+  num_threads_ = std::max(config.num_threads(), 1);
 
   // reserve mem
   const size_t KPolygonMaxNum = 100;
@@ -57,13 +85,23 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   Eigen::Vector2d max_range(range_, range_);
   Eigen::Vector2d cell_size(cell_size_, cell_size_);
   bitmap_.Init(min_range, max_range, cell_size);
+  if (use_cached_bitmap_) {
+    // the cached bitmap has to cover the roi range wherever the vehicle
+    // is within cache_margin_ of its anchor
+    const double cache_range = range_ + cache_margin_;
+    cached_bitmap_.Init(Eigen::Vector2d(-cache_range, -cache_range),
+                        Eigen::Vector2d(cache_range, cache_range), cell_size);
+  }
 
   // output input parameters
   AINFO << " HDMap Roi Filter Parameters: "
         << " range: " << range_ << " cell_size: " << cell_size_
         << " extend_dist: " << extend_dist_
         << " no_edge_table: " << no_edge_table_
-        << " set_roi_service: " << set_roi_service_;
+        << " set_roi_service: " << set_roi_service_
+        << " use_cached_bitmap: " << use_cached_bitmap_
+        << " cache_margin: " << cache_margin_
+        << " num_threads: " << num_threads_;
 
   return true;
 }
@@ -94,13 +132,29 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
     polygons_world_[i++] = &polygon;
   }
 
-  // transform to local
-  base::PointFCloudPtr cloud_local = base::PointFCloudPool::Instance().Get();
-  TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
-                 &polygons_local_, &cloud_local);
+  bool ret = false;
+  const Eigen::Vector3d location = frame->lidar2world_pose.translation();
+  if (use_cached_bitmap_) {
+    if (UpdateCachedBitmap(location.head<2>(), polygons_world_)) {
+      const Eigen::Vector2d offset = location.head<2>() - cache_anchor_;
+      if (cached_bitmap_.Check(offset)) {
+        ClassifyPoints(*frame->cloud, frame->lidar2world_pose.linear(), offset,
+                       cached_bitmap_, &(frame->roi_indices));
+        ret = true;
+      } else {
+        AWARN << " Car is not in roi!!.";
+      }
+    }
+  } else {
+    // transform to local
+    base::PointFCloudPtr cloud_local =
+        base::PointFCloudPool::Instance().Get();
+    TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
+                   &polygons_local_, &cloud_local);
 
-  bool ret = FilterWithPolygonMask(cloud_local, polygons_local_,
-                                   &(frame->roi_indices));
+    ret = FilterWithPolygonMask(cloud_local, polygons_local_,
+                                &(frame->roi_indices));
+  }
 
   // set roi points label
   if (ret) {
@@ -116,13 +170,18 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
   if (set_roi_service_) {
     auto roi_service = SceneManager::Instance().Service("ROIService");
     if (roi_service != nullptr) {
-      roi_service_content_.range_ = range_;
+      const Bitmap2D& bitmap = use_cached_bitmap_ ? cached_bitmap_ : bitmap_;
+      roi_service_content_.range_ =
+          use_cached_bitmap_ ? range_ + cache_margin_ : range_;
       roi_service_content_.cell_size_ = cell_size_;
-      roi_service_content_.map_size_ = bitmap_.map_size();
-      roi_service_content_.bitmap_ = bitmap_.bitmap();
+      roi_service_content_.map_size_ = bitmap.map_size();
+      roi_service_content_.bitmap_ = bitmap.bitmap();
       roi_service_content_.major_dir_ =
-          static_cast<ROIServiceContent::DirectionMajor>(bitmap_.dir_major());
-      roi_service_content_.transform_ = frame->lidar2world_pose.translation();
+          static_cast<ROIServiceContent::DirectionMajor>(bitmap.dir_major());
+      roi_service_content_.transform_ = location;
+      if (use_cached_bitmap_) {
+        roi_service_content_.transform_.head<2>() = cache_anchor_;
+      }
       if (!ret) {
         std::fill(roi_service_content_.bitmap_.begin(),
                   roi_service_content_.bitmap_.end(), -1);
@@ -233,6 +292,134 @@ bool HdmapROIFilter::Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
   return true;
 }
 
+bool HdmapROIFilter::UpdateCachedBitmap(
+    const Eigen::Vector2d& location,
+    const EigenVector<PolygonDType*>& polygons_world) {
+  const Eigen::Vector2d offset = location - cache_anchor_;
+  if (!cache_valid_ || offset.cwiseAbs().maxCoeff() > cache_margin_) {
+    // snap the anchor to the cell grid, so cells keep their world position
+    cache_anchor_ = (location.array() / cell_size_).floor() * cell_size_;
+    cached_bitmap_.SetUp(DirectionMajor::XMAJOR);
+    cached_polygons_.clear();
+    cache_valid_ = true;
+  }
+
+  // the roi is the union of the polygons, so polygons already drawn stay
+  // valid and only the ones entering the map query need to be drawn
+  std::vector<Polygon<double>> new_polygons;
+  for (const auto* polygon_world : polygons_world) {
+    if (!MarkPolygonDrawn(*polygon_world)) {
+      continue;
+    }
+    new_polygons.emplace_back(polygon_world->size());
+    auto& raw_polygon = new_polygons.back();
+    for (size_t j = 0; j < polygon_world->size(); ++j) {
+      raw_polygon[j].x() = polygon_world->at(j).x - cache_anchor_.x();
+      raw_polygon[j].y() = polygon_world->at(j).y - cache_anchor_.y();
+    }
+  }
+  if (new_polygons.empty()) {
+    return true;
+  }
+  if (!DrawPolygonsMask<double>(new_polygons, &cached_bitmap_, extend_dist_,
+                                no_edge_table_)) {
+    cache_valid_ = false;
+    return false;
+  }
+  ADEBUG << "Draw " << new_polygons.size() << " of " << polygons_world.size()
+         << " polygons into cached roi bitmap.";
+  return true;
+}
+
+size_t HdmapROIFilter::PolygonKey(const PolygonDType& polygon) {
+  size_t key = polygon.size();
+  for (const auto& pt : polygon) {
+    key ^= std::hash<double>()(pt.x) + 0x9e3779b9 + (key << 6) + (key >> 2);
+    key ^= std::hash<double>()(pt.y) + 0x9e3779b9 + (key << 6) + (key >> 2);
+  }
+  return key;
+}
+
+bool HdmapROIFilter::MarkPolygonDrawn(const PolygonDType& polygon) {
+  const size_t key = PolygonKey(polygon);
+  const auto range = cached_polygons_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (SamePolygon(it->second, polygon)) {
+      return false;
+    }
+  }
+  cached_polygons_.emplace(key, polygon.points());
+  return true;
+}
+
+void HdmapROIFilter::ClassifyPoints(const base::PointFCloud& cloud,
+                                    const Eigen::Matrix3d& rotation,
+                                    const Eigen::Vector2d& offset,
+                                    const Bitmap2D& bitmap,
+                                    base::PointIndices* roi_indices) {
+  const size_t size = cloud.size();
+  roi_indices->indices.clear();
+  if (size == 0) {
+    return;
+  }
+  local_x_.resize(size);
+  local_y_.resize(size);
+  roi_flags_.resize(size);
+
+  // the rows of the rotation rotate points to world aligned axes
+  const float r00 = static_cast<float>(rotation(0, 0));
+  const float r01 = static_cast<float>(rotation(0, 1));
+  const float r02 = static_cast<float>(rotation(0, 2));
+  const float r10 = static_cast<float>(rotation(1, 0));
+  const float r11 = static_cast<float>(rotation(1, 1));
+  const float r12 = static_cast<float>(rotation(1, 2));
+  const float range = static_cast<float>(range_);
+  const base::PointF* points = &cloud[0];
+
+  auto classify = [&](const size_t begin, const size_t end) {
+    float* __restrict local_x = local_x_.data();
+    float* __restrict local_y = local_y_.data();
+    uint8_t* __restrict flags = roi_flags_.data();
+    // plain float arithmetic over contiguous points to let the compiler
+    // vectorize the transform and the range test, then look up the cells
+    for (size_t i = begin; i < end; ++i) {
+      const base::PointF& pt = points[i];
+      local_x[i] = r00 * pt.x + r01 * pt.y + r02 * pt.z;
+      local_y[i] = r10 * pt.x + r11 * pt.y + r12 * pt.z;
+      flags[i] = std::fabs(local_x[i]) < range && std::fabs(local_y[i]) < range;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      if (flags[i]) {
+        // keep the same range around the car as the uncached bitmap
+        const Eigen::Vector2d e_pt(local_x[i] + offset.x(),
+                                   local_y[i] + offset.y());
+        flags[i] = bitmap.Check(e_pt);
+      }
+    }
+  };
+
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(num_threads_, size / kMinPointsPerThread));
+  const size_t chunk_size = (size + num_chunks - 1) / num_chunks;
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_chunks - 1);
+  for (size_t begin = chunk_size; begin < size; begin += chunk_size) {
+    futures.emplace_back(
+        cyber::Async(classify, begin, std::min(size, begin + chunk_size)));
+  }
+  classify(0, std::min(size, chunk_size));
+  for (auto& future : futures) {
+    future.wait();
+  }
+
+  roi_indices->indices.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (roi_flags_[i]) {
+      roi_indices->indices.push_back(static_cast<int>(i));
+    }
+  }
+}
+
 }  // namespace lidar
 }  // namespace perception
 }  // namespace apollo
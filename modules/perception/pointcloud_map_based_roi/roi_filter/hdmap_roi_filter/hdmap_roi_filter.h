@@ -17,6 +17,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/proto/hdmap_roi_filter.pb.h"
@@ -77,6 +78,8 @@ class HdmapROIFilter : public BaseROIFilter {
   std::string Name() const override { return "HdmapROIFilter"; }
 
  private:
+  friend class HdmapROIFilterTest;
+
   void TransformFrame(
       const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
       const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
@@ -91,6 +94,25 @@ class HdmapROIFilter : public BaseROIFilter {
   bool Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
                       const Bitmap2D& bitmap, base::PointIndices* roi_indices);
 
+  // draw the polygons not in the cached bitmap yet, re-anchoring it at
+  // location first if the vehicle moved beyond cache_margin_
+  bool UpdateCachedBitmap(
+      const Eigen::Vector2d& location,
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world);
+
+  static size_t PolygonKey(const base::PolygonDType& polygon);
+
+  // remember polygon as drawn into the cached bitmap, return false if an
+  // identical polygon was drawn before
+  bool MarkPolygonDrawn(const base::PolygonDType& polygon);
+
+  // classify points in lidar frame against a world aligned bitmap whose
+  // origin is at -offset from the lidar
+  void ClassifyPoints(const base::PointFCloud& cloud,
+                      const Eigen::Matrix3d& rotation,
+                      const Eigen::Vector2d& offset, const Bitmap2D& bitmap,
+                      base::PointIndices* roi_indices);
+
   // parameters for polygons scans convert
   double range_ = 120.0;
   double cell_size_ = 0.25;
@@ -101,6 +123,22 @@ class HdmapROIFilter : public BaseROIFilter {
   apollo::common::EigenVector<base::PolygonDType> polygons_local_;
   Bitmap2D bitmap_;
   ROIServiceContent roi_service_content_;
+
+  // cached bitmap centered at cache_anchor_ in world frame
+  bool use_cached_bitmap_ = false;
+  double cache_margin_ = 20.0;
+  int num_threads_ = 1;
+  bool cache_valid_ = false;
+  Eigen::Vector2d cache_anchor_ = Eigen::Vector2d::Zero();
+  // drawn polygons keyed by their hash, the contents are compared as well
+  // so that a hash collision can not drop a polygon
+  std::unordered_multimap<size_t, std::vector<base::PointD>>
+      cached_polygons_;
+  Bitmap2D cached_bitmap_;
+  // per point buffers reused across frames
+  std::vector<float> local_x_;
+  std::vector<float> local_y_;
+  std::vector<uint8_t> roi_flags_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::perception::lidar::HdmapROIFilter,
@@ -276,6 +276,30 @@ class HdmapROIFilterTest : public ::testing::Test {
     Filter();
   }
 
+  void MarkPolygonDrawn() {
+    base::PolygonDType first;
+    first.resize(3);
+    first.at(1).x = 10.0;
+    first.at(2).y = 10.0;
+    base::PolygonDType second = first;
+    second.at(2).x = 5.0;
+
+    EXPECT_TRUE(hdmap_roi_filter_ptr_->MarkPolygonDrawn(first));
+    EXPECT_FALSE(hdmap_roi_filter_ptr_->MarkPolygonDrawn(first));
+    // z is not drawn into the bitmap
+    base::PolygonDType first_lifted = first;
+    first_lifted.at(0).z = 1.0;
+    EXPECT_FALSE(hdmap_roi_filter_ptr_->MarkPolygonDrawn(first_lifted));
+
+    // a distinct polygon whose key collides with a drawn one is kept
+    hdmap_roi_filter_ptr_->cached_polygons_.clear();
+    hdmap_roi_filter_ptr_->cached_polygons_.emplace(
+        HdmapROIFilter::PolygonKey(second), first.points());
+    EXPECT_TRUE(hdmap_roi_filter_ptr_->MarkPolygonDrawn(second));
+    EXPECT_FALSE(hdmap_roi_filter_ptr_->MarkPolygonDrawn(second));
+    EXPECT_EQ(hdmap_roi_filter_ptr_->cached_polygons_.size(), 2);
+  }
+
   // input data
   LidarFrame frame_;
   ROIFilterOptions options_;
@@ -297,6 +321,10 @@ TEST_F(HdmapROIFilterTest, filter_with_parallel) {
   HdmapROIFilterTest::FilterWithParallel();
 }
 
+TEST_F(HdmapROIFilterTest, mark_polygon_drawn) {
+  HdmapROIFilterTest::MarkPolygonDrawn();
+}
+
 TEST_F(HdmapROIFilterTest, filter_with_simple_case) {
   // TODO(perception): fix the test.
   // HdmapROIFilterTest::SimpleCaseFilter();
@@ -76,8 +76,11 @@ bool PointCloudPreprocessComponent::Proc(
 
   auto out_message = std::make_shared<onboard::LidarFrameMessage>();
 
+  const double start_time = Clock::NowInSeconds();
   bool status = InternalProc(message, out_message);
   if (status) {
+    out_message->AddStageLatency("preprocess", start_time,
+                                 Clock::NowInSeconds());
     writer_->Write(out_message);
     AINFO << "Send pointcloud preprocess output message.";
   }
@@ -119,7 +122,10 @@ bool PointCloudPreprocessComponent::InternalProc(
 
   auto& frame = out_message->lidar_frame_;
   frame = lidar::LidarFramePool::Instance().Get();
-  frame->cloud = base::PointFCloudPool::Instance().Get();
+  // recycled frames keep their private point clouds
+  if (frame->cloud == nullptr) {
+    frame->cloud = base::PointFCloudPool::Instance().Get();
+  }
   frame->timestamp = timestamp;
   frame->sensor_info = sensor_info_;
 
@@ -48,88 +48,53 @@ PiecewiseJerkProblem::PiecewiseJerkProblem(
   weight_x_ref_vec_ = std::vector<double>(num_of_knots_, 0.0);
 }
 
-bool PiecewiseJerkProblem::FormulateProblem(OSQPData* data) {
+bool PiecewiseJerkProblem::FormulateProblem(
+    common::math::OsqpProblem* problem) {
   // calculate kernel
-  std::vector<c_float> P_data;
-  std::vector<c_int> P_indices;
-  std::vector<c_int> P_indptr;
-  CalculateKernel(&P_data, &P_indices, &P_indptr);
+  CalculateKernel(&problem->P_data, &problem->P_indices, &problem->P_indptr);
 
   // calculate affine constraints
-  std::vector<c_float> A_data;
-  std::vector<c_int> A_indices;
-  std::vector<c_int> A_indptr;
-  std::vector<c_float> lower_bounds;
-  std::vector<c_float> upper_bounds;
-  CalculateAffineConstraint(&A_data, &A_indices, &A_indptr, &lower_bounds,
-                            &upper_bounds);
+  CalculateAffineConstraint(&problem->A_data, &problem->A_indices,
+                            &problem->A_indptr, &problem->l, &problem->u);
 
   // calculate offset
-  std::vector<c_float> q;
-  CalculateOffset(&q);
-
-  CHECK_EQ(lower_bounds.size(), upper_bounds.size());
-
-  size_t kernel_dim = 3 * num_of_knots_;
-  size_t num_affine_constraint = lower_bounds.size();
-
-  data->n = kernel_dim;
-  data->m = num_affine_constraint;
-  data->P = csc_matrix(kernel_dim, kernel_dim, P_data.size(), CopyData(P_data),
-                       CopyData(P_indices), CopyData(P_indptr));
-  data->q = CopyData(q);
-  data->A =
-      csc_matrix(num_affine_constraint, kernel_dim, A_data.size(),
-                 CopyData(A_data), CopyData(A_indices), CopyData(A_indptr));
-  data->l = CopyData(lower_bounds);
-  data->u = CopyData(upper_bounds);
-
-  return CheckLowUpperBound(lower_bounds, upper_bounds);
+  CalculateOffset(&problem->q);
+
+  CHECK_EQ(problem->l.size(), problem->u.size());
+
+  problem->n = static_cast<c_int>(3 * num_of_knots_);
+  problem->m = static_cast<c_int>(problem->l.size());
+
+  return CheckLowUpperBound(problem->l, problem->u);
 }
 
 bool PiecewiseJerkProblem::Optimize(const int max_iter) {
-  OSQPData* data = reinterpret_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
-  if (FormulateProblem(data)) {
-    FreeData(data);
+  common::math::OsqpProblem problem;
+  if (FormulateProblem(&problem)) {
     return false;
   }
   OSQPSettings* settings = SolverDefaultSettings();
   settings->max_iter = max_iter;
-  OSQPWorkspace* osqp_work = nullptr;
-  osqp_work = osqp_setup(data, settings);
-  // osqp_setup(&osqp_work, data, settings);
-  osqp_solve(osqp_work);
-  auto status = osqp_work->info->status_val;
-
-  if (status < 0 || (status != 1 && status != 2)) {
-    AERROR << "failed optimization status:\t" << osqp_work->info->status;
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
-    return false;
-  } else if (osqp_work->solution == nullptr) {
-    AERROR << "The solution from OSQP is nullptr";
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
+
+  common::math::PersistentOsqpSolver local_solver;
+  common::math::PersistentOsqpSolver* solver =
+      solver_ != nullptr ? solver_ : &local_solver;
+  const bool success = solver->Solve(problem, *settings);
+  c_free(settings);
+  if (!success) {
     return false;
   }
 
   // extract primal results
+  const auto& solution = solver->solution();
   x_.resize(num_of_knots_);
   dx_.resize(num_of_knots_);
   ddx_.resize(num_of_knots_);
   for (size_t i = 0; i < num_of_knots_; ++i) {
-    x_.at(i) = osqp_work->solution->x[i] / scale_factor_[0];
-    dx_.at(i) = osqp_work->solution->x[i + num_of_knots_] / scale_factor_[1];
-    ddx_.at(i) =
-        osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
+    x_.at(i) = solution[i] / scale_factor_[0];
+    dx_.at(i) = solution[i + num_of_knots_] / scale_factor_[1];
+    ddx_.at(i) = solution[i + 2 * num_of_knots_] / scale_factor_[2];
   }
-
-  // Cleanup
-  osqp_cleanup(osqp_work);
-  FreeData(data);
-  c_free(settings);
   return true;
 }
 
@@ -338,20 +303,6 @@ void PiecewiseJerkProblem::set_end_state_ref(
   has_end_state_ref_ = true;
 }
 
-void PiecewiseJerkProblem::FreeData(OSQPData* data) {
-  delete[] data->q;
-  delete[] data->l;
-  delete[] data->u;
-
-  delete[] data->P->i;
-  delete[] data->P->p;
-  delete[] data->P->x;
-
-  delete[] data->A->i;
-  delete[] data->A->p;
-  delete[] data->A->x;
-}
-
 bool PiecewiseJerkProblem::CheckLowUpperBound(std::vector<c_float>& lower,
                                               std::vector<c_float>& upper) {
   for (size_t i = 0; i < lower.size(); i++) {
@@ -26,6 +26,8 @@
 
 #include "osqp/osqp.h"
 
+#include "modules/common/math/persistent_osqp_solver.h"
+
 namespace apollo {
 namespace planning {
 
@@ -108,6 +110,15 @@ class PiecewiseJerkProblem {
   void set_end_state_ref(const std::array<double, 3>& weight_end_state,
                          const std::array<double, 3>& end_state_ref);
 
+  /**
+   * @brief Solves with a solver owned by the caller, so that the osqp
+   *        workspace and the last solution are reused by the next problem
+   *        of the same size. The solver must outlive Optimize().
+   */
+  void set_solver(common::math::PersistentOsqpSolver* solver) {
+    solver_ = solver;
+  }
+
   virtual bool Optimize(const int max_iter = 4000);
 
   const std::vector<double>& opt_x() const { return x_; }
@@ -132,20 +143,11 @@ class PiecewiseJerkProblem {
 
   virtual OSQPSettings* SolverDefaultSettings();
 
-  bool FormulateProblem(OSQPData* data);
-
-  void FreeData(OSQPData* data);
+  bool FormulateProblem(common::math::OsqpProblem* problem);
 
   bool CheckLowUpperBound(std::vector<c_float>& lower,
                           std::vector<c_float>& upper);
 
-  template <typename T>
-  T* CopyData(const std::vector<T>& vec) {
-    T* data = new T[vec.size()];
-    memcpy(data, vec.data(), sizeof(T) * vec.size());
-    return data;
-  }
-
  protected:
   size_t num_of_knots_ = 0;
 
@@ -178,6 +180,8 @@ class PiecewiseJerkProblem {
   bool has_end_state_ref_ = false;
   std::array<double, 3> weight_end_state_ = {{0.0, 0.0, 0.0}};
   std::array<double, 3> end_state_ref_;
+
+  common::math::PersistentOsqpSolver* solver_ = nullptr;
 };
 
 }  // namespace planning
@@ -99,7 +99,8 @@ bool PathOptimizerUtil::OptimizePath(
     const PathBoundary& path_boundary,
     const std::vector<std::pair<double, double>>& ddl_bounds, double dddl_bound,
     const PiecewiseJerkPathConfig& config, std::vector<double>* x,
-    std::vector<double>* dx, std::vector<double>* ddx) {
+    std::vector<double>* dx, std::vector<double>* ddx,
+    common::math::PersistentOsqpSolver* solver) {
   // num of knots
   const auto& lat_boundaries = path_boundary.boundary();
   const size_t kNumKnots = lat_boundaries.size();
@@ -151,6 +152,7 @@ bool PathOptimizerUtil::OptimizePath(
   piecewise_jerk_problem.set_ddx_bounds(ddl_bounds);
 
   piecewise_jerk_problem.set_dddx_bound(dddl_bound);
+  piecewise_jerk_problem.set_solver(solver);
 
   bool success = piecewise_jerk_problem.Optimize(config.max_iteration());
 
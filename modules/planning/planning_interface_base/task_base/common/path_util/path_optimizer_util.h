@@ -19,6 +19,7 @@
 
 #include "modules/planning/planning_base/proto/piecewise_jerk_path_config.pb.h"
 
+#include "modules/common/math/persistent_osqp_solver.h"
 #include "modules/planning/planning_base/common/path/path_data.h"
 #include "modules/planning/planning_base/common/path_boundary.h"
 
@@ -53,6 +54,8 @@ class PathOptimizerUtil {
 
   /**
    * @brief Piecewise jerk path optimizer.
+   * @param solver Optional solver kept by the caller to reuse the osqp
+   *        workspace across planning cycles.
    */
   static bool OptimizePath(
       const SLState& init_state, const std::array<double, 3>& end_state,
@@ -61,7 +64,8 @@ class PathOptimizerUtil {
       const std::vector<std::pair<double, double>>& ddl_bounds,
       double dddl_bound, const PiecewiseJerkPathConfig& config,
       std::vector<double>* x, std::vector<double>* dx,
-      std::vector<double>* ddx);
+      std::vector<double>* ddx,
+      common::math::PersistentOsqpSolver* solver = nullptr);
 
   /**
    * @brief If ref_l is below or above path boundary, will update its values and
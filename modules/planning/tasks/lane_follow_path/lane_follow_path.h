@@ -25,6 +25,7 @@
 #include <vector>
 #include "modules/planning/tasks/lane_follow_path/proto/lane_follow_path.pb.h"
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "modules/common/math/persistent_osqp_solver.h"
 #include "modules/planning/planning_interface_base/task_base/common/path_generation.h"
 
 namespace apollo {
@@ -59,6 +60,8 @@ class LaneFollowPath : public PathGeneration {
                   PathData* final_path);
 
   LaneFollowPathConfig config_;
+  // Keeps the osqp workspace of the path problem across planning cycles.
+  common::math::PersistentOsqpSolver path_solver_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(apollo::planning::LaneFollowPath, Task)
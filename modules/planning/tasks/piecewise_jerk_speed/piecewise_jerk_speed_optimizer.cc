@@ -184,6 +184,7 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   piecewise_jerk_problem.set_x_ref(config_.ref_s_weight(), std::move(x_ref));
   piecewise_jerk_problem.set_penalty_dx(penalty_dx);
   piecewise_jerk_problem.set_dx_bounds(std::move(s_dot_bounds));
+  piecewise_jerk_problem.set_solver(&speed_solver_);
 
   // Solve the problem
   if (!piecewise_jerk_problem.Optimize()) {
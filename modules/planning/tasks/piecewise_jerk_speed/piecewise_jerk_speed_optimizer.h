@@ -26,6 +26,7 @@
 #include <vector>
 #include "modules/planning/tasks/piecewise_jerk_speed/proto/piecewise_jerk_speed.pb.h"
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "modules/common/math/persistent_osqp_solver.h"
 #include "modules/planning/planning_interface_base/task_base/common/speed_optimizer.h"
 
 namespace apollo {
@@ -46,6 +47,8 @@ class PiecewiseJerkSpeedOptimizer : public SpeedOptimizer {
       const std::vector<std::pair<double, double>> s_dot_bound, double delta_t,
       std::array<double, 3>& init_s);
   PiecewiseJerkSpeedOptimizerConfig config_;
+  // Keeps the osqp workspace of the speed problem across planning cycles.
+  common::math::PersistentOsqpSolver speed_solver_;
 };
 
 CYBER_PLUGIN_MANAGER_REGISTER_PLUGIN(
@@ -63,6 +63,16 @@ DEFINE_double(base_image_half_range, 100.0, "The half range of base image.");
 DEFINE_bool(enable_draw_adc_trajectory, true,
             "If draw adc trajectory in semantic map");
 DEFINE_bool(img_show_semantic_map, false, "If show the image of semantic map.");
+DEFINE_bool(enable_semantic_map_tile_cache, true,
+            "If compose the base image of semantic map from cached tiles of "
+            "the static map layers instead of drawing the map every frame.");
+DEFINE_int32(semantic_map_tile_size, 256,
+             "The size in pixels of a cached semantic map tile.");
+DEFINE_int32(semantic_map_tile_cache_capacity, 256,
+             "The max number of semantic map tiles kept in memory.");
+DEFINE_string(semantic_map_tile_dir, "",
+              "The directory to load and save pre-rasterized semantic map "
+              "tiles of the current map, empty to keep tiles in memory only.");
 
 // Scenario
 DEFINE_double(junction_distance_threshold, 10.0,
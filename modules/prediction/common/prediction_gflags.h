@@ -48,6 +48,10 @@ DECLARE_double(surrounding_lane_search_radius);
 DECLARE_double(base_image_half_range);
 DECLARE_bool(enable_draw_adc_trajectory);
 DECLARE_bool(img_show_semantic_map);
+DECLARE_bool(enable_semantic_map_tile_cache);
+DECLARE_int32(semantic_map_tile_size);
+DECLARE_int32(semantic_map_tile_cache_capacity);
+DECLARE_string(semantic_map_tile_dir);
 
 // Scenario
 DECLARE_double(junction_distance_threshold);
@@ -16,6 +16,7 @@
 
 #include "modules/prediction/common/semantic_map.h"
 
+#include <cmath>
 #include <utility>
 #include <vector>
 
@@ -36,6 +37,19 @@ namespace prediction {
 
 namespace {
 
+// Resolution and size of the base image, see SemanticMap::GetTransPoint.
+constexpr double kResolution = 0.1;
+constexpr int kBaseImageSize = 2000;
+// Radius to query static map elements around the ego vehicle.
+constexpr double kBaseMapSearchRadius = 141.4;
+// Extra search radius for a tile so that thick lines of elements just
+// outside the tile are still drawn on its border.
+constexpr double kTileSearchMargin = 1.0;
+// Half size of the neighbourhood around an obstacle that can be rotated
+// into the 400 x 400 cropping window, i.e. ceil(hypot(200, 300)) plus one
+// pixel for bilinear interpolation and some margin.
+constexpr int kCropHalfSize = 364;
+
 bool ValidFeatureHistory(const ObstacleHistory& obstacle_history,
                          const double curr_base_x, const double curr_base_y) {
   if (obstacle_history.feature_size() == 0) {
@@ -59,6 +73,17 @@ SemanticMap::SemanticMap() {}
 void SemanticMap::Init() {
   curr_img_ = cv::Mat(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
   obstacle_id_history_map_.clear();
+  if (FLAGS_enable_semantic_map_tile_cache) {
+    tile_cache_.reset(new SemanticMapTileCache(
+        FLAGS_semantic_map_tile_size,
+        static_cast<size_t>(FLAGS_semantic_map_tile_cache_capacity),
+        FLAGS_semantic_map_tile_dir,
+        [this](const int64_t tx, const int64_t ty, cv::Mat* tile) {
+          DrawTile(tx, ty, tile);
+        }));
+    tile_canvas_ =
+        cv::Mat(kBaseImageSize, kBaseImageSize, CV_8UC3, cv::Scalar(0, 0, 0));
+  }
 #ifdef __aarch64__
   affine_transformer_.Init(cv::Size(2000, 2000), CV_8UC3);
 #endif
@@ -72,18 +97,25 @@ void SemanticMap::RunCurrFrame(
   }
 
   ego_feature_ = obstacle_id_history_map.at(FLAGS_ego_vehicle_id).feature(0);
+  const double x = ego_feature_.position().x();
+  const double y = ego_feature_.position().y();
   if (!FLAGS_enable_async_draw_base_image) {
-    double x = ego_feature_.position().x();
-    double y = ego_feature_.position().y();
-    curr_base_x_ = x - FLAGS_base_image_half_range;
-    curr_base_y_ = y - FLAGS_base_image_half_range;
-    DrawBaseMap(x, y, curr_base_x_, curr_base_y_);
-    base_img_.copyTo(curr_img_);
-  } else {
-    base_img_.copyTo(curr_img_);
+    DrawBaseMap(x, y);
+  }
+  cv::Mat base_img;
+  {
+    std::lock_guard<std::mutex> lock(base_img_mutex_);
+    base_img = base_img_;
     curr_base_x_ = base_x_;
     curr_base_y_ = base_y_;
-    task_future_ = cyber::Async(&SemanticMap::DrawBaseMapThread, this);
+  }
+  // base_img_ is replaced rather than redrawn in place, so the copy can be
+  // taken without blocking the drawing thread.
+  if (!base_img.empty()) {
+    base_img.copyTo(curr_img_);
+  }
+  if (FLAGS_enable_async_draw_base_image) {
+    task_future_ = cyber::Async(&SemanticMap::DrawBaseMap, this, x, y);
     // This is only for the first frame without base image yet
     if (!started_drawing_) {
       started_drawing_ = true;
@@ -116,30 +148,61 @@ void SemanticMap::RunCurrFrame(
   }
 }
 
-void SemanticMap::DrawBaseMap(const double x, const double y,
-                              const double base_x, const double base_y) {
-  base_img_ = cv::Mat(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
-  common::PointENU center_point = common::util::PointFactory::ToPointENU(x, y);
-  DrawRoads(center_point, base_x, base_y);
-  DrawJunctions(center_point, base_x, base_y);
-  DrawCrosswalks(center_point, base_x, base_y);
-  DrawLanes(center_point, base_x, base_y);
+void SemanticMap::DrawBaseMap(const double x, const double y) {
+  std::lock_guard<std::mutex> lock(draw_base_map_thread_mutex_);
+  cv::Mat img;
+  double base_x = x - FLAGS_base_image_half_range;
+  double base_y = y - FLAGS_base_image_half_range;
+  if (tile_cache_ != nullptr) {
+    // Snap the origin to the global pixel grid, so that the canvas only
+    // needs to be scrolled by whole pixels and filled at its borders.
+    const int64_t ox = static_cast<int64_t>(std::floor(base_x / kResolution));
+    const int64_t oy = static_cast<int64_t>(std::floor(base_y / kResolution));
+    tile_cache_->ScrollCanvas(ox, oy, &tile_canvas_);
+    img = tile_canvas_;
+    base_x = static_cast<double>(ox) * kResolution;
+    base_y = static_cast<double>(oy) * kResolution;
+  } else {
+    img = cv::Mat(kBaseImageSize, kBaseImageSize, CV_8UC3,
+                  cv::Scalar(0, 0, 0));
+    DrawStaticLayers(common::util::PointFactory::ToPointENU(x, y),
+                     kBaseMapSearchRadius, base_x, base_y, &img);
+  }
+
+  std::lock_guard<std::mutex> base_img_lock(base_img_mutex_);
+  base_img_ = img;
+  base_x_ = base_x;
+  base_y_ = base_y;
+}
+
+void SemanticMap::DrawTile(const int64_t tx, const int64_t ty, cv::Mat* tile) {
+  const double tile_range = tile->rows * kResolution;
+  const double base_x = static_cast<double>(tx) * tile_range;
+  const double base_y = static_cast<double>(ty) * tile_range;
+  const common::PointENU center_point = common::util::PointFactory::ToPointENU(
+      base_x + 0.5 * tile_range, base_y + 0.5 * tile_range);
+  const double radius = M_SQRT1_2 * tile_range + kTileSearchMargin;
+  // GetTransPoint flips y against the height of the base image, so shift
+  // base_y to have rows counted from the top of the tile instead.
+  DrawStaticLayers(center_point, radius, base_x,
+                   base_y - (kBaseImageSize - tile->rows) * kResolution, tile);
 }
 
-void SemanticMap::DrawBaseMapThread() {
-  std::lock_guard<std::mutex> lock(draw_base_map_thread_mutex_);
-  double x = ego_feature_.position().x();
-  double y = ego_feature_.position().y();
-  base_x_ = x - FLAGS_base_image_half_range;
-  base_y_ = y - FLAGS_base_image_half_range;
-  DrawBaseMap(x, y, base_x_, base_y_);
+void SemanticMap::DrawStaticLayers(const common::PointENU& center_point,
+                                   const double radius, const double base_x,
+                                   const double base_y, cv::Mat* img) {
+  DrawRoads(center_point, radius, base_x, base_y, img);
+  DrawJunctions(center_point, radius, base_x, base_y, img);
+  DrawCrosswalks(center_point, radius, base_x, base_y, img);
+  DrawLanes(center_point, radius, base_x, base_y, img);
 }
 
 void SemanticMap::DrawRoads(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color) {
   std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
-  apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, 141.4, &roads);
+  apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, radius, &roads);
   for (const auto& road : roads) {
     for (const auto& section : road->road().section()) {
       std::vector<cv::Point> polygon;
@@ -161,7 +224,7 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
           }
         }
       }
-      cv::fillPoly(base_img_,
+      cv::fillPoly(*img,
                    std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                    color);
     }
@@ -169,10 +232,11 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
 }
 
 void SemanticMap::DrawJunctions(const common::PointENU& center_point,
-                                const double base_x, const double base_y,
+                                const double radius, const double base_x,
+                                const double base_y, cv::Mat* img,
                                 const cv::Scalar& color) {
   std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
-  apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, 141.4,
+  apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, radius,
                                                    &junctions);
   for (const auto& junction : junctions) {
     std::vector<cv::Point> polygon;
@@ -180,17 +244,18 @@ void SemanticMap::DrawJunctions(const common::PointENU& center_point,
       polygon.push_back(
           std::move(GetTransPoint(point.x(), point.y(), base_x, base_y)));
     }
-    cv::fillPoly(base_img_,
+    cv::fillPoly(*img,
                  std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                  color);
   }
 }
 
 void SemanticMap::DrawCrosswalks(const common::PointENU& center_point,
-                                 const double base_x, const double base_y,
+                                 const double radius, const double base_x,
+                                 const double base_y, cv::Mat* img,
                                  const cv::Scalar& color) {
   std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
-  apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, 141.4,
+  apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, radius,
                                                     &crosswalks);
   for (const auto& crosswalk : crosswalks) {
     std::vector<cv::Point> polygon;
@@ -198,17 +263,18 @@ void SemanticMap::DrawCrosswalks(const common::PointENU& center_point,
       polygon.push_back(
           std::move(GetTransPoint(point.x(), point.y(), base_x, base_y)));
     }
-    cv::fillPoly(base_img_,
+    cv::fillPoly(*img,
                  std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                  color);
   }
 }
 
 void SemanticMap::DrawLanes(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color) {
   std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
-  apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, 141.4, &lanes);
+  apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, radius, &lanes);
   for (const auto& lane : lanes) {
     // Draw lane_central first
     for (const auto& segment : lane->lane().central_curve().segment()) {
@@ -232,7 +298,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
         //     cv::Scalar(rgb.at<float>(0, 0) * 255, rgb.at<float>(0, 1) * 255,
         //                rgb.at<float>(0, 2) * 255);
 
-        cv::line(base_img_, p0, p1, HSVtoRGB(H), 4);
+        cv::line(*img, p0, p1, HSVtoRGB(H), 4);
       }
     }
     // Not drawing boundary for virtual city_driving lane
@@ -249,7 +315,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
         const auto& p1 = GetTransPoint(segment.line_segment().point(i + 1).x(),
                                        segment.line_segment().point(i + 1).y(),
                                        base_x, base_y);
-        cv::line(base_img_, p0, p1, color, 2);
+        cv::line(*img, p0, p1, color, 2);
       }
     }
     // Draw lane's right_boundary
@@ -262,7 +328,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
         const auto& p1 = GetTransPoint(segment.line_segment().point(i + 1).x(),
                                        segment.line_segment().point(i + 1).y(),
                                        base_x, base_y);
-        cv::line(base_img_, p0, p1, color, 2);
+        cv::line(*img, p0, p1, color, 2);
       }
     }
   }
@@ -292,7 +358,7 @@ cv::Scalar SemanticMap::HSVtoRGB(double H, double S, double V) {
 
 void SemanticMap::DrawRect(const Feature& feature, const cv::Scalar& color,
                            const double base_x, const double base_y,
-                           cv::Mat* img) {
+                           cv::Mat* img, const cv::Point& offset) {
   double obs_l = feature.length();
   double obs_w = feature.width();
   double obs_x = feature.position().x();
@@ -317,36 +383,37 @@ void SemanticMap::DrawRect(const Feature& feature, const cv::Scalar& color,
       obs_x + (cos(theta) * obs_l - sin(theta) * -obs_w) / 2,
       obs_y + (sin(theta) * obs_l + cos(theta) * -obs_w) / 2, base_x, base_y)));
   cv::fillPoly(*img, std::vector<std::vector<cv::Point>>({std::move(polygon)}),
-               color);
+               color, cv::LINE_8, 0, offset);
 }
 
 void SemanticMap::DrawPoly(const Feature& feature, const cv::Scalar& color,
                            const double base_x, const double base_y,
-                           cv::Mat* img) {
+                           cv::Mat* img, const cv::Point& offset) {
   std::vector<cv::Point> polygon;
   for (auto& polygon_point : feature.polygon_point()) {
     polygon.push_back(std::move(
         GetTransPoint(polygon_point.x(), polygon_point.y(), base_x, base_y)));
   }
   cv::fillPoly(*img, std::vector<std::vector<cv::Point>>({std::move(polygon)}),
-               color);
+               color, cv::LINE_8, 0, offset);
 }
 
 void SemanticMap::DrawHistory(const ObstacleHistory& history,
                               const cv::Scalar& color, const double base_x,
-                              const double base_y, cv::Mat* img) {
+                              const double base_y, cv::Mat* img,
+                              const cv::Point& offset) {
   for (int i = history.feature_size() - 1; i >= 0; --i) {
     const Feature& feature = history.feature(i);
     double time_decay = 1.0 - ego_feature_.timestamp() + feature.timestamp();
     cv::Scalar decay_color = color * time_decay;
     if (feature.id() == FLAGS_ego_vehicle_id) {
-      DrawRect(feature, decay_color, base_x, base_y, img);
+      DrawRect(feature, decay_color, base_x, base_y, img, offset);
     } else {
       if (feature.polygon_point_size() == 0) {
         AERROR << "No polygon points in feature, please check!";
         continue;
       }
-      DrawPoly(feature, decay_color, base_x, base_y, img);
+      DrawPoly(feature, decay_color, base_x, base_y, img, offset);
     }
   }
 }
@@ -385,12 +452,24 @@ cv::Mat SemanticMap::CropArea(const cv::Mat& input_img,
 cv::Mat SemanticMap::CropByHistory(const ObstacleHistory& history,
                                    const cv::Scalar& color, const double base_x,
                                    const double base_y) {
-  cv::Mat feature_map = curr_img_.clone();
-  DrawHistory(history, color, base_x, base_y, &feature_map);
   const Feature& curr_feature = history.feature(0);
   const cv::Point2i& center_point = GetTransPoint(
       curr_feature.position().x(), curr_feature.position().y(), base_x, base_y);
+#ifdef __aarch64__
+  cv::Mat feature_map = curr_img_.clone();
+  DrawHistory(history, color, base_x, base_y, &feature_map);
   return CropArea(feature_map, center_point, curr_feature.theta());
+#else
+  // Only the neighbourhood of the obstacle can end up in the cropped image,
+  // so copy, draw and rotate that part instead of the whole base image.
+  const cv::Rect roi =
+      cv::Rect(center_point.x - kCropHalfSize, center_point.y - kCropHalfSize,
+               2 * kCropHalfSize, 2 * kCropHalfSize) &
+      cv::Rect(0, 0, curr_img_.cols, curr_img_.rows);
+  cv::Mat feature_map = curr_img_(roi).clone();
+  DrawHistory(history, color, base_x, base_y, &feature_map, -roi.tl());
+  return CropArea(feature_map, center_point - roi.tl(), curr_feature.theta());
+#endif
 }
 
 bool SemanticMap::GetMapById(const int obstacle_id, cv::Mat* feature_map) {
@@ -17,12 +17,15 @@
 #pragma once
 
 #include <future>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "opencv2/opencv.hpp"
 
 #include "cyber/common/macros.h"
 #include "modules/common_msgs/prediction_msgs/feature.pb.h"
+#include "modules/prediction/common/semantic_map_tile_cache.h"
 
 #ifdef __aarch64__
 #include "modules/prediction/common/affine_transform.h"
@@ -51,37 +54,50 @@ class SemanticMap {
                        static_cast<int>(2000 - (y - base_y) / 0.1));
   }
 
-  void DrawBaseMap(const double x, const double y, const double base_x,
-                   const double base_y);
+  // Update base_img_ to be centered at (x, y), either by scrolling the
+  // cached static map tiles or by rasterizing the map from scratch.
+  // It runs asynchronously if FLAGS_enable_async_draw_base_image is set.
+  void DrawBaseMap(const double x, const double y);
 
-  void DrawBaseMapThread();
+  // Rasterize the static map layers of one tile of the tile cache.
+  void DrawTile(const int64_t tx, const int64_t ty, cv::Mat* tile);
 
-  void DrawRoads(const common::PointENU& center_point, const double base_x,
-                 const double base_y,
+  void DrawStaticLayers(const common::PointENU& center_point,
+                        const double radius, const double base_x,
+                        const double base_y, cv::Mat* img);
+
+  void DrawRoads(const common::PointENU& center_point, const double radius,
+                 const double base_x, const double base_y, cv::Mat* img,
                  const cv::Scalar& color = cv::Scalar(64, 64, 64));
 
-  void DrawJunctions(const common::PointENU& center_point, const double base_x,
-                     const double base_y,
+  void DrawJunctions(const common::PointENU& center_point, const double radius,
+                     const double base_x, const double base_y, cv::Mat* img,
                      const cv::Scalar& color = cv::Scalar(128, 128, 128));
 
-  void DrawCrosswalks(const common::PointENU& center_point, const double base_x,
-                      const double base_y,
+  void DrawCrosswalks(const common::PointENU& center_point,
+                      const double radius, const double base_x,
+                      const double base_y, cv::Mat* img,
                       const cv::Scalar& color = cv::Scalar(192, 192, 192));
 
-  void DrawLanes(const common::PointENU& center_point, const double base_x,
-                 const double base_y,
+  void DrawLanes(const common::PointENU& center_point, const double radius,
+                 const double base_x, const double base_y, cv::Mat* img,
                  const cv::Scalar& color = cv::Scalar(255, 255, 255));
 
   cv::Scalar HSVtoRGB(double H = 1.0, double S = 1.0, double V = 1.0);
 
+  // The offset is added to every point, which allows drawing into a
+  // sub-image of the base image without changing the rasterization.
   void DrawRect(const Feature& feature, const cv::Scalar& color,
-                const double base_x, const double base_y, cv::Mat* img);
+                const double base_x, const double base_y, cv::Mat* img,
+                const cv::Point& offset = cv::Point());
 
   void DrawPoly(const Feature& feature, const cv::Scalar& color,
-                const double base_x, const double base_y, cv::Mat* img);
+                const double base_x, const double base_y, cv::Mat* img,
+                const cv::Point& offset = cv::Point());
 
   void DrawHistory(const ObstacleHistory& history, const cv::Scalar& color,
-                   const double base_x, const double base_y, cv::Mat* img);
+                   const double base_x, const double base_y, cv::Mat* img,
+                   const cv::Point& offset = cv::Point());
 
   // Draw adc trajectory in semantic map
   void DrawADCTrajectory(const cv::Scalar& color, const double base_x,
@@ -99,8 +115,15 @@ class SemanticMap {
   double base_x_ = 0.0;
   double base_y_ = 0.0;
 
+  std::mutex base_img_mutex_;
+
   std::mutex draw_base_map_thread_mutex_;
 
+  // Static map tiles and the ego-centred canvas composed from them, only
+  // touched while holding draw_base_map_thread_mutex_
+  std::unique_ptr<SemanticMapTileCache> tile_cache_;
+  cv::Mat tile_canvas_;
+
   // base_image, base_x, and base_y to be used in the current cycle
   cv::Mat curr_img_;
   double curr_base_x_ = 0.0;
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/semantic_map_tile_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "absl/strings/str_cat.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace prediction {
+
+SemanticMapTileCache::SemanticMapTileCache(const int tile_size,
+                                           const size_t capacity,
+                                           const std::string& tile_dir,
+                                           TileRenderer renderer)
+    : tile_size_(tile_size),
+      capacity_(std::max<size_t>(capacity, 1)),
+      tile_dir_(tile_dir),
+      renderer_(std::move(renderer)) {
+  CHECK_GT(tile_size_, 0);
+}
+
+void SemanticMapTileCache::ScrollCanvas(const int64_t ox, const int64_t oy,
+                                        cv::Mat* canvas) {
+  CHECK_NOTNULL(canvas);
+  const int width = canvas->cols;
+  const int height = canvas->rows;
+  const int64_t dx = ox - canvas_ox_;
+  const int64_t dy = oy - canvas_oy_;
+  canvas_ox_ = ox;
+  canvas_oy_ = oy;
+
+  if (!has_canvas_origin_ || std::abs(dx) >= width ||
+      std::abs(dy) >= height) {
+    has_canvas_origin_ = true;
+    *canvas = cv::Mat(height, width, canvas->type());
+    FillCanvas(cv::Rect(0, 0, width, height), ox, oy, canvas);
+    return;
+  }
+  if (dx == 0 && dy == 0) {
+    return;
+  }
+
+  // New column c shows old column c + dx, new row r shows old row r - dy.
+  const int shift_x = static_cast<int>(dx);
+  const int shift_y = static_cast<int>(dy);
+  const cv::Rect kept(std::max(0, -shift_x), std::max(0, shift_y),
+                      width - std::abs(shift_x), height - std::abs(shift_y));
+  const cv::Rect src(kept.x + shift_x, kept.y - shift_y, kept.width,
+                     kept.height);
+  cv::Mat shifted(canvas->size(), canvas->type());
+  (*canvas)(src).copyTo(shifted(kept));
+  *canvas = shifted;
+
+  // Exposed full-width strips above and below the kept area, then the
+  // exposed columns on its left and right.
+  if (kept.y > 0) {
+    FillCanvas(cv::Rect(0, 0, width, kept.y), ox, oy, canvas);
+  }
+  if (kept.br().y < height) {
+    FillCanvas(cv::Rect(0, kept.br().y, width, height - kept.br().y), ox, oy,
+               canvas);
+  }
+  if (kept.x > 0) {
+    FillCanvas(cv::Rect(0, kept.y, kept.x, kept.height), ox, oy, canvas);
+  }
+  if (kept.br().x < width) {
+    FillCanvas(cv::Rect(kept.br().x, kept.y, width - kept.br().x, kept.height),
+               ox, oy, canvas);
+  }
+}
+
+void SemanticMapTileCache::FillCanvas(const cv::Rect& region,
+                                      const int64_t ox, const int64_t oy,
+                                      cv::Mat* canvas) {
+  CHECK_NOTNULL(canvas);
+  if (region.area() <= 0) {
+    return;
+  }
+  const int64_t height = canvas->rows;
+  const int64_t tx_begin = FloorDiv(ox + region.x, tile_size_);
+  const int64_t tx_end = FloorDiv(ox + region.br().x - 1, tile_size_);
+  const int64_t ty_begin = FloorDiv(oy + height - region.br().y, tile_size_);
+  const int64_t ty_end = FloorDiv(oy + height - region.y - 1, tile_size_);
+
+  for (int64_t tx = tx_begin; tx <= tx_end; ++tx) {
+    // canvas column c <-> tile column c + col_offset
+    const int64_t col_offset = ox - tx * tile_size_;
+    const int c0 = static_cast<int>(
+        std::max<int64_t>(region.x, tx * tile_size_ - ox));
+    const int c1 = static_cast<int>(
+        std::min<int64_t>(region.br().x, (tx + 1) * tile_size_ - ox));
+    for (int64_t ty = ty_begin; ty <= ty_end; ++ty) {
+      // canvas row r <-> tile row r + row_offset
+      const int64_t row_offset = (ty + 1) * tile_size_ - oy - height;
+      const int r0 = static_cast<int>(
+          std::max<int64_t>(region.y, oy + height - (ty + 1) * tile_size_));
+      const int r1 = static_cast<int>(
+          std::min<int64_t>(region.br().y, oy + height - ty * tile_size_));
+      if (c0 >= c1 || r0 >= r1) {
+        continue;
+      }
+      const cv::Mat& tile = GetTile(tx, ty);
+      const cv::Rect tile_rect(static_cast<int>(c0 + col_offset),
+                               static_cast<int>(r0 + row_offset), c1 - c0,
+                               r1 - r0);
+      tile(tile_rect).copyTo((*canvas)(cv::Rect(c0, r0, c1 - c0, r1 - r0)));
+    }
+  }
+}
+
+const cv::Mat& SemanticMapTileCache::GetTile(const int64_t tx,
+                                             const int64_t ty) {
+  const TileKey key(tx, ty);
+  auto iter = tiles_.find(key);
+  if (iter != tiles_.end()) {
+    tile_list_.splice(tile_list_.begin(), tile_list_, iter->second);
+    return iter->second->second;
+  }
+
+  cv::Mat tile;
+  if (!LoadTile(tx, ty, &tile)) {
+    tile = cv::Mat(tile_size_, tile_size_, CV_8UC3, cv::Scalar(0, 0, 0));
+    renderer_(tx, ty, &tile);
+    ++num_rendered_tiles_;
+    SaveTile(tx, ty, tile);
+  }
+
+  if (tiles_.size() >= capacity_) {
+    tiles_.erase(tile_list_.back().first);
+    tile_list_.pop_back();
+  }
+  tile_list_.emplace_front(key, std::move(tile));
+  tiles_[key] = tile_list_.begin();
+  return tile_list_.front().second;
+}
+
+std::string SemanticMapTileCache::TilePath(const int64_t tx,
+                                           const int64_t ty) const {
+  return absl::StrCat(tile_dir_, "/", tile_size_, "_", tx, "_", ty, ".png");
+}
+
+bool SemanticMapTileCache::LoadTile(const int64_t tx, const int64_t ty,
+                                    cv::Mat* tile) const {
+  if (tile_dir_.empty()) {
+    return false;
+  }
+  const std::string path = TilePath(tx, ty);
+  if (!cyber::common::PathExists(path)) {
+    return false;
+  }
+  cv::Mat loaded = cv::imread(path, cv::IMREAD_COLOR);
+  if (loaded.rows != tile_size_ || loaded.cols != tile_size_) {
+    AWARN << "Ignore semantic map tile with unexpected size: " << path;
+    return false;
+  }
+  *tile = loaded;
+  return true;
+}
+
+void SemanticMapTileCache::SaveTile(const int64_t tx, const int64_t ty,
+                                    const cv::Mat& tile) const {
+  if (tile_dir_.empty() || !cyber::common::EnsureDirectory(tile_dir_)) {
+    return;
+  }
+  const std::string path = TilePath(tx, ty);
+  if (!cv::imwrite(path, tile)) {
+    AWARN << "Failed to write semantic map tile: " << path;
+  }
+}
+
+}  // namespace prediction
+}  // namespace apollo
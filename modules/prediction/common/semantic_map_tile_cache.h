@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Cache of pre-rasterized static map tiles used by SemanticMap.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "opencv2/opencv.hpp"
+
+namespace apollo {
+namespace prediction {
+
+/**
+ * @class SemanticMapTileCache
+ * @brief Keeps square tiles of the static map layers, indexed on a global
+ *        pixel grid, and composes them into an ego-centred canvas that is
+ *        scrolled incrementally as the ego moves.
+ *
+ * Global pixel (gx, gy) covers world [gx * res, (gx + 1) * res) and the
+ * y axis points up. Tile (tx, ty) covers gx in [tx * size, (tx + 1) * size)
+ * and gy in (ty * size, (ty + 1) * size], with image row 0 at the top.
+ * A canvas with origin (ox, oy) maps its column c to gx = ox + c and its
+ * row r to gy = oy + canvas_height - r, which matches the transform used by
+ * SemanticMap::GetTransPoint.
+ *
+ * The class is not thread-safe; SemanticMap only touches it from the
+ * base map drawing task.
+ */
+class SemanticMapTileCache {
+ public:
+  /**
+   * @brief Draws the static layers of tile (tx, ty) into an already
+   *        allocated, zero-initialized tile image.
+   */
+  using TileRenderer =
+      std::function<void(const int64_t tx, const int64_t ty, cv::Mat* tile)>;
+
+  SemanticMapTileCache(const int tile_size, const size_t capacity,
+                       const std::string& tile_dir, TileRenderer renderer);
+
+  /**
+   * @brief Updates the canvas so that its origin becomes (ox, oy).
+   *        Pixels shared with the previous origin are copied into a new
+   *        buffer at their shifted position and only the newly exposed
+   *        strips are filled from tiles.
+   * @param ox Global pixel column of the canvas left edge.
+   * @param oy Global pixel row of the canvas bottom edge.
+   * @param canvas The allocated canvas to update. Its buffer is replaced
+   *        rather than modified in place, so readers still holding the
+   *        previous cv::Mat keep a consistent image.
+   */
+  void ScrollCanvas(const int64_t ox, const int64_t oy, cv::Mat* canvas);
+
+  /**
+   * @brief Fills a region of the canvas from tiles, rendering missing ones.
+   */
+  void FillCanvas(const cv::Rect& region, const int64_t ox, const int64_t oy,
+                  cv::Mat* canvas);
+
+  /**
+   * @brief Gets a tile, loading or rendering it on first use.
+   */
+  const cv::Mat& GetTile(const int64_t tx, const int64_t ty);
+
+  /**
+   * @brief Forgets the canvas origin so the next scroll redraws everything.
+   */
+  void ResetCanvas() { has_canvas_origin_ = false; }
+
+  int tile_size() const { return tile_size_; }
+
+  size_t size() const { return tiles_.size(); }
+
+  size_t num_rendered_tiles() const { return num_rendered_tiles_; }
+
+  static int64_t FloorDiv(const int64_t a, const int64_t b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+  }
+
+ private:
+  using TileKey = std::pair<int64_t, int64_t>;
+
+  struct TileKeyHash {
+    size_t operator()(const TileKey& key) const {
+      return std::hash<int64_t>()(key.first * 73856093 ^
+                                  key.second * 19349663);
+    }
+  };
+
+  using TileList = std::list<std::pair<TileKey, cv::Mat>>;
+
+  std::string TilePath(const int64_t tx, const int64_t ty) const;
+
+  bool LoadTile(const int64_t tx, const int64_t ty, cv::Mat* tile) const;
+
+  void SaveTile(const int64_t tx, const int64_t ty, const cv::Mat& tile) const;
+
+ private:
+  const int tile_size_;
+  const size_t capacity_;
+  const std::string tile_dir_;
+  TileRenderer renderer_;
+
+  // Most recently used tiles are kept at the front.
+  TileList tile_list_;
+  std::unordered_map<TileKey, TileList::iterator, TileKeyHash> tiles_;
+  size_t num_rendered_tiles_ = 0;
+
+  bool has_canvas_origin_ = false;
+  int64_t canvas_ox_ = 0;
+  int64_t canvas_oy_ = 0;
+};
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/semantic_map_tile_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace prediction {
+
+namespace {
+
+// Encodes the global pixel coordinates into the color so that every pixel
+// of the composed canvas can be checked.
+void RenderGlobalPixels(const int tile_size, const int64_t tx,
+                        const int64_t ty, cv::Mat* tile) {
+  for (int r = 0; r < tile_size; ++r) {
+    for (int c = 0; c < tile_size; ++c) {
+      const int64_t gx = tx * tile_size + c;
+      const int64_t gy = ty * tile_size + tile_size - r;
+      tile->at<cv::Vec3b>(r, c) =
+          cv::Vec3b(static_cast<uchar>(gx & 0xff),
+                    static_cast<uchar>(gy & 0xff),
+                    static_cast<uchar>((gx * 7 + gy * 13) & 0xff));
+    }
+  }
+}
+
+bool CanvasMatchesOrigin(const cv::Mat& canvas, const int64_t ox,
+                         const int64_t oy) {
+  for (int r = 0; r < canvas.rows; ++r) {
+    for (int c = 0; c < canvas.cols; ++c) {
+      const int64_t gx = ox + c;
+      const int64_t gy = oy + canvas.rows - r;
+      const cv::Vec3b expected(static_cast<uchar>(gx & 0xff),
+                               static_cast<uchar>(gy & 0xff),
+                               static_cast<uchar>((gx * 7 + gy * 13) & 0xff));
+      if (canvas.at<cv::Vec3b>(r, c) != expected) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(SemanticMapTileCacheTest, floor_div) {
+  EXPECT_EQ(0, SemanticMapTileCache::FloorDiv(0, 16));
+  EXPECT_EQ(0, SemanticMapTileCache::FloorDiv(15, 16));
+  EXPECT_EQ(1, SemanticMapTileCache::FloorDiv(16, 16));
+  EXPECT_EQ(-1, SemanticMapTileCache::FloorDiv(-1, 16));
+  EXPECT_EQ(-1, SemanticMapTileCache::FloorDiv(-16, 16));
+  EXPECT_EQ(-2, SemanticMapTileCache::FloorDiv(-17, 16));
+}
+
+TEST(SemanticMapTileCacheTest, scroll_matches_full_redraw) {
+  const int tile_size = 16;
+  SemanticMapTileCache cache(
+      tile_size, 64, "",
+      [tile_size](const int64_t tx, const int64_t ty, cv::Mat* tile) {
+        RenderGlobalPixels(tile_size, tx, ty, tile);
+      });
+
+  cv::Mat canvas(50, 40, CV_8UC3, cv::Scalar(0, 0, 0));
+  const std::vector<std::pair<int64_t, int64_t>> origins = {
+      {-7, 3}, {-4, 5}, {10, -9}, {10, -9}, {9, 30}, {200, -100}, {195, -97}};
+  for (const auto& origin : origins) {
+    cache.ScrollCanvas(origin.first, origin.second, &canvas);
+    EXPECT_TRUE(CanvasMatchesOrigin(canvas, origin.first, origin.second));
+  }
+}
+
+TEST(SemanticMapTileCacheTest, lru_eviction) {
+  int num_renders = 0;
+  SemanticMapTileCache cache(
+      8, 2, "", [&num_renders](const int64_t, const int64_t, cv::Mat*) {
+        ++num_renders;
+      });
+  cache.GetTile(0, 0);
+  cache.GetTile(0, 1);
+  cache.GetTile(0, 0);
+  EXPECT_EQ(2, num_renders);
+  cache.GetTile(1, 0);
+  EXPECT_EQ(3, num_renders);
+  EXPECT_EQ(2, cache.size());
+  // (0, 1) was the least recently used tile and has been evicted.
+  cache.GetTile(0, 0);
+  EXPECT_EQ(3, num_renders);
+  cache.GetTile(0, 1);
+  EXPECT_EQ(4, num_renders);
+  EXPECT_EQ(4, cache.num_rendered_tiles());
+}
+
+}  // namespace prediction
+}  // namespace apollo
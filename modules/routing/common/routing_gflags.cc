@@ -32,3 +32,10 @@ DEFINE_bool(enable_change_lane_in_result, true,
 
 DEFINE_uint32(routing_response_history_interval_ms, 1000,
               "ms, emit routing resposne for this time interval");
+
+DEFINE_bool(use_routing_landmarks, true,
+            "use the landmark costs stored alongside the routing map as A* "
+            "heuristic if they exist");
+
+DEFINE_int32(routing_landmark_num, 16,
+             "number of landmarks computed with the routing map, 0 to skip");
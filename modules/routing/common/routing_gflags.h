@@ -24,3 +24,6 @@ DECLARE_string(routing_node_name);
 DECLARE_double(min_length_for_lane_change);
 DECLARE_bool(enable_change_lane_in_result);
 DECLARE_uint32(routing_response_history_interval_ms);
+
+DECLARE_bool(use_routing_landmarks);
+DECLARE_int32(routing_landmark_num);
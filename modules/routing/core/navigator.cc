@@ -16,6 +16,8 @@
 
 #include "modules/routing/core/navigator.h"
 
+#include <utility>
+
 #include "cyber/common/file.h"
 #include "modules/routing/common/routing_gflags.h"
 #include "modules/routing/graph/sub_topo_graph.h"
@@ -107,6 +109,9 @@ Navigator::Navigator(const std::string& topo_file_path) {
           << topo_file_path;
     return;
   }
+  if (FLAGS_use_routing_landmarks) {
+    LoadLandmarkIndex(topo_file_path);
+  }
   black_list_generator_.reset(new BlackListRangeGenerator);
   result_generator_.reset(new ResultGenerator);
   is_ready_ = true;
@@ -119,6 +124,26 @@ bool Navigator::IsReady() const { return is_ready_; }
 
 void Navigator::Clear() { topo_range_manager_.Clear(); }
 
+void Navigator::LoadLandmarkIndex(const std::string& topo_file_path) {
+  const std::string index_file = LandmarkIndex::IndexFile(topo_file_path);
+  if (!cyber::common::PathExists(index_file)) {
+    AINFO << "No routing landmarks at " << index_file
+          << ", search with the manhattan heuristic.";
+    return;
+  }
+  RoutingLandmarks landmarks;
+  std::unique_ptr<LandmarkIndex> landmark_index(new LandmarkIndex());
+  if (!cyber::common::GetProtoFromFile(index_file, &landmarks) ||
+      !landmark_index->Init(landmarks, graph_.get())) {
+    AWARN << "Failed to load routing landmarks from " << index_file
+          << ", search with the manhattan heuristic.";
+    return;
+  }
+  AINFO << "Loaded " << landmark_index->LandmarkNum()
+        << " routing landmarks from " << index_file;
+  landmark_index_ = std::move(landmark_index);
+}
+
 bool Navigator::Init(const routing::RoutingRequest& request,
                      const TopoGraph* graph,
                      std::vector<const TopoNode*>* const way_nodes,
@@ -156,7 +181,8 @@ bool Navigator::SearchRouteByStrategy(
     const std::vector<double>& way_s,
     std::vector<NodeWithRange>* const result_nodes) const {
   std::unique_ptr<Strategy> strategy_ptr;
-  strategy_ptr.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result));
+  strategy_ptr.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result,
+                                       landmark_index_.get()));
 
   result_nodes->clear();
   std::vector<NodeWithRange> node_vec;
@@ -22,6 +22,7 @@
 
 #include "modules/routing/core/black_list_range_generator.h"
 #include "modules/routing/core/result_generator.h"
+#include "modules/routing/graph/landmark_index.h"
 
 namespace apollo {
 namespace routing {
@@ -43,6 +44,8 @@ class Navigator {
 
   void Clear();
 
+  void LoadLandmarkIndex(const std::string& topo_file_path);
+
   bool SearchRouteByStrategy(
       const TopoGraph* graph, const std::vector<const TopoNode*>& way_nodes,
       const std::vector<double>& way_s,
@@ -54,6 +57,7 @@ class Navigator {
  private:
   bool is_ready_ = false;
   std::unique_ptr<TopoGraph> graph_;
+  std::unique_ptr<LandmarkIndex> landmark_index_;
 
   TopoRangeManager topo_range_manager_;
 
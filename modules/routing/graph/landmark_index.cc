@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/routing/graph/landmark_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "absl/strings/match.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace routing {
+
+namespace {
+
+struct AdjacentNode {
+  int node = 0;
+  double cost = 0.0;
+};
+
+using AdjacencyList = std::vector<std::vector<AdjacentNode>>;
+
+// The cost AStarStrategy pays for an edge: lane changes are discounted by
+// half the cost of both lanes. Clamped to 0 so that Dijkstra applies.
+double GetEdgeCost(const Edge& edge, const Node& from_node,
+                   const Node& to_node) {
+  double cost = edge.cost() + to_node.cost();
+  if (edge.direction_type() != Edge::FORWARD) {
+    cost -= (from_node.cost() + to_node.cost()) / 2;
+  }
+  return std::max(cost, 0.0);
+}
+
+void Dijkstra(const AdjacencyList& graph, int source,
+              std::vector<double>* const costs) {
+  using QueueItem = std::pair<double, int>;
+  std::priority_queue<QueueItem, std::vector<QueueItem>,
+                      std::greater<QueueItem>>
+      queue;
+  costs->assign(graph.size(), -1.0);
+  (*costs)[source] = 0.0;
+  queue.emplace(0.0, source);
+  while (!queue.empty()) {
+    const double cost = queue.top().first;
+    const int node = queue.top().second;
+    queue.pop();
+    if (cost > (*costs)[node]) {
+      continue;
+    }
+    for (const auto& next : graph[node]) {
+      const double next_cost = cost + next.cost;
+      if ((*costs)[next.node] < 0.0 || next_cost < (*costs)[next.node]) {
+        (*costs)[next.node] = next_cost;
+        queue.emplace(next_cost, next.node);
+      }
+    }
+  }
+}
+
+// Keeps the cost of every node to its closest landmark, counting the
+// directions in which they are connected.
+void UpdateClosestCost(const std::vector<double>& cost_from,
+                       const std::vector<double>& cost_to,
+                       std::vector<double>* const closest_cost) {
+  for (size_t i = 0; i < closest_cost->size(); ++i) {
+    if (cost_from[i] < 0.0 && cost_to[i] < 0.0) {
+      continue;
+    }
+    const double cost =
+        std::max(cost_from[i], 0.0) + std::max(cost_to[i], 0.0);
+    (*closest_cost)[i] = std::min((*closest_cost)[i], cost);
+  }
+}
+
+}  // namespace
+
+std::string LandmarkIndex::IndexFile(const std::string& topo_file_path) {
+  std::string path = topo_file_path;
+  if (absl::EndsWith(path, ".bin") || absl::EndsWith(path, ".txt")) {
+    path.resize(path.size() - 4);
+  }
+  return path + "_landmarks.bin";
+}
+
+bool LandmarkIndex::Build(const Graph& graph, int landmark_num,
+                          RoutingLandmarks* landmarks) {
+  landmarks->Clear();
+  const int node_num = graph.node_size();
+  if (node_num == 0 || landmark_num <= 0) {
+    AERROR << "No landmark to build, node num: " << node_num
+           << ", landmark num: " << landmark_num;
+    return false;
+  }
+  landmarks->set_hdmap_version(graph.hdmap_version());
+
+  std::unordered_map<std::string, int> node_index;
+  for (int i = 0; i < node_num; ++i) {
+    node_index[graph.node(i).lane_id()] = i;
+    landmarks->add_lane_id(graph.node(i).lane_id());
+  }
+  AdjacencyList forward_graph(node_num);
+  AdjacencyList backward_graph(node_num);
+  for (const auto& edge : graph.edge()) {
+    const auto from_iter = node_index.find(edge.from_lane_id());
+    const auto to_iter = node_index.find(edge.to_lane_id());
+    if (from_iter == node_index.end() || to_iter == node_index.end()) {
+      AWARN << "Ignore edge with unknown lane: " << edge.from_lane_id()
+            << " -> " << edge.to_lane_id();
+      continue;
+    }
+    const double cost =
+        GetEdgeCost(edge, graph.node(from_iter->second),
+                    graph.node(to_iter->second));
+    forward_graph[from_iter->second].push_back({to_iter->second, cost});
+    backward_graph[to_iter->second].push_back({from_iter->second, cost});
+  }
+
+  // Farthest landmark selection: the next landmark is the node the farthest
+  // from the closest landmark so far, starting from the first node.
+  std::vector<double> closest_cost(node_num,
+                                   std::numeric_limits<double>::infinity());
+  std::vector<double> cost_from;
+  std::vector<double> cost_to;
+  Dijkstra(forward_graph, 0, &cost_from);
+  Dijkstra(backward_graph, 0, &cost_to);
+  UpdateClosestCost(cost_from, cost_to, &closest_cost);
+  std::vector<bool> is_landmark(node_num, false);
+  for (int i = 0; i < std::min(landmark_num, node_num); ++i) {
+    int next = -1;
+    for (int j = 0; j < node_num; ++j) {
+      if (!is_landmark[j] &&
+          (next < 0 || closest_cost[j] > closest_cost[next])) {
+        next = j;
+      }
+    }
+    is_landmark[next] = true;
+    Dijkstra(forward_graph, next, &cost_from);
+    Dijkstra(backward_graph, next, &cost_to);
+    UpdateClosestCost(cost_from, cost_to, &closest_cost);
+
+    auto* landmark = landmarks->add_landmark();
+    landmark->set_lane_id(graph.node(next).lane_id());
+    landmark->mutable_cost_from()->Reserve(node_num);
+    landmark->mutable_cost_to()->Reserve(node_num);
+    for (int j = 0; j < node_num; ++j) {
+      landmark->add_cost_from(cost_from[j]);
+      landmark->add_cost_to(cost_to[j]);
+    }
+  }
+  AINFO << "Built " << landmarks->landmark_size() << " landmarks for "
+        << node_num << " nodes.";
+  return true;
+}
+
+bool LandmarkIndex::Init(const RoutingLandmarks& landmarks,
+                         const TopoGraph* graph) {
+  landmark_num_ = 0;
+  node_index_.clear();
+  cost_from_.clear();
+  cost_to_.clear();
+  if (landmarks.hdmap_version() != graph->MapVersion()) {
+    AWARN << "Landmarks are built for map version "
+          << landmarks.hdmap_version() << ", not " << graph->MapVersion();
+    return false;
+  }
+  const size_t node_num = landmarks.lane_id_size();
+  const size_t landmark_num = landmarks.landmark_size();
+  if (landmark_num == 0) {
+    AWARN << "No landmark in the index.";
+    return false;
+  }
+  for (const auto& landmark : landmarks.landmark()) {
+    if (static_cast<size_t>(landmark.cost_from_size()) != node_num ||
+        static_cast<size_t>(landmark.cost_to_size()) != node_num) {
+      AWARN << "Invalid costs of landmark " << landmark.lane_id();
+      return false;
+    }
+  }
+  node_index_.reserve(node_num);
+  for (size_t i = 0; i < node_num; ++i) {
+    const auto* node = graph->GetNode(landmarks.lane_id(i));
+    if (node == nullptr) {
+      AWARN << "Landmark index lane " << landmarks.lane_id(i)
+            << " is not in the graph.";
+      node_index_.clear();
+      return false;
+    }
+    node_index_[node] = i;
+  }
+  cost_from_.resize(node_num * landmark_num);
+  cost_to_.resize(node_num * landmark_num);
+  for (size_t j = 0; j < landmark_num; ++j) {
+    const auto& landmark = landmarks.landmark(j);
+    for (size_t i = 0; i < node_num; ++i) {
+      cost_from_[i * landmark_num + j] = landmark.cost_from(i);
+      cost_to_[i * landmark_num + j] = landmark.cost_to(i);
+    }
+  }
+  landmark_num_ = landmark_num;
+  return true;
+}
+
+bool LandmarkIndex::LowerBound(const TopoNode* from_node,
+                               const TopoNode* to_node,
+                               double* cost) const {
+  // Sub nodes share the costs of their origin nodes, a sub graph only
+  // removes edges.
+  const auto from_iter = node_index_.find(from_node->OriginNode());
+  const auto to_iter = node_index_.find(to_node->OriginNode());
+  if (from_iter == node_index_.end() || to_iter == node_index_.end()) {
+    return false;
+  }
+  const double* from_cost_from = &cost_from_[from_iter->second * landmark_num_];
+  const double* from_cost_to = &cost_to_[from_iter->second * landmark_num_];
+  const double* to_cost_from = &cost_from_[to_iter->second * landmark_num_];
+  const double* to_cost_to = &cost_to_[to_iter->second * landmark_num_];
+  double bound = 0.0;
+  for (size_t i = 0; i < landmark_num_; ++i) {
+    // triangle inequalities d(l, to) <= d(l, from) + d(from, to) and
+    // d(from, l) <= d(from, to) + d(to, l)
+    if (from_cost_from[i] >= 0.0 && to_cost_from[i] >= 0.0) {
+      bound = std::max(bound, to_cost_from[i] - from_cost_from[i]);
+    }
+    if (from_cost_to[i] >= 0.0 && to_cost_to[i] >= 0.0) {
+      bound = std::max(bound, from_cost_to[i] - to_cost_to[i]);
+    }
+  }
+  *cost = bound;
+  return true;
+}
+
+}  // namespace routing
+}  // namespace apollo
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/routing/graph/topo_graph.h"
+#include "modules/routing/proto/topo_graph.pb.h"
+
+namespace apollo {
+namespace routing {
+
+/**
+ * @class LandmarkIndex
+ * @brief Lower bounds of the routing cost between two nodes, computed from
+ * the costs to and from a few landmark nodes (ALT). Black listed ranges only
+ * make routes more expensive, so the bounds hold for any sub graph.
+ */
+class LandmarkIndex {
+ public:
+  LandmarkIndex() = default;
+  ~LandmarkIndex() = default;
+
+  /**
+   * @brief The landmark file stored alongside a routing topo file.
+   */
+  static std::string IndexFile(const std::string& topo_file_path);
+
+  /**
+   * @brief Picks the landmarks of the graph and computes their costs.
+   */
+  static bool Build(const Graph& graph, int landmark_num,
+                    RoutingLandmarks* landmarks);
+
+  /**
+   * @brief Binds the landmark costs to the nodes of a loaded graph.
+   * @return False if the index was not built from that graph.
+   */
+  bool Init(const RoutingLandmarks& landmarks, const TopoGraph* graph);
+
+  bool IsReady() const { return landmark_num_ > 0; }
+
+  size_t LandmarkNum() const { return landmark_num_; }
+
+  /**
+   * @brief Lower bound of the cost from one node to another.
+   * @return False if one of the nodes is not indexed.
+   */
+  bool LowerBound(const TopoNode* from_node, const TopoNode* to_node,
+                  double* cost) const;
+
+ private:
+  size_t landmark_num_ = 0;
+  std::unordered_map<const TopoNode*, size_t> node_index_;
+  // Indexed by node_index * landmark_num_ + landmark_index.
+  std::vector<double> cost_from_;
+  std::vector<double> cost_to_;
+};
+
+}  // namespace routing
+}  // namespace apollo
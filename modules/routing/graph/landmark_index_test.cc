@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/routing/graph/landmark_index.h"
+
+#include "gtest/gtest.h"
+#include "modules/routing/graph/sub_topo_graph.h"
+#include "modules/routing/graph/topo_test_utils.h"
+#include "modules/routing/strategy/a_star_strategy.h"
+
+namespace apollo {
+namespace routing {
+
+TEST(LandmarkIndexTestSuit, index_file) {
+  EXPECT_EQ("/map/routing_map_landmarks.bin",
+            LandmarkIndex::IndexFile("/map/routing_map.bin"));
+  EXPECT_EQ("/map/routing_map_landmarks.bin",
+            LandmarkIndex::IndexFile("/map/routing_map.txt"));
+}
+
+TEST(LandmarkIndexTestSuit, lower_bound) {
+  Graph graph;
+  GetGraph3ForTest(&graph);
+  RoutingLandmarks landmarks;
+  ASSERT_TRUE(LandmarkIndex::Build(graph, 2, &landmarks));
+  ASSERT_EQ(2, landmarks.landmark_size());
+  ASSERT_EQ(graph.node_size(), landmarks.lane_id_size());
+
+  TopoGraph topo_graph;
+  ASSERT_TRUE(topo_graph.LoadGraph(graph));
+  LandmarkIndex index;
+  ASSERT_TRUE(index.Init(landmarks, &topo_graph));
+  ASSERT_TRUE(index.IsReady());
+
+  // L1 -> L3 -> L5 is the only route, it costs the lanes and the edges.
+  const double cost = 2 * (TEST_EDGE_COST + TEST_LANE_COST);
+  double bound = -1.0;
+  ASSERT_TRUE(index.LowerBound(topo_graph.GetNode(TEST_L1),
+                               topo_graph.GetNode(TEST_L5), &bound));
+  EXPECT_GE(bound, 0.0);
+  EXPECT_LE(bound, cost + 1e-9);
+  ASSERT_TRUE(index.LowerBound(topo_graph.GetNode(TEST_L5),
+                               topo_graph.GetNode(TEST_L5), &bound));
+  EXPECT_DOUBLE_EQ(0.0, bound);
+
+  landmarks.set_hdmap_version("other_version");
+  EXPECT_FALSE(index.Init(landmarks, &topo_graph));
+  EXPECT_FALSE(index.IsReady());
+}
+
+TEST(LandmarkIndexTestSuit, search_with_landmarks) {
+  Graph graph;
+  GetGraph3ForTest(&graph);
+  TopoGraph topo_graph;
+  ASSERT_TRUE(topo_graph.LoadGraph(graph));
+  RoutingLandmarks landmarks;
+  ASSERT_TRUE(LandmarkIndex::Build(graph, 4, &landmarks));
+  LandmarkIndex index;
+  ASSERT_TRUE(index.Init(landmarks, &topo_graph));
+
+  std::unordered_map<const TopoNode*, std::vector<NodeSRange>> black_map;
+  SubTopoGraph sub_graph(black_map);
+  const TopoNode* src_node = topo_graph.GetNode(TEST_L1);
+  const TopoNode* dest_node = topo_graph.GetNode(TEST_L5);
+
+  AStarStrategy plain_strategy(true);
+  std::vector<NodeWithRange> plain_result;
+  ASSERT_TRUE(plain_strategy.Search(&topo_graph, &sub_graph, src_node,
+                                    dest_node, &plain_result));
+  AStarStrategy landmark_strategy(true, &index);
+  std::vector<NodeWithRange> landmark_result;
+  ASSERT_TRUE(landmark_strategy.Search(&topo_graph, &sub_graph, src_node,
+                                       dest_node, &landmark_result));
+
+  ASSERT_EQ(plain_result.size(), landmark_result.size());
+  for (size_t i = 0; i < plain_result.size(); ++i) {
+    EXPECT_EQ(plain_result[i].GetTopoNode(), landmark_result[i].GetTopoNode());
+  }
+}
+
+}  // namespace routing
+}  // namespace apollo
@@ -201,8 +201,9 @@ bool Reconstruct(
 
 }  // namespace
 
-AStarStrategy::AStarStrategy(bool enable_change)
-    : change_lane_enabled_(enable_change) {}
+AStarStrategy::AStarStrategy(bool enable_change,
+                             const LandmarkIndex* landmark_index)
+    : change_lane_enabled_(enable_change), landmark_index_(landmark_index) {}
 
 void AStarStrategy::Clear() {
   closed_set_.clear();
@@ -214,6 +215,11 @@ void AStarStrategy::Clear() {
 
 double AStarStrategy::HeuristicCost(const TopoNode* src_node,
                                     const TopoNode* dest_node) {
+  double cost = 0.0;
+  if (landmark_index_ != nullptr && landmark_index_->IsReady() &&
+      landmark_index_->LowerBound(src_node, dest_node, &cost)) {
+    return cost;
+  }
   const auto& src_point = src_node->AnchorPoint();
   const auto& dest_point = dest_node->AnchorPoint();
   double distance = std::fabs(src_point.x() - dest_point.x()) +
@@ -289,8 +295,8 @@ bool AStarStrategy::Search(const TopoGraph* graph,
         tentative_g_score -=
             (edge->FromNode()->Cost() + edge->ToNode()->Cost()) / 2;
       }
-      double f = tentative_g_score + HeuristicCost(to_node, dest_node);
-      if (open_set_.count(to_node) != 0 && f >= g_score_[to_node]) {
+      if (open_set_.count(to_node) != 0 &&
+          tentative_g_score >= g_score_[to_node]) {
         continue;
       }
       // if to_node is reached by forward, reset enter_s to start_s
@@ -310,9 +316,9 @@ bool AStarStrategy::Search(const TopoGraph* graph,
         enter_s_[to_node] = to_node_enter_s;
       }
 
-      g_score_[to_node] = f;
+      g_score_[to_node] = tentative_g_score;
       SearchNode next_node(to_node);
-      next_node.f = f;
+      next_node.f = tentative_g_score + HeuristicCost(to_node, dest_node);
       open_set_detail.push(next_node);
       came_from_[to_node] = from_node;
       if (open_set_.count(to_node) == 0) {
@@ -20,6 +20,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "modules/routing/graph/landmark_index.h"
 #include "modules/routing/strategy/strategy.h"
 
 namespace apollo {
@@ -27,13 +28,21 @@ namespace routing {
 
 class AStarStrategy : public Strategy {
  public:
-  explicit AStarStrategy(bool enable_change);
+  /**
+   * @param enable_change Whether the route may change lanes.
+   * @param landmark_index Landmark costs used as heuristic instead of the
+   * manhattan distance if ready, not owned.
+   */
+  explicit AStarStrategy(bool enable_change,
+                         const LandmarkIndex* landmark_index = nullptr);
   ~AStarStrategy() = default;
 
   virtual bool Search(const TopoGraph* graph, const SubTopoGraph* sub_graph,
                       const TopoNode* src_node, const TopoNode* dest_node,
                       std::vector<NodeWithRange>* const result_nodes);
 
+  size_t ExpandedNodeNum() const { return closed_set_.size(); }
+
  private:
   void Clear();
   double HeuristicCost(const TopoNode* src_node, const TopoNode* dest_node);
@@ -42,6 +51,7 @@ class AStarStrategy : public Strategy {
 
  private:
   bool change_lane_enabled_;
+  const LandmarkIndex* landmark_index_ = nullptr;
   std::unordered_set<const TopoNode*> open_set_;
   std::unordered_set<const TopoNode*> closed_set_;
   std::unordered_map<const TopoNode*, const TopoNode*> came_from_;
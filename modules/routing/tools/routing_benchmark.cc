@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the route queries of the A* search with the manhattan heuristic
+// and with the landmark heuristic on the routing map of FLAGS_map_dir.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/file.h"
+#include "modules/map/hdmap/hdmap_util.h"
+#include "modules/routing/common/routing_gflags.h"
+#include "modules/routing/graph/landmark_index.h"
+#include "modules/routing/graph/sub_topo_graph.h"
+#include "modules/routing/graph/topo_graph.h"
+#include "modules/routing/strategy/a_star_strategy.h"
+
+DEFINE_int32(routing_benchmark_query_num, 200,
+             "number of random route queries");
+DEFINE_int32(routing_benchmark_black_lane_num, 0,
+             "number of random lanes black listed in every query");
+DEFINE_int32(routing_benchmark_seed, 0, "seed of the random queries");
+
+namespace {
+
+using apollo::routing::AStarStrategy;
+using apollo::routing::NodeSRange;
+using apollo::routing::NodeWithRange;
+using apollo::routing::SubTopoGraph;
+using apollo::routing::TopoGraph;
+using apollo::routing::TopoNode;
+
+struct QueryStats {
+  int found_num = 0;
+  size_t expanded_node_num = 0;
+  double total_time_ms = 0.0;
+};
+
+bool RunQuery(const TopoGraph& graph, const SubTopoGraph& sub_graph,
+              const TopoNode* src_node, const TopoNode* dest_node,
+              AStarStrategy* strategy, QueryStats* stats,
+              std::vector<NodeWithRange>* result) {
+  const auto start = std::chrono::steady_clock::now();
+  const bool found =
+      strategy->Search(&graph, &sub_graph, src_node, dest_node, result);
+  stats->total_time_ms += std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+  stats->expanded_node_num += strategy->ExpandedNodeNum();
+  stats->found_num += found ? 1 : 0;
+  return found;
+}
+
+void PrintStats(const std::string& name, const QueryStats& stats) {
+  const int query_num = std::max(FLAGS_routing_benchmark_query_num, 1);
+  std::cout << name << ": found " << stats.found_num << "/" << query_num
+            << ", mean time " << stats.total_time_ms / query_num
+            << " ms, mean expanded nodes "
+            << static_cast<double>(stats.expanded_node_num) / query_num
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  const std::string routing_map = apollo::hdmap::RoutingMapFile();
+  apollo::routing::Graph graph_pb;
+  if (!apollo::cyber::common::GetProtoFromFile(routing_map, &graph_pb)) {
+    AERROR << "Failed to read topology graph from " << routing_map;
+    return -1;
+  }
+  TopoGraph graph;
+  if (!graph.LoadGraph(graph_pb)) {
+    AERROR << "Failed to load topology graph from " << routing_map;
+    return -1;
+  }
+
+  apollo::routing::RoutingLandmarks landmarks;
+  const std::string landmark_file =
+      apollo::routing::LandmarkIndex::IndexFile(routing_map);
+  if (!apollo::cyber::common::PathExists(landmark_file) ||
+      !apollo::cyber::common::GetProtoFromFile(landmark_file, &landmarks)) {
+    const auto start = std::chrono::steady_clock::now();
+    if (!apollo::routing::LandmarkIndex::Build(
+            graph_pb, FLAGS_routing_landmark_num, &landmarks)) {
+      return -1;
+    }
+    std::cout << "Built " << landmarks.landmark_size() << " landmarks in "
+              << std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " s" << std::endl;
+  }
+  apollo::routing::LandmarkIndex landmark_index;
+  if (!landmark_index.Init(landmarks, &graph)) {
+    AERROR << "Failed to init the landmark index.";
+    return -1;
+  }
+
+  std::vector<const TopoNode*> nodes;
+  for (const auto& node : graph_pb.node()) {
+    nodes.push_back(graph.GetNode(node.lane_id()));
+  }
+  std::mt19937 generator(FLAGS_routing_benchmark_seed);
+  std::uniform_int_distribution<size_t> node_distribution(0,
+                                                          nodes.size() - 1);
+
+  AStarStrategy plain_strategy(FLAGS_enable_change_lane_in_result);
+  AStarStrategy landmark_strategy(FLAGS_enable_change_lane_in_result,
+                                  &landmark_index);
+  QueryStats plain_stats;
+  QueryStats landmark_stats;
+  int different_route_num = 0;
+  for (int i = 0; i < FLAGS_routing_benchmark_query_num; ++i) {
+    const TopoNode* src_node = nodes[node_distribution(generator)];
+    const TopoNode* dest_node = nodes[node_distribution(generator)];
+    std::unordered_map<const TopoNode*, std::vector<NodeSRange>> black_map;
+    for (int j = 0; j < FLAGS_routing_benchmark_black_lane_num; ++j) {
+      const TopoNode* node = nodes[node_distribution(generator)];
+      if (node != src_node && node != dest_node) {
+        black_map[node].emplace_back(0.0, node->Length());
+      }
+    }
+    SubTopoGraph sub_graph(black_map);
+
+    std::vector<NodeWithRange> plain_result;
+    std::vector<NodeWithRange> landmark_result;
+    const bool plain_found =
+        RunQuery(graph, sub_graph, src_node, dest_node, &plain_strategy,
+                 &plain_stats, &plain_result);
+    const bool landmark_found =
+        RunQuery(graph, sub_graph, src_node, dest_node, &landmark_strategy,
+                 &landmark_stats, &landmark_result);
+    if (plain_found != landmark_found ||
+        plain_result.size() != landmark_result.size()) {
+      ++different_route_num;
+    }
+  }
+
+  PrintStats("manhattan heuristic", plain_stats);
+  PrintStats("landmark heuristic", landmark_stats);
+  std::cout << "queries with different routes: " << different_route_num
+            << std::endl;
+  return 0;
+}
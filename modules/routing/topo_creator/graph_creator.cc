@@ -24,6 +24,7 @@
 #include "modules/common/math/math_utils.h"
 #include "modules/map/hdmap/adapter/opendrive_adapter.h"
 #include "modules/routing/common/routing_gflags.h"
+#include "modules/routing/graph/landmark_index.h"
 #include "modules/routing/topo_creator/edge_creator.h"
 #include "modules/routing/topo_creator/node_creator.h"
 
@@ -160,6 +161,19 @@ bool GraphCreator::Create() {
     return false;
   }
   AINFO << "Bin file is dumped successfully. Path: " << bin_file;
+
+  if (FLAGS_routing_landmark_num > 0) {
+    RoutingLandmarks landmarks;
+    const std::string landmark_file = LandmarkIndex::IndexFile(bin_file);
+    if (!LandmarkIndex::Build(graph_, FLAGS_routing_landmark_num,
+                              &landmarks) ||
+        !cyber::common::SetProtoToBinaryFile(landmarks, landmark_file)) {
+      AERROR << "Failed to dump routing landmarks into file "
+             << landmark_file;
+      return false;
+    }
+    AINFO << "Landmark file is dumped successfully. Path: " << landmark_file;
+  }
   return true;
 }
 
@@ -16,6 +16,9 @@
 
 #include "modules/transform/buffer.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "absl/strings/str_cat.h"
 
 #include "cyber/cyber.h"
@@ -73,8 +76,10 @@ void Buffer::SubscriptionCallbackImpl(
   cyber::Time now = Clock::Now();
   std::string authority =
       "cyber_tf";  // msg_evt.getPublisherName(); // lookup the authority
+  bool tree_changed = is_static;
   if (now.ToNanosecond() < last_update_.ToNanosecond()) {
     AINFO << "Detected jump back in time. Clearing TF buffer.";
+    tree_changed = true;
     clear();
     // cache static transform stamped again.
     for (auto& msg : static_msgs_) {
@@ -111,6 +116,11 @@ void Buffer::SubscriptionCallbackImpl(
 
       if (is_static) {
         static_msgs_.push_back(trans_stamped);
+      } else {
+        // A frame turning dynamic invalidates the cached static chains.
+        std::lock_guard<std::mutex> lock(dynamic_frames_mutex_);
+        tree_changed |=
+            dynamic_frames_.insert(trans_stamped.child_frame_id).second;
       }
       setTransform(trans_stamped, authority, is_static);
     } catch (tf2::TransformException& ex) {
@@ -118,6 +128,31 @@ void Buffer::SubscriptionCallbackImpl(
       AERROR << "Failure to set received transform:" << temp.c_str();
     }
   }
+  NotifyUpdate(tree_changed);
+}
+
+void Buffer::NotifyUpdate(bool tree_changed) {
+  {
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    if (tree_changed) {
+      static_generation_.fetch_add(1, std::memory_order_release);
+    } else {
+      dynamic_generation_.fetch_add(1, std::memory_order_release);
+    }
+  }
+  update_cv_.notify_all();
+}
+
+void Buffer::WaitForUpdate(
+    uint64_t static_generation, uint64_t dynamic_generation,
+    const std::chrono::steady_clock::time_point& deadline) const {
+  std::unique_lock<std::mutex> lock(update_mutex_);
+  update_cv_.wait_until(lock, deadline, [&] {
+    return static_generation_.load(std::memory_order_acquire) !=
+               static_generation ||
+           dynamic_generation_.load(std::memory_order_acquire) !=
+               dynamic_generation;
+  });
 }
 
 bool Buffer::GetLatestStaticTF(const std::string& frame_id,
@@ -165,15 +200,217 @@ void Buffer::TF2MsgToCyber(
       tf2_trans_stamped.transform.rotation.w);
 }
 
+void Buffer::TF2MsgToSample(
+    const geometry_msgs::TransformStamped& tf2_trans_stamped,
+    TransformSample* sample) const {
+  sample->stamp_ns = tf2_trans_stamped.header.stamp;
+  sample->translation[0] = tf2_trans_stamped.transform.translation.x;
+  sample->translation[1] = tf2_trans_stamped.transform.translation.y;
+  sample->translation[2] = tf2_trans_stamped.transform.translation.z;
+  sample->rotation[0] = tf2_trans_stamped.transform.rotation.x;
+  sample->rotation[1] = tf2_trans_stamped.transform.rotation.y;
+  sample->rotation[2] = tf2_trans_stamped.transform.rotation.z;
+  sample->rotation[3] = tf2_trans_stamped.transform.rotation.w;
+}
+
+void Buffer::SampleToCyber(const TransformSample& sample,
+                           const std::string& target_frame,
+                           const std::string& source_frame,
+                           TransformStamped* trans_stamped) const {
+  trans_stamped->mutable_header()->set_timestamp_sec(
+      static_cast<double>(sample.stamp_ns) / 1e9);
+  trans_stamped->mutable_header()->set_frame_id(target_frame);
+  trans_stamped->set_child_frame_id(source_frame);
+
+  auto* translation = trans_stamped->mutable_transform()->mutable_translation();
+  translation->set_x(sample.translation[0]);
+  translation->set_y(sample.translation[1]);
+  translation->set_z(sample.translation[2]);
+
+  auto* rotation = trans_stamped->mutable_transform()->mutable_rotation();
+  rotation->set_qx(sample.rotation[0]);
+  rotation->set_qy(sample.rotation[1]);
+  rotation->set_qz(sample.rotation[2]);
+  rotation->set_qw(sample.rotation[3]);
+}
+
+FrameId Buffer::GetFrameId(const std::string& frame_id) const {
+  return frame_ids_.GetOrRegister(frame_id);
+}
+
+bool Buffer::IsStaticChain(const std::string& target_frame,
+                           const std::string& source_frame) const {
+  // The latest common time of a chain of static transforms is 0.
+  try {
+    return tf2::BufferCore::lookupTransform(target_frame, source_frame, 0)
+               .header.stamp == 0;
+  } catch (tf2::TransformException&) {
+    return false;
+  }
+}
+
+TransformSample Buffer::LookupAndCacheTransform(
+    const std::string& target_frame, FrameId target_id,
+    const std::string& source_frame, FrameId source_id, uint64_t time_ns,
+    uint64_t static_generation, uint64_t dynamic_generation) const {
+  TransformSample sample;
+  TF2MsgToSample(
+      tf2::BufferCore::lookupTransform(target_frame, source_frame, time_ns),
+      &sample);
+  // Identity lookups are cheap and report the latest time of the frame.
+  if (target_id == source_id) {
+    return sample;
+  }
+  bool is_static = false;
+  if (time_ns == 0) {
+    is_static = sample.stamp_ns == 0;
+  } else if (!transform_cache_.IsStatic(target_id, source_id,
+                                        static_generation, &is_static)) {
+    is_static = IsStaticChain(target_frame, source_frame);
+  }
+  transform_cache_.Put(target_id, source_id, time_ns, is_static,
+                       static_generation, dynamic_generation, sample);
+  return sample;
+}
+
+bool Buffer::WaitForTransform(const std::string& target_frame,
+                              FrameId target_id,
+                              const std::string& source_frame,
+                              FrameId source_id, uint64_t time_ns,
+                              float timeout_second, TransformSample* sample,
+                              std::string* errstr) const {
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::nanoseconds(
+          static_cast<uint64_t>(timeout_second * kSecondToNanoFactor));
+  while (true) {
+    // Read the generations first so that an update racing with the lookup
+    // leaves a stale cache entry rather than a wrong one.
+    const uint64_t static_generation =
+        static_generation_.load(std::memory_order_acquire);
+    const uint64_t dynamic_generation =
+        dynamic_generation_.load(std::memory_order_acquire);
+    if (transform_cache_.Get(target_id, source_id, time_ns, static_generation,
+                             dynamic_generation, sample)) {
+      return true;
+    }
+    errstr->clear();
+    if (tf2::BufferCore::canTransform(target_frame, source_frame, time_ns,
+                                      errstr)) {
+      try {
+        *sample = LookupAndCacheTransform(target_frame, target_id,
+                                          source_frame, source_id, time_ns,
+                                          static_generation,
+                                          dynamic_generation);
+        return true;
+      } catch (tf2::TransformException& ex) {
+        *errstr = ex.what();
+      }
+    }
+    if (!cyber::common::GlobalData::Instance()->IsRealityMode() ||
+        std::chrono::steady_clock::now() >= deadline || cyber::IsShutdown()) {
+      break;
+    }
+    AWARN << "BufferCore::canTransform failed: " << *errstr;
+    WaitForUpdate(static_generation, dynamic_generation, deadline);
+  }
+  *errstr = *errstr + ":timeout";
+  return false;
+}
+
+bool Buffer::LookupTransform(FrameId target_frame, FrameId source_frame,
+                             const cyber::Time& time, float timeout_second,
+                             TransformSample* transform,
+                             std::string* errstr) const {
+  const uint64_t time_ns = time.ToNanosecond();
+  if (transform_cache_.Get(
+          target_frame, source_frame, time_ns,
+          static_generation_.load(std::memory_order_acquire),
+          dynamic_generation_.load(std::memory_order_acquire), transform)) {
+    return true;
+  }
+  std::string error;
+  return WaitForTransform(frame_ids_.GetName(target_frame), target_frame,
+                          frame_ids_.GetName(source_frame), source_frame,
+                          time_ns, timeout_second, transform,
+                          errstr == nullptr ? &error : errstr);
+}
+
+bool Buffer::LookupTransforms(FrameId target_frame, FrameId source_frame,
+                              const std::vector<uint64_t>& timestamps_ns,
+                              float timeout_second,
+                              std::vector<TransformSample>* transforms,
+                              std::string* errstr) const {
+  transforms->resize(timestamps_ns.size());
+  if (timestamps_ns.empty()) {
+    return true;
+  }
+  std::string error;
+  if (errstr == nullptr) {
+    errstr = &error;
+  }
+  const std::string target_name = frame_ids_.GetName(target_frame);
+  const std::string source_name = frame_ids_.GetName(source_frame);
+
+  // Once the latest time is available all the earlier ones are too, unless
+  // they are older than the buffer.
+  std::vector<size_t> order(timestamps_ns.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return timestamps_ns[lhs] > timestamps_ns[rhs];
+  });
+  TransformSample sample;
+  if (!WaitForTransform(target_name, target_frame, source_name, source_frame,
+                        timestamps_ns[order.front()], timeout_second, &sample,
+                        errstr)) {
+    return false;
+  }
+  if (IsStaticChain(target_name, source_name)) {
+    for (size_t i = 0; i < timestamps_ns.size(); ++i) {
+      (*transforms)[i] = sample;
+      (*transforms)[i].stamp_ns = timestamps_ns[i];
+    }
+    return true;
+  }
+
+  uint64_t sample_time_ns = timestamps_ns[order.front()];
+  try {
+    for (const size_t i : order) {
+      if (timestamps_ns[i] != sample_time_ns) {
+        sample_time_ns = timestamps_ns[i];
+        TF2MsgToSample(tf2::BufferCore::lookupTransform(
+                           target_name, source_name, sample_time_ns),
+                       &sample);
+      }
+      (*transforms)[i] = sample;
+    }
+  } catch (tf2::TransformException& ex) {
+    *errstr = ex.what();
+    return false;
+  }
+  return true;
+}
+
 TransformStamped Buffer::lookupTransform(const std::string& target_frame,
                                          const std::string& source_frame,
                                          const cyber::Time& time,
                                          const float timeout_second) const {
-  tf2::Time tf2_time(time.ToNanosecond());
-  geometry_msgs::TransformStamped tf2_trans_stamped =
-      tf2::BufferCore::lookupTransform(target_frame, source_frame, tf2_time);
+  const FrameId target_id = GetFrameId(target_frame);
+  const FrameId source_id = GetFrameId(source_frame);
+  const uint64_t time_ns = time.ToNanosecond();
+  const uint64_t static_generation =
+      static_generation_.load(std::memory_order_acquire);
+  const uint64_t dynamic_generation =
+      dynamic_generation_.load(std::memory_order_acquire);
+  TransformSample sample;
+  if (!transform_cache_.Get(target_id, source_id, time_ns, static_generation,
+                            dynamic_generation, &sample)) {
+    sample = LookupAndCacheTransform(target_frame, target_id, source_frame,
+                                     source_id, time_ns, static_generation,
+                                     dynamic_generation);
+  }
   TransformStamped trans_stamped;
-  TF2MsgToCyber(tf2_trans_stamped, trans_stamped);
+  SampleToCyber(sample, target_frame, source_frame, &trans_stamped);
   return trans_stamped;
 }
 
@@ -196,27 +433,12 @@ bool Buffer::canTransform(const std::string& target_frame,
                           const std::string& source_frame,
                           const cyber::Time& time, const float timeout_second,
                           std::string* errstr) const {
-  uint64_t timeout_ns =
-      static_cast<uint64_t>(timeout_second * kSecondToNanoFactor);
-  uint64_t start_time = Clock::Now().ToNanosecond();  // time.ToNanosecond();
-  while (Clock::Now().ToNanosecond() < start_time + timeout_ns &&
-         !cyber::IsShutdown()) {
-    errstr->clear();
-    bool retval = tf2::BufferCore::canTransform(target_frame, source_frame,
-                                                time.ToNanosecond(), errstr);
-    if (retval) {
-      return true;
-    } else {
-      if (!cyber::common::GlobalData::Instance()->IsRealityMode()) {
-        break;
-      }
-      const int sleep_time_ms = 3;
-      AWARN << "BufferCore::canTransform failed: " << *errstr;
-      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time_ms));
-    }
-  }
-  *errstr = *errstr + ":timeout";
-  return false;
+  std::string error;
+  TransformSample sample;
+  return WaitForTransform(target_frame, GetFrameId(target_frame), source_frame,
+                          GetFrameId(source_frame), time.ToNanosecond(),
+                          timeout_second, &sample,
+                          errstr == nullptr ? &error : errstr);
 }
 
 bool Buffer::canTransform(const std::string& target_frame,
@@ -241,8 +463,13 @@ bool Buffer::canTransform(const std::string& target_frame,
     } else {
       const int sleep_time_ms = 3;
       AWARN << "BufferCore::canTransform failed: " << *errstr;
-      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time_ms));
-      if (!cyber::common::GlobalData::Instance()->IsRealityMode()) {
+      if (cyber::common::GlobalData::Instance()->IsRealityMode()) {
+        WaitForUpdate(static_generation_.load(std::memory_order_acquire),
+                      dynamic_generation_.load(std::memory_order_acquire),
+                      std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(sleep_time_ms));
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time_ms));
         Clock::SetNow(Time(Clock::Now().ToNanosecond() +
                            sleep_time_ms * kMilliToNanoFactor));
       }
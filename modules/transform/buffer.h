@@ -16,8 +16,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "tf2/buffer_core.h"
@@ -25,6 +30,7 @@
 
 #include "cyber/node/node.h"
 #include "modules/transform/buffer_interface.h"
+#include "modules/transform/transform_cache.h"
 
 namespace apollo {
 namespace transform {
@@ -116,6 +122,49 @@ class Buffer : public BufferInterface, public tf2::BufferCore {
                          const std::string& child_frame_id,
                          TransformStamped* tf);
 
+  /** \brief Intern a frame ID for the lookups by FrameId below.
+   * \param frame_id The frame name, it does not need to be known yet
+   * \return The id of the frame, stable for the lifetime of the buffer
+   */
+  FrameId GetFrameId(const std::string& frame_id) const;
+
+  /** \brief Get the transform between two interned frames.
+   * Repeated lookups of the same frame pair are served from a lock-free
+   * cache, and a missing transform is waited for until the next update
+   * instead of being polled for.
+   * \param target_frame The frame to which data should be transformed
+   * \param source_frame The frame where the data originated
+   * \param time The time at which the value of the transform is desired. (0
+   *will get the latest)
+   * \param timeout_second How long to block before failing
+   * \param transform The transform between the frames
+   * \param errstr A pointer to a string which will be filled with why the
+   * lookup failed, if not nullptr
+   * \return True if the transform was found, false otherwise
+   */
+  bool LookupTransform(FrameId target_frame, FrameId source_frame,
+                       const cyber::Time& time, float timeout_second,
+                       TransformSample* transform,
+                       std::string* errstr = nullptr) const;
+
+  /** \brief Get the transforms between two interned frames at many times,
+   * e.g. for per-point motion compensation. Only waits once, for the latest
+   * of the times, and looks every distinct time up only once.
+   * \param target_frame The frame to which data should be transformed
+   * \param source_frame The frame where the data originated
+   * \param timestamps_ns The times at which the transforms are desired
+   * \param timeout_second How long to block before failing
+   * \param transforms The transforms, in the order of timestamps_ns
+   * \param errstr A pointer to a string which will be filled with why the
+   * lookup failed, if not nullptr
+   * \return True if all the transforms were found, false otherwise
+   */
+  bool LookupTransforms(FrameId target_frame, FrameId source_frame,
+                        const std::vector<uint64_t>& timestamps_ns,
+                        float timeout_second,
+                        std::vector<TransformSample>* transforms,
+                        std::string* errstr = nullptr) const;
+
  private:
   void SubscriptionCallback(
       const std::shared_ptr<const TransformStampeds>& transform);
@@ -127,6 +176,34 @@ class Buffer : public BufferInterface, public tf2::BufferCore {
 
   void TF2MsgToCyber(const geometry_msgs::TransformStamped& tf2_trans_stamped,
                      TransformStamped& trans_stamped) const;  // NOLINT
+  void TF2MsgToSample(const geometry_msgs::TransformStamped& tf2_trans_stamped,
+                      TransformSample* sample) const;
+  void SampleToCyber(const TransformSample& sample,
+                     const std::string& target_frame,
+                     const std::string& source_frame,
+                     TransformStamped* trans_stamped) const;
+
+  // Looks the transform up in BufferCore and caches it, throws like
+  // BufferCore::lookupTransform.
+  TransformSample LookupAndCacheTransform(const std::string& target_frame,
+                                          FrameId target_id,
+                                          const std::string& source_frame,
+                                          FrameId source_id, uint64_t time_ns,
+                                          uint64_t static_generation,
+                                          uint64_t dynamic_generation) const;
+  // Waits until the transform can be looked up or the timeout expires.
+  bool WaitForTransform(const std::string& target_frame, FrameId target_id,
+                        const std::string& source_frame, FrameId source_id,
+                        uint64_t time_ns, float timeout_second,
+                        TransformSample* sample, std::string* errstr) const;
+  // Blocks until a transform is received or the deadline passes.
+  void WaitForUpdate(
+      uint64_t static_generation, uint64_t dynamic_generation,
+      const std::chrono::steady_clock::time_point& deadline) const;
+  // Whether every transform between the frames is static.
+  bool IsStaticChain(const std::string& target_frame,
+                     const std::string& source_frame) const;
+  void NotifyUpdate(bool tree_changed);
 
   std::unique_ptr<cyber::Node> node_;
   std::shared_ptr<cyber::Reader<TransformStampeds>> message_subscriber_tf_;
@@ -136,6 +213,17 @@ class Buffer : public BufferInterface, public tf2::BufferCore {
   cyber::Time last_update_;
   std::vector<geometry_msgs::TransformStamped> static_msgs_;
 
+  mutable FrameIdRegistry frame_ids_;
+  mutable TransformCache transform_cache_;
+  // Bumped after static (resp. dynamic) transforms are set, the static one
+  // also when the frame tree may have changed.
+  std::atomic<uint64_t> static_generation_ = {1};
+  std::atomic<uint64_t> dynamic_generation_ = {1};
+  mutable std::mutex update_mutex_;
+  mutable std::condition_variable update_cv_;
+  std::mutex dynamic_frames_mutex_;
+  std::unordered_set<std::string> dynamic_frames_;
+
   DECLARE_SINGLETON(Buffer)
 };  // class
 
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/transform_cache.h"
+
+#include "cyber/base/rw_lock_guard.h"
+
+namespace apollo {
+namespace transform {
+
+using cyber::base::AtomicRWLock;
+using cyber::base::ReadLockGuard;
+using cyber::base::WriteLockGuard;
+
+FrameId FrameIdRegistry::GetOrRegister(const std::string& frame_id) {
+  const FrameId id = Find(frame_id);
+  if (id != kInvalidFrameId) {
+    return id;
+  }
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
+  auto iter = ids_.find(frame_id);
+  if (iter != ids_.end()) {
+    return iter->second;
+  }
+  names_.push_back(frame_id);
+  const FrameId new_id = static_cast<FrameId>(names_.size());
+  ids_.emplace(frame_id, new_id);
+  return new_id;
+}
+
+FrameId FrameIdRegistry::Find(const std::string& frame_id) const {
+  ReadLockGuard<AtomicRWLock> lock(rw_lock_);
+  auto iter = ids_.find(frame_id);
+  return iter == ids_.end() ? kInvalidFrameId : iter->second;
+}
+
+std::string FrameIdRegistry::GetName(FrameId id) const {
+  ReadLockGuard<AtomicRWLock> lock(rw_lock_);
+  if (id == kInvalidFrameId || id > names_.size()) {
+    return "";
+  }
+  return names_[id - 1];
+}
+
+TransformCache::Slot* TransformCache::FindSlot(uint64_t key) const {
+  Slot** slot = nullptr;
+  if (!slots_.Get(key, &slot)) {
+    return nullptr;
+  }
+  return *slot;
+}
+
+bool TransformCache::Get(FrameId target, FrameId source, uint64_t time_ns,
+                         uint64_t static_generation,
+                         uint64_t dynamic_generation,
+                         TransformSample* sample) const {
+  const Slot* slot = FindSlot(PairKey(target, source));
+  Entry entry;
+  if (slot == nullptr || !slot->Load(&entry) ||
+      entry.static_generation != static_generation) {
+    return false;
+  }
+  if (entry.is_static) {
+    // Static transforms hold at any time, report the requested one as
+    // BufferCore does.
+    *sample = entry.sample;
+    sample->stamp_ns = time_ns;
+    return true;
+  }
+  if (entry.dynamic_generation != dynamic_generation ||
+      entry.time_ns != time_ns) {
+    return false;
+  }
+  *sample = entry.sample;
+  return true;
+}
+
+bool TransformCache::IsStatic(FrameId target, FrameId source,
+                              uint64_t static_generation,
+                              bool* is_static) const {
+  const Slot* slot = FindSlot(PairKey(target, source));
+  Entry entry;
+  if (slot == nullptr || !slot->Load(&entry) ||
+      entry.static_generation != static_generation) {
+    return false;
+  }
+  *is_static = entry.is_static != 0;
+  return true;
+}
+
+void TransformCache::Put(FrameId target, FrameId source, uint64_t time_ns,
+                         bool is_static, uint64_t static_generation,
+                         uint64_t dynamic_generation,
+                         const TransformSample& sample) {
+  const uint64_t key = PairKey(target, source);
+  Slot* slot = FindSlot(key);
+  if (slot == nullptr) {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    slot = FindSlot(key);
+    if (slot == nullptr) {
+      slot_storage_.emplace_back(new Slot());
+      slot = slot_storage_.back().get();
+      slots_.Set(key, slot);
+    }
+  }
+  Entry entry;
+  entry.static_generation = static_generation;
+  entry.dynamic_generation = dynamic_generation;
+  entry.time_ns = time_ns;
+  entry.is_static = is_static ? 1 : 0;
+  entry.sample = sample;
+  slot->TryStore(entry);
+}
+
+}  // namespace transform
+}  // namespace apollo
@@ -0,0 +1,210 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/base/atomic_hash_map.h"
+#include "cyber/base/atomic_rw_lock.h"
+
+namespace apollo {
+namespace transform {
+
+/**
+ * @brief Interned frame id. Comparing and hashing it is much cheaper than a
+ * frame name, 0 is never a valid frame.
+ */
+using FrameId = uint32_t;
+constexpr FrameId kInvalidFrameId = 0;
+
+/**
+ * @brief A rigid transform and the time it was evaluated at.
+ */
+struct TransformSample {
+  uint64_t stamp_ns = 0;
+  double translation[3] = {0.0, 0.0, 0.0};
+  // qx, qy, qz, qw
+  double rotation[4] = {0.0, 0.0, 0.0, 1.0};
+};
+
+/**
+ * @class SeqLocked
+ * @brief Holds a trivially copyable value that is read without locking.
+ * Readers retry if a writer was active while they copied the value, and
+ * writers never block: a write that races with another one is dropped.
+ */
+template <typename T>
+class SeqLocked {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLocked requires a trivially copyable type");
+
+ public:
+  SeqLocked() = default;
+  SeqLocked(const SeqLocked&) = delete;
+  SeqLocked& operator=(const SeqLocked&) = delete;
+
+  /**
+   * @brief Copies the value out, returns false if it was never written.
+   */
+  bool Load(T* value) const {
+    uint64_t words[kNumWords];
+    uint64_t seq = 0;
+    do {
+      seq = seq_.load(std::memory_order_acquire);
+      while (seq & 1) {
+        seq = seq_.load(std::memory_order_acquire);
+      }
+      for (size_t i = 0; i < kNumWords; ++i) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while (seq != seq_.load(std::memory_order_relaxed));
+    if (seq == 0) {
+      return false;
+    }
+    std::memcpy(value, words, sizeof(T));
+    return true;
+  }
+
+  /**
+   * @brief Stores the value unless another writer is active.
+   */
+  bool TryStore(const T& value) {
+    uint64_t seq = seq_.load(std::memory_order_relaxed);
+    if ((seq & 1) || !seq_.compare_exchange_strong(
+                         seq, seq + 1, std::memory_order_acquire,
+                         std::memory_order_relaxed)) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    uint64_t words[kNumWords] = {0};
+    std::memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < kNumWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static constexpr size_t kNumWords = (sizeof(T) + 7) / 8;
+  std::atomic<uint64_t> seq_ = {0};
+  std::atomic<uint64_t> words_[kNumWords] = {};
+};
+
+/**
+ * @class FrameIdRegistry
+ * @brief Maps frame names to FrameIds. Names are never removed, so an id
+ * stays valid for the lifetime of the registry.
+ */
+class FrameIdRegistry {
+ public:
+  /**
+   * @brief Returns the id of the frame, registering it on first use.
+   */
+  FrameId GetOrRegister(const std::string& frame_id);
+
+  /**
+   * @brief Returns the id of the frame or kInvalidFrameId if unknown.
+   */
+  FrameId Find(const std::string& frame_id) const;
+
+  /**
+   * @brief Returns the name of a registered frame, empty if unknown.
+   */
+  std::string GetName(FrameId id) const;
+
+ private:
+  mutable cyber::base::AtomicRWLock rw_lock_;
+  std::unordered_map<std::string, FrameId> ids_;
+  std::vector<std::string> names_;
+};
+
+/**
+ * @class TransformCache
+ * @brief Read-mostly cache of the last transform looked up per frame pair.
+ *
+ * Entries are tagged with the generations of the static and dynamic
+ * transforms they were computed from. An entry computed from static
+ * transforms only is valid at any time until the static generation changes,
+ * other entries are only valid for the same query time and until the next
+ * dynamic update. Get never takes a lock.
+ */
+class TransformCache {
+ public:
+  TransformCache() = default;
+  TransformCache(const TransformCache&) = delete;
+  TransformCache& operator=(const TransformCache&) = delete;
+
+  /**
+   * @brief Looks up the transform from source to target at time_ns, 0 for
+   * the latest one.
+   * @return True on a hit that is still valid for the given generations.
+   */
+  bool Get(FrameId target, FrameId source, uint64_t time_ns,
+           uint64_t static_generation, uint64_t dynamic_generation,
+           TransformSample* sample) const;
+
+  /**
+   * @brief Tells whether the chain between the frames is static, if known
+   * for the given static generation.
+   */
+  bool IsStatic(FrameId target, FrameId source, uint64_t static_generation,
+                bool* is_static) const;
+
+  /**
+   * @brief Caches a transform computed for time_ns from the transforms of
+   * the given generations. is_static tells that every transform on the
+   * chain is static, so the result does not depend on time.
+   */
+  void Put(FrameId target, FrameId source, uint64_t time_ns, bool is_static,
+           uint64_t static_generation, uint64_t dynamic_generation,
+           const TransformSample& sample);
+
+ private:
+  struct Entry {
+    uint64_t static_generation;
+    uint64_t dynamic_generation;
+    uint64_t time_ns;
+    uint64_t is_static;
+    TransformSample sample;
+  };
+  using Slot = SeqLocked<Entry>;
+
+  static uint64_t PairKey(FrameId target, FrameId source) {
+    return (static_cast<uint64_t>(target) << 32) | source;
+  }
+
+  Slot* FindSlot(uint64_t key) const;
+
+  mutable cyber::base::AtomicHashMap<uint64_t, Slot*, 256> slots_;
+  // Serializes slot creation, AtomicHashMap frees the old value when a key is
+  // set twice.
+  std::mutex slots_mutex_;
+  std::vector<std::unique_ptr<Slot>> slot_storage_;
+};
+
+}  // namespace transform
+}  // namespace apollo
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/transform/transform_cache.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace transform {
+
+namespace {
+
+TransformSample MakeSample(uint64_t stamp_ns, double x) {
+  TransformSample sample;
+  sample.stamp_ns = stamp_ns;
+  sample.translation[0] = x;
+  return sample;
+}
+
+}  // namespace
+
+TEST(FrameIdRegistryTest, GetOrRegister) {
+  FrameIdRegistry registry;
+  EXPECT_EQ(kInvalidFrameId, registry.Find("world"));
+  const FrameId world = registry.GetOrRegister("world");
+  const FrameId novatel = registry.GetOrRegister("novatel");
+  EXPECT_NE(kInvalidFrameId, world);
+  EXPECT_NE(world, novatel);
+  EXPECT_EQ(world, registry.GetOrRegister("world"));
+  EXPECT_EQ(world, registry.Find("world"));
+  EXPECT_EQ("novatel", registry.GetName(novatel));
+  EXPECT_EQ("", registry.GetName(kInvalidFrameId));
+}
+
+TEST(TransformCacheTest, DynamicEntry) {
+  TransformCache cache;
+  TransformSample sample;
+  EXPECT_FALSE(cache.Get(1, 2, 100, 1, 1, &sample));
+
+  cache.Put(1, 2, 100, false, 1, 1, MakeSample(100, 1.0));
+  EXPECT_TRUE(cache.Get(1, 2, 100, 1, 1, &sample));
+  EXPECT_EQ(100, sample.stamp_ns);
+  EXPECT_DOUBLE_EQ(1.0, sample.translation[0]);
+  // other time, other frame pair, newer transforms
+  EXPECT_FALSE(cache.Get(1, 2, 200, 1, 1, &sample));
+  EXPECT_FALSE(cache.Get(2, 1, 100, 1, 1, &sample));
+  EXPECT_FALSE(cache.Get(1, 2, 100, 1, 2, &sample));
+  EXPECT_FALSE(cache.Get(1, 2, 100, 2, 1, &sample));
+  bool is_static = true;
+  EXPECT_TRUE(cache.IsStatic(1, 2, 1, &is_static));
+  EXPECT_FALSE(is_static);
+  EXPECT_FALSE(cache.IsStatic(1, 2, 2, &is_static));
+
+  // the latest transform is cached under time 0
+  cache.Put(1, 2, 0, false, 1, 2, MakeSample(300, 2.0));
+  EXPECT_TRUE(cache.Get(1, 2, 0, 1, 2, &sample));
+  EXPECT_EQ(300, sample.stamp_ns);
+  EXPECT_FALSE(cache.Get(1, 2, 100, 1, 2, &sample));
+}
+
+TEST(TransformCacheTest, StaticEntry) {
+  TransformCache cache;
+  TransformSample sample;
+  cache.Put(3, 4, 0, true, 5, 1, MakeSample(0, 3.0));
+  // static transforms hold at any time until the static ones change
+  EXPECT_TRUE(cache.Get(3, 4, 1000, 5, 7, &sample));
+  EXPECT_EQ(1000, sample.stamp_ns);
+  EXPECT_DOUBLE_EQ(3.0, sample.translation[0]);
+  EXPECT_FALSE(cache.Get(3, 4, 1000, 6, 7, &sample));
+}
+
+TEST(TransformCacheTest, ConcurrentAccess) {
+  TransformCache cache;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (uint64_t i = 1; i <= 1000; ++i) {
+        const FrameId source = static_cast<FrameId>(i % 8 + 1);
+        cache.Put(1, source, i, false, 1, 1,
+                  MakeSample(i, static_cast<double>(i)));
+        TransformSample sample;
+        if (cache.Get(1, source, i + t, 1, 1, &sample)) {
+          // an entry is never torn
+          EXPECT_DOUBLE_EQ(static_cast<double>(sample.stamp_ns),
+                           sample.translation[0]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace transform
+}  // namespace apollo